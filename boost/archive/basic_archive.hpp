@@ -236,7 +236,8 @@ enum archive_flags {
     no_codecvt = 2,  // suppress alteration of codecvt facet
     no_xml_tag_checking = 4,   // suppress checking of xml tags
     no_tracking = 8,           // suppress ALL tracking
-    flags_last = 8
+    track_pointers_only = 16,  // track only objects saved through pointers
+    flags_last = 16
 };
 
 BOOST_ARCHIVE_DECL(const char *)
@@ -0,0 +1,169 @@
+#ifndef BOOST_ARCHIVE_BASIC_BINARY_BUFFER_IPRIMITIVE_HPP
+#define BOOST_ARCHIVE_BASIC_BINARY_BUFFER_IPRIMITIVE_HPP
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+# pragma once
+#endif
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// basic_binary_buffer_iprimitive.hpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org for updates, documentation, and revision history.
+
+// native binary input of primitives directly from a contiguous block of
+// memory - for example a std::vector<char> filled by binary_buffer_oarchive
+// or a memory mapped file written by binary_oarchive.  Primitives are
+// copied out of the block with inline memcpy rather than through a
+// virtual call of std::streambuf::sgetn.
+
+// IN GENERAL, ARCHIVES CREATED WITH THIS CLASS WILL NOT BE READABLE
+// ON PLATFORM APART FROM THE ONE THEY ARE CREATE ON
+
+#include <boost/assert.hpp>
+#include <string>
+#include <cstdio> // EOF
+#include <cstring> // std::memcpy
+#include <cstddef> // size_t
+
+#include <boost/config.hpp>
+#if defined(BOOST_NO_STDC_NAMESPACE)
+namespace std{
+    using ::size_t;
+    using ::memcpy;
+} // namespace std
+#endif
+
+#include <boost/serialization/throw_exception.hpp>
+#include <boost/archive/archive_exception.hpp>
+#include <boost/mpl/placeholders.hpp>
+#include <boost/serialization/is_bitwise_serializable.hpp>
+#include <boost/serialization/array.hpp>
+#include <boost/archive/detail/auto_link_archive.hpp>
+#include <boost/archive/detail/abi_prefix.hpp> // must be the last header
+
+namespace boost {
+namespace archive {
+
+/////////////////////////////////////////////////////////////////////////////
+// class basic_binary_buffer_iprimitive - binary input of primitives from
+// a block of memory
+template<class Archive>
+class basic_binary_buffer_iprimitive
+{
+#ifndef BOOST_NO_MEMBER_TEMPLATE_FRIENDS
+    friend class load_access;
+protected:
+#else
+public:
+#endif
+    // the block being read.  It is not copied and must outlive the
+    // archive.  basic_binary_iarchive reads the library version a byte
+    // at a time through the streambuf member m_sb, so the block offers
+    // the two streambuf functions it uses.
+    struct block {
+        const char * m_ptr; // the next byte to read
+        const char * m_end;
+        block(const char * b, const char * e) :
+            m_ptr(b),
+            m_end(e)
+        {}
+        std::size_t available() const {
+            return static_cast<std::size_t>(m_end - m_ptr);
+        }
+        int sgetc() const {
+            return m_ptr == m_end ? EOF : static_cast<unsigned char>(*m_ptr);
+        }
+        int sbumpc(){
+            return m_ptr == m_end ? EOF : static_cast<unsigned char>(*m_ptr++);
+        }
+    } m_sb;
+    // return a pointer to the most derived class
+    Archive * This(){
+        return static_cast<Archive *>(this);
+    }
+
+    // main template for serilization of primitive types
+    template<class T>
+    void load(T & t){
+        load_binary(& t, sizeof(T));
+    }
+
+    /////////////////////////////////////////////////////////
+    // fundamental types that need special treatment
+
+    // trap usage of invalid uninitialized boolean
+    void load(bool & t){
+        load_binary(& t, sizeof(t));
+        int i = t;
+        BOOST_ASSERT(0 == i || 1 == i);
+        (void)i; // warning suppression for release builds.
+    }
+    BOOST_ARCHIVE_DECL(void)
+    load(std::string &s);
+    #ifndef BOOST_NO_STD_WSTRING
+    BOOST_ARCHIVE_DECL(void)
+    load(std::wstring &ws);
+    #endif
+    BOOST_ARCHIVE_DECL(void)
+    load(char * t);
+    BOOST_ARCHIVE_DECL(void)
+    load(wchar_t * t);
+
+    BOOST_ARCHIVE_DECL(void)
+    init();
+    BOOST_ARCHIVE_DECL(BOOST_PP_EMPTY())
+    basic_binary_buffer_iprimitive(
+        const void * address,
+        std::size_t count
+    );
+public:
+    // we provide an optimized load for all fundamental types
+    // typedef serialization::is_bitwise_serializable<mpl::_1>
+    // use_array_optimization;
+    struct use_array_optimization {
+        template <class T>
+        #if defined(BOOST_NO_DEPENDENT_NESTED_DERIVATIONS)
+            struct apply {
+                typedef BOOST_DEDUCED_TYPENAME boost::serialization::is_bitwise_serializable< T >::type type;
+            };
+        #else
+            struct apply : public boost::serialization::is_bitwise_serializable< T > {};
+        #endif
+    };
+
+    // the optimized load_array dispatches to load_binary
+    template <class ValueType>
+    void load_array(serialization::array<ValueType>& a, unsigned int)
+    {
+      load_binary(a.address(),a.count()*sizeof(ValueType));
+    }
+
+    void
+    load_binary(void *address, std::size_t count);
+};
+
+template<class Archive>
+inline void
+basic_binary_buffer_iprimitive<Archive>::load_binary(
+    void *address,
+    std::size_t count
+){
+    if(m_sb.available() < count)
+        boost::serialization::throw_exception(
+            archive_exception(archive_exception::input_stream_error)
+        );
+    std::memcpy(address, m_sb.m_ptr, count);
+    m_sb.m_ptr += count;
+}
+
+} // namespace archive
+} // namespace boost
+
+#include <boost/archive/detail/abi_suffix.hpp> // pop pragmas
+
+#endif // BOOST_ARCHIVE_BASIC_BINARY_BUFFER_IPRIMITIVE_HPP
@@ -0,0 +1,161 @@
+#ifndef BOOST_ARCHIVE_BASIC_BINARY_BUFFER_OPRIMITIVE_HPP
+#define BOOST_ARCHIVE_BASIC_BINARY_BUFFER_OPRIMITIVE_HPP
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+# pragma once
+#endif
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// basic_binary_buffer_oprimitive.hpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org for updates, documentation, and revision history.
+
+// native binary output of primitives directly into a contiguous block of
+// memory.  The format is the same as that of basic_binary_oprimitive so
+// that archives can be read with either binary_iarchive or
+// binary_buffer_iarchive.  But rather than passing each primitive through
+// a virtual call of std::streambuf::sputn, primitives are copied with
+// inline memcpy into a std::vector<char> which grows as required.
+
+// IN GENERAL, ARCHIVES CREATED WITH THIS CLASS WILL NOT BE READABLE
+// ON PLATFORM APART FROM THE ONE THEY ARE CREATE ON
+
+#include <boost/assert.hpp>
+#include <string>
+#include <vector>
+#include <cstring> // std::memcpy
+#include <cstddef> // size_t
+
+#include <boost/config.hpp>
+#if defined(BOOST_NO_STDC_NAMESPACE)
+namespace std{
+    using ::size_t;
+    using ::memcpy;
+} // namespace std
+#endif
+
+#include <boost/archive/archive_exception.hpp>
+#include <boost/serialization/is_bitwise_serializable.hpp>
+#include <boost/mpl/placeholders.hpp>
+#include <boost/serialization/array.hpp>
+#include <boost/archive/detail/auto_link_archive.hpp>
+#include <boost/archive/detail/abi_prefix.hpp> // must be the last header
+
+namespace boost {
+namespace archive {
+
+/////////////////////////////////////////////////////////////////////////
+// class basic_binary_buffer_oprimitive - binary output of primitives
+// into a growable buffer
+
+template<class Archive>
+class basic_binary_buffer_oprimitive
+{
+#ifndef BOOST_NO_MEMBER_TEMPLATE_FRIENDS
+    friend class save_access;
+protected:
+#else
+public:
+#endif
+    std::vector<char> & m_buffer;
+    // the next byte to write and the end of the space allocated in
+    // m_buffer. m_buffer is resized ahead of the writes and brought
+    // back to the number of bytes written when the archive is destroyed.
+    char * m_ptr;
+    char * m_end;
+    // return a pointer to the most derived class
+    Archive * This(){
+        return static_cast<Archive *>(this);
+    }
+    // default saving of primitives.
+    template<class T>
+    void save(const T & t)
+    {
+        save_binary(& t, sizeof(T));
+    }
+
+    /////////////////////////////////////////////////////////
+    // fundamental types that need special treatment
+
+    // trap usage of invalid uninitialized boolean which would
+    // otherwise crash on load.
+    void save(const bool t){
+        BOOST_ASSERT(0 == static_cast<int>(t) || 1 == static_cast<int>(t));
+        save_binary(& t, sizeof(t));
+    }
+    BOOST_ARCHIVE_DECL(void)
+    save(const std::string &s);
+    #ifndef BOOST_NO_STD_WSTRING
+    BOOST_ARCHIVE_DECL(void)
+    save(const std::wstring &ws);
+    #endif
+    BOOST_ARCHIVE_DECL(void)
+    save(const char * t);
+    BOOST_ARCHIVE_DECL(void)
+    save(const wchar_t * t);
+
+    BOOST_ARCHIVE_DECL(void)
+    init();
+
+    // offset of the next byte to write
+    std::size_t position() const {
+        return m_ptr - & m_buffer[0];
+    }
+    // make room for at least count more bytes
+    BOOST_ARCHIVE_DECL(void)
+    grow(std::size_t count);
+
+    BOOST_ARCHIVE_DECL(BOOST_PP_EMPTY())
+    basic_binary_buffer_oprimitive(std::vector<char> & buffer);
+    BOOST_ARCHIVE_DECL(BOOST_PP_EMPTY())
+    ~basic_binary_buffer_oprimitive();
+public:
+
+    // we provide an optimized save for all fundamental types
+    // typedef serialization::is_bitwise_serializable<mpl::_1>
+    // use_array_optimization;
+    // workaround without using mpl lambdas
+    struct use_array_optimization {
+        template <class T>
+        #if defined(BOOST_NO_DEPENDENT_NESTED_DERIVATIONS)
+            struct apply {
+                typedef BOOST_DEDUCED_TYPENAME boost::serialization::is_bitwise_serializable< T >::type type;
+            };
+        #else
+            struct apply : public boost::serialization::is_bitwise_serializable< T > {};
+        #endif
+    };
+
+    // the optimized save_array dispatches to save_binary
+    template <class ValueType>
+    void save_array(boost::serialization::array<ValueType> const& a, unsigned int)
+    {
+      save_binary(a.address(),a.count()*sizeof(ValueType));
+    }
+
+    void save_binary(const void *address, std::size_t count);
+};
+
+template<class Archive>
+inline void
+basic_binary_buffer_oprimitive<Archive>::save_binary(
+    const void *address,
+    std::size_t count
+){
+    if(static_cast<std::size_t>(m_end - m_ptr) < count)
+        grow(count);
+    std::memcpy(m_ptr, address, count);
+    m_ptr += count;
+}
+
+} //namespace boost
+} //namespace archive
+
+#include <boost/archive/detail/abi_suffix.hpp> // pop pragmas
+
+#endif // BOOST_ARCHIVE_BASIC_BINARY_BUFFER_OPRIMITIVE_HPP
@@ -0,0 +1,80 @@
+#ifndef BOOST_ARCHIVE_BINARY_BUFFER_IARCHIVE_HPP
+#define BOOST_ARCHIVE_BINARY_BUFFER_IARCHIVE_HPP
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+# pragma once
+#endif
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// binary_buffer_iarchive.hpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org for updates, documentation, and revision history.
+
+#include <vector>
+#include <cstddef> // size_t, NULL
+#include <boost/archive/binary_buffer_iarchive_impl.hpp>
+#include <boost/archive/detail/register_archive.hpp>
+
+#ifdef BOOST_MSVC
+#  pragma warning(push)
+#  pragma warning(disable : 4511 4512)
+#endif
+
+// note special treatment of shared_ptr. This type needs a special
+// structure associated with every archive.  We created a "mix-in"
+// class to provide this functionality.  Since shared_ptr holds a
+// special esteem in the boost library - we included it here by default.
+#include <boost/archive/shared_ptr_helper.hpp>
+
+namespace boost { 
+namespace archive {
+
+// a native binary archive which reads from a block of memory - such as
+// a std::vector<char> filled by binary_buffer_oarchive or a memory mapped
+// file written by binary_oarchive.  The block is not copied and must
+// outlive the archive.
+
+// do not derive from this class.  If you want to extend this functionality
+// via inhertance, derived from binary_buffer_iarchive_impl instead.  This will
+// preserve correct static polymorphism.
+class binary_buffer_iarchive : 
+    public binary_buffer_iarchive_impl<binary_buffer_iarchive>,
+    public detail::shared_ptr_helper
+{
+public:
+    binary_buffer_iarchive(
+        const void * address, 
+        std::size_t count, 
+        unsigned int flags = 0
+    ) :
+        binary_buffer_iarchive_impl<binary_buffer_iarchive>(
+            address, count, flags
+        )
+    {}
+    binary_buffer_iarchive(
+        const std::vector<char> & buffer, 
+        unsigned int flags = 0
+    ) :
+        binary_buffer_iarchive_impl<binary_buffer_iarchive>(
+            buffer.empty() ? NULL : & buffer[0], buffer.size(), flags
+        )
+    {}
+};
+
+} // namespace archive
+} // namespace boost
+
+// required by export
+BOOST_SERIALIZATION_REGISTER_ARCHIVE(boost::archive::binary_buffer_iarchive)
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION(boost::archive::binary_buffer_iarchive)
+
+#ifdef BOOST_MSVC
+#pragma warning(pop)
+#endif
+
+#endif // BOOST_ARCHIVE_BINARY_BUFFER_IARCHIVE_HPP
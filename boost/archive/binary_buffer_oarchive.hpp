@@ -0,0 +1,59 @@
+#ifndef BOOST_ARCHIVE_BINARY_BUFFER_OARCHIVE_HPP
+#define BOOST_ARCHIVE_BINARY_BUFFER_OARCHIVE_HPP
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+# pragma once
+#endif
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// binary_buffer_oarchive.hpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org for updates, documentation, and revision history.
+
+#include <vector>
+#include <boost/config.hpp>
+#include <boost/archive/binary_buffer_oarchive_impl.hpp>
+#include <boost/archive/detail/register_archive.hpp>
+
+#ifdef BOOST_MSVC
+#  pragma warning(push)
+#  pragma warning(disable : 4511 4512)
+#endif
+
+namespace boost { 
+namespace archive {
+
+// a native binary archive which appends to a std::vector<char>.  The
+// archive produced is identical to that of binary_oarchive.  The vector
+// holds extra uninitialized space while the archive is open - use it only
+// after the archive has been destroyed.
+
+// do not derive from this class.  If you want to extend this functionality
+// via inhertance, derived from binary_buffer_oarchive_impl instead.  This will
+// preserve correct static polymorphism.
+class binary_buffer_oarchive : 
+    public binary_buffer_oarchive_impl<binary_buffer_oarchive>
+{
+public:
+    binary_buffer_oarchive(std::vector<char> & buffer, unsigned int flags = 0) :
+        binary_buffer_oarchive_impl<binary_buffer_oarchive>(buffer, flags)
+    {}
+};
+
+} // namespace archive
+} // namespace boost
+
+// required by export
+BOOST_SERIALIZATION_REGISTER_ARCHIVE(boost::archive::binary_buffer_oarchive)
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION(boost::archive::binary_buffer_oarchive)
+
+#ifdef BOOST_MSVC
+#pragma warning(pop)
+#endif
+
+#endif // BOOST_ARCHIVE_BINARY_BUFFER_OARCHIVE_HPP
@@ -89,6 +89,9 @@ public:
     void end_preamble(); // default implementation does nothing
     library_version_type get_library_version() const;
     unsigned int get_flags() const;
+    // a hint of the number of tracked objects to be saved, so that the
+    // table of them needn't grow as they are
+    void reserve_tracked_objects(std::size_t count);
 };
 
 } // namespace detail
@@ -0,0 +1,72 @@
+#ifndef BOOST_ARCHIVE_FLAT_FORMAT_HPP
+#define BOOST_ARCHIVE_FLAT_FORMAT_HPP
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+# pragma once
+#endif
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// flat_format.hpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org for updates, documentation, and revision history.
+
+// layout of the archives written by flat_oarchive and read in place by
+// flat_view.  All numbers are in the native representation of the
+// platform which wrote the archive and offsets are counted from the
+// first byte of the archive.
+//
+//   header  "BSFA", one byte each for the sizes of int, long, float and
+//           double, a 32 bit 1 to check the byte order and the 32 bit
+//           format version.
+//   data    values, strings, arrays, names and objects, each aligned
+//           for its type.  The fields of an object are written before
+//           the object itself.
+//   trailer the 32 bit offset of the root object followed by "BSFA".
+//
+// An object is a 32 bit field count followed by that many flat_entry.
+// The root object has a field for each item saved with operator<< .
+
+#include <cstddef> // std::size_t
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+
+namespace boost {
+namespace archive {
+
+// what a field holds
+enum flat_kind {
+    flat_null = 0,  // a null pointer
+    flat_value,     // a primitive or bitwise serializable value
+    flat_string,    // characters followed by a '\0' which isn't counted
+    flat_array,     // contiguous bitwise serializable elements
+    flat_object     // another object
+};
+
+struct flat_entry {
+    boost::uint32_t m_offset;   // where the field is
+    boost::uint32_t m_name;     // the name given by an nvp, 0 if none
+    boost::uint32_t m_count;    // elements, characters or fields
+    boost::uint16_t m_kind;     // flat_kind
+    boost::uint16_t m_size;     // size of a value or of an element
+};
+
+BOOST_STATIC_ASSERT(sizeof(flat_entry) == 16);
+
+// the first and last four bytes of each archive
+const char flat_signature[4] = { 'B', 'S', 'F', 'A' };
+
+// incremented if the layout changes
+const boost::uint32_t flat_format_version = 1;
+
+const std::size_t flat_header_size = 16;
+const std::size_t flat_trailer_size = 8;
+
+} // namespace archive
+} // namespace boost
+
+#endif // BOOST_ARCHIVE_FLAT_FORMAT_HPP
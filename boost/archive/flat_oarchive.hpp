@@ -0,0 +1,315 @@
+#ifndef BOOST_ARCHIVE_FLAT_OARCHIVE_HPP
+#define BOOST_ARCHIVE_FLAT_OARCHIVE_HPP
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+# pragma once
+#endif
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// flat_oarchive.hpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org for updates, documentation, and revision history.
+
+// write an archive which can be read in place - see flat_view.hpp.  Each
+// object becomes a table of its fields in the order serialize() saves
+// them, named by any nvp wrapper used.  Primitives, bitwise serializable
+// types, strings and vectors or arrays of bitwise serializable types are
+// stored aligned so that a reader can use them where they lie, for
+// example in a memory mapped file.
+//
+// Like simple_log_archive, this archive calls serialize() directly rather
+// than going through the library's class information, tracking and
+// export machinery.  This means:
+//   - nothing is recorded about class versions;
+//   - objects saved through pointers are written once per address, but a
+//     pointer back to an object which is still being written is an error;
+//   - pointers are saved as their static type, and a pointer to a derived
+//     class through a base class is an error.
+
+// IN GENERAL, ARCHIVES CREATED WITH THIS CLASS WILL NOT BE READABLE
+// ON PLATFORM APART FROM THE ONE THEY ARE CREATE ON
+
+#include <cstddef> // std::size_t, NULL
+#include <map>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include <boost/config.hpp>
+#if defined(BOOST_NO_STDC_NAMESPACE)
+namespace std{
+    using ::size_t;
+} // namespace std
+#endif
+
+#include <boost/noncopyable.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/preprocessor/empty.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/is_enum.hpp>
+#include <boost/type_traits/is_polymorphic.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/mpl/eval_if.hpp>
+#include <boost/mpl/identity.hpp>
+#include <boost/mpl/int.hpp>
+#include <boost/mpl/or.hpp>
+#include <boost/mpl/equal_to.hpp>
+
+#include <boost/serialization/throw_exception.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/array.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/level.hpp>
+#include <boost/serialization/version.hpp>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/is_bitwise_serializable.hpp>
+
+#include <boost/archive/basic_archive.hpp>
+#include <boost/archive/archive_exception.hpp>
+#include <boost/archive/flat_format.hpp>
+#include <boost/archive/detail/decl.hpp>
+#include <boost/archive/detail/auto_link_archive.hpp>
+#include <boost/archive/detail/abi_prefix.hpp> // must be the last header
+
+#ifdef BOOST_MSVC
+#  pragma warning(push)
+#  pragma warning(disable : 4251 4511 4512)
+#endif
+
+namespace boost {
+namespace archive {
+
+class BOOST_ARCHIVE_DECL(BOOST_PP_EMPTY()) flat_oarchive :
+    private boost::noncopyable
+{
+    std::ostream & m_os;
+    std::size_t m_position; // bytes written so far
+    const char * m_name;    // name of the next field
+    // the fields of the objects being written, innermost last.  Finished
+    // levels are kept so that their capacity is reused.
+    std::vector<std::vector<flat_entry> > m_objects;
+    std::size_t m_depth;
+    // offsets of the names written so far, by address
+    std::map<const char *, boost::uint32_t> m_names;
+    // the fields of objects saved through pointers, by address.  An entry
+    // of kind flat_null marks an object which is still being written.
+    std::map<const void *, flat_entry> m_pointers;
+
+    void write(const void * address, std::size_t count);
+    void align(std::size_t alignment);
+    boost::uint32_t offset() const;
+    boost::uint32_t save_name(const char * name);
+    void add_field(
+        const char * name,
+        flat_kind kind,
+        boost::uint32_t offset,
+        std::size_t count,
+        std::size_t size
+    );
+    void save_data(
+        flat_kind kind,
+        const void * address,
+        std::size_t count,
+        std::size_t size,
+        std::size_t alignment
+    );
+    const char * take_name(){
+        const char * name = m_name;
+        m_name = NULL;
+        return name;
+    }
+    const char * begin_object();
+    void end_object(const char * name);
+    bool find_pointer(const void * address);
+    void begin_pointer(const void * address);
+    void end_pointer(const void * address);
+    void windup();
+
+    struct save_value_type {
+        template<class T>
+        static void invoke(flat_oarchive & ar, const T & t){
+            ar.save_data(
+                flat_value, & t, 1, sizeof(T), boost::alignment_of< T >::value
+            );
+        }
+    };
+    struct save_object_type {
+        template<class T>
+        static void invoke(flat_oarchive & ar, const T & t){
+            const char * name = ar.begin_object();
+            // make sure call is routed through the highest interface that might
+            // be specialized by the user.
+            boost::serialization::serialize_adl(
+                ar,
+                const_cast<T &>(t),
+                ::boost::serialization::version< T >::value
+            );
+            ar.end_object(name);
+        }
+    };
+    // enums, arithmetic types, types marked bitwise serializable and
+    // other primitives such as collection_size_type are stored as they
+    // are in memory, everything else as an object.
+    template<class T>
+    void save(const T & t){
+        typedef BOOST_DEDUCED_TYPENAME boost::mpl::eval_if<
+            boost::mpl::or_<
+                boost::is_enum< T >,
+                boost::serialization::is_bitwise_serializable< T >,
+                boost::mpl::equal_to<
+                    boost::serialization::implementation_level< T >,
+                    boost::mpl::int_<boost::serialization::primitive_type>
+                >
+            >,
+            boost::mpl::identity<save_value_type>,
+        // else
+            boost::mpl::identity<save_object_type>
+        >::type typex;
+        typex::invoke(*this, t);
+    }
+    void save(const std::string & s){
+        save_data(flat_string, s.data(), s.size(), 1, 1);
+    }
+    #ifndef BOOST_NO_STD_WSTRING
+    void save(const std::wstring & ws){
+        save_data(
+            flat_array,
+            ws.data(),
+            ws.size(),
+            sizeof(wchar_t),
+            boost::alignment_of<wchar_t>::value
+        );
+    }
+    #endif
+    template<class T, class Allocator>
+    void save(const std::vector<T, Allocator> & t){
+        save_sequence(
+            t.empty() ? NULL : & t[0],
+            t.size(),
+            boost::serialization::is_bitwise_serializable< T >()
+        );
+    }
+    template<class Allocator>
+    void save(const std::vector<bool, Allocator> & t){
+        const char * name = begin_object();
+        for(std::size_t i = 0; i < t.size(); ++i){
+            const bool b = t[i];
+            * this << boost::serialization::make_nvp("item", b);
+        }
+        end_object(name);
+    }
+    template<class T>
+    void save(const boost::serialization::array< T > & a){
+        save_sequence(
+            a.address(),
+            a.count(),
+            boost::serialization::is_bitwise_serializable< T >()
+        );
+    }
+    template<class T>
+    void save_sequence(const T * t, std::size_t count, boost::mpl::true_){
+        save_data(
+            flat_array, t, count, sizeof(T), boost::alignment_of< T >::value
+        );
+    }
+    template<class T>
+    void save_sequence(const T * t, std::size_t count, boost::mpl::false_){
+        const char * name = begin_object();
+        for(std::size_t i = 0; i < count; ++i)
+            * this << boost::serialization::make_nvp("item", t[i]);
+        end_object(name);
+    }
+    template<class T>
+    void save_pointer(const T * t){
+        if(NULL == t){
+            add_field(take_name(), flat_null, 0, 0, 0);
+            return;
+        }
+        #ifndef BOOST_NO_TYPEID
+        if(boost::is_polymorphic< T >::value && typeid(* t) != typeid(T))
+            boost::serialization::throw_exception(
+                archive_exception(
+                    archive_exception::unregistered_class,
+                    typeid(* t).name()
+                )
+            );
+        #endif
+        if(find_pointer(t))
+            return;
+        begin_pointer(t);
+        save(* t);
+        end_pointer(t);
+    }
+
+public:
+    ///////////////////////////////////////////////////
+    // Implement requirements for archive concept
+
+    typedef boost::mpl::bool_<false> is_loading;
+    typedef boost::mpl::bool_<true> is_saving;
+
+    // this can be a no-op since pointers are saved as their static type
+    template<class T>
+    void register_type(const T * = NULL){}
+
+    library_version_type get_library_version() const {
+        return BOOST_ARCHIVE_VERSION();
+    }
+
+    // raw bytes are saved as an array of char
+    void save_binary(const void * address, std::size_t count){
+        save_data(flat_array, address, count, 1, 1);
+    }
+
+    // the << operators
+    template<class T>
+    flat_oarchive & operator<<(T const & t){
+        save(t);
+        return * this;
+    }
+    template<class T>
+    flat_oarchive & operator<<(T * const t){
+        save_pointer(t);
+        return * this;
+    }
+    template<class T, int N>
+    flat_oarchive & operator<<(const T (&t)[N]){
+        return * this << boost::serialization::make_array(
+            static_cast<const T *>(&t[0]),
+            N
+        );
+    }
+    template<class T>
+    flat_oarchive & operator<<(const boost::serialization::nvp< T > & t){
+        m_name = t.name();
+        return * this << t.const_value();
+    }
+
+    // the & operator
+    template<class T>
+    flat_oarchive & operator&(const T & t){
+        return * this << t;
+    }
+    ///////////////////////////////////////////////
+
+    flat_oarchive(std::ostream & os);
+    // writes the root object and the trailer
+    ~flat_oarchive();
+};
+
+} // namespace archive
+} // namespace boost
+
+#ifdef BOOST_MSVC
+#pragma warning(pop)
+#endif
+
+#include <boost/archive/detail/abi_suffix.hpp> // pops abi_suffix.hpp pragmas
+
+#endif // BOOST_ARCHIVE_FLAT_OARCHIVE_HPP
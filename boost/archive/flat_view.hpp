@@ -0,0 +1,134 @@
+#ifndef BOOST_ARCHIVE_FLAT_VIEW_HPP
+#define BOOST_ARCHIVE_FLAT_VIEW_HPP
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+# pragma once
+#endif
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// flat_view.hpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org for updates, documentation, and revision history.
+
+// read an archive written by flat_oarchive where it lies - in a buffer or
+// a memory mapped file - without loading it.  Nothing is copied: values
+// and arrays are returned by reference into the archive, which must
+// outlive the view and everything obtained from it.
+//
+//  flat_view v(address, size);
+//  flat_table root = v.root();
+//  flat_table a = root.object(root.find("a"));
+//  double x = a.value<double>(a.find("x"));
+//  boost::iterator_range<const int *> ids = a.array<int>(a.find("ids"));
+//
+// Each access checks the kind and size of the field and that it lies
+// within the archive, and throws archive_exception if not.  The address
+// of the archive must be aligned for the most strictly aligned type it
+// holds, as is memory from operator new or a memory mapping.
+
+#include <cstddef> // std::size_t, NULL
+
+#include <boost/config.hpp>
+#if defined(BOOST_NO_STDC_NAMESPACE)
+namespace std{
+    using ::size_t;
+} // namespace std
+#endif
+
+#include <boost/cstdint.hpp>
+#include <boost/preprocessor/empty.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+
+#include <boost/archive/flat_format.hpp>
+#include <boost/archive/detail/decl.hpp>
+#include <boost/archive/detail/auto_link_archive.hpp>
+#include <boost/archive/detail/abi_prefix.hpp> // must be the last header
+
+namespace boost {
+namespace archive {
+
+// the fields of one object
+class BOOST_ARCHIVE_DECL(BOOST_PP_EMPTY()) flat_table
+{
+    friend class flat_view;
+    const char * m_base;    // the archive
+    std::size_t m_size;
+    const flat_entry * m_fields;
+    std::size_t m_count;
+
+    flat_table(const char * base, std::size_t size, boost::uint32_t offset);
+    // the field i, which must be of the given kind and element size.
+    // Also checks that the data lies within the archive and is aligned.
+    const flat_entry & field(
+        std::size_t i,
+        flat_kind kind,
+        std::size_t size,
+        std::size_t alignment
+    ) const;
+public:
+    flat_table() :
+        m_base(NULL),
+        m_size(0),
+        m_fields(NULL),
+        m_count(0)
+    {}
+    // the number of fields
+    std::size_t size() const {
+        return m_count;
+    }
+    // the name of field i, or NULL if it was saved without an nvp
+    const char * name(std::size_t i) const;
+    flat_kind kind(std::size_t i) const;
+    // the index of the first field of that name, or size() if none
+    std::size_t find(const char * name) const;
+
+    template<class T>
+    const T & value(std::size_t i) const {
+        const flat_entry & e = field(
+            i, flat_value, sizeof(T), boost::alignment_of< T >::value
+        );
+        return * reinterpret_cast<const T *>(m_base + e.m_offset);
+    }
+    template<class T>
+    boost::iterator_range<const T *> array(std::size_t i) const {
+        const flat_entry & e = field(
+            i, flat_array, sizeof(T), boost::alignment_of< T >::value
+        );
+        const T * t = reinterpret_cast<const T *>(m_base + e.m_offset);
+        return boost::iterator_range<const T *>(t, t + e.m_count);
+    }
+    // the characters of a string, which are followed by a '\0' so that
+    // begin() can be used as a C string
+    boost::iterator_range<const char *> string(std::size_t i) const;
+    flat_table object(std::size_t i) const;
+    bool is_null(std::size_t i) const {
+        return flat_null == kind(i);
+    }
+};
+
+class BOOST_ARCHIVE_DECL(BOOST_PP_EMPTY()) flat_view
+{
+    const char * m_base;
+    std::size_t m_size;
+    boost::uint32_t m_root;
+public:
+    // checks the header and trailer
+    flat_view(const void * address, std::size_t size);
+    // the object holding whatever was saved with operator<<
+    flat_table root() const {
+        return flat_table(m_base, m_size, m_root);
+    }
+};
+
+} // namespace archive
+} // namespace boost
+
+#include <boost/archive/detail/abi_suffix.hpp> // pops abi_suffix.hpp pragmas
+
+#endif // BOOST_ARCHIVE_FLAT_VIEW_HPP
@@ -0,0 +1,127 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// basic_binary_buffer_oprimitive.ipp:
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org for updates, documentation, and revision history.
+
+#include <algorithm> // std::max
+#include <cstddef> // NULL
+#include <cstring>
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_STDC_NAMESPACE) && ! defined(__LIBCOMO__)
+namespace std{
+    using ::strlen;
+} // namespace std
+#endif
+
+#ifndef BOOST_NO_CWCHAR
+#include <cwchar>
+#ifdef BOOST_NO_STDC_NAMESPACE
+namespace std{ using ::wcslen; }
+#endif
+#endif
+
+namespace boost {
+namespace archive {
+
+//////////////////////////////////////////////////////////////////////
+// implementation of basic_binary_buffer_oprimitive
+
+template<class Archive>
+BOOST_ARCHIVE_DECL(void)
+basic_binary_buffer_oprimitive<Archive>::init()
+{
+    // same header as basic_binary_oprimitive so that either kind of
+    // binary input archive can read the result.
+    this->This()->save(static_cast<unsigned char>(sizeof(int)));
+    this->This()->save(static_cast<unsigned char>(sizeof(long)));
+    this->This()->save(static_cast<unsigned char>(sizeof(float)));
+    this->This()->save(static_cast<unsigned char>(sizeof(double)));
+    // for checking endianness
+    this->This()->save(int(1));
+}
+
+template<class Archive>
+BOOST_ARCHIVE_DECL(void)
+basic_binary_buffer_oprimitive<Archive>::save(const char * s)
+{
+    std::size_t l = std::strlen(s);
+    this->This()->save(l);
+    save_binary(s, l);
+}
+
+template<class Archive>
+BOOST_ARCHIVE_DECL(void)
+basic_binary_buffer_oprimitive<Archive>::save(const std::string &s)
+{
+    std::size_t l = static_cast<std::size_t>(s.size());
+    this->This()->save(l);
+    save_binary(s.data(), l);
+}
+
+#ifndef BOOST_NO_CWCHAR
+template<class Archive>
+BOOST_ARCHIVE_DECL(void)
+basic_binary_buffer_oprimitive<Archive>::save(const wchar_t * ws)
+{
+    std::size_t l = std::wcslen(ws);
+    this->This()->save(l);
+    save_binary(ws, l * sizeof(wchar_t) / sizeof(char));
+}
+#endif
+
+#ifndef BOOST_NO_STD_WSTRING
+template<class Archive>
+BOOST_ARCHIVE_DECL(void)
+basic_binary_buffer_oprimitive<Archive>::save(const std::wstring &ws)
+{
+    std::size_t l = ws.size();
+    this->This()->save(l);
+    save_binary(ws.data(), l * sizeof(wchar_t) / sizeof(char));
+}
+#endif
+
+template<class Archive>
+BOOST_ARCHIVE_DECL(void)
+basic_binary_buffer_oprimitive<Archive>::grow(std::size_t count)
+{
+    // doubling keeps the number of reallocations logarithmic in the
+    // size of the archive
+    const std::size_t p = position();
+    m_buffer.resize((std::max)(2 * m_buffer.size(), p + count));
+    m_ptr = & m_buffer[0] + p;
+    m_end = & m_buffer[0] + m_buffer.size();
+}
+
+template<class Archive>
+BOOST_ARCHIVE_DECL(BOOST_PP_EMPTY())
+basic_binary_buffer_oprimitive<Archive>::basic_binary_buffer_oprimitive(
+    std::vector<char> & buffer
+) :
+    m_buffer(buffer),
+    m_ptr(NULL),
+    m_end(NULL)
+{
+    // append to whatever the buffer already holds, first using up
+    // any capacity which has been reserved
+    const std::size_t p = m_buffer.size();
+    m_buffer.resize((std::max)(m_buffer.capacity(), p + 256));
+    m_ptr = & m_buffer[0] + p;
+    m_end = & m_buffer[0] + m_buffer.size();
+}
+
+template<class Archive>
+BOOST_ARCHIVE_DECL(BOOST_PP_EMPTY())
+basic_binary_buffer_oprimitive<Archive>::~basic_binary_buffer_oprimitive(){
+    // trim the buffer to the bytes actually written. Shrinking a vector
+    // doesn't reallocate so this can't throw.
+    m_buffer.resize(position());
+}
+
+} // namespace archive
+} // namespace boost
@@ -521,6 +521,107 @@ public:
         destination, flags, BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
   }
 
+  /// Start an asynchronous send of multiple datagrams.
+  /**
+   * This function is used to asynchronously send a batch of datagrams, one
+   * from each buffer in the sequence. The function call always returns
+   * immediately.
+   *
+   * Where the platform supports it, the datagrams are sent using as few system
+   * calls as possible (e.g. using @c sendmmsg on Linux). The operation
+   * completes when all datagrams have been sent or an error occurs.
+   *
+   * @param buffers A sequence of buffers, each of which contains the data for a
+   * single datagram. Although the buffers object may be copied as necessary,
+   * ownership of the underlying memory blocks is retained by the caller, which
+   * must guarantee that they remain valid until the handler is called.
+   *
+   * @param destinations A pointer to an array of remote endpoints, one for each
+   * buffer in the sequence. May be null if the socket is connected. Ownership
+   * of the array is retained by the caller, which must guarantee that it is
+   * valid until the handler is called.
+   *
+   * @param handler The handler to be called when the send operation completes.
+   * Copies will be made of the handler as required. The function signature of
+   * the handler must be:
+   * @code void handler(
+   *   const boost::system::error_code& error, // Result of operation.
+   *   std::size_t datagrams_transferred       // Number of datagrams sent.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. Invocation
+   * of the handler will be performed in a manner equivalent to using
+   * boost::asio::io_service::post().
+   *
+   * @note This operation is not supported when using Windows I/O completion
+   * ports. On that platform the handler is passed the error
+   * boost::asio::error::operation_not_supported.
+   *
+   * @par Example
+   * @code
+   * boost::array<boost::asio::const_buffer, 2> bufs = {{
+   *   boost::asio::buffer(data1, size1),
+   *   boost::asio::buffer(data2, size2) }};
+   * boost::asio::ip::udp::endpoint destinations[2] = { ep1, ep2 };
+   * socket.async_send_batch(bufs, destinations, handler);
+   * @endcode
+   */
+  template <typename ConstBufferSequence, typename WriteHandler>
+  void async_send_batch(const ConstBufferSequence& buffers,
+      const endpoint_type* destinations,
+      BOOST_ASIO_MOVE_ARG(WriteHandler) handler)
+  {
+    // If you get an error on the following line it means that your handler does
+    // not meet the documented type requirements for a WriteHandler.
+    BOOST_ASIO_WRITE_HANDLER_CHECK(WriteHandler, handler) type_check;
+
+    this->get_service().async_send_batch(this->get_implementation(), buffers,
+        destinations, 0, BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
+  }
+
+  /// Start an asynchronous send of multiple datagrams.
+  /**
+   * This function is used to asynchronously send a batch of datagrams, one
+   * from each buffer in the sequence. The function call always returns
+   * immediately.
+   *
+   * @param buffers A sequence of buffers, each of which contains the data for a
+   * single datagram. Although the buffers object may be copied as necessary,
+   * ownership of the underlying memory blocks is retained by the caller, which
+   * must guarantee that they remain valid until the handler is called.
+   *
+   * @param destinations A pointer to an array of remote endpoints, one for each
+   * buffer in the sequence. May be null if the socket is connected. Ownership
+   * of the array is retained by the caller, which must guarantee that it is
+   * valid until the handler is called.
+   *
+   * @param flags Flags specifying how the send call is to be made.
+   *
+   * @param handler The handler to be called when the send operation completes.
+   * Copies will be made of the handler as required. The function signature of
+   * the handler must be:
+   * @code void handler(
+   *   const boost::system::error_code& error, // Result of operation.
+   *   std::size_t datagrams_transferred       // Number of datagrams sent.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. Invocation
+   * of the handler will be performed in a manner equivalent to using
+   * boost::asio::io_service::post().
+   */
+  template <typename ConstBufferSequence, typename WriteHandler>
+  void async_send_batch(const ConstBufferSequence& buffers,
+      const endpoint_type* destinations, socket_base::message_flags flags,
+      BOOST_ASIO_MOVE_ARG(WriteHandler) handler)
+  {
+    // If you get an error on the following line it means that your handler does
+    // not meet the documented type requirements for a WriteHandler.
+    BOOST_ASIO_WRITE_HANDLER_CHECK(WriteHandler, handler) type_check;
+
+    this->get_service().async_send_batch(this->get_implementation(), buffers,
+        destinations, flags, BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
+  }
+
   /// Receive some data on a connected socket.
   /**
    * This function is used to receive data on the datagram socket. The function
@@ -878,6 +979,123 @@ public:
     this->get_service().async_receive_from(this->get_implementation(), buffers,
         sender_endpoint, flags, BOOST_ASIO_MOVE_CAST(ReadHandler)(handler));
   }
+
+  /// Start an asynchronous receive of multiple datagrams.
+  /**
+   * This function is used to asynchronously receive a batch of datagrams, one
+   * into each buffer in the sequence. The function call always returns
+   * immediately.
+   *
+   * When the socket becomes readable, as many datagrams as are available, up
+   * to the number of buffers or socket_base::max_batch_size (whichever is
+   * smaller), are received using as few system calls as possible (e.g. using
+   * @c recvmmsg on Linux). The operation completes once at least one datagram
+   * has been received.
+   *
+   * @param buffers A sequence of buffers, each of which receives a single
+   * datagram. Although the buffers object may be copied as necessary,
+   * ownership of the underlying memory blocks is retained by the caller, which
+   * must guarantee that they remain valid until the handler is called.
+   *
+   * @param sender_endpoints A pointer to an array of endpoint objects, one for
+   * each buffer in the sequence, that receive the endpoints of the remote
+   * senders. May be null if the senders are not required. Ownership of the
+   * array is retained by the caller, which must guarantee that it is valid
+   * until the handler is called.
+   *
+   * @param lengths A pointer to an array, with one element for each buffer in
+   * the sequence, that receives the length of each datagram. Ownership of the
+   * array is retained by the caller, which must guarantee that it is valid
+   * until the handler is called.
+   *
+   * @param handler The handler to be called when the receive operation
+   * completes. Copies will be made of the handler as required. The function
+   * signature of the handler must be:
+   * @code void handler(
+   *   const boost::system::error_code& error, // Result of operation.
+   *   std::size_t datagrams_transferred       // Number of datagrams received.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. Invocation
+   * of the handler will be performed in a manner equivalent to using
+   * boost::asio::io_service::post().
+   *
+   * @note This operation is not supported when using Windows I/O completion
+   * ports. On that platform the handler is passed the error
+   * boost::asio::error::operation_not_supported.
+   *
+   * @par Example
+   * @code
+   * std::vector<boost::asio::mutable_buffer> bufs;
+   * for (std::size_t i = 0; i < 16; ++i)
+   *   bufs.push_back(boost::asio::buffer(data[i], sizeof(data[i])));
+   * socket.async_receive_batch(bufs, sender_endpoints, lengths, handler);
+   * @endcode
+   */
+  template <typename MutableBufferSequence, typename ReadHandler>
+  void async_receive_batch(const MutableBufferSequence& buffers,
+      endpoint_type* sender_endpoints, std::size_t* lengths,
+      BOOST_ASIO_MOVE_ARG(ReadHandler) handler)
+  {
+    // If you get an error on the following line it means that your handler does
+    // not meet the documented type requirements for a ReadHandler.
+    BOOST_ASIO_READ_HANDLER_CHECK(ReadHandler, handler) type_check;
+
+    this->get_service().async_receive_batch(this->get_implementation(),
+        buffers, sender_endpoints, lengths, 0,
+        BOOST_ASIO_MOVE_CAST(ReadHandler)(handler));
+  }
+
+  /// Start an asynchronous receive of multiple datagrams.
+  /**
+   * This function is used to asynchronously receive a batch of datagrams, one
+   * into each buffer in the sequence. The function call always returns
+   * immediately.
+   *
+   * @param buffers A sequence of buffers, each of which receives a single
+   * datagram. Although the buffers object may be copied as necessary,
+   * ownership of the underlying memory blocks is retained by the caller, which
+   * must guarantee that they remain valid until the handler is called.
+   *
+   * @param sender_endpoints A pointer to an array of endpoint objects, one for
+   * each buffer in the sequence, that receive the endpoints of the remote
+   * senders. May be null if the senders are not required. Ownership of the
+   * array is retained by the caller, which must guarantee that it is valid
+   * until the handler is called.
+   *
+   * @param lengths A pointer to an array, with one element for each buffer in
+   * the sequence, that receives the length of each datagram. Ownership of the
+   * array is retained by the caller, which must guarantee that it is valid
+   * until the handler is called.
+   *
+   * @param flags Flags specifying how the receive call is to be made.
+   *
+   * @param handler The handler to be called when the receive operation
+   * completes. Copies will be made of the handler as required. The function
+   * signature of the handler must be:
+   * @code void handler(
+   *   const boost::system::error_code& error, // Result of operation.
+   *   std::size_t datagrams_transferred       // Number of datagrams received.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. Invocation
+   * of the handler will be performed in a manner equivalent to using
+   * boost::asio::io_service::post().
+   */
+  template <typename MutableBufferSequence, typename ReadHandler>
+  void async_receive_batch(const MutableBufferSequence& buffers,
+      endpoint_type* sender_endpoints, std::size_t* lengths,
+      socket_base::message_flags flags,
+      BOOST_ASIO_MOVE_ARG(ReadHandler) handler)
+  {
+    // If you get an error on the following line it means that your handler does
+    // not meet the documented type requirements for a ReadHandler.
+    BOOST_ASIO_READ_HANDLER_CHECK(ReadHandler, handler) type_check;
+
+    this->get_service().async_receive_batch(this->get_implementation(),
+        buffers, sender_endpoints, lengths, flags,
+        BOOST_ASIO_MOVE_CAST(ReadHandler)(handler));
+  }
 };
 
 } // namespace asio
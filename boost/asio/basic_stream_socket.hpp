@@ -17,6 +17,7 @@
 
 #include <boost/asio/detail/config.hpp>
 #include <cstddef>
+#include <boost/cstdint.hpp>
 #include <boost/asio/basic_socket.hpp>
 #include <boost/asio/detail/handler_type_requirements.hpp>
 #include <boost/asio/detail/throw_error.hpp>
@@ -364,6 +365,68 @@ public:
         BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
   }
 
+#if defined(BOOST_ASIO_HAS_SEND_FILE) || defined(GENERATING_DOCUMENTATION)
+  /// Start an asynchronous transfer of a range of a file.
+  /**
+   * This function is used to asynchronously send a range of a file on the
+   * stream socket. The function call always returns immediately. The operation
+   * completes when the whole range has been sent, the end of the file is
+   * reached, or an error occurs.
+   *
+   * Where the platform supports it, the data is transferred from the file to
+   * the socket by the operating system without being copied into user memory
+   * (e.g. using @c sendfile on Linux). Otherwise the data is read from the file
+   * into an intermediate buffer and then sent.
+   *
+   * @param file A native descriptor for the open file. The file is read using
+   * positional reads, so its file offset is not modified. Ownership of the
+   * descriptor is retained by the caller, which must guarantee that it remains
+   * open until the handler is called.
+   *
+   * @param offset The offset in the file of the first byte to be sent.
+   *
+   * @param size The number of bytes to be sent.
+   *
+   * @param handler The handler to be called when the send operation completes.
+   * Copies will be made of the handler as required. The function signature of
+   * the handler must be:
+   * @code void handler(
+   *   const boost::system::error_code& error, // Result of operation.
+   *   std::size_t bytes_transferred           // Number of bytes sent.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. Invocation
+   * of the handler will be performed in a manner equivalent to using
+   * boost::asio::io_service::post().
+   *
+   * @note If the end of the file is reached before the whole range has been
+   * sent, the handler is passed boost::asio::error::eof and the number of bytes
+   * that were sent. Sending on a socket whose peer has closed the connection
+   * fails with boost::asio::error::broken_pipe and does not raise the
+   * @c SIGPIPE signal. An @c offset that cannot be represented as an @c off_t
+   * fails with boost::asio::error::invalid_argument.
+   *
+   * @par Example
+   * @code
+   * int fd = ::open("index.html", O_RDONLY);
+   * struct stat st;
+   * ::fstat(fd, &st);
+   * socket.async_send_file(fd, 0, st.st_size, handler);
+   * @endcode
+   */
+  template <typename WriteHandler>
+  void async_send_file(int file, boost::uint64_t offset, std::size_t size,
+      BOOST_ASIO_MOVE_ARG(WriteHandler) handler)
+  {
+    // If you get an error on the following line it means that your handler does
+    // not meet the documented type requirements for a WriteHandler.
+    BOOST_ASIO_WRITE_HANDLER_CHECK(WriteHandler, handler) type_check;
+
+    this->get_service().async_send_file(this->get_implementation(),
+        file, offset, size, BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
+  }
+#endif // defined(BOOST_ASIO_HAS_SEND_FILE) || defined(GENERATING_DOCUMENTATION)
+
   /// Receive some data on the socket.
   /**
    * This function is used to receive data on the stream socket. The function
@@ -0,0 +1,328 @@
+//
+// coalescing_write_stream.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_COALESCING_WRITE_STREAM_HPP
+#define BOOST_ASIO_COALESCING_WRITE_STREAM_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <cstddef>
+#include <boost/type_traits/remove_reference.hpp>
+#include <boost/utility/addressof.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/detail/bind_handler.hpp>
+#include <boost/asio/detail/coalescing_write_op.hpp>
+#include <boost/asio/detail/handler_alloc_helpers.hpp>
+#include <boost/asio/detail/mutex.hpp>
+#include <boost/asio/detail/noncopyable.hpp>
+#include <boost/asio/detail/op_queue.hpp>
+#include <boost/asio/detail/socket_types.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/io_service.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+
+/// Coalesces the asynchronous write operations of a stream.
+/**
+ * The coalescing_write_stream class template queues asynchronous write
+ * operations and writes the data from as many of them as possible to the next
+ * layer using a single gather-write operation. The data is not copied, and
+ * each write operation's completion handler is invoked once all of its data has
+ * been written.
+ *
+ * A write operation started while the stream is idle is not written until the
+ * io_service next runs a handler, so that all writes started by the current
+ * handler are written together. Writes started while data is being written to
+ * the next layer are queued and written as soon as that write completes. At
+ * most 64 buffers are written by each operation on the next layer, with any
+ * remaining buffers written by subsequent operations.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Unsafe. However, the queue of write operations is
+ * internally synchronised, so async_write_some() may be called concurrently
+ * from completion handlers that are running on different threads.
+ *
+ * @par Concepts:
+ * AsyncReadStream, AsyncWriteStream, Stream, SyncReadStream, SyncWriteStream.
+ */
+template <typename Stream>
+class coalescing_write_stream
+  : private noncopyable
+{
+public:
+  /// The type of the next layer.
+  typedef typename boost::remove_reference<Stream>::type next_layer_type;
+
+  /// The type of the lowest layer.
+  typedef typename next_layer_type::lowest_layer_type lowest_layer_type;
+
+  /// Construct, passing the specified argument to initialise the next layer.
+  template <typename Arg>
+  explicit coalescing_write_stream(Arg& a)
+    : next_layer_(a),
+      io_service_impl_(boost::asio::use_service<detail::io_service_impl>(
+            next_layer_.get_io_service())),
+      write_pending_(false)
+  {
+  }
+
+  /// Get a reference to the next layer.
+  next_layer_type& next_layer()
+  {
+    return next_layer_;
+  }
+
+  /// Get a reference to the lowest layer.
+  lowest_layer_type& lowest_layer()
+  {
+    return next_layer_.lowest_layer();
+  }
+
+  /// Get a const reference to the lowest layer.
+  const lowest_layer_type& lowest_layer() const
+  {
+    return next_layer_.lowest_layer();
+  }
+
+  /// Get the io_service associated with the object.
+  boost::asio::io_service& get_io_service()
+  {
+    return next_layer_.get_io_service();
+  }
+
+  /// Close the stream.
+  /**
+   * Any queued write operations will be completed with the error reported by
+   * the next layer.
+   */
+  void close()
+  {
+    next_layer_.close();
+  }
+
+  /// Close the stream.
+  boost::system::error_code close(boost::system::error_code& ec)
+  {
+    return next_layer_.close(ec);
+  }
+
+  /// Write the given data to the stream. Returns the number of bytes written.
+  /// Throws an exception on failure.
+  /**
+   * The data is written directly to the next layer, and so this function must
+   * not be called while asynchronous write operations are outstanding.
+   */
+  template <typename ConstBufferSequence>
+  std::size_t write_some(const ConstBufferSequence& buffers)
+  {
+    return next_layer_.write_some(buffers);
+  }
+
+  /// Write the given data to the stream. Returns the number of bytes written,
+  /// or 0 if an error occurred.
+  /**
+   * The data is written directly to the next layer, and so this function must
+   * not be called while asynchronous write operations are outstanding.
+   */
+  template <typename ConstBufferSequence>
+  std::size_t write_some(const ConstBufferSequence& buffers,
+      boost::system::error_code& ec)
+  {
+    return next_layer_.write_some(buffers, ec);
+  }
+
+  /// Start an asynchronous write. The data being written must be valid for the
+  /// lifetime of the asynchronous operation.
+  /**
+   * The write is added to the stream's queue. Unless an error occurs, the
+   * handler is not called until all of the data has been written, and the
+   * data is not interleaved with the data from any other write operation.
+   */
+  template <typename ConstBufferSequence, typename WriteHandler>
+  void async_write_some(const ConstBufferSequence& buffers,
+      WriteHandler handler)
+  {
+    std::size_t size = boost::asio::buffer_size(buffers);
+    if (size == 0)
+    {
+      get_io_service().post(detail::bind_handler(
+            handler, boost::system::error_code(), 0));
+      return;
+    }
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef detail::coalescing_write_op<
+      ConstBufferSequence, WriteHandler> op;
+    typename op::ptr p = { boost::addressof(handler),
+      boost_asio_handler_alloc_helpers::allocate(
+        sizeof(op), handler), 0 };
+    p.p = new (p.v) op(buffers, size, handler);
+
+    BOOST_ASIO_HANDLER_CREATION((p.p, "coalescing_write_stream",
+          this, "async_write_some"));
+
+    detail::mutex::scoped_lock lock(mutex_);
+
+    // The first write to be queued while the stream is idle is deferred until
+    // the io_service next runs a handler, so that it may be coalesced with any
+    // other writes made by the current handler.
+    if (!write_pending_)
+    {
+      start_write_handler h = { this };
+      get_io_service().post(h);
+      write_pending_ = true;
+    }
+
+    queue_.push(p.p);
+    p.v = p.p = 0;
+  }
+
+  /// Read some data from the stream. Returns the number of bytes read. Throws
+  /// an exception on failure.
+  template <typename MutableBufferSequence>
+  std::size_t read_some(const MutableBufferSequence& buffers)
+  {
+    return next_layer_.read_some(buffers);
+  }
+
+  /// Read some data from the stream. Returns the number of bytes read or 0 if
+  /// an error occurred.
+  template <typename MutableBufferSequence>
+  std::size_t read_some(const MutableBufferSequence& buffers,
+      boost::system::error_code& ec)
+  {
+    return next_layer_.read_some(buffers, ec);
+  }
+
+  /// Start an asynchronous read. The buffer into which the data will be read
+  /// must be valid for the lifetime of the asynchronous operation.
+  template <typename MutableBufferSequence, typename ReadHandler>
+  void async_read_some(const MutableBufferSequence& buffers,
+      ReadHandler handler)
+  {
+    next_layer_.async_read_some(buffers, handler);
+  }
+
+private:
+  // The maximum number of buffers to be written by a single operation on the
+  // next layer. This matches the limit used by the socket implementations.
+  enum { max_buffers = 64 < detail::max_iov_len ? 64 : detail::max_iov_len };
+
+  struct start_write_handler
+  {
+    coalescing_write_stream* this_;
+
+    void operator()()
+    {
+      detail::mutex::scoped_lock lock(this_->mutex_);
+      this_->start_write();
+    }
+  };
+
+  struct write_handler
+  {
+    coalescing_write_stream* this_;
+
+    void operator()(const boost::system::error_code& ec,
+        std::size_t bytes_transferred)
+    {
+      this_->handle_write(ec, bytes_transferred);
+    }
+  };
+
+  // Start writing the queued data to the next layer. The mutex must be held
+  // and the queue must not be empty.
+  void start_write()
+  {
+    std::size_t count = 0;
+    for (detail::coalescing_write_op_base* op = queue_.front();
+        op && count < max_buffers; op = detail::op_queue_access::next(op))
+    {
+      count += op->gather(buffers_ + count, max_buffers - count);
+    }
+
+    // A write is not pending if starting the operation throws an exception,
+    // so the next call to async_write_some will try again.
+    write_pending_ = false;
+    write_handler h = { this };
+    next_layer_.async_write_some(detail::coalesced_buffers(buffers_, count), h);
+    write_pending_ = true;
+  }
+
+  // Complete the queued operations whose data has now been written, and start
+  // writing any data that remains.
+  void handle_write(const boost::system::error_code& ec,
+      std::size_t bytes_transferred)
+  {
+    detail::op_queue<detail::coalescing_write_op_base> completed_ops;
+
+    {
+      detail::mutex::scoped_lock lock(mutex_);
+
+      while (detail::coalescing_write_op_base* op = queue_.front())
+      {
+        // An error fails every operation that has not been written in full.
+        if (!op->consume(bytes_transferred))
+        {
+          if (!ec)
+            break;
+          op->ec_ = ec;
+        }
+        queue_.pop();
+        completed_ops.push(op);
+      }
+
+      if (queue_.empty())
+        write_pending_ = false;
+      else
+        start_write();
+    }
+
+    // The handlers are invoked without the mutex held, as they may start new
+    // write operations.
+    while (detail::coalescing_write_op_base* op = completed_ops.front())
+    {
+      completed_ops.pop();
+      op->complete(io_service_impl_, op->ec_, 0);
+    }
+  }
+
+  // The next layer.
+  Stream next_layer_;
+
+  // The io_service implementation used to complete the write operations.
+  detail::io_service_impl& io_service_impl_;
+
+  // Mutex to protect access to the queue.
+  detail::mutex mutex_;
+
+  // The queued write operations, in the order in which they were started.
+  detail::op_queue<detail::coalescing_write_op_base> queue_;
+
+  // Whether a write to the next layer has been started or scheduled.
+  bool write_pending_;
+
+  // The buffers for the current write to the next layer.
+  boost::asio::const_buffer buffers_[max_buffers];
+};
+
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_COALESCING_WRITE_STREAM_HPP
@@ -21,6 +21,7 @@
 #include <boost/asio/io_service.hpp>
 
 #if defined(BOOST_ASIO_HAS_IOCP)
+# include <boost/asio/detail/bind_handler.hpp>
 # include <boost/asio/detail/win_iocp_socket_service.hpp>
 #else
 # include <boost/asio/detail/reactive_socket_service.hpp>
@@ -359,6 +360,49 @@ public:
         BOOST_ASIO_MOVE_CAST(ReadHandler)(handler));
   }
 
+  /// Start an asynchronous receive of multiple datagrams.
+  template <typename MutableBufferSequence, typename ReadHandler>
+  void async_receive_batch(implementation_type& impl,
+      const MutableBufferSequence& buffers, endpoint_type* sender_endpoints,
+      std::size_t* lengths, socket_base::message_flags flags,
+      BOOST_ASIO_MOVE_ARG(ReadHandler) handler)
+  {
+#if defined(BOOST_ASIO_HAS_IOCP)
+    (void)impl;
+    (void)buffers;
+    (void)sender_endpoints;
+    (void)lengths;
+    (void)flags;
+    boost::system::error_code ec = boost::asio::error::operation_not_supported;
+    this->get_io_service().post(detail::bind_handler(
+          BOOST_ASIO_MOVE_CAST(ReadHandler)(handler), ec, std::size_t(0)));
+#else
+    service_impl_.async_receive_batch(impl, buffers, sender_endpoints,
+        lengths, flags, BOOST_ASIO_MOVE_CAST(ReadHandler)(handler));
+#endif
+  }
+
+  /// Start an asynchronous send of multiple datagrams.
+  template <typename ConstBufferSequence, typename WriteHandler>
+  void async_send_batch(implementation_type& impl,
+      const ConstBufferSequence& buffers, const endpoint_type* destinations,
+      socket_base::message_flags flags,
+      BOOST_ASIO_MOVE_ARG(WriteHandler) handler)
+  {
+#if defined(BOOST_ASIO_HAS_IOCP)
+    (void)impl;
+    (void)buffers;
+    (void)destinations;
+    (void)flags;
+    boost::system::error_code ec = boost::asio::error::operation_not_supported;
+    this->get_io_service().post(detail::bind_handler(
+          BOOST_ASIO_MOVE_CAST(WriteHandler)(handler), ec, std::size_t(0)));
+#else
+    service_impl_.async_send_batch(impl, buffers, destinations, flags,
+        BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
+#endif
+  }
+
 private:
   // Destroy all user-defined handler objects owned by the service.
   void shutdown_service()
@@ -0,0 +1,138 @@
+//
+// detail/aio_descriptor_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_AIO_DESCRIPTOR_OP_HPP
+#define BOOST_ASIO_DETAIL_AIO_DESCRIPTOR_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+
+#if defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+
+#include <boost/cstdint.hpp>
+#include <boost/asio/detail/descriptor_ops.hpp>
+#include <boost/asio/detail/operation.hpp>
+#include <boost/asio/error.hpp>
+
+#if defined(BOOST_ASIO_HAS_LINUX_AIO)
+# include <linux/aio_abi.h>
+#endif // defined(BOOST_ASIO_HAS_LINUX_AIO)
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+class aio_descriptor_service;
+
+// Base class for file operations started by the aio_descriptor_service. The
+// operation is either submitted to the kernel or performed by a blocking call
+// on one of the service's internal threads. In both cases it is then returned
+// to the io_service for its handler to be invoked.
+class aio_descriptor_op
+  : public operation
+{
+public:
+  // The error code to be passed to the completion handler.
+  boost::system::error_code ec_;
+
+  // The number of bytes transferred, to be passed to the completion handler.
+  std::size_t bytes_transferred_;
+
+protected:
+  aio_descriptor_op(func_type complete_func, io_service_impl& io_service,
+      int descriptor, boost::uint64_t offset, bool is_read)
+    : operation(complete_func),
+      bytes_transferred_(0),
+      io_service_impl_(io_service),
+      descriptor_(descriptor),
+      offset_(offset),
+      is_read_(is_read),
+      bufs_(0),
+      count_(0),
+      all_empty_(true)
+  {
+  }
+
+  // Set the buffers used by the operation. They must remain valid until the
+  // operation is complete.
+  void set_buffers(descriptor_ops::buf* bufs,
+      std::size_t count, bool all_empty)
+  {
+    bufs_ = bufs;
+    count_ = count;
+    all_empty_ = all_empty;
+  }
+
+  // Perform the operation using a blocking system call.
+  void perform()
+  {
+    if (is_read_)
+    {
+      bytes_transferred_ = descriptor_ops::sync_read_at(
+          descriptor_, offset_, bufs_, count_, all_empty_, ec_);
+    }
+    else
+    {
+      bytes_transferred_ = descriptor_ops::sync_write_at(
+          descriptor_, offset_, bufs_, count_, all_empty_, ec_);
+    }
+  }
+
+  // The io_service that will invoke the handler.
+  io_service_impl& io_service_impl_;
+
+private:
+  friend class aio_descriptor_service;
+
+  // Record the result reported by the kernel for a submitted operation.
+  void set_result(boost::int64_t result)
+  {
+    if (result < 0)
+    {
+      ec_ = boost::system::error_code(static_cast<int>(-result),
+          boost::asio::error::get_system_category());
+      bytes_transferred_ = 0;
+    }
+    else
+    {
+      ec_ = boost::system::error_code();
+      bytes_transferred_ = static_cast<std::size_t>(result);
+      if (is_read_ && result == 0 && !all_empty_)
+        ec_ = boost::asio::error::eof;
+    }
+  }
+
+  int descriptor_;
+  boost::uint64_t offset_;
+  bool is_read_;
+  descriptor_ops::buf* bufs_;
+  std::size_t count_;
+  bool all_empty_;
+
+#if defined(BOOST_ASIO_HAS_LINUX_AIO)
+  // The control block used to submit the operation to the kernel.
+  iocb iocb_;
+#endif // defined(BOOST_ASIO_HAS_LINUX_AIO)
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+
+#endif // BOOST_ASIO_DETAIL_AIO_DESCRIPTOR_OP_HPP
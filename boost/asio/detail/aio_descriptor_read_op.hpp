@@ -0,0 +1,110 @@
+//
+// detail/aio_descriptor_read_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_AIO_DESCRIPTOR_READ_OP_HPP
+#define BOOST_ASIO_DETAIL_AIO_DESCRIPTOR_READ_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+
+#if defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+
+#include <boost/utility/addressof.hpp>
+#include <boost/asio/detail/aio_descriptor_op.hpp>
+#include <boost/asio/detail/bind_handler.hpp>
+#include <boost/asio/detail/buffer_sequence_adapter.hpp>
+#include <boost/asio/detail/fenced_block.hpp>
+#include <boost/asio/detail/handler_alloc_helpers.hpp>
+#include <boost/asio/detail/handler_invoke_helpers.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+template <typename MutableBufferSequence, typename Handler>
+class aio_descriptor_read_op : public aio_descriptor_op
+{
+public:
+  BOOST_ASIO_DEFINE_HANDLER_PTR(aio_descriptor_read_op);
+
+  aio_descriptor_read_op(io_service_impl& io_service, int descriptor,
+      boost::uint64_t offset, const MutableBufferSequence& buffers,
+      Handler& handler)
+    : aio_descriptor_op(&aio_descriptor_read_op::do_complete,
+        io_service, descriptor, offset, true),
+      bufs_(buffers),
+      handler_(BOOST_ASIO_MOVE_CAST(Handler)(handler))
+  {
+    set_buffers(bufs_.buffers(), bufs_.count(), bufs_.all_empty());
+  }
+
+  static void do_complete(io_service_impl* owner, operation* base,
+      const boost::system::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    // Take ownership of the operation object.
+    aio_descriptor_read_op* o(static_cast<aio_descriptor_read_op*>(base));
+    ptr p = { boost::addressof(o->handler_), o, o };
+
+    if (owner && owner != &o->io_service_impl_)
+    {
+      // The operation is being run on one of the service's internal threads.
+      // Perform the blocking read and pass the operation back to the main
+      // io_service for completion.
+      o->perform();
+      o->io_service_impl_.post_deferred_completion(o);
+      p.v = p.p = 0;
+    }
+    else
+    {
+      BOOST_ASIO_HANDLER_COMPLETION((o));
+
+      // Make a copy of the handler so that the memory can be deallocated
+      // before the upcall is made. Even if we're not about to make an upcall,
+      // a sub-object of the handler may be the true owner of the memory
+      // associated with the handler. Consequently, a local copy of the handler
+      // is required to ensure that any owning sub-object remains valid until
+      // after we have deallocated the memory here.
+      detail::binder2<Handler, boost::system::error_code, std::size_t>
+        handler(o->handler_, o->ec_, o->bytes_transferred_);
+      p.h = boost::addressof(handler.handler_);
+      p.reset();
+
+      // Make the upcall if required.
+      if (owner)
+      {
+        fenced_block b(fenced_block::half);
+        BOOST_ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_, handler.arg2_));
+        boost_asio_handler_invoke_helpers::invoke(handler, handler.handler_);
+        BOOST_ASIO_HANDLER_INVOCATION_END;
+      }
+    }
+  }
+
+private:
+  buffer_sequence_adapter<boost::asio::mutable_buffer,
+      MutableBufferSequence> bufs_;
+  Handler handler_;
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+
+#endif // BOOST_ASIO_DETAIL_AIO_DESCRIPTOR_READ_OP_HPP
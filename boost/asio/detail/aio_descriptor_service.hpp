@@ -0,0 +1,341 @@
+//
+// detail/aio_descriptor_service.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_AIO_DESCRIPTOR_SERVICE_HPP
+#define BOOST_ASIO_DETAIL_AIO_DESCRIPTOR_SERVICE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+
+#if defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+
+#include <boost/cstdint.hpp>
+#include <boost/utility/addressof.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/detail/aio_descriptor_op.hpp>
+#include <boost/asio/detail/aio_descriptor_read_op.hpp>
+#include <boost/asio/detail/aio_descriptor_write_op.hpp>
+#include <boost/asio/detail/buffer_sequence_adapter.hpp>
+#include <boost/asio/detail/descriptor_ops.hpp>
+#include <boost/asio/detail/handler_alloc_helpers.hpp>
+#include <boost/asio/detail/mutex.hpp>
+#include <boost/asio/detail/noncopyable.hpp>
+#include <boost/asio/detail/scoped_ptr.hpp>
+#include <boost/asio/detail/thread.hpp>
+
+#if defined(BOOST_ASIO_HAS_LINUX_AIO)
+# include <boost/asio/detail/atomic_count.hpp>
+# include <boost/asio/detail/reactor.hpp>
+#endif // defined(BOOST_ASIO_HAS_LINUX_AIO)
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+// Performs reads and writes at explicit offsets on file descriptors. Regular
+// files are always reported as ready by select and epoll, so the operations
+// cannot be driven by the reactor. Instead, descriptors opened with O_DIRECT
+// have their operations submitted to the kernel using native Linux AIO, with
+// completions signalled through an eventfd that is watched by the reactor.
+// All other operations are performed using blocking calls on a small pool of
+// internal threads. Either way, the handler is invoked by the io_service.
+class aio_descriptor_service
+{
+public:
+  // The native type of a descriptor.
+  typedef int native_handle_type;
+
+  // The implementation type of the descriptor.
+  class implementation_type
+    : private boost::asio::detail::noncopyable
+  {
+  public:
+    // Default constructor.
+    implementation_type()
+      : descriptor_(-1),
+        state_(0),
+        kernel_aio_(false)
+    {
+    }
+
+  private:
+    // Only this service will have access to the internal values.
+    friend class aio_descriptor_service;
+
+    // The native descriptor representation.
+    int descriptor_;
+
+    // The current state of the descriptor.
+    descriptor_ops::state_type state_;
+
+    // Whether operations are submitted using native AIO.
+    bool kernel_aio_;
+  };
+
+  // Constructor.
+  BOOST_ASIO_DECL aio_descriptor_service(
+      boost::asio::io_service& io_service);
+
+  // Destructor.
+  BOOST_ASIO_DECL ~aio_descriptor_service();
+
+  // Destroy all user-defined handler objects owned by the service.
+  BOOST_ASIO_DECL void shutdown_service();
+
+  // Perform any fork-related housekeeping.
+  BOOST_ASIO_DECL void fork_service(
+      boost::asio::io_service::fork_event fork_ev);
+
+  // Construct a new descriptor implementation.
+  BOOST_ASIO_DECL void construct(implementation_type& impl);
+
+  // Move-construct a new descriptor implementation.
+  BOOST_ASIO_DECL void move_construct(implementation_type& impl,
+      implementation_type& other_impl);
+
+  // Move-assign from another descriptor implementation.
+  BOOST_ASIO_DECL void move_assign(implementation_type& impl,
+      aio_descriptor_service& other_service,
+      implementation_type& other_impl);
+
+  // Destroy a descriptor implementation.
+  BOOST_ASIO_DECL void destroy(implementation_type& impl);
+
+  // Assign a native descriptor to a descriptor implementation.
+  BOOST_ASIO_DECL boost::system::error_code assign(implementation_type& impl,
+      const native_handle_type& native_descriptor,
+      boost::system::error_code& ec);
+
+  // Determine whether the descriptor is open.
+  bool is_open(const implementation_type& impl) const
+  {
+    return impl.descriptor_ != -1;
+  }
+
+  // Destroy a descriptor implementation.
+  BOOST_ASIO_DECL boost::system::error_code close(implementation_type& impl,
+      boost::system::error_code& ec);
+
+  // Get the native descriptor representation.
+  native_handle_type native_handle(const implementation_type& impl) const
+  {
+    return impl.descriptor_;
+  }
+
+  // Release ownership of the native descriptor representation.
+  BOOST_ASIO_DECL native_handle_type release(implementation_type& impl);
+
+  // Cancel all operations associated with the descriptor. File operations
+  // cannot be cancelled once started.
+  BOOST_ASIO_DECL boost::system::error_code cancel(implementation_type& impl,
+      boost::system::error_code& ec);
+
+  // Perform an IO control command on the descriptor.
+  template <typename IO_Control_Command>
+  boost::system::error_code io_control(implementation_type& impl,
+      IO_Control_Command& command, boost::system::error_code& ec)
+  {
+    descriptor_ops::ioctl(impl.descriptor_, impl.state_,
+        command.name(), static_cast<ioctl_arg_type*>(command.data()), ec);
+    return ec;
+  }
+
+  // Gets the non-blocking mode of the descriptor.
+  bool non_blocking(const implementation_type& impl) const
+  {
+    return (impl.state_ & descriptor_ops::user_set_non_blocking) != 0;
+  }
+
+  // Sets the non-blocking mode of the descriptor.
+  boost::system::error_code non_blocking(implementation_type& impl,
+      bool mode, boost::system::error_code& ec)
+  {
+    descriptor_ops::set_user_non_blocking(
+        impl.descriptor_, impl.state_, mode, ec);
+    return ec;
+  }
+
+  // Gets the non-blocking mode of the native descriptor implementation.
+  bool native_non_blocking(const implementation_type& impl) const
+  {
+    return (impl.state_ & descriptor_ops::internal_non_blocking) != 0;
+  }
+
+  // Sets the non-blocking mode of the native descriptor implementation.
+  boost::system::error_code native_non_blocking(implementation_type& impl,
+      bool mode, boost::system::error_code& ec)
+  {
+    descriptor_ops::set_internal_non_blocking(
+        impl.descriptor_, impl.state_, mode, ec);
+    return ec;
+  }
+
+  // Write some data at the specified offset.
+  template <typename ConstBufferSequence>
+  size_t write_some_at(implementation_type& impl, boost::uint64_t offset,
+      const ConstBufferSequence& buffers, boost::system::error_code& ec)
+  {
+    buffer_sequence_adapter<boost::asio::const_buffer,
+        ConstBufferSequence> bufs(buffers);
+
+    return descriptor_ops::sync_write_at(impl.descriptor_, offset,
+        bufs.buffers(), bufs.count(), bufs.all_empty(), ec);
+  }
+
+  // Start an asynchronous write at the specified offset. The data being sent
+  // must be valid for the lifetime of the asynchronous operation.
+  template <typename ConstBufferSequence, typename Handler>
+  void async_write_some_at(implementation_type& impl, boost::uint64_t offset,
+      const ConstBufferSequence& buffers, Handler handler)
+  {
+    // Allocate and construct an operation to wrap the handler.
+    typedef aio_descriptor_write_op<ConstBufferSequence, Handler> op;
+    typename op::ptr p = { boost::addressof(handler),
+      boost_asio_handler_alloc_helpers::allocate(
+        sizeof(op), handler), 0 };
+    p.p = new (p.v) op(io_service_impl_,
+        impl.descriptor_, offset, buffers, handler);
+
+    BOOST_ASIO_HANDLER_CREATION((p.p, "descriptor", &impl,
+          "async_write_some_at"));
+
+    start_op(impl, p.p);
+    p.v = p.p = 0;
+  }
+
+  // Read some data at the specified offset. Returns the number of bytes
+  // received.
+  template <typename MutableBufferSequence>
+  size_t read_some_at(implementation_type& impl, boost::uint64_t offset,
+      const MutableBufferSequence& buffers, boost::system::error_code& ec)
+  {
+    buffer_sequence_adapter<boost::asio::mutable_buffer,
+        MutableBufferSequence> bufs(buffers);
+
+    return descriptor_ops::sync_read_at(impl.descriptor_, offset,
+        bufs.buffers(), bufs.count(), bufs.all_empty(), ec);
+  }
+
+  // Start an asynchronous read at the specified offset. The buffer for the
+  // data being received must be valid for the lifetime of the asynchronous
+  // operation.
+  template <typename MutableBufferSequence, typename Handler>
+  void async_read_some_at(implementation_type& impl, boost::uint64_t offset,
+      const MutableBufferSequence& buffers, Handler handler)
+  {
+    // Allocate and construct an operation to wrap the handler.
+    typedef aio_descriptor_read_op<MutableBufferSequence, Handler> op;
+    typename op::ptr p = { boost::addressof(handler),
+      boost_asio_handler_alloc_helpers::allocate(
+        sizeof(op), handler), 0 };
+    p.p = new (p.v) op(io_service_impl_,
+        impl.descriptor_, offset, buffers, handler);
+
+    BOOST_ASIO_HANDLER_CREATION((p.p, "descriptor", &impl,
+          "async_read_some_at"));
+
+    start_op(impl, p.p);
+    p.v = p.p = 0;
+  }
+
+private:
+  // Start an asynchronous operation, either by submitting it to the kernel or
+  // by passing it to the internal threads.
+  BOOST_ASIO_DECL void start_op(implementation_type& impl,
+      aio_descriptor_op* op);
+
+  // Start the internal threads if they are not already running.
+  BOOST_ASIO_DECL void start_work_threads();
+
+  // Helper class to run the work io_service in a thread.
+  class work_io_service_runner;
+
+  // The number of internal threads used to perform blocking operations.
+  enum { max_work_threads = 4 };
+
+  // The io_service implementation used to post completions.
+  io_service_impl& io_service_impl_;
+
+  // Mutex to protect access to internal data.
+  boost::asio::detail::mutex mutex_;
+
+  // Private io_service used for performing blocking file operations.
+  boost::asio::detail::scoped_ptr<boost::asio::io_service> work_io_service_;
+
+  // The work io_service implementation used to post operations.
+  io_service_impl& work_io_service_impl_;
+
+  // Work for the private io_service to perform.
+  boost::asio::detail::scoped_ptr<boost::asio::io_service::work> work_;
+
+  // Threads used for running the work io_service's run loop.
+  boost::asio::detail::scoped_ptr<boost::asio::detail::thread>
+    work_threads_[max_work_threads];
+
+#if defined(BOOST_ASIO_HAS_LINUX_AIO)
+  // Create the AIO context and eventfd, if not already done. Returns true if
+  // native AIO may be used.
+  BOOST_ASIO_DECL bool init_kernel_aio();
+
+  // Submit an operation to the kernel. Returns false if the operation could
+  // not be submitted.
+  BOOST_ASIO_DECL bool submit_kernel_aio(aio_descriptor_op* op);
+
+  // Collect the operations that have been completed by the kernel. If block
+  // is true, waits until all submitted operations have completed.
+  BOOST_ASIO_DECL void reap_kernel_aio(
+      op_queue<operation>& ops, bool block);
+
+  // The reactor operation used to wait for the eventfd to become readable.
+  class eventfd_read_op;
+
+  // The maximum number of operations that may be submitted to the kernel at
+  // one time. Further operations are passed to the internal threads.
+  enum { max_kernel_aio_ops = 256 };
+
+  // The reactor used to wait for completions to be signalled.
+  reactor& reactor_;
+
+  // Whether an attempt has been made to create the AIO context.
+  bool kernel_aio_initialised_;
+
+  // The AIO context, or 0 if native AIO is unavailable.
+  aio_context_t aio_context_;
+
+  // The eventfd that is signalled when a submitted operation completes.
+  int aio_event_fd_;
+
+  // Per-descriptor data used by the reactor for the eventfd.
+  reactor::per_descriptor_data aio_reactor_data_;
+
+  // The number of operations submitted to the kernel and not yet collected.
+  atomic_count outstanding_kernel_aio_ops_;
+#endif // defined(BOOST_ASIO_HAS_LINUX_AIO)
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#if defined(BOOST_ASIO_HEADER_ONLY)
+# include <boost/asio/detail/impl/aio_descriptor_service.ipp>
+#endif // defined(BOOST_ASIO_HEADER_ONLY)
+
+#endif // defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+
+#endif // BOOST_ASIO_DETAIL_AIO_DESCRIPTOR_SERVICE_HPP
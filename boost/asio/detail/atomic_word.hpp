@@ -0,0 +1,139 @@
+//
+// detail/atomic_word.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_ATOMIC_WORD_HPP
+#define BOOST_ASIO_DETAIL_ATOMIC_WORD_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <cstddef>
+#include <boost/asio/detail/noncopyable.hpp>
+
+#if !defined(BOOST_HAS_THREADS) || defined(BOOST_ASIO_DISABLE_THREADS)
+// Nothing to include.
+#elif defined(BOOST_ASIO_HAS_STD_ATOMIC)
+# include <atomic>
+#elif defined(__GNUC__) \
+  && ((__GNUC__ == 4 && __GNUC_MINOR__ >= 1) || (__GNUC__ > 4)) \
+  && !defined(__INTEL_COMPILER) && !defined(__ICL) \
+  && !defined(__ICC) && !defined(__ECC) && !defined(__PATHSCALE__)
+# define BOOST_ASIO_HAS_GCC_SYNC_ATOMIC_WORD 1
+#else
+# include <boost/asio/detail/mutex.hpp>
+#endif
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+// A pointer-sized word supporting the atomic operations needed to implement
+// simple lock-free data structures. The read-modify-write operations have both
+// acquire and release semantics. Where the platform provides no suitable
+// primitives the operations are emulated using a mutex.
+class atomic_word
+  : private noncopyable
+{
+public:
+  // Constructor.
+  explicit atomic_word(std::size_t value)
+    : value_(value)
+  {
+  }
+
+  // Get the current value. The result is only a hint and must be confirmed
+  // using compare_exchange().
+  std::size_t load() const
+  {
+#if !defined(BOOST_HAS_THREADS) || defined(BOOST_ASIO_DISABLE_THREADS)
+    return value_;
+#elif defined(BOOST_ASIO_HAS_STD_ATOMIC)
+    return value_.load(std::memory_order_relaxed);
+#elif defined(BOOST_ASIO_HAS_GCC_SYNC_ATOMIC_WORD)
+    return value_;
+#else
+    boost::asio::detail::mutex::scoped_lock lock(mutex_);
+    return value_;
+#endif
+  }
+
+  // Replace the value with desired if it is equal to expected. Returns true on
+  // success. On failure, expected is updated with the current value.
+  bool compare_exchange(std::size_t& expected, std::size_t desired)
+  {
+#if !defined(BOOST_HAS_THREADS) || defined(BOOST_ASIO_DISABLE_THREADS)
+    if (value_ != expected)
+    {
+      expected = value_;
+      return false;
+    }
+    value_ = desired;
+    return true;
+#elif defined(BOOST_ASIO_HAS_STD_ATOMIC)
+    return value_.compare_exchange_weak(expected,
+        desired, std::memory_order_acq_rel, std::memory_order_relaxed);
+#elif defined(BOOST_ASIO_HAS_GCC_SYNC_ATOMIC_WORD)
+    std::size_t previous = __sync_val_compare_and_swap(
+        &value_, expected, desired);
+    if (previous == expected)
+      return true;
+    expected = previous;
+    return false;
+#else
+    boost::asio::detail::mutex::scoped_lock lock(mutex_);
+    if (value_ != expected)
+    {
+      expected = value_;
+      return false;
+    }
+    value_ = desired;
+    return true;
+#endif
+  }
+
+  // Replace the value, returning the previous value.
+  std::size_t exchange(std::size_t desired)
+  {
+#if defined(BOOST_ASIO_HAS_STD_ATOMIC) \
+  && defined(BOOST_HAS_THREADS) && !defined(BOOST_ASIO_DISABLE_THREADS)
+    return value_.exchange(desired, std::memory_order_acq_rel);
+#else
+    // The GCC __sync_lock_test_and_set builtin is only an acquire barrier, so
+    // a compare-and-swap loop is used instead.
+    std::size_t expected = load();
+    while (!compare_exchange(expected, desired)) {}
+    return expected;
+#endif
+  }
+
+private:
+#if !defined(BOOST_HAS_THREADS) || defined(BOOST_ASIO_DISABLE_THREADS)
+  std::size_t value_;
+#elif defined(BOOST_ASIO_HAS_STD_ATOMIC)
+  std::atomic<std::size_t> value_;
+#elif defined(BOOST_ASIO_HAS_GCC_SYNC_ATOMIC_WORD)
+  volatile std::size_t value_;
+#else
+  mutable boost::asio::detail::mutex mutex_;
+  std::size_t value_;
+#endif
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_DETAIL_ATOMIC_WORD_HPP
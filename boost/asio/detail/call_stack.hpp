@@ -102,6 +102,14 @@ public:
     return 0;
   }
 
+  // Obtain the key at the top of the stack for the current thread. Returns 0
+  // if the stack is empty.
+  static Key* top()
+  {
+    context* elem = top_;
+    return elem ? elem->key_ : 0;
+  }
+
 private:
   // The top of the stack of calls for the current thread.
   static tss_ptr<context> top_;
@@ -0,0 +1,207 @@
+//
+// detail/coalescing_write_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_COALESCING_WRITE_OP_HPP
+#define BOOST_ASIO_DETAIL_COALESCING_WRITE_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <cstddef>
+#include <boost/utility/addressof.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/detail/bind_handler.hpp>
+#include <boost/asio/detail/consuming_buffers.hpp>
+#include <boost/asio/detail/fenced_block.hpp>
+#include <boost/asio/detail/handler_alloc_helpers.hpp>
+#include <boost/asio/detail/handler_invoke_helpers.hpp>
+#include <boost/asio/detail/operation.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+// A write queued by a coalescing_write_stream. The stream gathers the unwritten
+// buffers of the operations at the front of its queue into a single write on
+// the next layer, and then consumes the bytes written from each operation in
+// turn.
+class coalescing_write_op_base : public operation
+{
+public:
+  // The error code to be passed to the completion handler.
+  boost::system::error_code ec_;
+
+  // The number of bytes written so far, to be passed to the completion handler.
+  std::size_t bytes_transferred_;
+
+  // Copy the operation's unwritten buffers into the array, returning the
+  // number of entries used. No more than max_count entries are used.
+  std::size_t gather(boost::asio::const_buffer* bufs, std::size_t max_count)
+  {
+    return gather_func_(this, bufs, max_count);
+  }
+
+  // Consume bytes written to the next layer. The number of bytes used by this
+  // operation is subtracted from n. Returns true if the operation has now been
+  // written in its entirety.
+  bool consume(std::size_t& n)
+  {
+    if (n >= bytes_remaining_)
+    {
+      n -= bytes_remaining_;
+      bytes_transferred_ += bytes_remaining_;
+      bytes_remaining_ = 0;
+      return true;
+    }
+
+    consume_func_(this, n);
+    bytes_transferred_ += n;
+    bytes_remaining_ -= n;
+    n = 0;
+    return false;
+  }
+
+protected:
+  typedef std::size_t (*gather_func_type)(coalescing_write_op_base*,
+      boost::asio::const_buffer*, std::size_t);
+  typedef void (*consume_func_type)(coalescing_write_op_base*, std::size_t);
+
+  coalescing_write_op_base(std::size_t size, gather_func_type gather_func,
+      consume_func_type consume_func, func_type complete_func)
+    : operation(complete_func),
+      bytes_transferred_(0),
+      bytes_remaining_(size),
+      gather_func_(gather_func),
+      consume_func_(consume_func)
+  {
+  }
+
+private:
+  std::size_t bytes_remaining_;
+  gather_func_type gather_func_;
+  consume_func_type consume_func_;
+};
+
+template <typename ConstBufferSequence, typename Handler>
+class coalescing_write_op : public coalescing_write_op_base
+{
+public:
+  BOOST_ASIO_DEFINE_HANDLER_PTR(coalescing_write_op);
+
+  coalescing_write_op(const ConstBufferSequence& buffers,
+      std::size_t size, Handler& handler)
+    : coalescing_write_op_base(size, &coalescing_write_op::do_gather,
+        &coalescing_write_op::do_consume, &coalescing_write_op::do_complete),
+      buffers_(buffers),
+      handler_(BOOST_ASIO_MOVE_CAST(Handler)(handler))
+  {
+  }
+
+  static std::size_t do_gather(coalescing_write_op_base* base,
+      boost::asio::const_buffer* bufs, std::size_t max_count)
+  {
+    coalescing_write_op* o(static_cast<coalescing_write_op*>(base));
+
+    std::size_t count = 0;
+    typename consuming_buffers<boost::asio::const_buffer,
+        ConstBufferSequence>::const_iterator iter = o->buffers_.begin();
+    typename consuming_buffers<boost::asio::const_buffer,
+        ConstBufferSequence>::const_iterator end = o->buffers_.end();
+    for (; iter != end && count < max_count; ++iter)
+    {
+      boost::asio::const_buffer buffer(*iter);
+      if (boost::asio::buffer_size(buffer) != 0)
+        bufs[count++] = buffer;
+    }
+    return count;
+  }
+
+  static void do_consume(coalescing_write_op_base* base, std::size_t n)
+  {
+    coalescing_write_op* o(static_cast<coalescing_write_op*>(base));
+    o->buffers_.consume(n);
+  }
+
+  static void do_complete(io_service_impl* owner, operation* base,
+      const boost::system::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    // Take ownership of the handler object.
+    coalescing_write_op* o(static_cast<coalescing_write_op*>(base));
+    ptr p = { boost::addressof(o->handler_), o, o };
+
+    BOOST_ASIO_HANDLER_COMPLETION((o));
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder2<Handler, boost::system::error_code, std::size_t>
+      handler(o->handler_, o->ec_, o->bytes_transferred_);
+    p.h = boost::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      BOOST_ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_, handler.arg2_));
+      boost_asio_handler_invoke_helpers::invoke(handler, handler.handler_);
+      BOOST_ASIO_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  consuming_buffers<boost::asio::const_buffer, ConstBufferSequence> buffers_;
+  Handler handler_;
+};
+
+// A buffer sequence referring to the buffers gathered for a single write.
+class coalesced_buffers
+{
+public:
+  typedef boost::asio::const_buffer value_type;
+  typedef const boost::asio::const_buffer* const_iterator;
+
+  coalesced_buffers(const boost::asio::const_buffer* bufs, std::size_t count)
+    : begin_(bufs),
+      end_(bufs + count)
+  {
+  }
+
+  const_iterator begin() const
+  {
+    return begin_;
+  }
+
+  const_iterator end() const
+  {
+    return end_;
+  }
+
+private:
+  const boost::asio::const_buffer* begin_;
+  const boost::asio::const_buffer* end_;
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_DETAIL_COALESCING_WRITE_OP_HPP
@@ -0,0 +1,129 @@
+//
+// detail/concurrency_hint.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_CONCURRENCY_HINT_HPP
+#define BOOST_ASIO_DETAIL_CONCURRENCY_HINT_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+
+// The concurrency hint ID and mask are used to identify when a "well-known"
+// concurrency hint value has been passed to the io_service.
+#define BOOST_ASIO_CONCURRENCY_HINT_ID 0xA5100000u
+#define BOOST_ASIO_CONCURRENCY_HINT_ID_MASK 0xFFF00000u
+
+// If set, this bit indicates that the io_service should use the work-stealing
+// scheduler, where each thread running the io_service has its own queue of
+// ready handlers.
+#define BOOST_ASIO_CONCURRENCY_HINT_WORK_STEALING 0x8000u
+
+// The low bits of a well-known concurrency hint hold the number of queues to
+// be used by the work-stealing scheduler. A value of zero selects a default
+// based on the number of processors.
+#define BOOST_ASIO_CONCURRENCY_HINT_QUEUE_MASK 0xFFu
+
+// The largest number of work-stealing queues that a concurrency hint can hold.
+#define BOOST_ASIO_CONCURRENCY_HINT_MAX_QUEUES 255u
+
+// The bits of a well-known concurrency hint that hold the number of additional
+// demultiplexer instances (e.g. epoll descriptors) to be used by the reactor.
+// A value of zero means that all descriptors share a single instance.
+#define BOOST_ASIO_CONCURRENCY_HINT_REACTOR_MASK 0x3F00u
+#define BOOST_ASIO_CONCURRENCY_HINT_REACTOR_SHIFT 8
+
+// The largest number of additional reactor instances that a concurrency hint
+// can hold.
+#define BOOST_ASIO_CONCURRENCY_HINT_MAX_REACTORS 63u
+
+// If set, this bit indicates that descriptors are assigned to the reactor's
+// demultiplexer instances by hashing the descriptor, rather than round-robin.
+#define BOOST_ASIO_CONCURRENCY_HINT_HASH_DESCRIPTORS 0x4000u
+
+// If set, this bit indicates that the memory used for handler-associated
+// temporary objects is recycled through a cache belonging to each thread that
+// runs the io_service.
+#define BOOST_ASIO_CONCURRENCY_HINT_RECYCLE_MEMORY 0x10000u
+
+// Test whether a concurrency hint is one of the well-known values.
+#define BOOST_ASIO_CONCURRENCY_HINT_IS_SPECIAL(hint) \
+  ((static_cast<unsigned>(hint) \
+    & BOOST_ASIO_CONCURRENCY_HINT_ID_MASK) \
+      == BOOST_ASIO_CONCURRENCY_HINT_ID)
+
+// Test whether a concurrency hint selects the work-stealing scheduler.
+#define BOOST_ASIO_CONCURRENCY_HINT_IS_WORK_STEALING(hint) \
+  (BOOST_ASIO_CONCURRENCY_HINT_IS_SPECIAL(hint) \
+    && ((static_cast<unsigned>(hint) \
+        & BOOST_ASIO_CONCURRENCY_HINT_WORK_STEALING) != 0))
+
+// Obtain the number of work-stealing queues requested by a concurrency hint.
+#define BOOST_ASIO_CONCURRENCY_HINT_QUEUES(hint) \
+  (static_cast<unsigned>(hint) & BOOST_ASIO_CONCURRENCY_HINT_QUEUE_MASK)
+
+// Obtain the number of reactor demultiplexer instances requested by a
+// concurrency hint.
+#define BOOST_ASIO_CONCURRENCY_HINT_REACTORS(hint) \
+  (BOOST_ASIO_CONCURRENCY_HINT_IS_SPECIAL(hint) \
+    ? ((static_cast<unsigned>(hint) \
+        & BOOST_ASIO_CONCURRENCY_HINT_REACTOR_MASK) \
+      >> BOOST_ASIO_CONCURRENCY_HINT_REACTOR_SHIFT) : 0u)
+
+// Test whether a concurrency hint requests that descriptors be assigned to
+// reactor instances by hash.
+#define BOOST_ASIO_CONCURRENCY_HINT_IS_HASH_DESCRIPTORS(hint) \
+  (BOOST_ASIO_CONCURRENCY_HINT_IS_SPECIAL(hint) \
+    && ((static_cast<unsigned>(hint) \
+        & BOOST_ASIO_CONCURRENCY_HINT_HASH_DESCRIPTORS) != 0))
+
+// Test whether a concurrency hint requests that handler memory be recycled.
+#define BOOST_ASIO_CONCURRENCY_HINT_IS_RECYCLE_MEMORY(hint) \
+  (BOOST_ASIO_CONCURRENCY_HINT_IS_SPECIAL(hint) \
+    && ((static_cast<unsigned>(hint) \
+        & BOOST_ASIO_CONCURRENCY_HINT_RECYCLE_MEMORY) != 0))
+
+// Construct a concurrency hint that selects the work-stealing scheduler with
+// the specified number of queues. The number of queues is normally the number
+// of threads that will call io_service::run(). Values greater than
+// BOOST_ASIO_CONCURRENCY_HINT_MAX_QUEUES are reduced to that maximum.
+#define BOOST_ASIO_CONCURRENCY_HINT_WORK_STEALING_QUEUES(n) \
+  static_cast<std::size_t>(BOOST_ASIO_CONCURRENCY_HINT_ID \
+      | BOOST_ASIO_CONCURRENCY_HINT_WORK_STEALING \
+      | (static_cast<unsigned>(n) < BOOST_ASIO_CONCURRENCY_HINT_MAX_QUEUES \
+        ? static_cast<unsigned>(n) \
+        : BOOST_ASIO_CONCURRENCY_HINT_MAX_QUEUES))
+
+// Construct a concurrency hint that distributes descriptors round-robin over
+// the specified number of reactor instances. Values greater than
+// BOOST_ASIO_CONCURRENCY_HINT_MAX_REACTORS are reduced to that maximum. May be
+// combined with the other well-known hints using bitwise or.
+#define BOOST_ASIO_CONCURRENCY_HINT_MULTI_REACTOR(n) \
+  static_cast<std::size_t>(BOOST_ASIO_CONCURRENCY_HINT_ID \
+      | ((static_cast<unsigned>(n) \
+            < BOOST_ASIO_CONCURRENCY_HINT_MAX_REACTORS \
+          ? static_cast<unsigned>(n) \
+          : BOOST_ASIO_CONCURRENCY_HINT_MAX_REACTORS) \
+        << BOOST_ASIO_CONCURRENCY_HINT_REACTOR_SHIFT))
+
+// Construct a concurrency hint that distributes descriptors by hash over the
+// specified number of reactor instances.
+#define BOOST_ASIO_CONCURRENCY_HINT_HASHED_MULTI_REACTOR(n) \
+  static_cast<std::size_t>(BOOST_ASIO_CONCURRENCY_HINT_MULTI_REACTOR(n) \
+      | BOOST_ASIO_CONCURRENCY_HINT_HASH_DESCRIPTORS)
+
+// A concurrency hint that enables the recycling handler allocator. May be
+// combined with the other well-known hints using bitwise or.
+#define BOOST_ASIO_CONCURRENCY_HINT_RECYCLING_ALLOCATOR \
+  static_cast<std::size_t>(BOOST_ASIO_CONCURRENCY_HINT_ID \
+      | BOOST_ASIO_CONCURRENCY_HINT_RECYCLE_MEMORY)
+
+#endif // BOOST_ASIO_DETAIL_CONCURRENCY_HINT_HPP
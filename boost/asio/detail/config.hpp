@@ -262,7 +262,7 @@
 # endif // defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0400)
 #endif // defined(BOOST_WINDOWS) || defined(__CYGWIN__)
 
-// Linux: epoll, eventfd and timerfd.
+// Linux: epoll, eventfd, timerfd, recvmmsg/sendmmsg, sendfile and native AIO.
 #if defined(__linux__)
 # include <linux/version.h>
 # if !defined(BOOST_ASIO_DISABLE_EPOLL)
@@ -280,6 +280,21 @@
 #   define BOOST_ASIO_HAS_TIMERFD 1
 #  endif // (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 8)
 # endif // defined(BOOST_ASIO_HAS_EPOLL)
+# if !defined(BOOST_ASIO_DISABLE_MMSG)
+#  if defined(_GNU_SOURCE) && LINUX_VERSION_CODE >= KERNEL_VERSION(3,0,0)
+#   if (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 14)
+#    define BOOST_ASIO_HAS_MMSG 1
+#   endif // (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 14)
+#  endif // defined(_GNU_SOURCE) && LINUX_VERSION_CODE >= ...
+# endif // !defined(BOOST_ASIO_DISABLE_MMSG)
+# if !defined(BOOST_ASIO_DISABLE_LINUX_SENDFILE)
+#  define BOOST_ASIO_HAS_LINUX_SENDFILE 1
+# endif // !defined(BOOST_ASIO_DISABLE_LINUX_SENDFILE)
+# if !defined(BOOST_ASIO_DISABLE_LINUX_AIO)
+#  if defined(BOOST_ASIO_HAS_EVENTFD)
+#   define BOOST_ASIO_HAS_LINUX_AIO 1
+#  endif // defined(BOOST_ASIO_HAS_EVENTFD)
+# endif // !defined(BOOST_ASIO_DISABLE_LINUX_AIO)
 #endif // defined(__linux__)
 
 // Mac OS X, FreeBSD, NetBSD, OpenBSD: kqueue.
@@ -350,6 +365,20 @@
 # endif // !defined(BOOST_WINDOWS) && !defined(__CYGWIN__)
 #endif // !defined(BOOST_ASIO_DISABLE_POSIX_STREAM_DESCRIPTOR)
 
+// POSIX: random-access file descriptors.
+#if !defined(BOOST_ASIO_DISABLE_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+# if !defined(BOOST_WINDOWS) && !defined(__CYGWIN__)
+#  define BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR 1
+# endif // !defined(BOOST_WINDOWS) && !defined(__CYGWIN__)
+#endif // !defined(BOOST_ASIO_DISABLE_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+
+// POSIX: transmission of files on stream sockets.
+#if !defined(BOOST_ASIO_DISABLE_SEND_FILE)
+# if !defined(BOOST_WINDOWS) && !defined(__CYGWIN__)
+#  define BOOST_ASIO_HAS_SEND_FILE 1
+# endif // !defined(BOOST_WINDOWS) && !defined(__CYGWIN__)
+#endif // !defined(BOOST_ASIO_DISABLE_SEND_FILE)
+
 // UNIX domain sockets.
 #if !defined(BOOST_ASIO_DISABLE_LOCAL_SOCKETS)
 # if !defined(BOOST_WINDOWS) && !defined(__CYGWIN__)
@@ -371,6 +400,13 @@
 # endif // !defined(UNDER_CE)
 #endif // !defined(BOOST_ASIO_DISABLE_SIGNAL)
 
+// Recording of handler statistics by the io_service.
+#if !defined(BOOST_ASIO_DISABLE_HANDLER_STATISTICS)
+# if !defined(BOOST_ASIO_HAS_IOCP)
+#  define BOOST_ASIO_HAS_HANDLER_STATISTICS 1
+# endif // !defined(BOOST_ASIO_HAS_IOCP)
+#endif // !defined(BOOST_ASIO_DISABLE_HANDLER_STATISTICS)
+
 // Support for the __thread keyword extension.
 #if !defined(BOOST_ASIO_DISABLE_THREAD_KEYWORD_EXTENSION)
 # if defined(__linux__)
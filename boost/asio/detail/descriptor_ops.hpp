@@ -20,6 +20,7 @@
 #if !defined(BOOST_WINDOWS) && !defined(__CYGWIN__)
 
 #include <cstddef>
+#include <boost/cstdint.hpp>
 #include <boost/system/error_code.hpp>
 #include <boost/asio/detail/socket_types.hpp>
 
@@ -85,6 +86,24 @@ BOOST_ASIO_DECL bool non_blocking_write(int d,
     const buf* bufs, std::size_t count,
     boost::system::error_code& ec, std::size_t& bytes_transferred);
 
+// Read from a file at the specified offset, blocking until the data is
+// available. Returns 0 and sets ec to eof at the end of the file.
+BOOST_ASIO_DECL std::size_t sync_read_at(int d, boost::uint64_t offset,
+    buf* bufs, std::size_t count, bool all_empty,
+    boost::system::error_code& ec);
+
+// Write to a file at the specified offset, blocking until the data has been
+// accepted.
+BOOST_ASIO_DECL std::size_t sync_write_at(int d, boost::uint64_t offset,
+    const buf* bufs, std::size_t count, bool all_empty,
+    boost::system::error_code& ec);
+
+// Transfer up to size bytes from the file, starting at offset, to the socket
+// or pipe d. A bytes_transferred value of 0 indicates the end of the file.
+BOOST_ASIO_DECL bool non_blocking_send_file(int d, int file,
+    boost::uint64_t offset, std::size_t size,
+    boost::system::error_code& ec, std::size_t& bytes_transferred);
+
 BOOST_ASIO_DECL int ioctl(int d, state_type& state, long cmd,
     ioctl_arg_type* arg, boost::system::error_code& ec);
 
@@ -19,12 +19,14 @@
 
 #if defined(BOOST_ASIO_HAS_EPOLL)
 
+#include <sys/epoll.h>
 #include <boost/cstdint.hpp>
 #include <boost/limits.hpp>
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/detail/atomic_count.hpp>
 #include <boost/asio/detail/epoll_reactor_fwd.hpp>
 #include <boost/asio/detail/mutex.hpp>
+#include <boost/asio/detail/noncopyable.hpp>
 #include <boost/asio/detail/object_pool.hpp>
 #include <boost/asio/detail/op_queue.hpp>
 #include <boost/asio/detail/reactor_op.hpp>
@@ -35,6 +37,16 @@
 #include <boost/asio/detail/timer_queue_set.hpp>
 #include <boost/asio/detail/wait_op.hpp>
 
+// The smallest and largest number of events that may be requested from a
+// single call to epoll_wait. The number requested adapts between these limits
+// according to the number of events returned by previous calls.
+#if !defined(BOOST_ASIO_EPOLL_MIN_EVENTS)
+# define BOOST_ASIO_EPOLL_MIN_EVENTS 16
+#endif // !defined(BOOST_ASIO_EPOLL_MIN_EVENTS)
+#if !defined(BOOST_ASIO_EPOLL_MAX_EVENTS)
+# define BOOST_ASIO_EPOLL_MAX_EVENTS 1024
+#endif // !defined(BOOST_ASIO_EPOLL_MAX_EVENTS)
+
 #include <boost/asio/detail/push_options.hpp>
 
 namespace boost {
@@ -48,6 +60,74 @@ public:
   enum op_types { read_op = 0, write_op = 1,
     connect_op = 1, except_op = 2, max_ops = 3 };
 
+  // Storage for the events returned by epoll_wait. The number of events
+  // requested is doubled when a call fills the batch, and halved when calls
+  // return only a small fraction of it.
+  class event_batch
+    : private boost::asio::detail::noncopyable
+  {
+  public:
+    event_batch()
+      : events_(new epoll_event[max_size]),
+        size_(initial_size < min_size ? min_size
+            : (initial_size > max_size ? max_size : initial_size))
+    {
+    }
+
+    ~event_batch()
+    {
+      delete[] events_;
+    }
+
+    epoll_event* data()
+    {
+      return events_;
+    }
+
+    int size() const
+    {
+      return size_;
+    }
+
+    void update(int num_events)
+    {
+      if (num_events >= size_ && size_ < max_size)
+        size_ = (size_ * 2 > max_size) ? max_size : size_ * 2;
+      else if (num_events < size_ / 4 && size_ > min_size)
+        size_ = (size_ / 2 < min_size) ? min_size : size_ / 2;
+    }
+
+  private:
+    enum
+    {
+      min_size = BOOST_ASIO_EPOLL_MIN_EVENTS,
+      max_size = BOOST_ASIO_EPOLL_MAX_EVENTS,
+      initial_size = 128
+    };
+
+    epoll_event* events_;
+    int size_;
+  };
+
+  // An additional epoll descriptor over which registered descriptors may be
+  // distributed. The instance is itself registered with the main epoll
+  // descriptor, and its ready events are gathered by whichever thread runs
+  // the corresponding operation.
+  class epoll_instance : operation
+  {
+    friend class epoll_reactor;
+
+    epoll_reactor* reactor_;
+    int epoll_fd_;
+    event_batch events_;
+
+    BOOST_ASIO_DECL epoll_instance();
+    BOOST_ASIO_DECL ~epoll_instance();
+    BOOST_ASIO_DECL static void do_complete(
+        io_service_impl* owner, operation* base,
+        const boost::system::error_code& ec, std::size_t bytes_transferred);
+  };
+
   // Per-descriptor queues.
   class descriptor_state : operation
   {
@@ -59,13 +139,16 @@ public:
 
     mutex mutex_;
     epoll_reactor* reactor_;
+    epoll_instance* instance_;
     int descriptor_;
     boost::uint32_t registered_events_;
     op_queue<reactor_op> op_queue_[max_ops];
     bool shutdown_;
+    bool pending_;
 
     BOOST_ASIO_DECL descriptor_state();
     void set_ready_events(uint32_t events) { task_result_ = events; }
+    void add_ready_events(uint32_t events) { task_result_ |= events; }
     BOOST_ASIO_DECL operation* perform_io(uint32_t events);
     BOOST_ASIO_DECL static void do_complete(
         io_service_impl* owner, operation* base,
@@ -185,6 +268,29 @@ private:
   // Helper function to remove a timer queue.
   BOOST_ASIO_DECL void do_remove_timer_queue(timer_queue_base& queue);
 
+  // Create the additional epoll instances and register them with the main
+  // epoll descriptor.
+  BOOST_ASIO_DECL void create_instances();
+
+  // Choose the epoll instance to which a new descriptor will be added.
+  BOOST_ASIO_DECL epoll_instance* choose_instance(socket_type descriptor);
+
+  // Get the epoll descriptor with which a descriptor is registered.
+  int epoll_fd_for(descriptor_state* descriptor_data) const
+  {
+    return descriptor_data->instance_
+      ? descriptor_data->instance_->epoll_fd_ : epoll_fd_;
+  }
+
+  // Gather the ready events from an additional epoll instance, and post the
+  // corresponding descriptor operations to the io_service.
+  BOOST_ASIO_DECL void gather_instance_events(epoll_instance* instance);
+
+  // Add a descriptor reported as ready by epoll to the queue of operations to
+  // be returned to the io_service.
+  BOOST_ASIO_DECL void queue_ready_descriptor(descriptor_state* descriptor_data,
+      uint32_t events, op_queue<operation>& ops);
+
   // Called to recalculate and update the timeout.
   BOOST_ASIO_DECL void update_timeout();
 
@@ -202,6 +308,16 @@ private:
   // The io_service implementation used to post completions.
   io_service_impl& io_service_;
 
+  // The number of additional epoll instances.
+  const std::size_t num_instances_;
+
+  // Whether descriptors are assigned to instances by hash.
+  const bool hash_descriptors_;
+
+  // Whether a descriptor may still be queued from a previous run when epoll
+  // reports it as ready again.
+  const bool check_pending_;
+
   // Mutex to protect access to internal data.
   mutex mutex_;
 
@@ -211,6 +327,16 @@ private:
   // The epoll file descriptor.
   int epoll_fd_;
 
+  // The events returned by the main epoll descriptor.
+  event_batch events_;
+
+  // The additional epoll instances, or 0 if all descriptors are registered
+  // with the main epoll descriptor.
+  epoll_instance* instances_;
+
+  // Used to assign descriptors to instances round-robin.
+  atomic_count next_instance_;
+
   // The timer file descriptor.
   int timer_fd_;
 
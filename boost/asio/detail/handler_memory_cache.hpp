@@ -0,0 +1,177 @@
+//
+// detail/handler_memory_cache.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_HANDLER_MEMORY_CACHE_HPP
+#define BOOST_ASIO_DETAIL_HANDLER_MEMORY_CACHE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <cstddef>
+#include <boost/asio/detail/call_stack.hpp>
+#include <boost/asio/detail/noncopyable.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+// A per-thread cache of the memory blocks used for handler-associated
+// temporary objects, such as the operation objects of asynchronous operations.
+// Blocks are grouped into size classes, and a freed block is kept in its size
+// class's free list so that it can be reused by the next allocation of a
+// similar size on the same thread.
+//
+// All blocks are allocated with their size rounded up to that of their class,
+// whether or not a cache is in use. This allows a block to be allocated on one
+// thread and freed to the cache of another.
+class handler_memory_cache
+  : private noncopyable
+{
+public:
+  enum
+  {
+    // The granularity of the size classes.
+    chunk_size = 16,
+
+    // The number of size classes. Larger blocks are not cached.
+    num_classes = 64,
+
+    // The maximum number of free blocks kept in each size class.
+    max_cached_blocks = 16
+  };
+
+  typedef call_stack<handler_memory_cache> thread_call_stack;
+
+  // Constructor. A cache that is not enabled does not hold any blocks.
+  explicit handler_memory_cache(bool enabled)
+    : enabled_(enabled)
+  {
+    if (enabled_)
+    {
+      for (std::size_t i = 0; i < num_classes; ++i)
+      {
+        free_lists_[i] = 0;
+        free_counts_[i] = 0;
+      }
+    }
+  }
+
+  // Destructor frees all cached blocks.
+  ~handler_memory_cache()
+  {
+    if (enabled_)
+    {
+      for (std::size_t i = 0; i < num_classes; ++i)
+      {
+        while (block* b = free_lists_[i])
+        {
+          free_lists_[i] = b->next_;
+          ::operator delete(b);
+        }
+      }
+    }
+  }
+
+  // Allocate a block using the current thread's cache, if any.
+  static void* allocate(std::size_t size)
+  {
+    std::size_t index = size_class(size);
+    if (index < num_classes)
+    {
+      if (handler_memory_cache* cache = thread_call_stack::top())
+      {
+        if (block* b = cache->free_lists_[index])
+        {
+          cache->free_lists_[index] = b->next_;
+          --cache->free_counts_[index];
+          return b;
+        }
+      }
+      return ::operator new((index + 1) * chunk_size);
+    }
+    return ::operator new(size);
+  }
+
+  // Free a block to the current thread's cache, if any.
+  static void deallocate(void* pointer, std::size_t size)
+  {
+    std::size_t index = size_class(size);
+    if (index < num_classes)
+    {
+      if (handler_memory_cache* cache = thread_call_stack::top())
+      {
+        if (cache->free_counts_[index] < max_cached_blocks)
+        {
+          block* b = static_cast<block*>(pointer);
+          b->next_ = cache->free_lists_[index];
+          cache->free_lists_[index] = b;
+          ++cache->free_counts_[index];
+          return;
+        }
+      }
+    }
+    ::operator delete(pointer);
+  }
+
+  // Makes a cache available to the current thread for the lifetime of the
+  // object.
+  class thread_scope;
+
+private:
+  // Free blocks are linked through their first word.
+  struct block
+  {
+    block* next_;
+  };
+
+  // Get the size class for a block of the specified size.
+  static std::size_t size_class(std::size_t size)
+  {
+    return size == 0 ? 0 : (size - 1) / chunk_size;
+  }
+
+  // Whether the cache is in use.
+  bool enabled_;
+
+  // The free blocks in each size class.
+  block* free_lists_[num_classes];
+
+  // The number of free blocks in each size class.
+  std::size_t free_counts_[num_classes];
+};
+
+// If the cache is not enabled, blocks allocated and freed by the thread bypass
+// any cache belonging to an enclosing scope.
+class handler_memory_cache::thread_scope
+  : private noncopyable
+{
+public:
+  explicit thread_scope(bool enabled)
+    : cache_(enabled),
+      context_(enabled ? &cache_ : 0)
+  {
+  }
+
+private:
+  handler_memory_cache cache_;
+  thread_call_stack::context context_;
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_DETAIL_HANDLER_MEMORY_CACHE_HPP
@@ -0,0 +1,264 @@
+//
+// detail/handler_stats.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_HANDLER_STATS_HPP
+#define BOOST_ASIO_DETAIL_HANDLER_STATS_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/asio/io_service_statistics.hpp>
+#include <boost/asio/detail/atomic_word.hpp>
+#include <boost/asio/detail/mutex.hpp>
+#include <boost/asio/detail/noncopyable.hpp>
+#include <boost/asio/detail/op_queue.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+// Records the number of handlers invoked by an io_service for each type of
+// operation, together with histograms of the time each operation spent queued
+// and the time taken to execute its handler. Each thread running the
+// io_service records into its own block of counters, so no locking is needed
+// once the thread has obtained a block. The counters are atomic and are
+// written only by the owning thread, so snapshots may be taken while the
+// io_service is running, although they may be slightly out of date.
+// Operations without a name are internal to the implementation and are not
+// recorded.
+//
+// The data members are present in every configuration, so that translation
+// units compiled with and without support agree on the layout of operations.
+// Recording is controlled at runtime, at the cost of one relaxed load per
+// handler while it is disabled. When handler statistics are not supported
+// all operations are no-ops.
+class handler_stats
+  : private noncopyable
+{
+public:
+  class invocation;
+
+  // Base class for operations whose handlers may be recorded.
+  class tracked_operation
+  {
+  private:
+    // Only the handler_stats class will have access to the data.
+    friend class handler_stats;
+    friend class invocation;
+    const char* object_type_;
+    const char* op_name_;
+    boost::uint64_t queued_time_;
+
+  protected:
+    // Constructor initialises with no name.
+    tracked_operation()
+      : object_type_(0),
+        op_name_(0),
+        queued_time_(0)
+    {
+    }
+
+    // Prevent deletion through this type.
+    ~tracked_operation()
+    {
+    }
+  };
+
+  // The counters owned by a single thread.
+  struct thread_stats;
+
+  // Constructor. Recording is initially disabled.
+  BOOST_ASIO_DECL handler_stats();
+
+  // Destructor.
+  BOOST_ASIO_DECL ~handler_stats();
+
+  // Record the name of a newly created operation.
+  static void creation(tracked_operation* op,
+      const char* object_type, void* object, const char* op_name)
+  {
+    (void)object;
+    op->object_type_ = object_type;
+    op->op_name_ = op_name;
+  }
+
+  // Enable or disable recording.
+  BOOST_ASIO_DECL void enable(bool enabled);
+
+  // Determine whether recording is enabled.
+  bool enabled() const
+  {
+#if defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+    return enabled_.load() != 0;
+#else // defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+    return false;
+#endif // defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+  }
+
+  // Record the time at which an operation was queued for invocation.
+  void queued(tracked_operation* op)
+  {
+#if defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+    if (enabled() && op->op_name_)
+      op->queued_time_ = now();
+#else // defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+    (void)op;
+#endif // defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+  }
+
+  // Record the time at which a queue of operations became ready. Operations
+  // that were already queued keep their original time.
+  template <typename Operation>
+  void queued(op_queue<Operation>& ops)
+  {
+#if defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+    if (enabled() && !ops.empty())
+    {
+      boost::uint64_t t = now();
+      Operation* op = op_queue_access::front(ops);
+      for (; op; op = op_queue_access::next(op))
+        if (op->op_name_ && op->queued_time_ == 0)
+          op->queued_time_ = t;
+    }
+#else // defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+    (void)ops;
+#endif // defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+  }
+
+  // Obtain a snapshot of the statistics recorded so far.
+  BOOST_ASIO_DECL io_service_statistics snapshot() const;
+
+  // Returns the block of counters used by a thread when it stops running the
+  // io_service, so that the block may be reused by another thread.
+  class thread_scope
+    : private noncopyable
+  {
+  public:
+    thread_scope(handler_stats& stats, thread_stats*& block)
+      : stats_(stats),
+        block_(block)
+    {
+    }
+
+    ~thread_scope()
+    {
+#if defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+      if (block_)
+        stats_.release(block_);
+#endif // defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+    }
+
+  private:
+    handler_stats& stats_;
+    thread_stats*& block_;
+  };
+
+  // Records the invocation of an operation's handler. The execution time is
+  // measured until the object is destroyed.
+  class invocation
+    : private noncopyable
+  {
+  public:
+    invocation(handler_stats& stats,
+        thread_stats*& block, tracked_operation* op)
+#if defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+      : block_(0)
+    {
+      if (stats.enabled() && op->op_name_)
+      {
+        if (block == 0)
+          block = stats.acquire();
+        block_ = block;
+        object_type_ = op->object_type_;
+        op_name_ = op->op_name_;
+        queued_time_ = op->queued_time_;
+        op->queued_time_ = 0;
+        start_time_ = now();
+      }
+    }
+#else // defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+    {
+      (void)stats;
+      (void)block;
+      (void)op;
+    }
+#endif // defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+
+    ~invocation()
+    {
+#if defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+      if (block_)
+      {
+        handler_stats::record(block_, object_type_, op_name_,
+            queued_time_ ? start_time_ - queued_time_ : 0,
+            queued_time_ != 0, now() - start_time_);
+      }
+#endif // defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+    }
+
+  private:
+    thread_stats* block_;
+    const char* object_type_;
+    const char* op_name_;
+    boost::uint64_t queued_time_;
+    boost::uint64_t start_time_;
+  };
+
+private:
+#if defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+  friend class thread_scope;
+  friend class invocation;
+
+  // Get the current time in nanoseconds from an arbitrary epoch. Never
+  // returns 0.
+  BOOST_ASIO_DECL static boost::uint64_t now();
+
+  // Obtain a block of counters for the calling thread.
+  BOOST_ASIO_DECL thread_stats* acquire();
+
+  // Return a block of counters for reuse.
+  BOOST_ASIO_DECL void release(thread_stats* block);
+
+  // Add an invocation to a thread's counters.
+  BOOST_ASIO_DECL static void record(thread_stats* block,
+      const char* object_type, const char* op_name,
+      boost::uint64_t queue_wait, bool has_queue_wait,
+      boost::uint64_t execution);
+#endif // defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+
+  // Whether recording is enabled.
+  atomic_word enabled_;
+
+  // Mutex to protect access to the lists of blocks.
+  mutable mutex mutex_;
+
+  // All blocks that have been created.
+  thread_stats* first_block_;
+
+  // The blocks that are not currently owned by a thread.
+  thread_stats* first_free_block_;
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#if defined(BOOST_ASIO_HEADER_ONLY)
+# include <boost/asio/detail/impl/handler_stats.ipp>
+#endif // defined(BOOST_ASIO_HEADER_ONLY)
+
+#endif // BOOST_ASIO_DETAIL_HANDLER_STATS_HPP
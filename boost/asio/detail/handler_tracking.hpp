@@ -16,6 +16,7 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include <boost/asio/detail/config.hpp>
+#include <boost/asio/detail/handler_stats.hpp>
 
 #if defined(BOOST_ASIO_ENABLE_HANDLER_TRACKING)
 # include <boost/cstdint.hpp>
@@ -30,6 +31,9 @@ namespace boost {
 namespace asio {
 namespace detail {
 
+#define BOOST_ASIO_HANDLER_STATS_CREATION(args) \
+  boost::asio::detail::handler_stats::creation args
+
 #if defined(BOOST_ASIO_ENABLE_HANDLER_TRACKING)
 
 class handler_tracking
@@ -121,7 +125,8 @@ private:
   boost::asio::detail::handler_tracking::init()
 
 # define BOOST_ASIO_HANDLER_CREATION(args) \
-  boost::asio::detail::handler_tracking::creation args
+  (boost::asio::detail::handler_tracking::creation args, \
+   BOOST_ASIO_HANDLER_STATS_CREATION(args))
 
 # define BOOST_ASIO_HANDLER_COMPLETION(args) \
   boost::asio::detail::handler_tracking::completion tracked_completion args
@@ -140,7 +145,8 @@ private:
 # define BOOST_ASIO_INHERIT_TRACKED_HANDLER
 # define BOOST_ASIO_ALSO_INHERIT_TRACKED_HANDLER
 # define BOOST_ASIO_HANDLER_TRACKING_INIT (void)0
-# define BOOST_ASIO_HANDLER_CREATION(args) (void)0
+# define BOOST_ASIO_HANDLER_CREATION(args) \
+  BOOST_ASIO_HANDLER_STATS_CREATION(args)
 # define BOOST_ASIO_HANDLER_COMPLETION(args) (void)0
 # define BOOST_ASIO_HANDLER_INVOCATION_BEGIN(args) (void)0
 # define BOOST_ASIO_HANDLER_INVOCATION_END (void)0
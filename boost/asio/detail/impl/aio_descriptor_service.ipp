@@ -0,0 +1,472 @@
+//
+// detail/impl/aio_descriptor_service.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_IMPL_AIO_DESCRIPTOR_SERVICE_IPP
+#define BOOST_ASIO_DETAIL_IMPL_AIO_DESCRIPTOR_SERVICE_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+
+#if defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+
+#include <cstring>
+#include <boost/asio/error.hpp>
+#include <boost/asio/detail/aio_descriptor_service.hpp>
+
+#if defined(BOOST_ASIO_HAS_LINUX_AIO)
+# include <cerrno>
+# include <fcntl.h>
+# include <time.h>
+# include <unistd.h>
+# include <sys/syscall.h>
+# if __GLIBC__ == 2 && __GLIBC_MINOR__ < 8
+#  include <asm/unistd.h>
+# else // __GLIBC__ == 2 && __GLIBC_MINOR__ < 8
+#  include <sys/eventfd.h>
+# endif // __GLIBC__ == 2 && __GLIBC_MINOR__ < 8
+# include <boost/asio/detail/reactor_op.hpp>
+#endif // defined(BOOST_ASIO_HAS_LINUX_AIO)
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+class aio_descriptor_service::work_io_service_runner
+{
+public:
+  work_io_service_runner(boost::asio::io_service& io_service)
+    : io_service_(io_service) {}
+  void operator()() { io_service_.run(); }
+private:
+  boost::asio::io_service& io_service_;
+};
+
+#if defined(BOOST_ASIO_HAS_LINUX_AIO)
+class aio_descriptor_service::eventfd_read_op : public reactor_op
+{
+public:
+  eventfd_read_op(aio_descriptor_service* service)
+    : reactor_op(&eventfd_read_op::do_perform, eventfd_read_op::do_complete),
+      service_(service)
+  {
+  }
+
+  static bool do_perform(reactor_op* base)
+  {
+    eventfd_read_op* o(static_cast<eventfd_read_op*>(base));
+    aio_descriptor_service* service = o->service_;
+
+    // Reset the eventfd before collecting the completions, so that an
+    // operation completing after this point signals it again.
+    boost::uint64_t counter(0);
+    while (::read(service->aio_event_fd_, &counter,
+          sizeof(counter)) == sizeof(counter))
+      ;
+
+    op_queue<operation> ops;
+    service->reap_kernel_aio(ops, false);
+    service->io_service_impl_.post_deferred_completions(ops);
+
+    return false;
+  }
+
+  static void do_complete(io_service_impl* /*owner*/, operation* base,
+      const boost::system::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    eventfd_read_op* o(static_cast<eventfd_read_op*>(base));
+    delete o;
+  }
+
+private:
+  aio_descriptor_service* service_;
+};
+#endif // defined(BOOST_ASIO_HAS_LINUX_AIO)
+
+aio_descriptor_service::aio_descriptor_service(
+    boost::asio::io_service& io_service)
+  : io_service_impl_(boost::asio::use_service<io_service_impl>(io_service)),
+    mutex_(),
+    work_io_service_(new boost::asio::io_service),
+    work_io_service_impl_(boost::asio::use_service<
+        io_service_impl>(*work_io_service_)),
+    work_(new boost::asio::io_service::work(*work_io_service_))
+#if defined(BOOST_ASIO_HAS_LINUX_AIO)
+    , reactor_(boost::asio::use_service<reactor>(io_service)),
+    kernel_aio_initialised_(false),
+    aio_context_(0),
+    aio_event_fd_(-1),
+    aio_reactor_data_(),
+    outstanding_kernel_aio_ops_(0)
+#endif // defined(BOOST_ASIO_HAS_LINUX_AIO)
+{
+}
+
+aio_descriptor_service::~aio_descriptor_service()
+{
+  shutdown_service();
+
+#if defined(BOOST_ASIO_HAS_LINUX_AIO)
+  if (aio_event_fd_ != -1)
+  {
+    reactor_.deregister_internal_descriptor(
+        aio_event_fd_, aio_reactor_data_);
+    ::close(aio_event_fd_);
+  }
+
+  if (aio_context_ != 0)
+    ::syscall(__NR_io_destroy, aio_context_);
+#endif // defined(BOOST_ASIO_HAS_LINUX_AIO)
+}
+
+void aio_descriptor_service::shutdown_service()
+{
+  work_.reset();
+  if (work_io_service_.get())
+  {
+    work_io_service_->stop();
+    for (int i = 0; i < max_work_threads; ++i)
+    {
+      if (work_threads_[i].get())
+      {
+        work_threads_[i]->join();
+        work_threads_[i].reset();
+      }
+    }
+    work_io_service_.reset();
+  }
+
+#if defined(BOOST_ASIO_HAS_LINUX_AIO)
+  // Operations submitted to the kernel cannot be cancelled, so wait for them
+  // to finish before their handlers and buffers are destroyed.
+  op_queue<operation> ops;
+  reap_kernel_aio(ops, true);
+#endif // defined(BOOST_ASIO_HAS_LINUX_AIO)
+}
+
+void aio_descriptor_service::fork_service(
+    boost::asio::io_service::fork_event fork_ev)
+{
+  if (work_io_service_.get() && work_threads_[0].get())
+  {
+    if (fork_ev == boost::asio::io_service::fork_prepare)
+    {
+      work_io_service_->stop();
+      for (int i = 0; i < max_work_threads; ++i)
+        work_threads_[i]->join();
+    }
+    else
+    {
+      work_io_service_->reset();
+      for (int i = 0; i < max_work_threads; ++i)
+      {
+        work_threads_[i].reset(new boost::asio::detail::thread(
+              work_io_service_runner(*work_io_service_)));
+      }
+    }
+  }
+}
+
+void aio_descriptor_service::construct(
+    aio_descriptor_service::implementation_type& impl)
+{
+  impl.descriptor_ = -1;
+  impl.state_ = 0;
+  impl.kernel_aio_ = false;
+}
+
+void aio_descriptor_service::move_construct(
+    aio_descriptor_service::implementation_type& impl,
+    aio_descriptor_service::implementation_type& other_impl)
+{
+  impl.descriptor_ = other_impl.descriptor_;
+  other_impl.descriptor_ = -1;
+
+  impl.state_ = other_impl.state_;
+  other_impl.state_ = 0;
+
+  impl.kernel_aio_ = other_impl.kernel_aio_;
+  other_impl.kernel_aio_ = false;
+}
+
+void aio_descriptor_service::move_assign(
+    aio_descriptor_service::implementation_type& impl,
+    aio_descriptor_service& other_service,
+    aio_descriptor_service::implementation_type& other_impl)
+{
+  destroy(impl);
+
+  impl.descriptor_ = other_impl.descriptor_;
+  other_impl.descriptor_ = -1;
+
+  impl.state_ = other_impl.state_;
+  other_impl.state_ = 0;
+
+  // Native AIO is only used if this service has been able to set it up.
+  impl.kernel_aio_ = false;
+#if defined(BOOST_ASIO_HAS_LINUX_AIO)
+  if (other_impl.kernel_aio_)
+    impl.kernel_aio_ = (&other_service == this) || init_kernel_aio();
+#else // defined(BOOST_ASIO_HAS_LINUX_AIO)
+  (void)other_service;
+#endif // defined(BOOST_ASIO_HAS_LINUX_AIO)
+  other_impl.kernel_aio_ = false;
+}
+
+void aio_descriptor_service::destroy(
+    aio_descriptor_service::implementation_type& impl)
+{
+  if (is_open(impl))
+  {
+    BOOST_ASIO_HANDLER_OPERATION(("descriptor", &impl, "close"));
+  }
+
+  boost::system::error_code ignored_ec;
+  descriptor_ops::close(impl.descriptor_, impl.state_, ignored_ec);
+}
+
+boost::system::error_code aio_descriptor_service::assign(
+    aio_descriptor_service::implementation_type& impl,
+    const native_handle_type& native_descriptor, boost::system::error_code& ec)
+{
+  if (is_open(impl))
+  {
+    ec = boost::asio::error::already_open;
+    return ec;
+  }
+
+  impl.descriptor_ = native_descriptor;
+  impl.state_ = descriptor_ops::possible_dup;
+  impl.kernel_aio_ = false;
+
+#if defined(BOOST_ASIO_HAS_LINUX_AIO) && defined(O_DIRECT)
+  // Native AIO only runs asynchronously for descriptors that bypass the page
+  // cache. For other descriptors the submission blocks.
+  boost::system::error_code ignored_ec;
+  int flags = descriptor_ops::fcntl(native_descriptor, F_GETFL, ignored_ec);
+  if (flags >= 0 && (flags & O_DIRECT) != 0)
+    impl.kernel_aio_ = init_kernel_aio();
+#endif // defined(BOOST_ASIO_HAS_LINUX_AIO) && defined(O_DIRECT)
+
+  ec = boost::system::error_code();
+  return ec;
+}
+
+boost::system::error_code aio_descriptor_service::close(
+    aio_descriptor_service::implementation_type& impl,
+    boost::system::error_code& ec)
+{
+  if (is_open(impl))
+  {
+    BOOST_ASIO_HANDLER_OPERATION(("descriptor", &impl, "close"));
+  }
+
+  descriptor_ops::close(impl.descriptor_, impl.state_, ec);
+
+  // The descriptor is closed by the OS even if close() returns an error.
+  construct(impl);
+
+  return ec;
+}
+
+aio_descriptor_service::native_handle_type
+aio_descriptor_service::release(
+    aio_descriptor_service::implementation_type& impl)
+{
+  native_handle_type descriptor = impl.descriptor_;
+
+  if (is_open(impl))
+  {
+    BOOST_ASIO_HANDLER_OPERATION(("descriptor", &impl, "release"));
+
+    construct(impl);
+  }
+
+  return descriptor;
+}
+
+boost::system::error_code aio_descriptor_service::cancel(
+    aio_descriptor_service::implementation_type& impl,
+    boost::system::error_code& ec)
+{
+  if (!is_open(impl))
+  {
+    ec = boost::asio::error::bad_descriptor;
+    return ec;
+  }
+
+  BOOST_ASIO_HANDLER_OPERATION(("descriptor", &impl, "cancel"));
+
+  ec = boost::asio::error::operation_not_supported;
+  return ec;
+}
+
+void aio_descriptor_service::start_op(
+    aio_descriptor_service::implementation_type& impl, aio_descriptor_op* op)
+{
+  // Operations that cannot transfer any data complete immediately.
+  if (impl.descriptor_ == -1 || op->all_empty_)
+  {
+    if (impl.descriptor_ == -1)
+      op->ec_ = boost::asio::error::bad_descriptor;
+    io_service_impl_.post_immediate_completion(op);
+    return;
+  }
+
+  io_service_impl_.work_started();
+
+#if defined(BOOST_ASIO_HAS_LINUX_AIO)
+  if (impl.kernel_aio_ && submit_kernel_aio(op))
+    return;
+#endif // defined(BOOST_ASIO_HAS_LINUX_AIO)
+
+  start_work_threads();
+  work_io_service_impl_.post_immediate_completion(op);
+}
+
+void aio_descriptor_service::start_work_threads()
+{
+  boost::asio::detail::mutex::scoped_lock lock(mutex_);
+  if (!work_threads_[0].get())
+  {
+    for (int i = 0; i < max_work_threads; ++i)
+    {
+      work_threads_[i].reset(new boost::asio::detail::thread(
+            work_io_service_runner(*work_io_service_)));
+    }
+  }
+}
+
+#if defined(BOOST_ASIO_HAS_LINUX_AIO)
+bool aio_descriptor_service::init_kernel_aio()
+{
+  boost::asio::detail::mutex::scoped_lock lock(mutex_);
+  if (kernel_aio_initialised_)
+    return aio_context_ != 0;
+  kernel_aio_initialised_ = true;
+
+  aio_context_t context = 0;
+  if (::syscall(__NR_io_setup, max_kernel_aio_ops, &context) != 0)
+    return false;
+
+#if __GLIBC__ == 2 && __GLIBC_MINOR__ < 8
+  int fd = ::syscall(__NR_eventfd, 0);
+#else // __GLIBC__ == 2 && __GLIBC_MINOR__ < 8
+  int fd = ::eventfd(0, 0);
+#endif // __GLIBC__ == 2 && __GLIBC_MINOR__ < 8
+  if (fd == -1)
+  {
+    ::syscall(__NR_io_destroy, context);
+    return false;
+  }
+  ::fcntl(fd, F_SETFL, O_NONBLOCK);
+  ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+  if (reactor_.register_internal_descriptor(reactor::read_op,
+        fd, aio_reactor_data_, new eventfd_read_op(this)) != 0)
+  {
+    reactor_.deregister_internal_descriptor(fd, aio_reactor_data_);
+    ::close(fd);
+    ::syscall(__NR_io_destroy, context);
+    return false;
+  }
+
+  reactor_.init_task();
+  aio_event_fd_ = fd;
+  aio_context_ = context;
+  return true;
+}
+
+bool aio_descriptor_service::submit_kernel_aio(aio_descriptor_op* op)
+{
+  iocb& cb = op->iocb_;
+  std::memset(&cb, 0, sizeof(cb));
+  cb.aio_data = reinterpret_cast<std::size_t>(op);
+  cb.aio_lio_opcode = op->is_read_ ? IOCB_CMD_PREADV : IOCB_CMD_PWRITEV;
+  cb.aio_fildes = op->descriptor_;
+  cb.aio_buf = reinterpret_cast<std::size_t>(op->bufs_);
+  cb.aio_nbytes = op->count_;
+  cb.aio_offset = op->offset_;
+  cb.aio_flags = IOCB_FLAG_RESFD;
+  cb.aio_resfd = aio_event_fd_;
+
+  // The count is incremented first so that it cannot be seen to fall below
+  // zero if the operation completes immediately.
+  ++outstanding_kernel_aio_ops_;
+  iocb* cbs[1] = { &cb };
+  if (::syscall(__NR_io_submit, aio_context_, 1, cbs) == 1)
+    return true;
+
+  // The kernel's queue is full, or the operation was rejected. Either way, a
+  // blocking call will complete it or report the error.
+  --outstanding_kernel_aio_ops_;
+  return false;
+}
+
+void aio_descriptor_service::reap_kernel_aio(
+    op_queue<operation>& ops, bool block)
+{
+  if (aio_context_ == 0)
+    return;
+
+  const long max_events = 64;
+  io_event events[max_events];
+  timespec zero_timeout = { 0, 0 };
+
+  for (;;)
+  {
+    long min_events = 0;
+    if (block)
+    {
+      long outstanding = outstanding_kernel_aio_ops_;
+      if (outstanding == 0)
+        return;
+      min_events = outstanding < max_events ? outstanding : max_events;
+    }
+
+    long result = ::syscall(__NR_io_getevents, aio_context_,
+        min_events, max_events, events, block ? 0 : &zero_timeout);
+    if (result < 0)
+    {
+      // The context is not inherited by a child process.
+      if (errno == EINTR)
+        continue;
+      return;
+    }
+
+    for (long i = 0; i < result; ++i)
+    {
+      aio_descriptor_op* op = reinterpret_cast<aio_descriptor_op*>(
+          static_cast<std::size_t>(events[i].data));
+      op->set_result(events[i].res);
+      ops.push(op);
+      --outstanding_kernel_aio_ops_;
+    }
+
+    if (!block && result < max_events)
+      return;
+  }
+}
+#endif // defined(BOOST_ASIO_HAS_LINUX_AIO)
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+
+#endif // BOOST_ASIO_DETAIL_IMPL_AIO_DESCRIPTOR_SERVICE_IPP
@@ -17,11 +17,21 @@
 
 #include <boost/asio/detail/config.hpp>
 #include <cerrno>
+#include <limits>
 #include <boost/asio/detail/descriptor_ops.hpp>
 #include <boost/asio/error.hpp>
 
 #if !defined(BOOST_WINDOWS) && !defined(__CYGWIN__)
 
+#if defined(BOOST_ASIO_HAS_LINUX_SENDFILE)
+# include <sys/sendfile.h>
+# include <csignal>
+# include <ctime>
+# if defined(BOOST_HAS_PTHREADS)
+#  include <pthread.h>
+# endif // defined(BOOST_HAS_PTHREADS)
+#endif // defined(BOOST_ASIO_HAS_LINUX_SENDFILE)
+
 #include <boost/asio/detail/push_options.hpp>
 
 namespace boost {
@@ -316,6 +326,262 @@ bool non_blocking_write(int d, const buf* bufs, std::size_t count,
   }
 }
 
+// Read into the buffers from the given offset. Where preadv() is unavailable,
+// the buffers are filled one at a time and a short read ends the operation.
+inline ssize_t read_at(int d, boost::uint64_t offset,
+    buf* bufs, std::size_t count, boost::system::error_code& ec)
+{
+  errno = 0;
+#if defined(__linux__) || defined(__FreeBSD__) \
+  || defined(__NetBSD__) || defined(__OpenBSD__)
+  return error_wrapper(::preadv(d, bufs,
+        static_cast<int>(count), static_cast<off_t>(offset)), ec);
+#else // defined(__linux__) || defined(__FreeBSD__) ...
+  ssize_t total = 0;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    ssize_t bytes = error_wrapper(::pread(d, bufs[i].iov_base,
+          bufs[i].iov_len, static_cast<off_t>(offset + total)), ec);
+    if (bytes < 0)
+      return total > 0 ? total : bytes;
+    total += bytes;
+    if (static_cast<std::size_t>(bytes) < bufs[i].iov_len)
+      break;
+  }
+  ec = boost::system::error_code();
+  return total;
+#endif // defined(__linux__) || defined(__FreeBSD__) ...
+}
+
+// Write from the buffers at the given offset.
+inline ssize_t write_at(int d, boost::uint64_t offset,
+    const buf* bufs, std::size_t count, boost::system::error_code& ec)
+{
+  errno = 0;
+#if defined(__linux__) || defined(__FreeBSD__) \
+  || defined(__NetBSD__) || defined(__OpenBSD__)
+  return error_wrapper(::pwritev(d, bufs,
+        static_cast<int>(count), static_cast<off_t>(offset)), ec);
+#else // defined(__linux__) || defined(__FreeBSD__) ...
+  ssize_t total = 0;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    ssize_t bytes = error_wrapper(::pwrite(d, bufs[i].iov_base,
+          bufs[i].iov_len, static_cast<off_t>(offset + total)), ec);
+    if (bytes < 0)
+      return total > 0 ? total : bytes;
+    total += bytes;
+    if (static_cast<std::size_t>(bytes) < bufs[i].iov_len)
+      break;
+  }
+  ec = boost::system::error_code();
+  return total;
+#endif // defined(__linux__) || defined(__FreeBSD__) ...
+}
+
+std::size_t sync_read_at(int d, boost::uint64_t offset, buf* bufs,
+    std::size_t count, bool all_empty, boost::system::error_code& ec)
+{
+  if (d == -1)
+  {
+    ec = boost::asio::error::bad_descriptor;
+    return 0;
+  }
+
+  // A request to read 0 bytes is a no-op.
+  if (all_empty)
+  {
+    ec = boost::system::error_code();
+    return 0;
+  }
+
+  for (;;)
+  {
+    ssize_t bytes = read_at(d, offset, bufs, count, ec);
+
+    // Retry operation if interrupted by signal.
+    if (ec == boost::asio::error::interrupted)
+      continue;
+
+    // Check if operation succeeded.
+    if (bytes > 0)
+    {
+      ec = boost::system::error_code();
+      return bytes;
+    }
+
+    // Check for EOF.
+    if (bytes == 0)
+      ec = boost::asio::error::eof;
+
+    return 0;
+  }
+}
+
+std::size_t sync_write_at(int d, boost::uint64_t offset, const buf* bufs,
+    std::size_t count, bool all_empty, boost::system::error_code& ec)
+{
+  if (d == -1)
+  {
+    ec = boost::asio::error::bad_descriptor;
+    return 0;
+  }
+
+  // A request to write 0 bytes is a no-op.
+  if (all_empty)
+  {
+    ec = boost::system::error_code();
+    return 0;
+  }
+
+  for (;;)
+  {
+    ssize_t bytes = write_at(d, offset, bufs, count, ec);
+
+    // Retry operation if interrupted by signal.
+    if (ec == boost::asio::error::interrupted)
+      continue;
+
+    // Check if operation succeeded.
+    if (bytes >= 0)
+    {
+      ec = boost::system::error_code();
+      return bytes;
+    }
+
+    return 0;
+  }
+}
+
+// Transfer data from a file by reading it into an intermediate buffer. This is
+// used where the operating system does not provide a way to transfer the data
+// directly.
+inline ssize_t send_file_by_copying(int d, int file,
+    boost::uint64_t offset, std::size_t size, boost::system::error_code& ec)
+{
+  char buffer[16384];
+  std::size_t length = size < sizeof(buffer) ? size : sizeof(buffer);
+
+  errno = 0;
+  ssize_t bytes_read = error_wrapper(::pread(file,
+        buffer, length, static_cast<off_t>(offset)), ec);
+  if (bytes_read <= 0)
+    return bytes_read;
+
+  // Data that is not accepted by the descriptor is read again on the next
+  // call.
+  errno = 0;
+#if defined(MSG_NOSIGNAL)
+  ssize_t bytes = error_wrapper(
+      ::send(d, buffer, bytes_read, MSG_NOSIGNAL), ec);
+  if (ec == boost::asio::error::not_socket)
+  {
+    errno = 0;
+    bytes = error_wrapper(::write(d, buffer, bytes_read), ec);
+  }
+#else // defined(MSG_NOSIGNAL)
+  ssize_t bytes = error_wrapper(::write(d, buffer, bytes_read), ec);
+#endif // defined(MSG_NOSIGNAL)
+  return bytes;
+}
+
+#if defined(BOOST_ASIO_HAS_LINUX_SENDFILE)
+// Unlike send() there is no MSG_NOSIGNAL flag for sendfile(), so SIGPIPE is
+// blocked in the calling thread for the duration of the call. A SIGPIPE that
+// the call raises is then discarded before the signal mask is restored, while
+// one that was already pending is left for the application.
+inline ssize_t sendfile_without_sigpipe(int d, int file,
+    off_t* file_offset, std::size_t size, boost::system::error_code& ec)
+{
+  sigset_t pipe_mask;
+  ::sigemptyset(&pipe_mask);
+  ::sigaddset(&pipe_mask, SIGPIPE);
+
+  sigset_t pending;
+  ::sigemptyset(&pending);
+  ::sigpending(&pending);
+  bool already_pending = ::sigismember(&pending, SIGPIPE) == 1;
+
+  sigset_t old_mask;
+#if defined(BOOST_HAS_PTHREADS)
+  ::pthread_sigmask(SIG_BLOCK, &pipe_mask, &old_mask);
+#else // defined(BOOST_HAS_PTHREADS)
+  ::sigprocmask(SIG_BLOCK, &pipe_mask, &old_mask);
+#endif // defined(BOOST_HAS_PTHREADS)
+
+  errno = 0;
+  ssize_t bytes = error_wrapper(
+      ::sendfile(d, file, file_offset, size), ec);
+
+  if (ec == boost::asio::error::broken_pipe && !already_pending)
+  {
+    struct timespec no_wait = { 0, 0 };
+    while (::sigtimedwait(&pipe_mask, 0, &no_wait) == -1 && errno == EINTR)
+      ;
+  }
+
+#if defined(BOOST_HAS_PTHREADS)
+  ::pthread_sigmask(SIG_SETMASK, &old_mask, 0);
+#else // defined(BOOST_HAS_PTHREADS)
+  ::sigprocmask(SIG_SETMASK, &old_mask, 0);
+#endif // defined(BOOST_HAS_PTHREADS)
+
+  return bytes;
+}
+#endif // defined(BOOST_ASIO_HAS_LINUX_SENDFILE)
+
+bool non_blocking_send_file(int d, int file,
+    boost::uint64_t offset, std::size_t size,
+    boost::system::error_code& ec, std::size_t& bytes_transferred)
+{
+  // Offsets are passed to the operating system as an off_t, which may be
+  // narrower than 64 bits.
+  if (offset > static_cast<boost::uint64_t>(
+        (std::numeric_limits<off_t>::max)()))
+  {
+    ec = boost::asio::error::invalid_argument;
+    bytes_transferred = 0;
+    return true;
+  }
+
+  for (;;)
+  {
+    // Transfer some data.
+#if defined(BOOST_ASIO_HAS_LINUX_SENDFILE)
+    off_t file_offset = static_cast<off_t>(offset);
+    ssize_t bytes = sendfile_without_sigpipe(
+        d, file, &file_offset, size, ec);
+
+    // Not all types of file support sendfile().
+    if (ec == boost::asio::error::invalid_argument
+        || ec.value() == ENOSYS)
+      bytes = send_file_by_copying(d, file, offset, size, ec);
+#else // defined(BOOST_ASIO_HAS_LINUX_SENDFILE)
+    ssize_t bytes = send_file_by_copying(d, file, offset, size, ec);
+#endif // defined(BOOST_ASIO_HAS_LINUX_SENDFILE)
+
+    // Retry operation if interrupted by signal.
+    if (ec == boost::asio::error::interrupted)
+      continue;
+
+    // Check if we need to run the operation again.
+    if (ec == boost::asio::error::would_block
+        || ec == boost::asio::error::try_again)
+      return false;
+
+    // Operation is complete.
+    if (bytes >= 0)
+    {
+      ec = boost::system::error_code();
+      bytes_transferred = bytes;
+    }
+    else
+      bytes_transferred = 0;
+
+    return true;
+  }
+}
+
 int ioctl(int d, state_type& state, long cmd,
     ioctl_arg_type* arg, boost::system::error_code& ec)
 {
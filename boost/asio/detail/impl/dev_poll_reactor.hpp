@@ -50,6 +50,7 @@ void dev_poll_reactor::schedule_timer(timer_queue<Time_Traits>& queue,
     return;
   }
 
+  io_service_.set_affinity(op);
   bool earliest = queue.enqueue_timer(time, timer, op);
   io_service_.work_started();
   if (earliest)
@@ -190,6 +190,7 @@ void dev_poll_reactor::start_op(int op_type, socket_type descriptor,
     }
   }
 
+  io_service_.set_affinity(op);
   bool first = op_queue_[op_type].enqueue_operation(descriptor, op);
   io_service_.work_started();
   if (first)
@@ -38,9 +38,16 @@ namespace detail {
 epoll_reactor::epoll_reactor(boost::asio::io_service& io_service)
   : boost::asio::detail::service_base<epoll_reactor>(io_service),
     io_service_(use_service<io_service_impl>(io_service)),
+    num_instances_(BOOST_ASIO_CONCURRENCY_HINT_REACTORS(
+          io_service_.concurrency_hint())),
+    hash_descriptors_(BOOST_ASIO_CONCURRENCY_HINT_IS_HASH_DESCRIPTORS(
+          io_service_.concurrency_hint())),
+    check_pending_(io_service_.task_runs_ahead() || num_instances_ > 0),
     mutex_(),
     interrupter_(),
     epoll_fd_(do_epoll_create()),
+    instances_(0),
+    next_instance_(0),
     timer_fd_(do_timerfd_create()),
     shutdown_(false)
 {
@@ -58,10 +65,17 @@ epoll_reactor::epoll_reactor(boost::asio::io_service& io_service)
     ev.data.ptr = &timer_fd_;
     epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, timer_fd_, &ev);
   }
+
+  if (num_instances_ > 0)
+  {
+    instances_ = new epoll_instance[num_instances_];
+    create_instances();
+  }
 }
 
 epoll_reactor::~epoll_reactor()
 {
+  delete[] instances_;
   if (epoll_fd_ != -1)
     close(epoll_fd_);
   if (timer_fd_ != -1)
@@ -122,6 +136,17 @@ void epoll_reactor::fork_service(boost::asio::io_service::fork_event fork_ev)
 
     update_timeout();
 
+    if (num_instances_ > 0)
+    {
+      for (std::size_t i = 0; i < num_instances_; ++i)
+      {
+        if (instances_[i].epoll_fd_ != -1)
+          ::close(instances_[i].epoll_fd_);
+        instances_[i].epoll_fd_ = -1;
+      }
+      create_instances();
+    }
+
     // Re-register all descriptors with epoll.
     mutex::scoped_lock descriptors_lock(registered_descriptors_mutex_);
     for (descriptor_state* state = registered_descriptors_.first();
@@ -129,7 +154,8 @@ void epoll_reactor::fork_service(boost::asio::io_service::fork_event fork_ev)
     {
       ev.events = state->registered_events_;
       ev.data.ptr = state;
-      int result = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, state->descriptor_, &ev);
+      int result = epoll_ctl(epoll_fd_for(state),
+          EPOLL_CTL_ADD, state->descriptor_, &ev);
       if (result != 0)
       {
         boost::system::error_code ec(errno,
@@ -154,6 +180,7 @@ int epoll_reactor::register_descriptor(socket_type descriptor,
     mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
 
     descriptor_data->reactor_ = this;
+    descriptor_data->instance_ = choose_instance(descriptor);
     descriptor_data->descriptor_ = descriptor;
     descriptor_data->shutdown_ = false;
   }
@@ -162,7 +189,8 @@ int epoll_reactor::register_descriptor(socket_type descriptor,
   ev.events = EPOLLIN | EPOLLERR | EPOLLHUP | EPOLLPRI | EPOLLET;
   descriptor_data->registered_events_ = ev.events;
   ev.data.ptr = descriptor_data;
-  int result = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, descriptor, &ev);
+  int result = epoll_ctl(epoll_fd_for(descriptor_data),
+      EPOLL_CTL_ADD, descriptor, &ev);
   if (result != 0)
     return errno;
 
@@ -179,6 +207,7 @@ int epoll_reactor::register_internal_descriptor(
     mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
 
     descriptor_data->reactor_ = this;
+    descriptor_data->instance_ = choose_instance(descriptor);
     descriptor_data->descriptor_ = descriptor;
     descriptor_data->shutdown_ = false;
     descriptor_data->op_queue_[op_type].push(op);
@@ -188,7 +217,8 @@ int epoll_reactor::register_internal_descriptor(
   ev.events = EPOLLIN | EPOLLERR | EPOLLHUP | EPOLLPRI | EPOLLET;
   descriptor_data->registered_events_ = ev.events;
   ev.data.ptr = descriptor_data;
-  int result = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, descriptor, &ev);
+  int result = epoll_ctl(epoll_fd_for(descriptor_data),
+      EPOLL_CTL_ADD, descriptor, &ev);
   if (result != 0)
     return errno;
 
@@ -242,7 +272,8 @@ void epoll_reactor::start_op(int op_type, socket_type descriptor,
           epoll_event ev = { 0, { 0 } };
           ev.events = descriptor_data->registered_events_ | EPOLLOUT;
           ev.data.ptr = descriptor_data;
-          if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, descriptor, &ev) == 0)
+          if (epoll_ctl(epoll_fd_for(descriptor_data),
+                EPOLL_CTL_MOD, descriptor, &ev) == 0)
           {
             descriptor_data->registered_events_ |= ev.events;
           }
@@ -266,10 +297,15 @@ void epoll_reactor::start_op(int op_type, socket_type descriptor,
       epoll_event ev = { 0, { 0 } };
       ev.events = descriptor_data->registered_events_;
       ev.data.ptr = descriptor_data;
-      epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, descriptor, &ev);
+      epoll_ctl(epoll_fd_for(descriptor_data),
+          EPOLL_CTL_MOD, descriptor, &ev);
     }
   }
 
+  // The descriptor state object performs the operation and completes it
+  // inline, so it carries the affinity too.
+  io_service_.set_affinity(op);
+  io_service_.set_affinity(descriptor_data);
   descriptor_data->op_queue_[op_type].push(op);
   io_service_.work_started();
 }
@@ -316,7 +352,8 @@ void epoll_reactor::deregister_descriptor(socket_type descriptor,
     else
     {
       epoll_event ev = { 0, { 0 } };
-      epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, descriptor, &ev);
+      epoll_ctl(epoll_fd_for(descriptor_data),
+          EPOLL_CTL_DEL, descriptor, &ev);
     }
 
     op_queue<operation> ops;
@@ -353,7 +390,8 @@ void epoll_reactor::deregister_internal_descriptor(socket_type descriptor,
   if (!descriptor_data->shutdown_)
   {
     epoll_event ev = { 0, { 0 } };
-    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, descriptor, &ev);
+    epoll_ctl(epoll_fd_for(descriptor_data),
+        EPOLL_CTL_DEL, descriptor, &ev);
 
     op_queue<operation> ops;
     for (int i = 0; i < max_ops; ++i)
@@ -388,8 +426,9 @@ void epoll_reactor::run(bool block, op_queue<operation>& ops)
   }
 
   // Block on the epoll descriptor.
-  epoll_event events[128];
-  int num_events = epoll_wait(epoll_fd_, events, 128, timeout);
+  epoll_event* events = events_.data();
+  int num_events = epoll_wait(epoll_fd_, events, events_.size(), timeout);
+  events_.update(num_events);
 
 #if defined(BOOST_ASIO_HAS_TIMERFD)
   bool check_timers = (timer_fd_ == -1);
@@ -421,14 +460,20 @@ void epoll_reactor::run(bool block, op_queue<operation>& ops)
       check_timers = true;
     }
 #endif // defined(BOOST_ASIO_HAS_TIMERFD)
+    else if (num_instances_ > 0)
+    {
+      // When using additional epoll instances, no descriptors are registered
+      // directly with the main epoll descriptor, so this is an instance that
+      // has ready events. The instance operation doesn't count as work.
+      ops.push(static_cast<epoll_instance*>(ptr));
+    }
     else
     {
       // The descriptor operation doesn't count as work in and of itself, so we
       // don't call work_started() here. This still allows the io_service to
       // stop if the only remaining operations are descriptor operations.
-      descriptor_state* descriptor_data = static_cast<descriptor_state*>(ptr);
-      descriptor_data->set_ready_events(events[i].events);
-      ops.push(descriptor_data);
+      queue_ready_descriptor(static_cast<descriptor_state*>(ptr),
+          events[i].events, ops);
     }
   }
 
@@ -506,6 +551,88 @@ int epoll_reactor::do_timerfd_create()
 #endif // defined(BOOST_ASIO_HAS_TIMERFD)
 }
 
+void epoll_reactor::create_instances()
+{
+  for (std::size_t i = 0; i < num_instances_; ++i)
+  {
+    instances_[i].reactor_ = this;
+    instances_[i].epoll_fd_ = do_epoll_create();
+
+    // The instance is reported at most once until its events are gathered.
+    epoll_event ev = { 0, { 0 } };
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.ptr = &instances_[i];
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, instances_[i].epoll_fd_, &ev);
+  }
+}
+
+epoll_reactor::epoll_instance* epoll_reactor::choose_instance(
+    socket_type descriptor)
+{
+  if (num_instances_ == 0)
+    return 0;
+
+  std::size_t index = hash_descriptors_
+    ? static_cast<std::size_t>(descriptor)
+    : static_cast<std::size_t>(++next_instance_);
+  return &instances_[index % num_instances_];
+}
+
+void epoll_reactor::gather_instance_events(
+    epoll_reactor::epoll_instance* instance)
+{
+  // Gathering events doesn't count as work, so compensate for the
+  // work_finished() call that the io_service will make once this operation
+  // returns.
+  io_service_.work_started();
+
+  epoll_event* events = instance->events_.data();
+  int num_events = epoll_wait(instance->epoll_fd_,
+      events, instance->events_.size(), 0);
+  instance->events_.update(num_events);
+
+  op_queue<operation> ops;
+  for (int i = 0; i < num_events; ++i)
+  {
+    queue_ready_descriptor(static_cast<descriptor_state*>(events[i].data.ptr),
+        events[i].events, ops);
+  }
+
+  // Rearm the instance. If events remain that did not fit in the batch, the
+  // main epoll descriptor will report the instance again immediately.
+  epoll_event ev = { 0, { 0 } };
+  ev.events = EPOLLIN | EPOLLONESHOT;
+  ev.data.ptr = instance;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, instance->epoll_fd_, &ev);
+
+  io_service_.post_deferred_completions(ops);
+}
+
+void epoll_reactor::queue_ready_descriptor(
+    epoll_reactor::descriptor_state* descriptor_data,
+    uint32_t events, op_queue<operation>& ops)
+{
+  if (check_pending_)
+  {
+    // The descriptor's previous readiness notification may not have been
+    // processed yet, in which case the new events are merged into it.
+    mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+    if (descriptor_data->pending_)
+    {
+      descriptor_data->add_ready_events(events);
+      return;
+    }
+    descriptor_data->pending_ = true;
+    descriptor_data->set_ready_events(events);
+  }
+  else
+  {
+    descriptor_data->set_ready_events(events);
+  }
+
+  ops.push(descriptor_data);
+}
+
 epoll_reactor::descriptor_state* epoll_reactor::allocate_descriptor_state()
 {
   mutex::scoped_lock descriptors_lock(registered_descriptors_mutex_);
@@ -600,8 +727,35 @@ struct epoll_reactor::perform_io_cleanup_on_block_exit
   operation* first_op_;
 };
 
+epoll_reactor::epoll_instance::epoll_instance()
+  : operation(&epoll_reactor::epoll_instance::do_complete),
+    reactor_(0),
+    epoll_fd_(-1)
+{
+}
+
+epoll_reactor::epoll_instance::~epoll_instance()
+{
+  if (epoll_fd_ != -1)
+    ::close(epoll_fd_);
+}
+
+void epoll_reactor::epoll_instance::do_complete(
+    io_service_impl* owner, operation* base,
+    const boost::system::error_code& /*ec*/,
+    std::size_t /*bytes_transferred*/)
+{
+  if (owner)
+  {
+    epoll_instance* instance = static_cast<epoll_instance*>(base);
+    instance->reactor_->gather_instance_events(instance);
+  }
+}
+
 epoll_reactor::descriptor_state::descriptor_state()
-  : operation(&epoll_reactor::descriptor_state::do_complete)
+  : operation(&epoll_reactor::descriptor_state::do_complete),
+    instance_(0),
+    pending_(false)
 {
 }
 
@@ -610,6 +764,13 @@ operation* epoll_reactor::descriptor_state::perform_io(uint32_t events)
   perform_io_cleanup_on_block_exit io_cleanup(reactor_);
   mutex::scoped_lock descriptor_lock(mutex_);
 
+  // Pick up any events that were merged in after the descriptor was queued.
+  if (pending_)
+  {
+    events = task_result_;
+    pending_ = false;
+  }
+
   // Exception operations must be processed first to ensure that any
   // out-of-band data is read before normal data.
   static const int flag[max_ops] = { EPOLLIN, EPOLLOUT, EPOLLPRI };
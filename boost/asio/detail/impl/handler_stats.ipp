@@ -0,0 +1,365 @@
+//
+// detail/impl/handler_stats.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_IMPL_HANDLER_STATS_IPP
+#define BOOST_ASIO_DETAIL_IMPL_HANDLER_STATS_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <boost/asio/detail/handler_stats.hpp>
+
+#if defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+
+#include <cstring>
+#include <time.h>
+
+#if defined(BOOST_ASIO_HAS_STD_ATOMIC)
+# include <atomic>
+#elif defined(__ATOMIC_RELAXED)
+# define BOOST_ASIO_HAS_GCC_ATOMIC_BUILTINS 1
+#endif // defined(__ATOMIC_RELAXED)
+
+#if !defined(CLOCK_MONOTONIC)
+# include <boost/asio/detail/push_options.hpp>
+# include <boost/date_time/posix_time/posix_time_types.hpp>
+# include <boost/asio/detail/pop_options.hpp>
+#endif // !defined(CLOCK_MONOTONIC)
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+struct handler_stats::thread_stats
+{
+  enum
+  {
+    // The number of distinct operation types that can be recorded by a
+    // thread. The last entry counts the invocations of all other types.
+    max_entries = 32,
+
+    // The number of buckets in each histogram.
+    buckets = io_service_statistics::histogram::bucket_count
+  };
+
+  // A value that is written only by the thread owning the block, and that may
+  // be read concurrently by snapshot().
+  template <typename T>
+  class value
+    : private noncopyable
+  {
+  public:
+    value()
+      : value_(0)
+    {
+    }
+
+    T load() const
+    {
+#if defined(BOOST_ASIO_HAS_STD_ATOMIC)
+      return value_.load(std::memory_order_relaxed);
+#elif defined(BOOST_ASIO_HAS_GCC_ATOMIC_BUILTINS)
+      return __atomic_load_n(&value_, __ATOMIC_RELAXED);
+#else
+      return value_;
+#endif
+    }
+
+    // Get the value, also making visible the writes made before the value was
+    // set using store_release().
+    T load_acquire() const
+    {
+#if defined(BOOST_ASIO_HAS_STD_ATOMIC)
+      return value_.load(std::memory_order_acquire);
+#elif defined(BOOST_ASIO_HAS_GCC_ATOMIC_BUILTINS)
+      return __atomic_load_n(&value_, __ATOMIC_ACQUIRE);
+#else
+      return value_;
+#endif
+    }
+
+    void store_release(T v)
+    {
+#if defined(BOOST_ASIO_HAS_STD_ATOMIC)
+      value_.store(v, std::memory_order_release);
+#elif defined(BOOST_ASIO_HAS_GCC_ATOMIC_BUILTINS)
+      __atomic_store_n(&value_, v, __ATOMIC_RELEASE);
+#else
+      value_ = v;
+#endif
+    }
+
+    // There is only one writer, so no read-modify-write operation is needed.
+    void increment()
+    {
+#if defined(BOOST_ASIO_HAS_STD_ATOMIC)
+      value_.store(load() + 1, std::memory_order_relaxed);
+#elif defined(BOOST_ASIO_HAS_GCC_ATOMIC_BUILTINS)
+      __atomic_store_n(&value_, load() + 1, __ATOMIC_RELAXED);
+#else
+      value_ = load() + 1;
+#endif
+    }
+
+  private:
+#if defined(BOOST_ASIO_HAS_STD_ATOMIC)
+    std::atomic<T> value_;
+#else
+    volatile T value_;
+#endif
+  };
+
+  struct entry
+  {
+    entry()
+      : object_type(0),
+        op_name(0)
+    {
+    }
+
+    // Set before used, and not changed afterwards.
+    const char* object_type;
+    const char* op_name;
+
+    value<bool> used;
+    value<boost::uint64_t> count;
+    value<boost::uint64_t> queue_wait[buckets];
+    value<boost::uint64_t> execution[buckets];
+  };
+
+  // Add a duration to a histogram's counts.
+  static void add_sample(value<boost::uint64_t>* counts,
+      boost::uint64_t duration)
+  {
+    std::size_t bucket = 0;
+#if defined(__GNUC__)
+    if (duration > 1)
+      bucket = 63 - __builtin_clzll(duration);
+#else // defined(__GNUC__)
+    while (duration > 1)
+    {
+      duration >>= 1;
+      ++bucket;
+    }
+#endif // defined(__GNUC__)
+    if (bucket >= buckets)
+      bucket = buckets - 1;
+    counts[bucket].increment();
+  }
+
+  thread_stats()
+    : next_block(0),
+      next_free_block(0)
+  {
+  }
+
+  thread_stats* next_block;
+  thread_stats* next_free_block;
+  entry entries[max_entries];
+};
+
+handler_stats::handler_stats()
+  : enabled_(0),
+    mutex_(),
+    first_block_(0),
+    first_free_block_(0)
+{
+}
+
+handler_stats::~handler_stats()
+{
+  while (thread_stats* block = first_block_)
+  {
+    first_block_ = block->next_block;
+    delete block;
+  }
+}
+
+void handler_stats::enable(bool enabled)
+{
+  enabled_.exchange(enabled ? 1 : 0);
+}
+
+io_service_statistics handler_stats::snapshot() const
+{
+  io_service_statistics result;
+  std::vector<io_service_statistics::operation>& ops = result.operations_;
+
+  mutex::scoped_lock lock(mutex_);
+  for (thread_stats* block = first_block_; block; block = block->next_block)
+  {
+    for (std::size_t i = 0; i < thread_stats::max_entries; ++i)
+    {
+      const thread_stats::entry& e = block->entries[i];
+      if (!e.used.load_acquire())
+        continue;
+
+      // Operations are identified by name, since the same name may appear at
+      // different addresses.
+      const char* object_type = e.object_type;
+      const char* op_name = e.op_name;
+      std::size_t j = 0;
+      for (; j < ops.size(); ++j)
+        if (std::strcmp(ops[j].object_type_, object_type) == 0
+            && std::strcmp(ops[j].name_, op_name) == 0)
+          break;
+      if (j == ops.size())
+      {
+        ops.push_back(io_service_statistics::operation());
+        ops[j].object_type_ = object_type;
+        ops[j].name_ = op_name;
+      }
+
+      ops[j].count_ += e.count.load();
+      for (std::size_t k = 0; k < thread_stats::buckets; ++k)
+      {
+        ops[j].queue_wait_.counts_[k] += e.queue_wait[k].load();
+        ops[j].execution_.counts_[k] += e.execution[k].load();
+      }
+    }
+  }
+
+  return result;
+}
+
+boost::uint64_t handler_stats::now()
+{
+#if defined(CLOCK_MONOTONIC)
+  timespec ts;
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  boost::uint64_t t = static_cast<boost::uint64_t>(ts.tv_sec) * 1000000000
+    + static_cast<boost::uint64_t>(ts.tv_nsec);
+#else // defined(CLOCK_MONOTONIC)
+  boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+  boost::uint64_t t = static_cast<boost::uint64_t>((
+        boost::posix_time::microsec_clock::universal_time()
+          - epoch).total_microseconds()) * 1000;
+#endif // defined(CLOCK_MONOTONIC)
+  return t ? t : 1;
+}
+
+handler_stats::thread_stats* handler_stats::acquire()
+{
+  mutex::scoped_lock lock(mutex_);
+  if (thread_stats* block = first_free_block_)
+  {
+    first_free_block_ = block->next_free_block;
+    block->next_free_block = 0;
+    return block;
+  }
+
+  thread_stats* block = new thread_stats;
+  block->next_block = first_block_;
+  first_block_ = block;
+  return block;
+}
+
+void handler_stats::release(thread_stats* block)
+{
+  mutex::scoped_lock lock(mutex_);
+  block->next_free_block = first_free_block_;
+  first_free_block_ = block;
+}
+
+void handler_stats::record(thread_stats* block,
+    const char* object_type, const char* op_name,
+    boost::uint64_t queue_wait, bool has_queue_wait,
+    boost::uint64_t execution)
+{
+  // Find the entry for the operation type using open addressing, keyed on the
+  // addresses of the names.
+  const std::size_t table_size = thread_stats::max_entries - 1;
+  std::size_t index = ((reinterpret_cast<std::size_t>(object_type) >> 3)
+      ^ (reinterpret_cast<std::size_t>(op_name) >> 3)) % table_size;
+  thread_stats::entry* e = 0;
+  for (std::size_t i = 0; i < table_size; ++i)
+  {
+    thread_stats::entry& candidate = block->entries[index];
+    if (!candidate.used.load())
+    {
+      candidate.object_type = object_type;
+      candidate.op_name = op_name;
+      candidate.used.store_release(true);
+      e = &candidate;
+      break;
+    }
+    if (candidate.object_type == object_type && candidate.op_name == op_name)
+    {
+      e = &candidate;
+      break;
+    }
+    index = (index + 1) % table_size;
+  }
+
+  if (e == 0)
+  {
+    e = &block->entries[table_size];
+    if (!e->used.load())
+    {
+      e->object_type = "";
+      e->op_name = "other";
+      e->used.store_release(true);
+    }
+  }
+
+  e->count.increment();
+  if (has_queue_wait)
+    thread_stats::add_sample(e->queue_wait, queue_wait);
+  thread_stats::add_sample(e->execution, execution);
+}
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#else // defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+handler_stats::handler_stats()
+  : enabled_(0),
+    mutex_(),
+    first_block_(0),
+    first_free_block_(0)
+{
+}
+
+handler_stats::~handler_stats()
+{
+}
+
+void handler_stats::enable(bool)
+{
+}
+
+io_service_statistics handler_stats::snapshot() const
+{
+  return io_service_statistics();
+}
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+
+#endif // BOOST_ASIO_DETAIL_IMPL_HANDLER_STATS_IPP
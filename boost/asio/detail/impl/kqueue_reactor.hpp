@@ -52,6 +52,7 @@ void kqueue_reactor::schedule_timer(timer_queue<Time_Traits>& queue,
     return;
   }
 
+  io_service_.set_affinity(op);
   bool earliest = queue.enqueue_timer(time, timer, op);
   io_service_.work_started();
   if (earliest)
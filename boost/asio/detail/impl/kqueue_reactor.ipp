@@ -213,6 +213,7 @@ void kqueue_reactor::start_op(int op_type, socket_type descriptor,
     }
   }
 
+  io_service_.set_affinity(op);
   descriptor_data->op_queue_[op_type].push(op);
   io_service_.work_started();
 
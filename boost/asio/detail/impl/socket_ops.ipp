@@ -939,6 +939,104 @@ bool non_blocking_recvfrom(socket_type s,
 
 #endif // defined(BOOST_ASIO_HAS_IOCP)
 
+#if !defined(BOOST_ASIO_HAS_IOCP)
+
+int recvmmsg(socket_type s, buf* bufs, size_t count, int flags,
+    socket_addr_type** addrs, std::size_t* addrlens,
+    std::size_t* lengths, boost::system::error_code& ec)
+{
+  if (count > max_mmsg_count)
+    count = max_mmsg_count;
+
+#if defined(BOOST_ASIO_HAS_MMSG)
+  clear_last_error();
+  mmsghdr msgs[max_mmsg_count];
+  for (size_t i = 0; i < count; ++i)
+  {
+    msgs[i] = mmsghdr();
+    if (addrs)
+    {
+      init_msghdr_msg_name(msgs[i].msg_hdr.msg_name, addrs[i]);
+      msgs[i].msg_hdr.msg_namelen = addrlens[i];
+    }
+    msgs[i].msg_hdr.msg_iov = &bufs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  int result = error_wrapper(::recvmmsg(s, msgs,
+        static_cast<unsigned int>(count), flags, 0), ec);
+  if (result >= 0)
+  {
+    for (int i = 0; i < result; ++i)
+    {
+      lengths[i] = msgs[i].msg_len;
+      if (addrs)
+        addrlens[i] = msgs[i].msg_hdr.msg_namelen;
+    }
+    ec = boost::system::error_code();
+    return result;
+  }
+
+  // Fall back to receiving one datagram at a time if the kernel does not
+  // support the system call.
+  if (ec.value() != ENOSYS)
+    return result;
+#endif // defined(BOOST_ASIO_HAS_MMSG)
+
+  // Stop at the first failure. Errors that occur after one or more datagrams
+  // have been received will be reported by the next call.
+  size_t i = 0;
+  for (; i < count; ++i)
+  {
+    std::size_t addrlen = addrs ? addrlens[i] : 0;
+    int bytes = socket_ops::recvfrom(s, &bufs[i], 1,
+        flags, addrs ? addrs[i] : 0, &addrlen, ec);
+    if (bytes < 0)
+      break;
+    lengths[i] = bytes;
+    if (addrs)
+      addrlens[i] = addrlen;
+  }
+  if (i == 0 && count > 0)
+    return socket_error_retval;
+  ec = boost::system::error_code();
+  return static_cast<int>(i);
+}
+
+bool non_blocking_recvmmsg(socket_type s,
+    buf* bufs, size_t count, int flags,
+    socket_addr_type** addrs, std::size_t* addrlens, std::size_t* lengths,
+    boost::system::error_code& ec, size_t& messages_transferred)
+{
+  for (;;)
+  {
+    // Read some datagrams.
+    int messages = socket_ops::recvmmsg(s,
+        bufs, count, flags, addrs, addrlens, lengths, ec);
+
+    // Retry operation if interrupted by signal.
+    if (ec == boost::asio::error::interrupted)
+      continue;
+
+    // Check if we need to run the operation again.
+    if (ec == boost::asio::error::would_block
+        || ec == boost::asio::error::try_again)
+      return false;
+
+    // Operation is complete.
+    if (messages >= 0)
+    {
+      ec = boost::system::error_code();
+      messages_transferred = messages;
+    }
+    else
+      messages_transferred = 0;
+
+    return true;
+  }
+}
+
+#endif // !defined(BOOST_ASIO_HAS_IOCP)
+
 int recvmsg(socket_type s, buf* bufs, size_t count,
     int in_flags, int& out_flags, boost::system::error_code& ec)
 {
@@ -1277,6 +1375,90 @@ bool non_blocking_sendto(socket_type s,
   }
 }
 
+int sendmmsg(socket_type s, const buf* bufs, size_t count, int flags,
+    const socket_addr_type* const* addrs, const std::size_t* addrlens,
+    boost::system::error_code& ec)
+{
+  if (count > max_mmsg_count)
+    count = max_mmsg_count;
+
+#if defined(BOOST_ASIO_HAS_MMSG)
+  clear_last_error();
+  mmsghdr msgs[max_mmsg_count];
+  for (size_t i = 0; i < count; ++i)
+  {
+    msgs[i] = mmsghdr();
+    if (addrs)
+    {
+      init_msghdr_msg_name(msgs[i].msg_hdr.msg_name, addrs[i]);
+      msgs[i].msg_hdr.msg_namelen = addrlens[i];
+    }
+    msgs[i].msg_hdr.msg_iov = const_cast<buf*>(&bufs[i]);
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  int result = error_wrapper(::sendmmsg(s, msgs,
+        static_cast<unsigned int>(count), flags | MSG_NOSIGNAL), ec);
+  if (result >= 0)
+  {
+    ec = boost::system::error_code();
+    return result;
+  }
+
+  // Fall back to sending one datagram at a time if the kernel does not
+  // support the system call.
+  if (ec.value() != ENOSYS)
+    return result;
+#endif // defined(BOOST_ASIO_HAS_MMSG)
+
+  // Stop at the first failure. Errors that occur after one or more datagrams
+  // have been sent will be reported by the next call.
+  size_t i = 0;
+  for (; i < count; ++i)
+  {
+    int bytes = socket_ops::sendto(s, &bufs[i], 1, flags,
+        addrs ? addrs[i] : 0, addrs ? addrlens[i] : 0, ec);
+    if (bytes < 0)
+      break;
+  }
+  if (i == 0 && count > 0)
+    return socket_error_retval;
+  ec = boost::system::error_code();
+  return static_cast<int>(i);
+}
+
+bool non_blocking_sendmmsg(socket_type s,
+    const buf* bufs, size_t count, int flags,
+    const socket_addr_type* const* addrs, const std::size_t* addrlens,
+    boost::system::error_code& ec, size_t& messages_transferred)
+{
+  for (;;)
+  {
+    // Write some datagrams.
+    int messages = socket_ops::sendmmsg(s,
+        bufs, count, flags, addrs, addrlens, ec);
+
+    // Retry operation if interrupted by signal.
+    if (ec == boost::asio::error::interrupted)
+      continue;
+
+    // Check if we need to run the operation again.
+    if (ec == boost::asio::error::would_block
+        || ec == boost::asio::error::try_again)
+      return false;
+
+    // Operation is complete.
+    if (messages >= 0)
+    {
+      ec = boost::system::error_code();
+      messages_transferred = messages;
+    }
+    else
+      messages_transferred = 0;
+
+    return true;
+  }
+}
+
 #endif // !defined(BOOST_ASIO_HAS_IOCP)
 
 socket_type socket(int af, int type, int protocol,
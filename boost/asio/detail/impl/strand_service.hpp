@@ -29,7 +29,8 @@ namespace detail {
 
 inline strand_service::strand_impl::strand_impl()
   : operation(&strand_service::do_complete),
-    locked_(false)
+    ref_count_(1),
+    state_(unlocked)
 {
 }
 
@@ -40,12 +41,7 @@ struct strand_service::on_dispatch_exit
 
   ~on_dispatch_exit()
   {
-    impl_->mutex_.lock();
-    impl_->ready_queue_.push(impl_->waiting_queue_);
-    bool more_handlers = impl_->locked_ = !impl_->ready_queue_.empty();
-    impl_->mutex_.unlock();
-
-    if (more_handlers)
+    if (strand_service::unlock(impl_))
       io_service_->post_immediate_completion(impl_);
   }
 };
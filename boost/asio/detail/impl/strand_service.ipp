@@ -32,119 +32,81 @@ struct strand_service::on_do_complete_exit
 
   ~on_do_complete_exit()
   {
-    impl_->mutex_.lock();
-    impl_->ready_queue_.push(impl_->waiting_queue_);
-    bool more_handlers = impl_->locked_ = !impl_->ready_queue_.empty();
-    impl_->mutex_.unlock();
-
-    if (more_handlers)
+    if (strand_service::unlock(impl_))
       owner_->post_private_immediate_completion(impl_);
   }
 };
 
 strand_service::strand_service(boost::asio::io_service& io_service)
   : boost::asio::detail::service_base<strand_service>(io_service),
-    io_service_(boost::asio::use_service<io_service_impl>(io_service)),
-    mutex_(),
-    salt_(0)
+    io_service_(boost::asio::use_service<io_service_impl>(io_service))
 {
 }
 
 void strand_service::shutdown_service()
 {
-  op_queue<operation> ops;
+  // A strand with pending handlers holds its lock and so has been scheduled
+  // with the io_service. The handlers are destroyed when the io_service
+  // destroys the strand's queued operation.
+}
 
-  boost::asio::detail::mutex::scoped_lock lock(mutex_);
+void strand_service::construct(strand_service::implementation_type& impl)
+{
+  impl = new strand_impl;
+}
 
-  for (std::size_t i = 0; i < num_implementations; ++i)
-  {
-    if (strand_impl* impl = implementations_[i].get())
-    {
-      ops.push(impl->waiting_queue_);
-      ops.push(impl->ready_queue_);
-    }
-  }
+void strand_service::copy_construct(strand_service::implementation_type& impl,
+    const strand_service::implementation_type& other_impl)
+{
+  impl = other_impl;
+  ++impl->ref_count_;
 }
 
-void strand_service::construct(strand_service::implementation_type& impl)
+void strand_service::destroy(strand_service::implementation_type& impl)
 {
-  boost::asio::detail::mutex::scoped_lock lock(mutex_);
-
-  std::size_t salt = salt_++;
-#if defined(BOOST_ASIO_ENABLE_SEQUENTIAL_STRAND_ALLOCATION)
-  std::size_t index = salt;
-#else // defined(BOOST_ASIO_ENABLE_SEQUENTIAL_STRAND_ALLOCATION)
-  std::size_t index = reinterpret_cast<std::size_t>(&impl);
-  index += (reinterpret_cast<std::size_t>(&impl) >> 3);
-  index ^= salt + 0x9e3779b9 + (index << 6) + (index >> 2);
-#endif // defined(BOOST_ASIO_ENABLE_SEQUENTIAL_STRAND_ALLOCATION)
-  index = index % num_implementations;
-
-  if (!implementations_[index].get())
-    implementations_[index].reset(new strand_impl);
-  impl = implementations_[index].get();
+  strand_impl* released = impl;
+  impl = 0;
+  release(released);
 }
 
 bool strand_service::do_dispatch(implementation_type& impl, operation* op)
 {
   // If we are running inside the io_service, and no other handler already
   // holds the strand lock, then the handler can run immediately.
-  bool can_dispatch = io_service_.can_dispatch();
-  impl->mutex_.lock();
-  if (can_dispatch && !impl->locked_)
+  if (io_service_.can_dispatch())
   {
-    // Immediate invocation is allowed.
-    impl->locked_ = true;
-    impl->mutex_.unlock();
-    return true;
+    std::size_t state = strand_impl::unlocked;
+    if (impl->state_.compare_exchange(state, strand_impl::locked))
+    {
+      // Immediate invocation is allowed.
+      ++impl->ref_count_;
+      return true;
+    }
   }
 
-  if (impl->locked_)
-  {
-    // Some other handler already holds the strand lock. Enqueue for later.
-    impl->waiting_queue_.push(op);
-    impl->mutex_.unlock();
-  }
-  else
-  {
-    // The handler is acquiring the strand lock and so is responsible for
-    // scheduling the strand.
-    impl->locked_ = true;
-    impl->mutex_.unlock();
-    impl->ready_queue_.push(op);
+  // If the handler acquires the strand lock then it is responsible for
+  // scheduling the strand.
+  if (enqueue(impl, op))
     io_service_.post_immediate_completion(impl);
-  }
 
   return false;
 }
 
 void strand_service::do_post(implementation_type& impl, operation* op)
 {
-  impl->mutex_.lock();
-  if (impl->locked_)
-  {
-    // Some other handler already holds the strand lock. Enqueue for later.
-    impl->waiting_queue_.push(op);
-    impl->mutex_.unlock();
-  }
-  else
-  {
-    // The handler is acquiring the strand lock and so is responsible for
-    // scheduling the strand.
-    impl->locked_ = true;
-    impl->mutex_.unlock();
-    impl->ready_queue_.push(op);
+  // If the handler acquires the strand lock then it is responsible for
+  // scheduling the strand.
+  if (enqueue(impl, op))
     io_service_.post_immediate_completion(impl);
-  }
 }
 
 void strand_service::do_complete(io_service_impl* owner, operation* base,
     const boost::system::error_code& ec, std::size_t /*bytes_transferred*/)
 {
+  strand_impl* impl = static_cast<strand_impl*>(base);
+
   if (owner)
   {
-    strand_impl* impl = static_cast<strand_impl*>(base);
-
     // Indicate that this strand is executing on the current thread.
     call_stack<strand_impl>::context ctx(impl);
 
@@ -160,6 +122,96 @@ void strand_service::do_complete(io_service_impl* owner, operation* base,
       o->complete(*owner, ec, 0);
     }
   }
+  else
+  {
+    // The io_service is being shut down. Destroy all pending handlers and
+    // give up the lock, along with the reference that it holds.
+    op_queue<operation> ops;
+    do
+      ops.push(impl->ready_queue_);
+    while (unlock(impl));
+  }
+}
+
+bool strand_service::enqueue(strand_impl* impl, operation* op)
+{
+  std::size_t state = impl->state_.load();
+  for (;;)
+  {
+    if (state == strand_impl::unlocked)
+    {
+      if (impl->state_.compare_exchange(state, strand_impl::locked))
+      {
+        ++impl->ref_count_;
+        impl->ready_queue_.push(op);
+        return true;
+      }
+    }
+    else
+    {
+      // Some other handler already holds the strand lock. Enqueue for later.
+      operation* next = reinterpret_cast<operation*>(
+          state & ~static_cast<std::size_t>(strand_impl::locked));
+      op_queue_access::next(op, next);
+      if (impl->state_.compare_exchange(state,
+            reinterpret_cast<std::size_t>(op) | strand_impl::locked))
+        return false;
+    }
+  }
+}
+
+bool strand_service::unlock(strand_impl* impl)
+{
+  std::size_t state = impl->state_.load();
+  for (;;)
+  {
+    if (state == strand_impl::locked)
+    {
+      // Handlers may remain in the ready queue if one of them has thrown an
+      // exception.
+      if (!impl->ready_queue_.empty())
+        return true;
+
+      // No handlers are waiting, so release the lock.
+      if (impl->state_.compare_exchange(state, strand_impl::unlocked))
+      {
+        release(impl);
+        return false;
+      }
+    }
+    else
+    {
+      // Take all waiting handlers, leaving the strand locked.
+      state = impl->state_.exchange(strand_impl::locked);
+      operation* waiting = reinterpret_cast<operation*>(
+          state & ~static_cast<std::size_t>(strand_impl::locked));
+
+      // The waiting handlers are linked most recent first, so reverse them
+      // to preserve the order in which they were enqueued.
+      operation* reversed = 0;
+      while (waiting)
+      {
+        operation* next = op_queue_access::next(waiting);
+        op_queue_access::next(waiting, reversed);
+        reversed = waiting;
+        waiting = next;
+      }
+      while (reversed)
+      {
+        operation* next = op_queue_access::next(reversed);
+        impl->ready_queue_.push(reversed);
+        reversed = next;
+      }
+
+      return true;
+    }
+  }
+}
+
+void strand_service::release(strand_impl* impl)
+{
+  if (--impl->ref_count_ == 0)
+    delete impl;
 }
 
 } // namespace detail
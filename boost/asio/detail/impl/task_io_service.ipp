@@ -20,6 +20,9 @@
 #if !defined(BOOST_ASIO_HAS_IOCP)
 
 #include <boost/limits.hpp>
+#if !defined(BOOST_WINDOWS) && !defined(__CYGWIN__)
+# include <unistd.h>
+#endif // !defined(BOOST_WINDOWS) && !defined(__CYGWIN__)
 #include <boost/asio/detail/event.hpp>
 #include <boost/asio/detail/reactor.hpp>
 #include <boost/asio/detail/task_io_service.hpp>
@@ -36,6 +39,26 @@ struct task_io_service::thread_info
   op_queue<operation> private_op_queue;
   long private_outstanding_work;
   thread_info* next;
+  std::size_t home_shard;
+  handler_stats::thread_stats* stats;
+};
+
+struct task_io_service::shard
+{
+  shard() : stopped_(false) {}
+
+  // Mutex to protect access to the shard's queue.
+  mutex mutex_;
+
+  // The queue of handlers that are ready to be delivered.
+  op_queue<operation> op_queue_;
+
+  // Mirrors the io_service's stopped flag so that it may be tested without
+  // locking the main mutex.
+  bool stopped_;
+
+  // Keep neighbouring shards off the same cache line.
+  char padding_[64];
 };
 
 struct task_io_service::task_cleanup
@@ -49,6 +72,7 @@ struct task_io_service::task_cleanup
           this_thread_->private_outstanding_work);
     }
     this_thread_->private_outstanding_work = 0;
+    task_io_service_->stats_.queued(this_thread_->private_op_queue);
 
     // Enqueue the completed operations and reinsert the task at the end of
     // the operation queue.
@@ -93,19 +117,86 @@ struct task_io_service::work_cleanup
   thread_info* this_thread_;
 };
 
+struct task_io_service::sharded_task_cleanup
+{
+  ~sharded_task_cleanup()
+  {
+    if (blocking_)
+      --task_io_service_->task_blocking_;
+
+    // Deliver the completed operations to their preferred queues and reinsert
+    // the task into the main queue.
+    task_io_service_->stats_.queued(this_thread_->private_op_queue);
+    task_io_service_->post_sharded(this_thread_->private_op_queue);
+
+    mutex::scoped_lock lock(task_io_service_->mutex_);
+    task_io_service_->task_interrupted_ = true;
+    task_io_service_->op_queue_.push(&task_io_service_->task_operation_);
+  }
+
+  task_io_service* task_io_service_;
+  thread_info* this_thread_;
+  bool blocking_;
+};
+
+struct task_io_service::sharded_work_cleanup
+{
+  ~sharded_work_cleanup()
+  {
+    task_io_service_->work_finished();
+  }
+
+  task_io_service* task_io_service_;
+};
+
 task_io_service::task_io_service(
     boost::asio::io_service& io_service, std::size_t concurrency_hint)
   : boost::asio::detail::service_base<task_io_service>(io_service),
+    concurrency_hint_(concurrency_hint),
     one_thread_(concurrency_hint == 1),
+    recycle_handler_memory_(
+        BOOST_ASIO_CONCURRENCY_HINT_IS_RECYCLE_MEMORY(concurrency_hint)),
+    stats_(),
     mutex_(),
     task_(0),
     task_interrupted_(true),
     outstanding_work_(0),
     stopped_(false),
     shutdown_(false),
-    first_idle_thread_(0)
+    first_idle_thread_(0),
+    num_idle_threads_(0),
+    shards_(0),
+    num_shards_(0),
+    next_home_shard_(0),
+    next_post_shard_(0),
+    task_blocking_(0)
 {
   BOOST_ASIO_HANDLER_TRACKING_INIT;
+
+#if defined(BOOST_HAS_THREADS) && !defined(BOOST_ASIO_DISABLE_THREADS)
+  if (BOOST_ASIO_CONCURRENCY_HINT_IS_WORK_STEALING(concurrency_hint))
+  {
+    num_shards_ = BOOST_ASIO_CONCURRENCY_HINT_QUEUES(concurrency_hint);
+# if defined(_SC_NPROCESSORS_ONLN)
+    if (num_shards_ == 0)
+    {
+      long num_cpus = ::sysconf(_SC_NPROCESSORS_ONLN);
+      if (num_cpus > 0)
+        num_shards_ = static_cast<std::size_t>(num_cpus);
+    }
+# endif // defined(_SC_NPROCESSORS_ONLN)
+    if (num_shards_ == 0)
+      num_shards_ = 16;
+    if (num_shards_ > BOOST_ASIO_CONCURRENCY_HINT_QUEUE_MASK)
+      num_shards_ = BOOST_ASIO_CONCURRENCY_HINT_QUEUE_MASK;
+    shards_ = new shard[num_shards_];
+  }
+#endif // defined(BOOST_HAS_THREADS) && !defined(BOOST_ASIO_DISABLE_THREADS)
+}
+
+task_io_service::~task_io_service()
+{
+  delete[] shards_;
 }
 
 void task_io_service::shutdown_service()
@@ -123,6 +214,15 @@ void task_io_service::shutdown_service()
       o->destroy();
   }
 
+  for (std::size_t i = 0; i < num_shards_; ++i)
+  {
+    while (operation* o = shards_[i].op_queue_.front())
+    {
+      shards_[i].op_queue_.pop();
+      o->destroy();
+    }
+  }
+
   // Reset to initial state.
   task_ = 0;
 }
@@ -152,7 +252,23 @@ std::size_t task_io_service::run(boost::system::error_code& ec)
   this_thread.wakeup_event = &wakeup_event;
   this_thread.private_outstanding_work = 0;
   this_thread.next = 0;
+  this_thread.home_shard = 0;
+  this_thread.stats = 0;
   thread_call_stack::context ctx(this, this_thread);
+  handler_memory_cache::thread_scope memory_scope(recycle_handler_memory_);
+  handler_stats::thread_scope stats_scope(stats_, this_thread.stats);
+
+  if (shards_)
+  {
+    this_thread.home_shard =
+      static_cast<std::size_t>(++next_home_shard_) % num_shards_;
+
+    std::size_t n = 0;
+    for (; do_run_one_sharded(this_thread, ec); )
+      if (n != (std::numeric_limits<std::size_t>::max)())
+        ++n;
+    return n;
+  }
 
   mutex::scoped_lock lock(mutex_);
 
@@ -177,7 +293,18 @@ std::size_t task_io_service::run_one(boost::system::error_code& ec)
   this_thread.wakeup_event = &wakeup_event;
   this_thread.private_outstanding_work = 0;
   this_thread.next = 0;
+  this_thread.home_shard = 0;
+  this_thread.stats = 0;
   thread_call_stack::context ctx(this, this_thread);
+  handler_memory_cache::thread_scope memory_scope(recycle_handler_memory_);
+  handler_stats::thread_scope stats_scope(stats_, this_thread.stats);
+
+  if (shards_)
+  {
+    this_thread.home_shard =
+      static_cast<std::size_t>(++next_home_shard_) % num_shards_;
+    return do_run_one_sharded(this_thread, ec);
+  }
 
   mutex::scoped_lock lock(mutex_);
 
@@ -197,7 +324,23 @@ std::size_t task_io_service::poll(boost::system::error_code& ec)
   this_thread.wakeup_event = 0;
   this_thread.private_outstanding_work = 0;
   this_thread.next = 0;
+  this_thread.home_shard = 0;
+  this_thread.stats = 0;
   thread_call_stack::context ctx(this, this_thread);
+  handler_memory_cache::thread_scope memory_scope(recycle_handler_memory_);
+  handler_stats::thread_scope stats_scope(stats_, this_thread.stats);
+
+  if (shards_)
+  {
+    this_thread.home_shard =
+      static_cast<std::size_t>(++next_home_shard_) % num_shards_;
+
+    std::size_t n = 0;
+    for (; do_poll_one_sharded(this_thread, ec); )
+      if (n != (std::numeric_limits<std::size_t>::max)())
+        ++n;
+    return n;
+  }
 
   mutex::scoped_lock lock(mutex_);
 
@@ -230,7 +373,18 @@ std::size_t task_io_service::poll_one(boost::system::error_code& ec)
   this_thread.wakeup_event = 0;
   this_thread.private_outstanding_work = 0;
   this_thread.next = 0;
+  this_thread.home_shard = 0;
+  this_thread.stats = 0;
   thread_call_stack::context ctx(this, this_thread);
+  handler_memory_cache::thread_scope memory_scope(recycle_handler_memory_);
+  handler_stats::thread_scope stats_scope(stats_, this_thread.stats);
+
+  if (shards_)
+  {
+    this_thread.home_shard =
+      static_cast<std::size_t>(++next_home_shard_) % num_shards_;
+    return do_poll_one_sharded(this_thread, ec);
+  }
 
   mutex::scoped_lock lock(mutex_);
 
@@ -262,10 +416,22 @@ void task_io_service::reset()
 {
   mutex::scoped_lock lock(mutex_);
   stopped_ = false;
+  set_shards_stopped(false);
 }
 
 void task_io_service::post_immediate_completion(task_io_service::operation* op)
 {
+  stats_.queued(op);
+
+  if (shards_)
+  {
+    work_started();
+    op_queue<operation> ops;
+    ops.push(op);
+    post_sharded(ops);
+    return;
+  }
+
 #if defined(BOOST_HAS_THREADS) && !defined(BOOST_ASIO_DISABLE_THREADS)
   if (one_thread_)
   {
@@ -286,6 +452,16 @@ void task_io_service::post_immediate_completion(task_io_service::operation* op)
 
 void task_io_service::post_deferred_completion(task_io_service::operation* op)
 {
+  stats_.queued(op);
+
+  if (shards_)
+  {
+    op_queue<operation> ops;
+    ops.push(op);
+    post_sharded(ops);
+    return;
+  }
+
 #if defined(BOOST_HAS_THREADS) && !defined(BOOST_ASIO_DISABLE_THREADS)
   if (one_thread_)
   {
@@ -307,6 +483,14 @@ void task_io_service::post_deferred_completions(
 {
   if (!ops.empty())
   {
+    stats_.queued(ops);
+
+    if (shards_)
+    {
+      post_sharded(ops);
+      return;
+    }
+
 #if defined(BOOST_HAS_THREADS) && !defined(BOOST_ASIO_DISABLE_THREADS)
     if (one_thread_)
     {
@@ -334,6 +518,16 @@ void task_io_service::post_private_immediate_completion(
 void task_io_service::post_private_deferred_completion(
     task_io_service::operation* op)
 {
+  stats_.queued(op);
+
+  if (shards_)
+  {
+    op_queue<operation> ops;
+    ops.push(op);
+    post_sharded(ops);
+    return;
+  }
+
 #if defined(BOOST_HAS_THREADS) && !defined(BOOST_ASIO_DISABLE_THREADS)
   if (thread_info* this_thread = thread_call_stack::contains(this))
   {
@@ -357,6 +551,16 @@ void task_io_service::post_non_private_immediate_completion(
 void task_io_service::post_non_private_deferred_completion(
     task_io_service::operation* op)
 {
+  stats_.queued(op);
+
+  if (shards_)
+  {
+    op_queue<operation> ops;
+    ops.push(op);
+    post_sharded(ops);
+    return;
+  }
+
   mutex::scoped_lock lock(mutex_);
   op_queue_.push(op);
   wake_one_thread_and_unlock(lock);
@@ -415,6 +619,11 @@ std::size_t task_io_service::do_run_one(mutex::scoped_lock& lock,
         work_cleanup on_exit = { this, &lock, &this_thread };
         (void)on_exit;
 
+        // Record the invocation if statistics are enabled.
+        handler_stats::invocation stats_invocation(
+            stats_, this_thread.stats, o);
+        (void)stats_invocation;
+
         // Complete the operation. May throw an exception. Deletes the object.
         o->complete(*this, ec, task_result);
 
@@ -426,6 +635,7 @@ std::size_t task_io_service::do_run_one(mutex::scoped_lock& lock,
       // Nothing to run right now, so just wait for work to do.
       this_thread.next = first_idle_thread_;
       first_idle_thread_ = &this_thread;
+      ++num_idle_threads_;
       this_thread.wakeup_event->clear(lock);
       this_thread.wakeup_event->wait(lock);
     }
@@ -479,22 +689,262 @@ std::size_t task_io_service::do_poll_one(mutex::scoped_lock& lock,
   work_cleanup on_exit = { this, &lock, &this_thread };
   (void)on_exit;
 
+  // Record the invocation if statistics are enabled.
+  handler_stats::invocation stats_invocation(stats_, this_thread.stats, o);
+  (void)stats_invocation;
+
+  // Complete the operation. May throw an exception. Deletes the object.
+  o->complete(*this, ec, task_result);
+
+  return 1;
+}
+
+void task_io_service::set_shard_affinity(task_io_service::operation* op)
+{
+  if (thread_info* this_thread = thread_call_stack::contains(this))
+    op->affinity_ = static_cast<unsigned int>(this_thread->home_shard + 1);
+}
+
+std::size_t task_io_service::do_run_one_sharded(
+    task_io_service::thread_info& this_thread,
+    const boost::system::error_code& ec)
+{
+  for (;;)
+  {
+    if (operation* o = pop_sharded(this_thread))
+    {
+      std::size_t task_result = o->task_result_;
+
+      // Ensure the count of outstanding work is decremented on block exit.
+      sharded_work_cleanup on_exit = { this };
+      (void)on_exit;
+
+      // Record the invocation if statistics are enabled.
+      handler_stats::invocation stats_invocation(
+          stats_, this_thread.stats, o);
+      (void)stats_invocation;
+
+      // Complete the operation. May throw an exception. Deletes the object.
+      o->complete(*this, ec, task_result);
+
+      return 1;
+    }
+
+    mutex::scoped_lock lock(mutex_);
+
+    if (stopped_)
+      return 0;
+
+    if (!op_queue_.empty())
+    {
+      // The main queue holds only the task when using the work-stealing
+      // scheduler. All handlers live on the shards.
+      op_queue_.pop();
+      ++task_blocking_;
+      bool more_handlers = shards_have_work();
+      if (more_handlers)
+        --task_blocking_;
+      task_interrupted_ = more_handlers;
+      lock.unlock();
+
+      sharded_task_cleanup on_exit = { this, &this_thread, !more_handlers };
+      (void)on_exit;
+
+      // Run the task. May throw an exception. Only block if there are no
+      // handlers waiting on any shard.
+      task_->run(!more_handlers, this_thread.private_op_queue);
+    }
+    else
+    {
+      // Nothing to run right now, so register as idle. Handlers may have been
+      // added to a shard since we last looked, and the posting thread will
+      // only wake us if it can see that we are idle, so check again.
+      this_thread.next = first_idle_thread_;
+      first_idle_thread_ = &this_thread;
+      ++num_idle_threads_;
+      if (shards_have_work())
+      {
+        first_idle_thread_ = this_thread.next;
+        this_thread.next = 0;
+        --num_idle_threads_;
+        continue;
+      }
+
+      this_thread.wakeup_event->clear(lock);
+      this_thread.wakeup_event->wait(lock);
+    }
+  }
+}
+
+std::size_t task_io_service::do_poll_one_sharded(
+    task_io_service::thread_info& this_thread,
+    const boost::system::error_code& ec)
+{
+  operation* o = pop_sharded(this_thread);
+  if (o == 0)
+  {
+    mutex::scoped_lock lock(mutex_);
+
+    if (stopped_ || op_queue_.empty())
+      return 0;
+
+    op_queue_.pop();
+    lock.unlock();
+
+    {
+      sharded_task_cleanup c = { this, &this_thread, false };
+      (void)c;
+
+      // Run the task. May throw an exception. Never block when polling.
+      task_->run(false, this_thread.private_op_queue);
+    }
+
+    o = pop_sharded(this_thread);
+    if (o == 0)
+      return 0;
+  }
+
+  std::size_t task_result = o->task_result_;
+
+  // Ensure the count of outstanding work is decremented on block exit.
+  sharded_work_cleanup on_exit = { this };
+  (void)on_exit;
+
+  // Record the invocation if statistics are enabled.
+  handler_stats::invocation stats_invocation(stats_, this_thread.stats, o);
+  (void)stats_invocation;
+
   // Complete the operation. May throw an exception. Deletes the object.
   o->complete(*this, ec, task_result);
 
   return 1;
 }
 
+task_io_service::operation* task_io_service::pop_sharded(
+    task_io_service::thread_info& this_thread)
+{
+  for (std::size_t i = 0; i < num_shards_; ++i)
+  {
+    shard& s = shards_[(this_thread.home_shard + i) % num_shards_];
+    mutex::scoped_lock shard_lock(s.mutex_);
+    if (s.stopped_)
+      return 0;
+    if (operation* o = s.op_queue_.front())
+    {
+      s.op_queue_.pop();
+      bool more_handlers = !s.op_queue_.empty();
+      shard_lock.unlock();
+
+      // Let an idle thread share the remaining handlers.
+      if (more_handlers && num_idle_threads_ > 0)
+      {
+        mutex::scoped_lock lock(mutex_);
+        if (!wake_one_idle_thread_and_unlock(lock))
+          lock.unlock();
+      }
+
+      return o;
+    }
+  }
+  return 0;
+}
+
+bool task_io_service::shards_have_work()
+{
+  for (std::size_t i = 0; i < num_shards_; ++i)
+  {
+    mutex::scoped_lock shard_lock(shards_[i].mutex_);
+    if (!shards_[i].op_queue_.empty())
+      return true;
+  }
+  return false;
+}
+
+void task_io_service::post_sharded(op_queue<task_io_service::operation>& ops)
+{
+  if (ops.empty())
+    return;
+
+  thread_info* this_thread = thread_call_stack::contains(this);
+  std::size_t default_shard = this_thread ? this_thread->home_shard
+    : static_cast<std::size_t>(++next_post_shard_) % num_shards_;
+
+  // Operations without a preferred queue are pushed to the default shard as
+  // a single batch.
+  op_queue<operation> default_ops;
+  std::size_t num_ops = 0;
+  while (operation* o = ops.front())
+  {
+    ops.pop();
+    ++num_ops;
+    std::size_t target = o->affinity_ ? o->affinity_ - 1 : default_shard;
+    if (target == default_shard || target >= num_shards_)
+    {
+      default_ops.push(o);
+    }
+    else
+    {
+      mutex::scoped_lock shard_lock(shards_[target].mutex_);
+      shards_[target].op_queue_.push(o);
+    }
+  }
+
+  if (!default_ops.empty())
+  {
+    mutex::scoped_lock shard_lock(shards_[default_shard].mutex_);
+    shards_[default_shard].op_queue_.push(default_ops);
+  }
+
+  if (this_thread)
+  {
+    // The calling thread will get to its own queue eventually, so we only
+    // need to wake idle threads to steal the work.
+    bool woken = false;
+    for (; num_ops > 0 && num_idle_threads_ > 0; --num_ops)
+    {
+      mutex::scoped_lock lock(mutex_);
+      if (!wake_one_idle_thread_and_unlock(lock))
+        break;
+      woken = true;
+    }
+
+    // The calling thread may block before returning to its queue, so a task
+    // that is blocked waiting for events must be interrupted if there was no
+    // idle thread to take the work.
+    if (!woken && task_blocking_ > 0)
+    {
+      mutex::scoped_lock lock(mutex_);
+      wake_one_thread_and_unlock(lock);
+    }
+  }
+  else
+  {
+    mutex::scoped_lock lock(mutex_);
+    wake_one_thread_and_unlock(lock);
+  }
+}
+
+void task_io_service::set_shards_stopped(bool stopped)
+{
+  for (std::size_t i = 0; i < num_shards_; ++i)
+  {
+    mutex::scoped_lock shard_lock(shards_[i].mutex_);
+    shards_[i].stopped_ = stopped;
+  }
+}
+
 void task_io_service::stop_all_threads(
     mutex::scoped_lock& lock)
 {
   stopped_ = true;
+  set_shards_stopped(true);
 
   while (first_idle_thread_)
   {
     thread_info* idle_thread = first_idle_thread_;
     first_idle_thread_ = idle_thread->next;
     idle_thread->next = 0;
+    --num_idle_threads_;
     idle_thread->wakeup_event->signal(lock);
   }
 
@@ -513,6 +963,7 @@ bool task_io_service::wake_one_idle_thread_and_unlock(
     thread_info* idle_thread = first_idle_thread_;
     first_idle_thread_ = idle_thread->next;
     idle_thread->next = 0;
+    --num_idle_threads_;
     idle_thread->wakeup_event->signal_and_unlock(lock);
     return true;
   }
@@ -0,0 +1,162 @@
+//
+// detail/reactive_socket_recvmmsg_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_REACTIVE_SOCKET_RECVMMSG_OP_HPP
+#define BOOST_ASIO_DETAIL_REACTIVE_SOCKET_RECVMMSG_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <boost/utility/addressof.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/detail/bind_handler.hpp>
+#include <boost/asio/detail/fenced_block.hpp>
+#include <boost/asio/detail/reactor_op.hpp>
+#include <boost/asio/detail/socket_ops.hpp>
+#include <boost/asio/socket_base.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+template <typename MutableBufferSequence, typename Endpoint>
+class reactive_socket_recvmmsg_op_base : public reactor_op
+{
+public:
+  reactive_socket_recvmmsg_op_base(socket_type socket,
+      const MutableBufferSequence& buffers, Endpoint* endpoints,
+      std::size_t* lengths, socket_base::message_flags flags,
+      func_type complete_func)
+    : reactor_op(&reactive_socket_recvmmsg_op_base::do_perform, complete_func),
+      socket_(socket),
+      buffers_(buffers),
+      sender_endpoints_(endpoints),
+      lengths_(lengths),
+      flags_(flags)
+  {
+  }
+
+  static bool do_perform(reactor_op* base)
+  {
+    reactive_socket_recvmmsg_op_base* o(
+        static_cast<reactive_socket_recvmmsg_op_base*>(base));
+
+    // Each buffer in the sequence receives a single datagram.
+    socket_ops::buf bufs[socket_base::max_batch_size];
+    socket_addr_type* addrs[socket_base::max_batch_size];
+    std::size_t addrlens[socket_base::max_batch_size];
+    const std::size_t max_count = socket_base::max_batch_size;
+    std::size_t count = 0;
+    typename MutableBufferSequence::const_iterator iter = o->buffers_.begin();
+    typename MutableBufferSequence::const_iterator end = o->buffers_.end();
+    for (; iter != end && count < max_count; ++iter, ++count)
+    {
+      boost::asio::mutable_buffer buffer(*iter);
+      socket_ops::init_buf(bufs[count],
+          boost::asio::buffer_cast<void*>(buffer),
+          boost::asio::buffer_size(buffer));
+      if (o->sender_endpoints_)
+      {
+        addrs[count] = o->sender_endpoints_[count].data();
+        addrlens[count] = o->sender_endpoints_[count].capacity();
+      }
+    }
+
+    if (count == 0)
+    {
+      o->ec_ = boost::system::error_code();
+      o->bytes_transferred_ = 0;
+      return true;
+    }
+
+    bool result = socket_ops::non_blocking_recvmmsg(o->socket_,
+        bufs, count, o->flags_, o->sender_endpoints_ ? addrs : 0,
+        addrlens, o->lengths_, o->ec_, o->bytes_transferred_);
+
+    if (result && !o->ec_ && o->sender_endpoints_)
+      for (std::size_t i = 0; i < o->bytes_transferred_; ++i)
+        o->sender_endpoints_[i].resize(addrlens[i]);
+
+    return result;
+  }
+
+private:
+  socket_type socket_;
+  MutableBufferSequence buffers_;
+  Endpoint* sender_endpoints_;
+  std::size_t* lengths_;
+  socket_base::message_flags flags_;
+};
+
+template <typename MutableBufferSequence, typename Endpoint, typename Handler>
+class reactive_socket_recvmmsg_op :
+  public reactive_socket_recvmmsg_op_base<MutableBufferSequence, Endpoint>
+{
+public:
+  BOOST_ASIO_DEFINE_HANDLER_PTR(reactive_socket_recvmmsg_op);
+
+  reactive_socket_recvmmsg_op(socket_type socket,
+      const MutableBufferSequence& buffers, Endpoint* endpoints,
+      std::size_t* lengths, socket_base::message_flags flags,
+      Handler& handler)
+    : reactive_socket_recvmmsg_op_base<MutableBufferSequence, Endpoint>(
+        socket, buffers, endpoints, lengths, flags,
+        &reactive_socket_recvmmsg_op::do_complete),
+      handler_(BOOST_ASIO_MOVE_CAST(Handler)(handler))
+  {
+  }
+
+  static void do_complete(io_service_impl* owner, operation* base,
+      const boost::system::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    // Take ownership of the handler object.
+    reactive_socket_recvmmsg_op* o(
+        static_cast<reactive_socket_recvmmsg_op*>(base));
+    ptr p = { boost::addressof(o->handler_), o, o };
+
+    BOOST_ASIO_HANDLER_COMPLETION((o));
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder2<Handler, boost::system::error_code, std::size_t>
+      handler(o->handler_, o->ec_, o->bytes_transferred_);
+    p.h = boost::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      BOOST_ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_, handler.arg2_));
+      boost_asio_handler_invoke_helpers::invoke(handler, handler.handler_);
+      BOOST_ASIO_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_DETAIL_REACTIVE_SOCKET_RECVMMSG_OP_HPP
@@ -0,0 +1,151 @@
+//
+// detail/reactive_socket_send_file_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_REACTIVE_SOCKET_SEND_FILE_OP_HPP
+#define BOOST_ASIO_DETAIL_REACTIVE_SOCKET_SEND_FILE_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+
+#if defined(BOOST_ASIO_HAS_SEND_FILE)
+
+#include <boost/cstdint.hpp>
+#include <boost/utility/addressof.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/detail/bind_handler.hpp>
+#include <boost/asio/detail/descriptor_ops.hpp>
+#include <boost/asio/detail/fenced_block.hpp>
+#include <boost/asio/detail/reactor_op.hpp>
+#include <boost/asio/detail/socket_types.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+class reactive_socket_send_file_op_base : public reactor_op
+{
+public:
+  reactive_socket_send_file_op_base(socket_type socket, int file,
+      boost::uint64_t offset, std::size_t size, func_type complete_func)
+    : reactor_op(&reactive_socket_send_file_op_base::do_perform,
+        complete_func),
+      socket_(socket),
+      file_(file),
+      offset_(offset),
+      size_(size),
+      total_transferred_(0)
+  {
+  }
+
+  static bool do_perform(reactor_op* base)
+  {
+    reactive_socket_send_file_op_base* o(
+        static_cast<reactive_socket_send_file_op_base*>(base));
+
+    // Keep transferring data until the whole range has been sent, the socket's
+    // send buffer is full, or an error occurs.
+    while (o->total_transferred_ < o->size_)
+    {
+      std::size_t bytes = 0;
+      if (!descriptor_ops::non_blocking_send_file(o->socket_, o->file_,
+            o->offset_ + o->total_transferred_,
+            o->size_ - o->total_transferred_, o->ec_, bytes))
+        return false;
+
+      if (!o->ec_ && bytes == 0)
+        o->ec_ = boost::asio::error::eof;
+
+      if (o->ec_)
+      {
+        o->bytes_transferred_ = o->total_transferred_;
+        return true;
+      }
+
+      o->total_transferred_ += bytes;
+    }
+
+    o->ec_ = boost::system::error_code();
+    o->bytes_transferred_ = o->total_transferred_;
+    return true;
+  }
+
+private:
+  socket_type socket_;
+  int file_;
+  boost::uint64_t offset_;
+  std::size_t size_;
+  std::size_t total_transferred_;
+};
+
+template <typename Handler>
+class reactive_socket_send_file_op :
+  public reactive_socket_send_file_op_base
+{
+public:
+  BOOST_ASIO_DEFINE_HANDLER_PTR(reactive_socket_send_file_op);
+
+  reactive_socket_send_file_op(socket_type socket, int file,
+      boost::uint64_t offset, std::size_t size, Handler& handler)
+    : reactive_socket_send_file_op_base(socket, file, offset, size,
+        &reactive_socket_send_file_op::do_complete),
+      handler_(BOOST_ASIO_MOVE_CAST(Handler)(handler))
+  {
+  }
+
+  static void do_complete(io_service_impl* owner, operation* base,
+      const boost::system::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    // Take ownership of the handler object.
+    reactive_socket_send_file_op* o(
+        static_cast<reactive_socket_send_file_op*>(base));
+    ptr p = { boost::addressof(o->handler_), o, o };
+
+    BOOST_ASIO_HANDLER_COMPLETION((o));
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder2<Handler, boost::system::error_code, std::size_t>
+      handler(o->handler_, o->ec_, o->bytes_transferred_);
+    p.h = boost::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      BOOST_ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_, handler.arg2_));
+      boost_asio_handler_invoke_helpers::invoke(handler, handler.handler_);
+      BOOST_ASIO_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // defined(BOOST_ASIO_HAS_SEND_FILE)
+
+#endif // BOOST_ASIO_DETAIL_REACTIVE_SOCKET_SEND_FILE_OP_HPP
@@ -0,0 +1,179 @@
+//
+// detail/reactive_socket_sendmmsg_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_REACTIVE_SOCKET_SENDMMSG_OP_HPP
+#define BOOST_ASIO_DETAIL_REACTIVE_SOCKET_SENDMMSG_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <iterator>
+#include <boost/utility/addressof.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/detail/bind_handler.hpp>
+#include <boost/asio/detail/fenced_block.hpp>
+#include <boost/asio/detail/reactor_op.hpp>
+#include <boost/asio/detail/socket_ops.hpp>
+#include <boost/asio/socket_base.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+template <typename ConstBufferSequence, typename Endpoint>
+class reactive_socket_sendmmsg_op_base : public reactor_op
+{
+public:
+  reactive_socket_sendmmsg_op_base(socket_type socket,
+      const ConstBufferSequence& buffers, const Endpoint* endpoints,
+      socket_base::message_flags flags, func_type complete_func)
+    : reactor_op(&reactive_socket_sendmmsg_op_base::do_perform, complete_func),
+      socket_(socket),
+      buffers_(buffers),
+      destinations_(endpoints),
+      flags_(flags),
+      next_(buffers_.begin()),
+      sent_(0)
+  {
+  }
+
+  static bool do_perform(reactor_op* base)
+  {
+    reactive_socket_sendmmsg_op_base* o(
+        static_cast<reactive_socket_sendmmsg_op_base*>(base));
+
+    // Keep sending until every datagram has been sent, the socket's send
+    // buffer is full, or an error occurs.
+    const std::size_t max_count = socket_base::max_batch_size;
+    for (;;)
+    {
+      // Each buffer in the sequence is sent as a single datagram.
+      socket_ops::buf bufs[socket_base::max_batch_size];
+      const socket_addr_type* addrs[socket_base::max_batch_size];
+      std::size_t addrlens[socket_base::max_batch_size];
+      std::size_t count = 0;
+      std::size_t index = o->sent_;
+      typename ConstBufferSequence::const_iterator iter = o->next_;
+      typename ConstBufferSequence::const_iterator end = o->buffers_.end();
+      for (; iter != end && count < max_count; ++iter, ++index)
+      {
+        boost::asio::const_buffer buffer(*iter);
+        socket_ops::init_buf(bufs[count],
+            boost::asio::buffer_cast<const void*>(buffer),
+            boost::asio::buffer_size(buffer));
+        if (o->destinations_)
+        {
+          addrs[count] = o->destinations_[index].data();
+          addrlens[count] = o->destinations_[index].size();
+        }
+        ++count;
+      }
+
+      if (count == 0)
+      {
+        o->ec_ = boost::system::error_code();
+        o->bytes_transferred_ = o->sent_;
+        return true;
+      }
+
+      std::size_t messages = 0;
+      if (!socket_ops::non_blocking_sendmmsg(o->socket_,
+            bufs, count, o->flags_, o->destinations_ ? addrs : 0,
+            addrlens, o->ec_, messages))
+        return false;
+
+      if (o->ec_)
+      {
+        o->bytes_transferred_ = o->sent_;
+        return true;
+      }
+
+      // Resume from the first datagram that has not been sent.
+      o->sent_ += messages;
+      if (messages == count)
+        o->next_ = iter;
+      else
+        std::advance(o->next_, messages);
+    }
+  }
+
+private:
+  socket_type socket_;
+  ConstBufferSequence buffers_;
+  const Endpoint* destinations_;
+  socket_base::message_flags flags_;
+  typename ConstBufferSequence::const_iterator next_;
+  std::size_t sent_;
+};
+
+template <typename ConstBufferSequence, typename Endpoint, typename Handler>
+class reactive_socket_sendmmsg_op :
+  public reactive_socket_sendmmsg_op_base<ConstBufferSequence, Endpoint>
+{
+public:
+  BOOST_ASIO_DEFINE_HANDLER_PTR(reactive_socket_sendmmsg_op);
+
+  reactive_socket_sendmmsg_op(socket_type socket,
+      const ConstBufferSequence& buffers, const Endpoint* endpoints,
+      socket_base::message_flags flags, Handler& handler)
+    : reactive_socket_sendmmsg_op_base<ConstBufferSequence, Endpoint>(
+        socket, buffers, endpoints, flags,
+        &reactive_socket_sendmmsg_op::do_complete),
+      handler_(BOOST_ASIO_MOVE_CAST(Handler)(handler))
+  {
+  }
+
+  static void do_complete(io_service_impl* owner, operation* base,
+      const boost::system::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    // Take ownership of the handler object.
+    reactive_socket_sendmmsg_op* o(
+        static_cast<reactive_socket_sendmmsg_op*>(base));
+    ptr p = { boost::addressof(o->handler_), o, o };
+
+    BOOST_ASIO_HANDLER_COMPLETION((o));
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder2<Handler, boost::system::error_code, std::size_t>
+      handler(o->handler_, o->ec_, o->bytes_transferred_);
+    p.h = boost::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      BOOST_ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_, handler.arg2_));
+      boost_asio_handler_invoke_helpers::invoke(handler, handler.handler_);
+      BOOST_ASIO_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_DETAIL_REACTIVE_SOCKET_SENDMMSG_OP_HPP
@@ -125,6 +125,10 @@ typedef WSABUF buf;
 typedef iovec buf;
 #endif // defined(BOOST_WINDOWS) || defined(__CYGWIN__)
 
+// The maximum number of datagrams transferred by a single call to recvmmsg()
+// or sendmmsg().
+enum { max_mmsg_count = 64 };
+
 BOOST_ASIO_DECL void init_buf(buf& b, void* data, size_t size);
 
 BOOST_ASIO_DECL void init_buf(buf& b, const void* data, size_t size);
@@ -193,6 +197,22 @@ BOOST_ASIO_DECL bool non_blocking_recvmsg(socket_type s,
 
 #endif // defined(BOOST_ASIO_HAS_IOCP)
 
+#if !defined(BOOST_ASIO_HAS_IOCP)
+
+// Receive up to count datagrams, each into a single buffer. Returns the number
+// of datagrams received. The addrs array may be null if the source addresses
+// are not required. At most max_mmsg_count datagrams are received per call.
+BOOST_ASIO_DECL int recvmmsg(socket_type s, buf* bufs, size_t count,
+    int flags, socket_addr_type** addrs, std::size_t* addrlens,
+    std::size_t* lengths, boost::system::error_code& ec);
+
+BOOST_ASIO_DECL bool non_blocking_recvmmsg(socket_type s,
+    buf* bufs, size_t count, int flags,
+    socket_addr_type** addrs, std::size_t* addrlens, std::size_t* lengths,
+    boost::system::error_code& ec, size_t& messages_transferred);
+
+#endif // !defined(BOOST_ASIO_HAS_IOCP)
+
 BOOST_ASIO_DECL int send(socket_type s, const buf* bufs,
     size_t count, int flags, boost::system::error_code& ec);
 
@@ -229,6 +249,18 @@ BOOST_ASIO_DECL bool non_blocking_sendto(socket_type s,
     const socket_addr_type* addr, std::size_t addrlen,
     boost::system::error_code& ec, size_t& bytes_transferred);
 
+// Send up to count datagrams, each from a single buffer. Returns the number of
+// datagrams sent. The addrs array may be null if the socket is connected. At
+// most max_mmsg_count datagrams are sent per call.
+BOOST_ASIO_DECL int sendmmsg(socket_type s, const buf* bufs, size_t count,
+    int flags, const socket_addr_type* const* addrs,
+    const std::size_t* addrlens, boost::system::error_code& ec);
+
+BOOST_ASIO_DECL bool non_blocking_sendmmsg(socket_type s,
+    const buf* bufs, size_t count, int flags,
+    const socket_addr_type* const* addrs, const std::size_t* addrlens,
+    boost::system::error_code& ec, size_t& messages_transferred);
+
 #endif // !defined(BOOST_ASIO_HAS_IOCP)
 
 BOOST_ASIO_DECL socket_type socket(int af, int type, int protocol,
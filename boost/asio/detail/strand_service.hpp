@@ -17,10 +17,10 @@
 
 #include <boost/asio/detail/config.hpp>
 #include <boost/asio/io_service.hpp>
-#include <boost/asio/detail/mutex.hpp>
+#include <boost/asio/detail/atomic_count.hpp>
+#include <boost/asio/detail/atomic_word.hpp>
 #include <boost/asio/detail/op_queue.hpp>
 #include <boost/asio/detail/operation.hpp>
-#include <boost/asio/detail/scoped_ptr.hpp>
 
 #include <boost/asio/detail/push_options.hpp>
 
@@ -29,6 +29,13 @@ namespace asio {
 namespace detail {
 
 // Default service implementation for a strand.
+//
+// Each strand object owns its implementation, shared only with copies of
+// that strand object, so the BOOST_ASIO_STRAND_IMPLEMENTATIONS and
+// BOOST_ASIO_ENABLE_SEQUENTIAL_STRAND_ALLOCATION macros, which configured a
+// pool of shared implementations, no longer have any effect. The service
+// holds no implementations itself, so a strand may be destroyed after its
+// io_service.
 class strand_service
   : public boost::asio::detail::service_base<strand_service>
 {
@@ -41,7 +48,8 @@ private:
 
 public:
 
-  // The underlying implementation of a strand.
+  // The underlying implementation of a strand. Each strand object has its own
+  // implementation, shared only with copies of that strand object.
   class strand_impl
     : public operation
   {
@@ -54,22 +62,28 @@ public:
     friend struct on_do_complete_exit;
     friend struct on_dispatch_exit;
 
-    // Mutex to protect access to internal data.
-    boost::asio::detail::mutex mutex_;
-
-    // Indicates whether the strand is currently "locked" by a handler. This
-    // means that there is a handler upcall in progress, or that the strand
-    // itself has been scheduled in order to invoke some pending handlers.
-    bool locked_;
-
-    // The handlers that are waiting on the strand but should not be run until
-    // after the next time the strand is scheduled. This queue must only be
-    // modified while the mutex is locked.
-    op_queue<operation> waiting_queue_;
+    // Values of the state word. A locked strand with waiting handlers stores
+    // a pointer to the most recently enqueued handler with the locked bit set.
+    enum
+    {
+      unlocked = 0,
+      locked = 1
+    };
+
+    // The number of strand objects referring to the implementation, plus one
+    // while the strand is locked.
+    atomic_count ref_count_;
+
+    // Indicates whether the strand is currently "locked" by a handler, and
+    // holds the handlers that are waiting on the strand but should not be run
+    // until after the next time the strand is scheduled. The waiting handlers
+    // form a stack, linked most recent first, that is pushed without locking
+    // and taken in its entirety by the lock holder.
+    atomic_word state_;
 
     // The handlers that are ready to be run. Logically speaking, these are the
     // handlers that hold the strand's lock. The ready queue is only modified
-    // from within the strand and so may be accessed without locking the mutex.
+    // from within the strand and so may be accessed without synchronisation.
     op_queue<operation> ready_queue_;
   };
 
@@ -78,12 +92,22 @@ public:
   // Construct a new strand service for the specified io_service.
   BOOST_ASIO_DECL explicit strand_service(boost::asio::io_service& io_service);
 
-  // Destroy all user-defined handler objects owned by the service.
+  // Destroy all user-defined handler objects owned by the service. There are
+  // none, as pending handlers are owned by the strand's queued operation.
   BOOST_ASIO_DECL void shutdown_service();
 
   // Construct a new strand implementation.
   BOOST_ASIO_DECL void construct(implementation_type& impl);
 
+  // Construct a strand implementation that refers to the same strand as
+  // another.
+  BOOST_ASIO_DECL void copy_construct(implementation_type& impl,
+      const implementation_type& other_impl);
+
+  // Destroy a strand implementation. Does not use the service, which may
+  // already have been destroyed.
+  BOOST_ASIO_DECL static void destroy(implementation_type& impl);
+
   // Request the io_service to invoke the given handler.
   template <typename Handler>
   void dispatch(implementation_type& impl, Handler handler);
@@ -104,25 +128,23 @@ private:
       operation* base, const boost::system::error_code& ec,
       std::size_t bytes_transferred);
 
-  // The io_service implementation used to post completions.
-  io_service_impl& io_service_;
-
-  // Mutex to protect access to the array of implementations.
-  boost::asio::detail::mutex mutex_;
+  // Add a handler to the strand's waiting stack. Returns true if the handler
+  // instead acquired the strand lock, in which case it has been placed in the
+  // ready queue and the caller is responsible for scheduling the strand.
+  BOOST_ASIO_DECL static bool enqueue(strand_impl* impl, operation* op);
 
-  // Number of implementations shared between all strand objects.
-#if defined(BOOST_ASIO_STRAND_IMPLEMENTATIONS)
-  enum { num_implementations = BOOST_ASIO_STRAND_IMPLEMENTATIONS };
-#else // defined(BOOST_ASIO_STRAND_IMPLEMENTATIONS)
-  enum { num_implementations = 193 };
-#endif // defined(BOOST_ASIO_STRAND_IMPLEMENTATIONS)
+  // Release the strand lock held by the caller, unless there are handlers
+  // waiting on the strand. Returns true if the waiting handlers were moved to
+  // the ready queue, in which case the lock is retained and the caller is
+  // responsible for rescheduling the strand. If the lock is released the
+  // implementation may be destroyed.
+  BOOST_ASIO_DECL static bool unlock(strand_impl* impl);
 
-  // Pool of implementations.
-  scoped_ptr<strand_impl> implementations_[num_implementations];
+  // Drop a reference to the implementation, destroying it if it is the last.
+  BOOST_ASIO_DECL static void release(strand_impl* impl);
 
-  // Extra value used when hashing to prevent recycled memory locations from
-  // getting the same strand implementation.
-  std::size_t salt_;
+  // The io_service implementation used to post completions.
+  io_service_impl& io_service_;
 };
 
 } // namespace detail
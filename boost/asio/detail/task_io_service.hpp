@@ -23,6 +23,9 @@
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/detail/atomic_count.hpp>
 #include <boost/asio/detail/call_stack.hpp>
+#include <boost/asio/detail/concurrency_hint.hpp>
+#include <boost/asio/detail/handler_memory_cache.hpp>
+#include <boost/asio/detail/handler_stats.hpp>
 #include <boost/asio/detail/mutex.hpp>
 #include <boost/asio/detail/op_queue.hpp>
 #include <boost/asio/detail/reactor_fwd.hpp>
@@ -42,10 +45,15 @@ public:
   typedef task_io_service_operation operation;
 
   // Constructor. Specifies the number of concurrent threads that are likely to
-  // run the io_service. If set to 1 certain optimisation are performed.
+  // run the io_service. If set to 1 certain optimisation are performed. If set
+  // to a BOOST_ASIO_CONCURRENCY_HINT_WORK_STEALING_QUEUES value, each thread
+  // running the io_service uses its own queue of ready handlers.
   BOOST_ASIO_DECL task_io_service(boost::asio::io_service& io_service,
       std::size_t concurrency_hint = 0);
 
+  // Destructor.
+  BOOST_ASIO_DECL ~task_io_service();
+
   // Destroy all user-defined handler objects owned by the service.
   BOOST_ASIO_DECL void shutdown_service();
 
@@ -73,6 +81,18 @@ public:
   // Reset in preparation for a subsequent run invocation.
   BOOST_ASIO_DECL void reset();
 
+  // Enable or disable the recording of handler statistics.
+  void enable_statistics(bool enabled)
+  {
+    stats_.enable(enabled);
+  }
+
+  // Obtain a snapshot of the handler statistics.
+  io_service_statistics statistics() const
+  {
+    return stats_.snapshot();
+  }
+
   // Notify that some work has started.
   void work_started()
   {
@@ -86,6 +106,28 @@ public:
       stop();
   }
 
+  // Record the calling thread's queue as the preferred destination for the
+  // completion of the given operation. Only has an effect when using the
+  // work-stealing scheduler.
+  void set_affinity(operation* op)
+  {
+    if (shards_)
+      set_shard_affinity(op);
+  }
+
+  // Get the concurrency hint that was used to construct the io_service.
+  std::size_t concurrency_hint() const
+  {
+    return concurrency_hint_;
+  }
+
+  // Whether the task may be run again before all operations returned by its
+  // previous run have been dequeued.
+  bool task_runs_ahead() const
+  {
+    return shards_ != 0;
+  }
+
   // Return whether a handler can be dispatched immediately.
   bool can_dispatch()
   {
@@ -130,6 +172,10 @@ private:
   // Structure containing information about an idle thread.
   struct thread_info;
 
+  // Structure containing a queue of ready handlers used by the work-stealing
+  // scheduler.
+  struct shard;
+
   // Request invocation of the given operation, avoiding the thread-private
   // queue, and return immediately. Assumes that work_started() has not yet
   // been called for the operation.
@@ -161,6 +207,32 @@ private:
   BOOST_ASIO_DECL void wake_one_thread_and_unlock(
       mutex::scoped_lock& lock);
 
+  // Record the calling thread's shard in the operation.
+  BOOST_ASIO_DECL void set_shard_affinity(operation* op);
+
+  // Run at most one operation using the work-stealing scheduler. May block.
+  BOOST_ASIO_DECL std::size_t do_run_one_sharded(
+      thread_info& this_thread, const boost::system::error_code& ec);
+
+  // Poll for at most one operation using the work-stealing scheduler.
+  BOOST_ASIO_DECL std::size_t do_poll_one_sharded(
+      thread_info& this_thread, const boost::system::error_code& ec);
+
+  // Dequeue an operation from the calling thread's shard, or steal one from
+  // another shard if the thread's own shard is empty.
+  BOOST_ASIO_DECL operation* pop_sharded(thread_info& this_thread);
+
+  // Determine whether any shard holds an operation that is ready to run.
+  BOOST_ASIO_DECL bool shards_have_work();
+
+  // Distribute operations across the shards, honouring each operation's
+  // affinity, and wake idle threads to run them. Assumes that work_started()
+  // was previously called for each operation.
+  BOOST_ASIO_DECL void post_sharded(op_queue<operation>& ops);
+
+  // Mark all shards as stopped or running.
+  BOOST_ASIO_DECL void set_shards_stopped(bool stopped);
+
   // Helper class to perform task-related operations on block exit.
   struct task_cleanup;
   friend struct task_cleanup;
@@ -169,9 +241,25 @@ private:
   struct work_cleanup;
   friend struct work_cleanup;
 
+  // Helper classes to perform the equivalent operations for the work-stealing
+  // scheduler.
+  struct sharded_task_cleanup;
+  friend struct sharded_task_cleanup;
+  struct sharded_work_cleanup;
+  friend struct sharded_work_cleanup;
+
+  // The concurrency hint used to construct the io_service.
+  const std::size_t concurrency_hint_;
+
   // Whether to optimise for single-threaded use cases.
   const bool one_thread_;
 
+  // Whether threads running the io_service recycle handler memory.
+  const bool recycle_handler_memory_;
+
+  // The handler statistics recorded by threads running the io_service.
+  handler_stats stats_;
+
   // Mutex to protect access to internal data.
   mutable mutex mutex_;
 
@@ -204,6 +292,26 @@ private:
 
   // The threads that are currently idle.
   thread_info* first_idle_thread_;
+
+  // The number of threads that are currently idle. Used by the work-stealing
+  // scheduler to avoid locking the mutex when there is no thread to wake.
+  atomic_count num_idle_threads_;
+
+  // The per-thread queues used by the work-stealing scheduler, or 0 if the
+  // scheduler is not in use.
+  shard* shards_;
+
+  // The number of per-thread queues.
+  std::size_t num_shards_;
+
+  // Counters used to assign queues to threads and to operations posted from
+  // outside the io_service.
+  atomic_count next_home_shard_;
+  atomic_count next_post_shard_;
+
+  // Non-zero while a thread is running the task and may block waiting for
+  // events.
+  atomic_count task_blocking_;
 };
 
 } // namespace detail
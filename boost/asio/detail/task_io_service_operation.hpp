@@ -16,6 +16,7 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include <boost/system/error_code.hpp>
+#include <boost/asio/detail/handler_stats.hpp>
 #include <boost/asio/detail/handler_tracking.hpp>
 #include <boost/asio/detail/op_queue.hpp>
 #include <boost/asio/detail/task_io_service_fwd.hpp>
@@ -28,7 +29,9 @@ namespace detail {
 
 // Base class for all operations. A function pointer is used instead of virtual
 // functions to avoid the associated overhead.
-class task_io_service_operation BOOST_ASIO_INHERIT_TRACKED_HANDLER
+class task_io_service_operation
+  : public handler_stats::tracked_operation
+    BOOST_ASIO_ALSO_INHERIT_TRACKED_HANDLER
 {
 public:
   void complete(task_io_service& owner,
@@ -50,7 +53,8 @@ protected:
   task_io_service_operation(func_type func)
     : next_(0),
       func_(func),
-      task_result_(0)
+      task_result_(0),
+      affinity_(0)
   {
   }
 
@@ -66,6 +70,7 @@ private:
 protected:
   friend class task_io_service;
   unsigned int task_result_; // Passed into bytes transferred.
+  unsigned int affinity_; // Preferred queue plus one, or 0 for none.
 };
 
 } // namespace detail
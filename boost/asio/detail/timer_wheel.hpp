@@ -0,0 +1,509 @@
+//
+// detail/timer_wheel.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_TIMER_WHEEL_HPP
+#define BOOST_ASIO_DETAIL_TIMER_WHEEL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <cstddef>
+#include <boost/config.hpp>
+#include <boost/limits.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/asio/detail/chrono_time_traits.hpp>
+#include <boost/asio/detail/date_time_fwd.hpp>
+#include <boost/asio/detail/op_queue.hpp>
+#include <boost/asio/detail/timer_queue.hpp>
+#include <boost/asio/detail/timer_queue_base.hpp>
+#include <boost/asio/detail/wait_op.hpp>
+#include <boost/asio/error.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+
+template <typename Traits, long Resolution>
+struct timing_wheel_traits;
+
+namespace detail {
+
+// A hierarchical timing wheel. Timers are kept in intrusive lists hanging off
+// the wheel slots, so that scheduling and cancelling a timer are constant time
+// operations. Expiry times are rounded up to a whole number of ticks, where the
+// length of a tick is given by the Resolution template parameter in
+// microseconds. Timers never fire early, but may fire up to one tick late.
+template <typename Time_Traits, long Resolution>
+class timer_wheel
+  : public timer_queue_base
+{
+public:
+  // The time type.
+  typedef typename Time_Traits::time_type time_type;
+
+  // The duration type.
+  typedef typename Time_Traits::duration_type duration_type;
+
+  // Per-timer data.
+  class per_timer_data
+  {
+  public:
+    per_timer_data() : next_(0), prev_(0), list_(0) {}
+
+  private:
+    friend class timer_wheel;
+
+    // The operations waiting on the timer.
+    op_queue<wait_op> op_queue_;
+
+    // The tick at which the timer expires.
+    boost::uint64_t tick_;
+
+    // The wheel level that holds the timer.
+    std::size_t level_;
+
+    // Pointers to adjacent timers in the same slot.
+    per_timer_data* next_;
+    per_timer_data* prev_;
+
+    // The head of the list containing the timer, or 0 if not queued.
+    per_timer_data** list_;
+  };
+
+  // Constructor.
+  timer_wheel()
+    : origin_(Time_Traits::now()),
+      current_tick_(0),
+      ready_(0),
+      overflow_(0),
+      never_(0),
+      wakeup_tick_((std::numeric_limits<boost::uint64_t>::max)())
+  {
+    for (std::size_t level = 0; level < num_levels; ++level)
+      for (std::size_t slot = 0; slot < num_slots; ++slot)
+        slots_[level][slot] = 0;
+    for (std::size_t level = 0; level < num_counts; ++level)
+      level_count_[level] = 0;
+  }
+
+  // Add a new timer to the queue. Returns true if the timer expires before the
+  // reactor is next due to process the wheel, in which case the reactor's
+  // event demultiplexing function call may need to be interrupted and
+  // restarted.
+  bool enqueue_timer(const time_type& time, per_timer_data& timer, wait_op* op)
+  {
+    // Enqueue the timer object.
+    if (timer.list_ == 0)
+    {
+      if (this->is_positive_infinity(time))
+      {
+        // No wheel slot is required for timers that never expire.
+        timer.tick_ = (std::numeric_limits<boost::uint64_t>::max)();
+        link_timer(timer, &never_, unscheduled_level);
+      }
+      else
+      {
+        timer.tick_ = to_tick(time);
+        schedule_timer(timer);
+      }
+    }
+
+    // Enqueue the individual timer operation.
+    timer.op_queue_.push(op);
+
+    // Interrupt reactor only if the newly added timer expires before the
+    // reactor's next scheduled wakeup.
+    return timer.op_queue_.front() == op && timer.tick_ < wakeup_tick_;
+  }
+
+  // Whether there are no timers in the queue.
+  virtual bool empty() const
+  {
+    for (std::size_t level = 0; level < num_counts; ++level)
+      if (level_count_[level] != 0)
+        return false;
+    return true;
+  }
+
+  // Get the time until the wheel next needs to be processed.
+  virtual long wait_duration_msec(long max_duration) const
+  {
+    boost::int64_t usec = next_wakeup_usec();
+    if (usec < 0)
+      return max_duration;
+    if (usec == 0)
+      return 0;
+    boost::int64_t msec = (usec + 999) / 1000;
+    if (msec > max_duration)
+      return max_duration;
+    return static_cast<long>(msec);
+  }
+
+  // Get the time until the wheel next needs to be processed.
+  virtual long wait_duration_usec(long max_duration) const
+  {
+    boost::int64_t usec = next_wakeup_usec();
+    if (usec < 0)
+      return max_duration;
+    if (usec > max_duration)
+      return max_duration;
+    return static_cast<long>(usec);
+  }
+
+  // Dequeue all timers not later than the current time.
+  virtual void get_ready_timers(op_queue<operation>& ops)
+  {
+    while (per_timer_data* timer = ready_)
+    {
+      ops.push(timer->op_queue_);
+      unlink_timer(*timer);
+    }
+
+    if (!wheel_empty())
+    {
+      boost::int64_t usec = elapsed_usec(Time_Traits::now());
+      if (usec >= 0)
+        advance(static_cast<boost::uint64_t>(usec) / Resolution, ops);
+    }
+  }
+
+  // Dequeue all timers.
+  virtual void get_all_timers(op_queue<operation>& ops)
+  {
+    dequeue_all(&ready_, ops);
+    dequeue_all(&overflow_, ops);
+    dequeue_all(&never_, ops);
+    for (std::size_t level = 0; level < num_levels; ++level)
+      if (level_count_[level] != 0)
+        for (std::size_t slot = 0; slot < num_slots; ++slot)
+          dequeue_all(&slots_[level][slot], ops);
+  }
+
+  // Cancel and dequeue operations for the given timer.
+  std::size_t cancel_timer(per_timer_data& timer, op_queue<operation>& ops,
+      std::size_t max_cancelled = (std::numeric_limits<std::size_t>::max)())
+  {
+    std::size_t num_cancelled = 0;
+    if (timer.list_ != 0)
+    {
+      while (wait_op* op = (num_cancelled != max_cancelled)
+          ? timer.op_queue_.front() : 0)
+      {
+        op->ec_ = boost::asio::error::operation_aborted;
+        timer.op_queue_.pop();
+        ops.push(op);
+        ++num_cancelled;
+      }
+      if (timer.op_queue_.empty())
+        unlink_timer(timer);
+    }
+    return num_cancelled;
+  }
+
+private:
+  enum
+  {
+    // Each level of the wheel has 2^slot_bits slots.
+    slot_bits = 8,
+    num_slots = 1 << slot_bits,
+    slot_mask = num_slots - 1,
+
+    // The number of levels. Timers further in the future than the wheel can
+    // represent are kept on an overflow list.
+    num_levels = 4,
+    overflow_level = num_levels,
+
+    // Timers on the ready and never-expiring lists.
+    unscheduled_level = num_levels + 1,
+
+    num_counts = num_levels + 2
+  };
+
+  // Get the number of microseconds between the origin and the given time.
+  boost::int64_t elapsed_usec(const time_type& time) const
+  {
+    return Time_Traits::to_posix_duration(
+        Time_Traits::subtract(time, origin_)).total_microseconds();
+  }
+
+  // Convert an absolute time into a tick, rounding up.
+  boost::uint64_t to_tick(const time_type& time) const
+  {
+    boost::int64_t usec = elapsed_usec(time);
+    if (usec <= 0)
+      return 0;
+    return (static_cast<boost::uint64_t>(usec) + Resolution - 1) / Resolution;
+  }
+
+  // Whether there are no timers in the wheel levels or on the overflow list.
+  bool wheel_empty() const
+  {
+    for (std::size_t level = 0; level <= overflow_level; ++level)
+      if (level_count_[level] != 0)
+        return false;
+    return true;
+  }
+
+  // Get the mask for the ticks covered by a single slot at the given level.
+  static boost::uint64_t level_mask(std::size_t level)
+  {
+    return (boost::uint64_t(1) << (level * slot_bits)) - 1;
+  }
+
+  // Add a timer to the front of a list.
+  void link_timer(per_timer_data& timer,
+      per_timer_data** list, std::size_t level)
+  {
+    timer.list_ = list;
+    timer.level_ = level;
+    timer.prev_ = 0;
+    timer.next_ = *list;
+    if (*list)
+      (*list)->prev_ = &timer;
+    *list = &timer;
+    ++level_count_[level];
+  }
+
+  // Remove a timer from the list that contains it.
+  void unlink_timer(per_timer_data& timer)
+  {
+    if (timer.prev_)
+      timer.prev_->next_ = timer.next_;
+    else
+      *timer.list_ = timer.next_;
+    if (timer.next_)
+      timer.next_->prev_ = timer.prev_;
+    --level_count_[timer.level_];
+    timer.next_ = 0;
+    timer.prev_ = 0;
+    timer.list_ = 0;
+  }
+
+  // Place a timer in the slot corresponding to its expiry tick.
+  void schedule_timer(per_timer_data& timer)
+  {
+    if (timer.tick_ < current_tick_)
+    {
+      // The tick has already been processed.
+      link_timer(timer, &ready_, unscheduled_level);
+      return;
+    }
+
+    boost::uint64_t delta = timer.tick_ - current_tick_;
+    std::size_t level = 0;
+    while (level < num_levels && delta > level_mask(level + 1))
+      ++level;
+
+    if (level == num_levels)
+    {
+      link_timer(timer, &overflow_, overflow_level);
+    }
+    else
+    {
+      std::size_t slot = static_cast<std::size_t>(
+          timer.tick_ >> (level * slot_bits)) & slot_mask;
+      link_timer(timer, &slots_[level][slot], level);
+    }
+  }
+
+  // Redistribute all timers on a list according to the current tick.
+  void reschedule_timers(per_timer_data** list)
+  {
+    per_timer_data* timer = *list;
+    *list = 0;
+    while (timer)
+    {
+      per_timer_data* next = timer->next_;
+      --level_count_[timer->level_];
+      timer->next_ = 0;
+      timer->prev_ = 0;
+      timer->list_ = 0;
+      schedule_timer(*timer);
+      timer = next;
+    }
+  }
+
+  // Move the timers in the current slot of a level down to the lower levels,
+  // continuing to the next level up each time a level wraps around.
+  void cascade(std::size_t level)
+  {
+    if (level == num_levels)
+    {
+      reschedule_timers(&overflow_);
+      return;
+    }
+
+    std::size_t slot = static_cast<std::size_t>(
+        current_tick_ >> (level * slot_bits)) & slot_mask;
+    reschedule_timers(&slots_[level][slot]);
+    if (slot == 0)
+      cascade(level + 1);
+  }
+
+  // Process all ticks up to and including the specified tick.
+  void advance(boost::uint64_t now_tick, op_queue<operation>& ops)
+  {
+    while (current_tick_ <= now_tick)
+    {
+      if (wheel_empty())
+      {
+        current_tick_ = now_tick + 1;
+        break;
+      }
+
+      std::size_t slot = static_cast<std::size_t>(current_tick_) & slot_mask;
+      if (slot == 0)
+        cascade(1);
+
+      while (per_timer_data* timer = slots_[0][slot])
+      {
+        ops.push(timer->op_queue_);
+        unlink_timer(*timer);
+      }
+
+      ++current_tick_;
+
+      // Skip ahead over ticks at which no timers can expire or cascade.
+      std::size_t level = 0;
+      while (level < num_levels && level_count_[level] == 0)
+        ++level;
+      boost::uint64_t mask = level_mask(level);
+      if ((current_tick_ & mask) != 0)
+      {
+        boost::uint64_t next = (current_tick_ | mask) + 1;
+        current_tick_ = next < now_tick + 1 ? next : now_tick + 1;
+      }
+    }
+  }
+
+  // Get the number of microseconds until the wheel next needs processing, or
+  // a negative value if there are no timers that will expire.
+  boost::int64_t next_wakeup_usec() const
+  {
+    boost::uint64_t tick = (std::numeric_limits<boost::uint64_t>::max)();
+
+    if (ready_)
+    {
+      wakeup_tick_ = 0;
+      return 0;
+    }
+
+    // Look for the first occupied slot in the lowest level.
+    if (level_count_[0] != 0)
+    {
+      for (std::size_t i = 0; i < num_slots; ++i)
+      {
+        if (slots_[0][(current_tick_ + i) & slot_mask])
+        {
+          tick = current_tick_ + i;
+          break;
+        }
+      }
+    }
+
+    // Timers on higher levels cannot expire before they are cascaded.
+    std::size_t level = 1;
+    while (level <= overflow_level && level_count_[level] == 0)
+      ++level;
+    if (level <= overflow_level)
+    {
+      boost::uint64_t mask = level_mask(level);
+      boost::uint64_t boundary = (current_tick_ & mask) == 0
+        ? current_tick_ : (current_tick_ | mask) + 1;
+      if (boundary < tick)
+        tick = boundary;
+    }
+
+    wakeup_tick_ = tick;
+    if (tick == (std::numeric_limits<boost::uint64_t>::max)())
+      return -1;
+
+    boost::int64_t usec = static_cast<boost::int64_t>(tick) * Resolution
+      - elapsed_usec(Time_Traits::now());
+    return usec > 0 ? usec : 0;
+  }
+
+  // Dequeue all timers on a list.
+  void dequeue_all(per_timer_data** list, op_queue<operation>& ops)
+  {
+    while (per_timer_data* timer = *list)
+    {
+      ops.push(timer->op_queue_);
+      unlink_timer(*timer);
+    }
+  }
+
+  // Determine if the specified absolute time is positive infinity.
+  template <typename Time_Type>
+  static bool is_positive_infinity(const Time_Type&)
+  {
+    return false;
+  }
+
+  // Determine if the specified absolute time is positive infinity.
+  template <typename T, typename TimeSystem>
+  static bool is_positive_infinity(
+      const boost::date_time::base_time<T, TimeSystem>& time)
+  {
+    return time.is_pos_infinity();
+  }
+
+  // The time corresponding to tick zero.
+  time_type origin_;
+
+  // The next tick to be processed.
+  boost::uint64_t current_tick_;
+
+  // The slots of each level of the wheel.
+  per_timer_data* slots_[num_levels][num_slots];
+
+  // Timers whose tick had already been processed when they were scheduled.
+  per_timer_data* ready_;
+
+  // Timers that are too far in the future to be placed in the wheel.
+  per_timer_data* overflow_;
+
+  // Timers that never expire.
+  per_timer_data* never_;
+
+  // The number of timers held at each level.
+  std::size_t level_count_[num_counts];
+
+  // The tick at which the reactor was last told to process the wheel.
+  mutable boost::uint64_t wakeup_tick_;
+};
+
+// Timing wheel traits select the timing wheel for deadline timers.
+template <typename Time_Traits, long Resolution>
+class timer_queue<timing_wheel_traits<Time_Traits, Resolution> >
+  : public timer_wheel<
+      timing_wheel_traits<Time_Traits, Resolution>, Resolution>
+{
+};
+
+// Timing wheel traits select the timing wheel for waitable timers.
+template <typename Clock, typename WaitTraits, long Resolution>
+class timer_queue<chrono_time_traits<Clock,
+    timing_wheel_traits<WaitTraits, Resolution> > >
+  : public timer_wheel<chrono_time_traits<Clock,
+      timing_wheel_traits<WaitTraits, Resolution> >, Resolution>
+{
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_DETAIL_TIMER_WHEEL_HPP
@@ -17,6 +17,7 @@
 
 #include <boost/asio/detail/config.hpp>
 #include <cstddef>
+#include <boost/asio/detail/handler_memory_cache.hpp>
 
 #include <boost/asio/detail/push_options.hpp>
 
@@ -32,10 +33,11 @@ namespace asio {
  * Implement asio_handler_allocate and asio_handler_deallocate for your own
  * handlers to provide custom allocation for these temporary objects.
  *
- * This default implementation is simply:
- * @code
- * return ::operator new(size);
- * @endcode
+ * The default implementation allocates memory using <tt>::operator new</tt>.
+ * If the io_service was constructed with the concurrency hint
+ * <tt>BOOST_ASIO_CONCURRENCY_HINT_RECYCLING_ALLOCATOR</tt>, each thread that
+ * runs the io_service keeps a cache of recently freed blocks, grouped by size,
+ * and memory is allocated from the calling thread's cache where possible.
  *
  * @note All temporary objects associated with a handler will be deallocated
  * before the upcall to the handler is performed. This allows the same memory to
@@ -59,7 +61,7 @@ namespace asio {
  */
 inline void* asio_handler_allocate(std::size_t size, ...)
 {
-  return ::operator new(size);
+  return detail::handler_memory_cache::allocate(size);
 }
 
 /// Default deallocation function for handlers.
@@ -67,17 +69,15 @@ inline void* asio_handler_allocate(std::size_t size, ...)
  * Implement asio_handler_allocate and asio_handler_deallocate for your own
  * handlers to provide custom allocation for the associated temporary objects.
  *
- * This default implementation is simply:
- * @code
- * ::operator delete(pointer);
- * @endcode
+ * The default implementation frees memory using <tt>::operator delete</tt>, or
+ * returns it to the calling thread's cache if the recycling allocator is in
+ * use.
  *
  * @sa asio_handler_allocate.
  */
 inline void asio_handler_deallocate(void* pointer, std::size_t size, ...)
 {
-  (void)(size);
-  ::operator delete(pointer);
+  detail::handler_memory_cache::deallocate(pointer, size);
 }
 
 } // namespace asio
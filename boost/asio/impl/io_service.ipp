@@ -120,6 +120,29 @@ void io_service::reset()
   impl_.reset();
 }
 
+void io_service::enable_statistics()
+{
+#if !defined(BOOST_ASIO_HAS_IOCP)
+  impl_.enable_statistics(true);
+#endif // !defined(BOOST_ASIO_HAS_IOCP)
+}
+
+void io_service::disable_statistics()
+{
+#if !defined(BOOST_ASIO_HAS_IOCP)
+  impl_.enable_statistics(false);
+#endif // !defined(BOOST_ASIO_HAS_IOCP)
+}
+
+io_service_statistics io_service::statistics() const
+{
+#if !defined(BOOST_ASIO_HAS_IOCP)
+  return impl_.statistics();
+#else // !defined(BOOST_ASIO_HAS_IOCP)
+  return io_service_statistics();
+#endif // !defined(BOOST_ASIO_HAS_IOCP)
+}
+
 void io_service::notify_fork(boost::asio::io_service::fork_event event)
 {
   service_registry_->notify_fork(event);
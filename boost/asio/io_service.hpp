@@ -19,9 +19,11 @@
 #include <cstddef>
 #include <stdexcept>
 #include <typeinfo>
+#include <boost/asio/detail/concurrency_hint.hpp>
 #include <boost/asio/detail/noncopyable.hpp>
 #include <boost/asio/detail/service_registry_fwd.hpp>
 #include <boost/asio/detail/wrapped_handler.hpp>
+#include <boost/asio/io_service_statistics.hpp>
 #include <boost/system/error_code.hpp>
 
 #if defined(BOOST_ASIO_HAS_IOCP)
@@ -212,6 +214,40 @@ public:
    *
    * @param concurrency_hint A suggestion to the implementation on how many
    * threads it should allow to run simultaneously.
+   *
+   * @note On platforms other than Windows, passing the value
+   * <tt>BOOST_ASIO_CONCURRENCY_HINT_WORK_STEALING_QUEUES(n)</tt> selects a
+   * scheduler where each thread that runs the io_service has its own queue of
+   * ready handlers, and takes handlers from other threads' queues only when
+   * its own queue is empty. Handlers posted from within a thread that is
+   * running the io_service are added to that thread's queue, and the
+   * completion of a reactor-based operation is delivered to the queue of the
+   * thread that started it. This reduces lock contention when many threads
+   * run a single io_service. The argument @c n specifies the number of
+   * queues, and should normally be the number of threads that will call
+   * run(), and may be at most 255; larger values are treated as 255. If @c n
+   * is 0, the number of processors is used.
+   *
+   * @note On Linux, passing
+   * <tt>BOOST_ASIO_CONCURRENCY_HINT_MULTI_REACTOR(n)</tt> distributes
+   * registered descriptors round-robin over @c n additional epoll instances,
+   * and <tt>BOOST_ASIO_CONCURRENCY_HINT_HASHED_MULTI_REACTOR(n)</tt>
+   * distributes them by descriptor value. The ready events of each instance
+   * are gathered by whichever thread is available, so that the processing of
+   * descriptor readiness is spread across the threads running the io_service.
+   * These values may be combined with the work-stealing hint using bitwise or.
+   * The number of instances @c n may be from 0 to 63; larger values are
+   * treated as 63.
+   *
+   * @note On platforms other than Windows, passing the value
+   * <tt>BOOST_ASIO_CONCURRENCY_HINT_RECYCLING_ALLOCATOR</tt> causes each call
+   * to run(), run_one(), poll() or poll_one() to keep a cache of the memory
+   * blocks used by handlers' operation objects, grouped by size. Blocks freed
+   * by the calling thread are reused by subsequent operations started on that
+   * thread, avoiding most calls to the global <tt>operator new</tt> for
+   * steady-state asynchronous operations. The cache is only used for handlers
+   * that do not provide their own @c asio_handler_allocate hook. This value
+   * may be combined with the other hints using bitwise or.
    */
   BOOST_ASIO_DECL explicit io_service(std::size_t concurrency_hint);
 
@@ -419,6 +455,46 @@ public:
    */
   BOOST_ASIO_DECL void reset();
 
+  /// Start recording handler statistics.
+  /**
+   * After this function is called, the io_service records the number of
+   * handlers it invokes for each type of asynchronous operation, the time each
+   * operation's handler spends queued waiting to be invoked, and the time taken
+   * to execute each handler. Each thread running the io_service records into
+   * its own counters, so that the cost of recording is a few reads of a
+   * monotonic clock per handler. The statistics may be obtained using the
+   * statistics() function.
+   *
+   * Handlers that are invoked directly by dispatch(), rather than being queued,
+   * are not recorded.
+   *
+   * While recording is disabled, its cost is a single relaxed atomic load per
+   * handler.
+   *
+   * @note Handler statistics are not supported on Windows when using I/O
+   * completion ports, or when @c BOOST_ASIO_DISABLE_HANDLER_STATISTICS is
+   * defined. In these cases this function has no effect.
+   */
+  BOOST_ASIO_DECL void enable_statistics();
+
+  /// Stop recording handler statistics.
+  /**
+   * The statistics recorded so far are retained, and recording resumes from
+   * them if enable_statistics() is called again.
+   */
+  BOOST_ASIO_DECL void disable_statistics();
+
+  /// Obtain a snapshot of the handler statistics.
+  /**
+   * This function may be called from any thread, including while other
+   * threads are running the io_service. Counts being updated concurrently may
+   * be slightly out of date.
+   *
+   * @returns The statistics recorded since enable_statistics() was first
+   * called. The snapshot is empty if statistics have never been enabled.
+   */
+  BOOST_ASIO_DECL io_service_statistics statistics() const;
+
   /// Request the io_service to invoke the given handler.
   /**
    * This function is used to ask the io_service to execute the given handler.
@@ -0,0 +1,237 @@
+//
+// io_service_statistics.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_IO_SERVICE_STATISTICS_HPP
+#define BOOST_ASIO_IO_SERVICE_STATISTICS_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <cstddef>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail { class handler_stats; }
+
+/// A snapshot of the handler statistics recorded by an io_service.
+/**
+ * The io_service::statistics() function returns an object of this class. The
+ * snapshot holds, for each type of asynchronous operation, the number of
+ * handlers invoked, a histogram of the time each handler spent queued waiting
+ * to be invoked, and a histogram of the time taken to execute each handler.
+ *
+ * The values are cumulative from the first call to
+ * io_service::enable_statistics(). The statistics for an interval may be found
+ * by subtracting one snapshot from another.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Unsafe.
+ */
+class io_service_statistics
+{
+public:
+  /// A histogram of durations.
+  /**
+   * The durations are measured in nanoseconds and grouped into buckets whose
+   * limits are powers of two. Bucket @c i counts the durations that are at
+   * least <tt>2^i</tt> nanoseconds (or zero, for the first bucket) and less
+   * than bucket_limit(i). The last bucket also counts all longer durations.
+   */
+  class histogram
+  {
+  public:
+    /// The number of buckets in the histogram.
+    BOOST_STATIC_CONSTANT(std::size_t, bucket_count = 32);
+
+    /// Construct an empty histogram.
+    histogram()
+    {
+      for (std::size_t i = 0; i < bucket_count; ++i)
+        counts_[i] = 0;
+    }
+
+    /// Get the number of buckets in the histogram.
+    std::size_t size() const
+    {
+      return bucket_count;
+    }
+
+    /// Get the number of durations counted in a bucket.
+    boost::uint64_t operator[](std::size_t bucket) const
+    {
+      return counts_[bucket];
+    }
+
+    /// Get the exclusive upper limit of a bucket, in nanoseconds.
+    /**
+     * Returns the largest representable value for the last bucket.
+     */
+    static boost::uint64_t bucket_limit(std::size_t bucket)
+    {
+      if (bucket + 1 >= bucket_count)
+        return ~boost::uint64_t(0);
+      return boost::uint64_t(1) << (bucket + 1);
+    }
+
+    /// Get the total number of durations counted in the histogram.
+    boost::uint64_t count() const
+    {
+      boost::uint64_t total = 0;
+      for (std::size_t i = 0; i < bucket_count; ++i)
+        total += counts_[i];
+      return total;
+    }
+
+    /// Get an upper bound on a percentile of the durations, in nanoseconds.
+    /**
+     * @param p The percentile, between 0 and 100.
+     *
+     * @returns The limit of the bucket containing the specified percentile, or
+     * 0 if the histogram is empty.
+     */
+    boost::uint64_t percentile(double p) const
+    {
+      boost::uint64_t total = count();
+      if (total == 0)
+        return 0;
+      boost::uint64_t rank = static_cast<boost::uint64_t>(total * p / 100.0);
+      if (rank >= total)
+        rank = total - 1;
+      boost::uint64_t seen = 0;
+      for (std::size_t i = 0; i < bucket_count; ++i)
+      {
+        seen += counts_[i];
+        if (seen > rank)
+          return bucket_limit(i);
+      }
+      return bucket_limit(bucket_count - 1);
+    }
+
+    /// Add the counts from another histogram to this one.
+    histogram& operator+=(const histogram& other)
+    {
+      for (std::size_t i = 0; i < bucket_count; ++i)
+        counts_[i] += other.counts_[i];
+      return *this;
+    }
+
+  private:
+    friend class detail::handler_stats;
+    boost::uint64_t counts_[bucket_count];
+  };
+
+  /// The statistics recorded for one type of operation.
+  class operation
+  {
+  public:
+    /// Default constructor.
+    operation()
+      : object_type_(""),
+        name_(""),
+        count_(0)
+    {
+    }
+
+    /// Get the type of I/O object that started the operation, such as
+    /// @c "socket".
+    /**
+     * Returns an empty string for the io_service's internal operations, such
+     * as the execution of a strand's queued handlers.
+     */
+    const char* object_type() const
+    {
+      return object_type_;
+    }
+
+    /// Get the name of the operation, such as @c "async_receive".
+    const char* name() const
+    {
+      return name_;
+    }
+
+    /// Get the number of handlers invoked.
+    boost::uint64_t count() const
+    {
+      return count_;
+    }
+
+    /// Get the histogram of the time between the operation becoming ready and
+    /// its handler being invoked.
+    const histogram& queue_wait() const
+    {
+      return queue_wait_;
+    }
+
+    /// Get the histogram of the time taken to execute the handlers.
+    const histogram& execution() const
+    {
+      return execution_;
+    }
+
+  private:
+    friend class detail::handler_stats;
+    const char* object_type_;
+    const char* name_;
+    boost::uint64_t count_;
+    histogram queue_wait_;
+    histogram execution_;
+  };
+
+  /// Get the statistics for each type of operation.
+  const std::vector<operation>& operations() const
+  {
+    return operations_;
+  }
+
+  /// Get the total number of handlers invoked.
+  boost::uint64_t count() const
+  {
+    boost::uint64_t total = 0;
+    for (std::size_t i = 0; i < operations_.size(); ++i)
+      total += operations_[i].count();
+    return total;
+  }
+
+  /// Get the histogram of queue wait times for all operations.
+  histogram queue_wait() const
+  {
+    histogram h;
+    for (std::size_t i = 0; i < operations_.size(); ++i)
+      h += operations_[i].queue_wait();
+    return h;
+  }
+
+  /// Get the histogram of handler execution times for all operations.
+  histogram execution() const
+  {
+    histogram h;
+    for (std::size_t i = 0; i < operations_.size(); ++i)
+      h += operations_[i].execution();
+    return h;
+  }
+
+private:
+  friend class detail::handler_stats;
+  std::vector<operation> operations_;
+};
+
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_IO_SERVICE_STATISTICS_HPP
@@ -0,0 +1,39 @@
+//
+// posix/random_access_descriptor.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_POSIX_RANDOM_ACCESS_DESCRIPTOR_HPP
+#define BOOST_ASIO_POSIX_RANDOM_ACCESS_DESCRIPTOR_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+
+#if defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR) \
+  || defined(GENERATING_DOCUMENTATION)
+
+#include <boost/asio/posix/basic_random_access_descriptor.hpp>
+
+namespace boost {
+namespace asio {
+namespace posix {
+
+/// Typedef for the typical usage of a random-access descriptor.
+typedef basic_random_access_descriptor<> random_access_descriptor;
+
+} // namespace posix
+} // namespace asio
+} // namespace boost
+
+#endif // defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+       //   || defined(GENERATING_DOCUMENTATION)
+
+#endif // BOOST_ASIO_POSIX_RANDOM_ACCESS_DESCRIPTOR_HPP
@@ -499,6 +499,9 @@ public:
   BOOST_STATIC_CONSTANT(int, max_connections = SOMAXCONN);
 #endif
 
+  /// The maximum number of datagrams transferred by a single batch operation.
+  BOOST_STATIC_CONSTANT(int, max_batch_size = 64);
+
 protected:
   /// Protected destructor to prevent deletion through this type.
   ~socket_base()
@@ -96,15 +96,29 @@ public:
     service_.construct(impl_);
   }
 
+  /// Copy constructor.
+  /**
+   * Constructs a strand that refers to the same underlying strand as
+   * @c other. Handlers posted or dispatched through either object will not be
+   * executed concurrently.
+   */
+  strand(const strand& other)
+    : service_(other.service_)
+  {
+    service_.copy_construct(impl_, other.impl_);
+  }
+
   /// Destructor.
   /**
    * Destroys a strand.
    *
    * Handlers posted through the strand that have not yet been invoked will
    * still be dispatched in a way that meets the guarantee of non-concurrency.
+   * A strand may be destroyed after its associated io_service.
    */
   ~strand()
   {
+    boost::asio::detail::strand_service::destroy(impl_);
   }
 
   /// Get the io_service associated with the strand.
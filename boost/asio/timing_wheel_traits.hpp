@@ -0,0 +1,75 @@
+//
+// timing_wheel_traits.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_TIMING_WHEEL_TRAITS_HPP
+#define BOOST_ASIO_TIMING_WHEEL_TRAITS_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <boost/asio/detail/timer_wheel.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+
+/// Traits adapter that selects a hierarchical timing wheel for timers.
+/**
+ * By default, the pending waits for all timers of a given type are kept in a
+ * binary heap ordered by expiry time, so that scheduling and cancelling a wait
+ * is O(log n) in the number of timers. Wrapping the time traits (for
+ * basic_deadline_timer) or wait traits (for basic_waitable_timer) in
+ * timing_wheel_traits instead keeps the timers in a hierarchical timing wheel,
+ * where these operations are O(1).
+ *
+ * Expiry times are rounded up to the wheel's resolution. Timers never complete
+ * early, but may complete up to one tick late. The timing wheel is therefore
+ * best suited to large numbers of coarse-grained timeouts that are usually
+ * cancelled before they expire.
+ *
+ * @par Example
+ * A deadline timer that uses a timing wheel with the default resolution of one
+ * millisecond:
+ * @code
+ * typedef boost::asio::basic_deadline_timer<boost::posix_time::ptime,
+ *   boost::asio::timing_wheel_traits<
+ *     boost::asio::time_traits<boost::posix_time::ptime> > > wheel_timer;
+ * @endcode
+ * A steady timer that uses a timing wheel with a resolution of ten
+ * milliseconds:
+ * @code
+ * typedef boost::asio::basic_waitable_timer<boost::chrono::steady_clock,
+ *   boost::asio::timing_wheel_traits<
+ *     boost::asio::wait_traits<boost::chrono::steady_clock>, 10000> >
+ *       wheel_steady_timer;
+ * @endcode
+ *
+ * @tparam Traits The time traits or wait traits to be adapted.
+ *
+ * @tparam Resolution The length of a tick of the timing wheel, in
+ * microseconds.
+ */
+template <typename Traits, long Resolution = 1000>
+struct timing_wheel_traits
+  : Traits
+{
+  /// The length of a tick of the timing wheel, in microseconds.
+  BOOST_STATIC_CONSTANT(long, resolution = Resolution);
+};
+
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_TIMING_WHEEL_TRAITS_HPP
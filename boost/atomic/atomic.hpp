@@ -9,6 +9,10 @@
 
 #include <cstddef>
 #include <boost/cstdint.hpp>
+#if defined(BOOST_HAS_STDINT_H)
+// For intptr_t and uintptr_t, which <boost/cstdint.hpp> does not provide.
+#include <stdint.h>
+#endif
 
 #include <boost/memory_order.hpp>
 
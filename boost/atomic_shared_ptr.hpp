@@ -0,0 +1,16 @@
+#ifndef BOOST_ATOMIC_SHARED_PTR_HPP_INCLUDED
+#define BOOST_ATOMIC_SHARED_PTR_HPP_INCLUDED
+
+//
+//  atomic_shared_ptr.hpp
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+//  See http://www.boost.org/libs/smart_ptr/atomic_shared_ptr.html for documentation.
+//
+
+#include <boost/smart_ptr/atomic_shared_ptr.hpp>
+
+#endif  // #ifndef BOOST_ATOMIC_SHARED_PTR_HPP_INCLUDED
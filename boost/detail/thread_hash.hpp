@@ -0,0 +1,79 @@
+#ifndef BOOST_DETAIL_THREAD_HASH_HPP_INCLUDED
+#define BOOST_DETAIL_THREAD_HASH_HPP_INCLUDED
+
+// MS compatible compilers support #pragma once
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+# pragma once
+#endif
+
+//
+//  boost/detail/thread_hash.hpp - hash value of the calling thread
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+//  std::size_t current_thread_hash();
+//
+//  Returns a well mixed value that identifies the calling thread, for
+//  spreading threads over per-thread slots, stripes or caches. Two threads
+//  may have the same hash, so it must only be used to reduce contention,
+//  never for correctness.
+//
+//  The address of a thread-local variable is hashed where the compiler
+//  supports one; define BOOST_DETAIL_NO_THREAD_KEYWORD to prevent this.
+//  Otherwise the address of a local variable is used, as the stacks of
+//  different threads are disjoint; a thread may then change hash from time
+//  to time.
+//
+
+#include <boost/config.hpp>
+#include <cstddef>
+
+#if !defined( BOOST_DETAIL_NO_THREAD_KEYWORD )
+# if defined( _MSC_VER )
+#  define BOOST_DETAIL_THREAD_KEYWORD __declspec(thread)
+# elif defined( __GNUC__ ) && !defined( __APPLE__ )
+#  define BOOST_DETAIL_THREAD_KEYWORD __thread
+# endif
+#endif
+
+namespace boost
+{
+
+namespace detail
+{
+
+inline std::size_t current_thread_hash()
+{
+#if defined( BOOST_DETAIL_THREAD_KEYWORD )
+
+    static BOOST_DETAIL_THREAD_KEYWORD char marker;
+    std::size_t id = reinterpret_cast< std::size_t >( &marker );
+
+#else
+
+    char marker;
+    std::size_t id = reinterpret_cast< std::size_t >( &marker ) >> 16;
+
+#endif
+
+    // the finalizer of MurmurHash3, after folding in the upper half of a
+    // 64 bit address
+
+    id ^= ( id >> 16 ) >> 16;
+    id ^= id >> 16;
+    id *= 0x85ebca6bU;
+    id ^= id >> 13;
+    id *= 0xc2b2ae35U;
+    id ^= id >> 16;
+
+    return id;
+}
+
+} // namespace detail
+
+} // namespace boost
+
+#endif // #ifndef BOOST_DETAIL_THREAD_HASH_HPP_INCLUDED
@@ -51,12 +51,16 @@ using boost::memory_order_acquire;
 using boost::memory_order_consume;
 using boost::memory_order_relaxed;
 using boost::memory_order_release;
+using boost::memory_order_seq_cst;
+using boost::atomic_thread_fence;
 #else
 using std::atomic;
 using std::memory_order_acquire;
 using std::memory_order_consume;
 using std::memory_order_relaxed;
 using std::memory_order_release;
+using std::memory_order_seq_cst;
+using std::atomic_thread_fence;
 #endif
 
 }
@@ -0,0 +1,317 @@
+//  epoch-based memory reclamation
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_LOCKFREE_DETAIL_EPOCH_RECLAMATION_HPP_INCLUDED
+#define BOOST_LOCKFREE_DETAIL_EPOCH_RECLAMATION_HPP_INCLUDED
+
+#include <cstddef>
+
+#include <boost/config.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/detail/thread_hash.hpp>
+
+#include <boost/lockfree/detail/atomic.hpp>
+#include <boost/lockfree/detail/prefix.hpp>
+#include <boost/lockfree/detail/tagged_ptr.hpp>
+
+namespace boost    {
+namespace lockfree {
+namespace detail   {
+
+/** Epoch-based reclamation of objects that have been unlinked from a lock-free data structure.
+ *
+ *  Each operation on the data structure is enclosed in a \c guard, which announces the global epoch that was current
+ *  when the operation started. An unlinked object is retired with the epoch that is current after it has been
+ *  unlinked. The global epoch is only advanced when all guards have announced the current epoch, so once it is two
+ *  epochs ahead of an object, no guard that may have seen the object is alive any more and the object is passed to
+ *  the reclaim function.
+ *
+ *  The guards claim one of RecordCount records with an atomic exchange, starting at a record selected by the calling
+ *  thread. If all records are claimed, an additional record is allocated and kept until the domain is destroyed.
+ *  Retired objects are kept in three lists per record, one per epoch modulo three. They are linked through their
+ *  first bytes in the same way as freelist_stack links free nodes, so a data structure that tolerates its nodes
+ *  being pushed to a freelist_stack while other threads still access them tolerates their retirement, too. Every
+ *  few guards, a thread tries to advance the epoch and reclaims the objects of records that are not claimed, so
+ *  objects retired by a thread that has finished are reclaimed as well.
+ *
+ *  Entering and leaving a guard is lock-free. A thread that is preempted inside a guard keeps the global epoch from
+ *  advancing, so retired objects accumulate until it resumes, but it does not keep other threads from making
+ *  progress.
+ *
+ *  See K. Fraser, "Practical lock-freedom", PhD thesis, University of Cambridge, 2004.
+ * */
+template <std::size_t RecordCount = 16>
+class epoch_domain:
+    boost::noncopyable
+{
+    struct retired_object
+    {
+        tagged_ptr<retired_object> next;
+    };
+
+    struct limbo_list
+    {
+        std::size_t epoch;
+        retired_object * objects;
+    };
+
+    struct record
+    {
+        record(void):
+            next(NULL)
+        {
+            claimed.store(false, memory_order_relaxed);
+            state.store(0, memory_order_relaxed);
+            for (int i = 0; i != 3; ++i) {
+                limbo[i].epoch = 0;
+                limbo[i].objects = NULL;
+            }
+            holds_objects.store(false, memory_order_relaxed);
+            scan_countdown = scan_interval;
+        }
+
+        atomic<bool> claimed;
+
+        /* (epoch << 1) | 1 while inside a guard, 0 otherwise */
+        atomic<std::size_t> state;
+
+        /* whether the limbo lists hold objects, which lets other threads find records to clean up */
+        atomic<bool> holds_objects;
+
+        /* accessed only by the thread that has claimed the record */
+        limbo_list limbo[3];
+        std::size_t scan_countdown;
+
+        /* the list of additional records */
+        record * next;
+
+        /* avoid false sharing with the next record */
+        char padding[BOOST_LOCKFREE_CACHELINE_BYTES];
+    };
+
+    /* the number of guards of a record between two attempts to advance the epoch */
+    static const std::size_t scan_interval = 32;
+
+public:
+    typedef void (*reclaim_function)(void * context, void * object);
+
+    /** Construct an epoch_domain, which passes reclaimed objects to reclaim(context, object). */
+    epoch_domain(reclaim_function reclaim, void * context):
+        reclaim_(reclaim), context_(context)
+    {
+        global_epoch_.store(0, memory_order_relaxed);
+        additional_records_.store(NULL, memory_order_relaxed);
+    }
+
+    /** Destroys the epoch_domain and reclaims all retired objects.
+     *
+     * \pre no guard of the domain is alive
+     * */
+    ~epoch_domain(void)
+    {
+        for (std::size_t i = 0; i != RecordCount; ++i)
+            reclaim_all(records_[i]);
+
+        record * r = additional_records_.load(memory_order_relaxed);
+        while (r) {
+            record * next = r->next;
+            reclaim_all(*r);
+            delete r;
+            r = next;
+        }
+    }
+
+    /** Encloses an operation on the data structure. Objects that may still be accessed by the operation are not
+     *  reclaimed before the guard is destroyed.
+     * */
+    class guard:
+        boost::noncopyable
+    {
+    public:
+        explicit guard(epoch_domain & domain):
+            domain_(domain), record_(domain.enter())
+        {}
+
+        ~guard(void)
+        {
+            domain_.leave(record_);
+        }
+
+        /** Retires an object that has been unlinked from the data structure. The object has to be at least as large
+         *  as a tagged_ptr, its first bytes are overwritten.
+         * */
+        void retire(void * object)
+        {
+            domain_.retire(record_, object);
+        }
+
+    private:
+        epoch_domain & domain_;
+        record & record_;
+    };
+
+    bool is_lock_free(void) const
+    {
+        return global_epoch_.is_lock_free() && records_[0].state.is_lock_free() &&
+               records_[0].claimed.is_lock_free() && additional_records_.is_lock_free();
+    }
+
+private:
+    record & claim(void)
+    {
+        std::size_t start = boost::detail::current_thread_hash();
+        for (std::size_t i = 0; i != RecordCount; ++i) {
+            record & r = records_[(start + i) % RecordCount];
+            if (!r.claimed.exchange(true, memory_order_acquire))
+                return r;
+        }
+
+        record * additional = additional_records_.load(memory_order_acquire);
+        for (record * r = additional; r; r = r->next) {
+            if (!r->claimed.exchange(true, memory_order_acquire))
+                return *r;
+        }
+
+        record * r = new record;
+        r->claimed.store(true, memory_order_relaxed);
+        r->next = additional;
+        while (!additional_records_.compare_exchange_weak(r->next, r))
+            ;
+        return *r;
+    }
+
+    record & enter(void)
+    {
+        record & r = claim();
+        std::size_t epoch = global_epoch_.load(memory_order_relaxed);
+        r.state.store((epoch << 1) | 1, memory_order_relaxed);
+
+        /* the announcement has to be visible to threads advancing the epoch before this thread reads any pointer
+         * from the data structure */
+        atomic_thread_fence(memory_order_seq_cst);
+
+        if (--r.scan_countdown == 0) {
+            r.scan_countdown = scan_interval;
+            try_advance();
+            reclaim_unclaimed();
+        }
+
+        if (r.holds_objects.load(memory_order_relaxed))
+            reclaim_expired(r, global_epoch_.load(memory_order_acquire));
+        return r;
+    }
+
+    void leave(record & r)
+    {
+        r.state.store(0, memory_order_release);
+        r.claimed.store(false, memory_order_release);
+    }
+
+    void retire(record & r, void * object)
+    {
+        /* the epoch has to be read after the object has been unlinked */
+        atomic_thread_fence(memory_order_seq_cst);
+        std::size_t epoch = global_epoch_.load(memory_order_relaxed);
+
+        limbo_list & list = r.limbo[epoch % 3];
+        if (list.epoch != epoch) {
+            /* the list holds objects that have been retired at least three epochs ago */
+            reclaim_list(list);
+            list.epoch = epoch;
+        }
+
+        retired_object * retired = reinterpret_cast<retired_object*>(object);
+        retired->next.set_ptr(list.objects);
+        list.objects = retired;
+        r.holds_objects.store(true, memory_order_relaxed);
+    }
+
+    /* advances the global epoch, if all guards have announced the current epoch */
+    void try_advance(void)
+    {
+        std::size_t epoch = global_epoch_.load(memory_order_relaxed);
+        std::size_t current = (epoch << 1) | 1;
+
+        atomic_thread_fence(memory_order_seq_cst);
+        for (std::size_t i = 0; i != RecordCount; ++i) {
+            std::size_t state = records_[i].state.load(memory_order_relaxed);
+            if (state != 0 && state != current)
+                return;
+        }
+
+        for (record * r = additional_records_.load(memory_order_acquire); r; r = r->next) {
+            std::size_t state = r->state.load(memory_order_relaxed);
+            if (state != 0 && state != current)
+                return;
+        }
+        atomic_thread_fence(memory_order_seq_cst);
+
+        global_epoch_.compare_exchange_strong(epoch, epoch + 1);
+    }
+
+    void reclaim_expired(record & r, std::size_t global_epoch)
+    {
+        bool holds_objects = false;
+        for (int i = 0; i != 3; ++i) {
+            limbo_list & list = r.limbo[i];
+            if (list.objects && list.epoch + 2 <= global_epoch)
+                reclaim_list(list);
+            holds_objects = holds_objects || list.objects;
+        }
+        r.holds_objects.store(holds_objects, memory_order_relaxed);
+    }
+
+    void reclaim_unclaimed(record & r, std::size_t global_epoch)
+    {
+        if (!r.holds_objects.load(memory_order_relaxed) || r.claimed.load(memory_order_relaxed))
+            return;
+        if (r.claimed.exchange(true, memory_order_acquire))
+            return;
+        reclaim_expired(r, global_epoch);
+        r.claimed.store(false, memory_order_release);
+    }
+
+    /* reclaims the expired objects of records that are not claimed by any thread */
+    void reclaim_unclaimed(void)
+    {
+        std::size_t global_epoch = global_epoch_.load(memory_order_acquire);
+        for (std::size_t i = 0; i != RecordCount; ++i)
+            reclaim_unclaimed(records_[i], global_epoch);
+
+        for (record * r = additional_records_.load(memory_order_acquire); r; r = r->next)
+            reclaim_unclaimed(*r, global_epoch);
+    }
+
+    void reclaim_all(record & r)
+    {
+        for (int i = 0; i != 3; ++i)
+            reclaim_list(r.limbo[i]);
+    }
+
+    void reclaim_list(limbo_list & list)
+    {
+        retired_object * object = list.objects;
+        list.objects = NULL;
+        while (object) {
+            retired_object * next = object->next.get_ptr();
+            reclaim_(context_, object);
+            object = next;
+        }
+    }
+
+    reclaim_function reclaim_;
+    void * context_;
+    atomic<std::size_t> global_epoch_;
+    char padding_[BOOST_LOCKFREE_CACHELINE_BYTES];
+    record records_[RecordCount];
+    atomic<record*> additional_records_;
+};
+
+} /* namespace detail */
+} /* namespace lockfree */
+} /* namespace boost */
+
+#endif /* BOOST_LOCKFREE_DETAIL_EPOCH_RECLAMATION_HPP_INCLUDED */
@@ -14,10 +14,12 @@
 #include <boost/array.hpp>
 #include <boost/config.hpp>
 #include <boost/cstdint.hpp>
+#include <boost/detail/thread_hash.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/static_assert.hpp>
 
 #include <boost/lockfree/detail/atomic.hpp>
+#include <boost/lockfree/detail/epoch_reclamation.hpp>
 #include <boost/lockfree/detail/parameter.hpp>
 #include <boost/lockfree/detail/tagged_ptr.hpp>
 
@@ -25,6 +27,14 @@ namespace boost    {
 namespace lockfree {
 namespace detail   {
 
+/* freelists that never return nodes to the allocator do not need to protect the operations of a data structure */
+struct no_operation_guard
+{
+    template <typename Freelist>
+    explicit no_operation_guard(Freelist const &)
+    {}
+};
+
 template <typename T,
           typename Alloc = std::allocator<T>
          >
@@ -40,6 +50,7 @@ class freelist_stack:
 
 public:
     typedef tagged_ptr<T> tagged_node_handle;
+    typedef no_operation_guard operation_guard;
 
     template <typename Allocator>
     freelist_stack (Allocator const & alloc, std::size_t n = 0):
@@ -244,6 +255,400 @@ private:
     atomic<tagged_node_ptr> pool_;
 };
 
+/** A freelist_stack with a front end of per-thread magazine caches.
+ *
+ *  Each thread is mapped to one of CacheCount caches, which holds up to 2 * MagazineSize free nodes, so that most
+ *  allocations and deallocations only touch the cache of the calling thread. A cache that runs empty is refilled
+ *  with a full magazine of MagazineSize nodes from a shared depot, a cache that runs full hands over a magazine to
+ *  the depot, each with a single compare-and-swap. Only if the depot is empty, nodes are taken from the underlying
+ *  freelist one at a time.
+ *
+ *  A thread claims its cache with an atomic exchange. If the cache is claimed by another thread, either because
+ *  both threads are mapped to it or because its owner has been preempted while holding it, the thread uses the
+ *  underlying freelist instead, so the cache does not introduce any blocking.
+ *
+ *  The magazines are allocated together with the nodes, so deallocating a node never allocates memory. A bounded
+ *  allocation that finds the freelist exhausted takes a node from any other cache that is not claimed at that time.
+ * */
+template <typename T,
+          typename Alloc = std::allocator<T>,
+          std::size_t CacheCount = 16,
+          std::size_t MagazineSize = 16
+         >
+class caching_freelist:
+    public freelist_stack<T, Alloc>
+{
+    typedef freelist_stack<T, Alloc> base_type;
+
+    struct magazine
+    {
+        /* overlaid by the freelist of the magazine stack */
+        tagged_ptr<magazine> link;
+        T * nodes[MagazineSize];
+    };
+
+    typedef typename Alloc::template rebind<magazine>::other magazine_allocator;
+
+    /* a lock-free stack of magazines, which is the freelist of magazines */
+    class magazine_stack:
+        public freelist_stack<magazine, magazine_allocator>
+    {
+        typedef freelist_stack<magazine, magazine_allocator> stack_base;
+
+    public:
+        template <typename Allocator>
+        magazine_stack(Allocator const & alloc, std::size_t n = 0):
+            stack_base(alloc, n)
+        {}
+
+        template <bool ThreadSafe>
+        magazine * pop(void)
+        {
+            return stack_base::template allocate<ThreadSafe, true>();
+        }
+
+        template <bool ThreadSafe>
+        void push(magazine * m)
+        {
+            stack_base::template deallocate<ThreadSafe>(m);
+        }
+    };
+
+    struct cache
+    {
+        atomic<bool> claimed;
+        std::size_t count;
+        T * nodes[2 * MagazineSize];
+
+        /* avoid false sharing with the next cache */
+        char padding[BOOST_LOCKFREE_CACHELINE_BYTES];
+    };
+
+public:
+    typedef typename base_type::tagged_node_handle tagged_node_handle;
+
+    template <typename Allocator>
+    caching_freelist (Allocator const & alloc, std::size_t n = 0):
+        base_type(alloc, n), full_(alloc), empty_(alloc, n / MagazineSize), node_count_(n)
+    {
+        for (std::size_t i = 0; i != CacheCount; ++i) {
+            caches_[i].claimed.store(false, memory_order_relaxed);
+            caches_[i].count = 0;
+        }
+    }
+
+    ~caching_freelist(void)
+    {
+        for (std::size_t i = 0; i != CacheCount; ++i) {
+            cache & c = caches_[i];
+            for (std::size_t j = 0; j != c.count; ++j)
+                base_type::template deallocate<false>(c.nodes[j]);
+        }
+
+        for (;;) {
+            magazine * m = full_.template pop<false>();
+            if (!m)
+                break;
+            for (std::size_t j = 0; j != MagazineSize; ++j)
+                base_type::template deallocate<false>(m->nodes[j]);
+            empty_.template push<false>(m);
+        }
+    }
+
+    template <bool ThreadSafe>
+    void reserve (std::size_t count)
+    {
+        base_type::template reserve<ThreadSafe>(count);
+        added_nodes<ThreadSafe>(count);
+    }
+
+    template <bool ThreadSafe, bool Bounded>
+    T * construct (void)
+    {
+        T * node = allocate<ThreadSafe, Bounded>();
+        if (node)
+            new(node) T();
+        return node;
+    }
+
+    template <bool ThreadSafe, bool Bounded, typename ArgumentType>
+    T * construct (ArgumentType const & arg)
+    {
+        T * node = allocate<ThreadSafe, Bounded>();
+        if (node)
+            new(node) T(arg);
+        return node;
+    }
+
+    template <bool ThreadSafe, bool Bounded, typename ArgumentType1, typename ArgumentType2>
+    T * construct (ArgumentType1 const & arg1, ArgumentType2 const & arg2)
+    {
+        T * node = allocate<ThreadSafe, Bounded>();
+        if (node)
+            new(node) T(arg1, arg2);
+        return node;
+    }
+
+    template <bool ThreadSafe>
+    void destruct (tagged_node_handle tagged_ptr)
+    {
+        T * n = tagged_ptr.get_ptr();
+        n->~T();
+        deallocate<ThreadSafe>(n);
+    }
+
+    template <bool ThreadSafe>
+    void destruct (T * n)
+    {
+        n->~T();
+        deallocate<ThreadSafe>(n);
+    }
+
+    bool is_lock_free(void) const
+    {
+        return base_type::is_lock_free() && full_.is_lock_free() && empty_.is_lock_free() &&
+               caches_[0].claimed.is_lock_free();
+    }
+
+protected: // allow use from subclasses
+    template <bool ThreadSafe, bool Bounded>
+    T * allocate (void)
+    {
+        T * node = 0;
+        if (ThreadSafe)
+            node = allocate_cached(this_thread_cache());
+
+        if (!node)
+            node = base_type::template allocate<ThreadSafe, true>();
+
+        if (!node && ThreadSafe && Bounded) {
+            for (std::size_t i = 0; i != CacheCount && !node; ++i)
+                node = allocate_cached(caches_[i]);
+        }
+
+        if (!node && !Bounded)
+            node = allocate_new<ThreadSafe>();
+
+        return node;
+    }
+
+    template <bool ThreadSafe>
+    void deallocate (T * n)
+    {
+        if (ThreadSafe) {
+            cache & c = this_thread_cache();
+            if (!c.claimed.exchange(true, memory_order_acquire)) {
+                if (c.count == 2 * MagazineSize && !flush(c)) {
+                    c.claimed.store(false, memory_order_release);
+                    base_type::template deallocate<ThreadSafe>(n);
+                    return;
+                }
+                c.nodes[c.count++] = n;
+                c.claimed.store(false, memory_order_release);
+                return;
+            }
+        }
+        base_type::template deallocate<ThreadSafe>(n);
+    }
+
+private:
+    cache & this_thread_cache(void)
+    {
+        return caches_[boost::detail::current_thread_hash() % CacheCount];
+    }
+
+    /* takes a node from the cache or refills the cache from the depot. returns 0 if the cache is claimed by another
+     * thread or if both cache and depot are empty */
+    T * allocate_cached(cache & c)
+    {
+        if (c.claimed.exchange(true, memory_order_acquire))
+            return 0;
+
+        T * node = 0;
+        if (c.count != 0 || refill(c))
+            node = c.nodes[--c.count];
+
+        c.claimed.store(false, memory_order_release);
+        return node;
+    }
+
+    bool refill(cache & c)
+    {
+        magazine * m = full_.template pop<true>();
+        if (!m)
+            return false;
+
+        for (std::size_t i = 0; i != MagazineSize; ++i)
+            c.nodes[i] = m->nodes[i];
+        c.count = MagazineSize;
+        empty_.template push<true>(m);
+        return true;
+    }
+
+    bool flush(cache & c)
+    {
+        magazine * m = empty_.template pop<true>();
+        if (!m)
+            return false;
+
+        c.count -= MagazineSize;
+        for (std::size_t i = 0; i != MagazineSize; ++i)
+            m->nodes[i] = c.nodes[c.count + i];
+        full_.template push<true>(m);
+        return true;
+    }
+
+    template <bool ThreadSafe>
+    T * allocate_new(void)
+    {
+        T * node = base_type::template allocate<ThreadSafe, false>();
+        added_nodes<ThreadSafe>(1);
+        return node;
+    }
+
+    /* keeps one magazine per MagazineSize nodes, so that a full cache always finds an empty magazine */
+    template <bool ThreadSafe>
+    void added_nodes(std::size_t count)
+    {
+        std::size_t old_count = node_count_.fetch_add(count, memory_order_relaxed);
+        std::size_t magazines = (old_count + count) / MagazineSize - old_count / MagazineSize;
+        if (magazines)
+            empty_.template reserve<ThreadSafe>(magazines);
+    }
+
+    cache caches_[CacheCount];
+    magazine_stack full_;
+    magazine_stack empty_;
+    atomic<std::size_t> node_count_;
+};
+
+/** A freelist_stack that returns nodes to the allocator.
+ *
+ *  Nodes that are destructed by thread-safe operations are retired to an epoch_domain and released once no
+ *  operation of the data structure can access them any more. Every thread-safe operation on the data structure has
+ *  to be enclosed in an operation_guard. Released nodes are kept in the freelist as long as it holds fewer nodes than
+ *  have been reserved (by the constructor or by reserve), all others are returned to the allocator.
+ * */
+template <typename T,
+          typename Alloc = std::allocator<T>
+         >
+class reclaiming_freelist:
+    public freelist_stack<T, Alloc>
+{
+    typedef freelist_stack<T, Alloc> base_type;
+    typedef epoch_domain<> domain_type;
+
+public:
+    typedef typename base_type::tagged_node_handle tagged_node_handle;
+
+    class operation_guard:
+        public domain_type::guard
+    {
+    public:
+        explicit operation_guard(reclaiming_freelist & freelist):
+            domain_type::guard(freelist.domain_)
+        {}
+    };
+
+    template <typename Allocator>
+    reclaiming_freelist (Allocator const & alloc, std::size_t n = 0):
+        base_type(alloc, n), alloc_(alloc), domain_(&release_node, this)
+    {
+        reserved_.store(n, memory_order_relaxed);
+        pooled_.store(n, memory_order_relaxed);
+    }
+
+    template <bool ThreadSafe>
+    void reserve (std::size_t count)
+    {
+        reserved_.fetch_add(count, memory_order_relaxed);
+        pooled_.fetch_add(count, memory_order_relaxed);
+        base_type::template reserve<ThreadSafe>(count);
+    }
+
+    template <bool ThreadSafe, bool Bounded>
+    T * construct (void)
+    {
+        T * node = allocate<ThreadSafe, Bounded>();
+        if (node)
+            new(node) T();
+        return node;
+    }
+
+    template <bool ThreadSafe, bool Bounded, typename ArgumentType>
+    T * construct (ArgumentType const & arg)
+    {
+        T * node = allocate<ThreadSafe, Bounded>();
+        if (node)
+            new(node) T(arg);
+        return node;
+    }
+
+    template <bool ThreadSafe, bool Bounded, typename ArgumentType1, typename ArgumentType2>
+    T * construct (ArgumentType1 const & arg1, ArgumentType2 const & arg2)
+    {
+        T * node = allocate<ThreadSafe, Bounded>();
+        if (node)
+            new(node) T(arg1, arg2);
+        return node;
+    }
+
+    template <bool ThreadSafe>
+    void destruct (tagged_node_handle tagged_ptr)
+    {
+        destruct<ThreadSafe>(tagged_ptr.get_ptr());
+    }
+
+    template <bool ThreadSafe>
+    void destruct (T * n)
+    {
+        n->~T();
+        if (ThreadSafe) {
+            typename domain_type::guard guard(domain_);
+            guard.retire(n);
+        } else
+            release(n);
+    }
+
+    bool is_lock_free(void) const
+    {
+        return base_type::is_lock_free() && domain_.is_lock_free();
+    }
+
+protected: // allow use from subclasses
+    template <bool ThreadSafe, bool Bounded>
+    T * allocate (void)
+    {
+        T * node = base_type::template allocate<ThreadSafe, true>();
+        if (node)
+            pooled_.fetch_sub(1, memory_order_relaxed);
+        else if (!Bounded)
+            node = alloc_.allocate(1);
+        return node;
+    }
+
+private:
+    static void release_node(void * context, void * node)
+    {
+        static_cast<reclaiming_freelist*>(context)->release(static_cast<T*>(node));
+    }
+
+    void release(T * n)
+    {
+        if (pooled_.fetch_add(1, memory_order_relaxed) < reserved_.load(memory_order_relaxed))
+            base_type::template deallocate<true>(n);
+        else {
+            pooled_.fetch_sub(1, memory_order_relaxed);
+            alloc_.deallocate(n, 1);
+        }
+    }
+
+    Alloc alloc_;
+    atomic<std::size_t> reserved_;
+    atomic<std::size_t> pooled_;
+    domain_type domain_;
+};
+
 class tagged_index
 {
 public:
@@ -392,6 +797,7 @@ class fixed_size_freelist:
 
 public:
     typedef tagged_index tagged_node_handle;
+    typedef no_operation_guard operation_guard;
 
     template <typename Allocator>
     fixed_size_freelist (Allocator const & alloc, std::size_t count):
@@ -588,7 +994,9 @@ template <typename T,
           typename Alloc,
           bool IsCompileTimeSized,
           bool IsFixedSize,
-          std::size_t Capacity
+          std::size_t Capacity,
+          bool IsThreadCached = false,
+          bool IsReclaiming = false
           >
 struct select_freelist
 {
@@ -597,9 +1005,17 @@ struct select_freelist
                                runtime_sized_freelist_storage<T, Alloc>
                               >::type fixed_sized_storage_type;
 
+    typedef typename mpl::if_c<IsReclaiming,
+                               reclaiming_freelist<T, Alloc>,
+                               typename mpl::if_c<IsThreadCached,
+                                                  caching_freelist<T, Alloc>,
+                                                  freelist_stack<T, Alloc>
+                                                 >::type
+                              >::type node_based_freelist_type;
+
     typedef typename mpl::if_c<IsCompileTimeSized || IsFixedSize,
                                fixed_size_freelist<T, fixed_sized_storage_type>,
-                               freelist_stack<T, Alloc>
+                               node_based_freelist_type
                               >::type type;
 };
 
@@ -65,6 +65,32 @@ struct extract_fixed_sized
     static const bool value = type::value;
 };
 
+template <typename bound_args>
+struct extract_thread_cached
+{
+    static const bool has_thread_cached = has_arg<bound_args, tag::thread_cached>::value;
+
+    typedef typename mpl::if_c<has_thread_cached,
+                               typename has_arg<bound_args, tag::thread_cached>::type,
+                               mpl::false_
+                              >::type type;
+
+    static const bool value = type::value;
+};
+
+template <typename bound_args>
+struct extract_reclaim_memory
+{
+    static const bool has_reclaim_memory = has_arg<bound_args, tag::reclaim_memory>::value;
+
+    typedef typename mpl::if_c<has_reclaim_memory,
+                               typename has_arg<bound_args, tag::reclaim_memory>::type,
+                               mpl::false_
+                              >::type type;
+
+    static const bool value = type::value;
+};
+
 
 } /* namespace detail */
 } /* namespace lockfree */
@@ -21,6 +21,8 @@ namespace lockfree {
 namespace tag { struct allocator ; }
 namespace tag { struct fixed_sized; }
 namespace tag { struct capacity; }
+namespace tag { struct thread_cached; }
+namespace tag { struct reclaim_memory; }
 
 #endif
 
@@ -45,6 +47,28 @@ struct capacity:
     boost::parameter::template_keyword<tag::capacity, boost::mpl::size_t<Size> >
 {};
 
+/** Places a \b thread-local cache in front of the freelist of a data structure.
+ *
+ *  Freed nodes are kept in a small cache that is selected by the calling thread and are handed between the caches in
+ *  batches, so that most node allocations and deallocations do not touch the shared freelist.
+ *  Has no effect on fixed-sized data structures.
+ * */
+template <bool IsThreadCached>
+struct thread_cached:
+    boost::parameter::template_keyword<tag::thread_cached, boost::mpl::bool_<IsThreadCached> >
+{};
+
+/** Configures a data structure to \b reclaim the memory of its nodes.
+ *
+ *  Nodes are returned to the allocator once no thread can access them any more, which is detected with epoch-based
+ *  reclamation, so the memory of a node-based data structure shrinks again after a burst of elements. Only as many
+ *  free nodes as have been reserved are kept in the freelist. Has no effect on fixed-sized data structures.
+ * */
+template <bool IsReclaiming>
+struct reclaim_memory:
+    boost::parameter::template_keyword<tag::reclaim_memory, boost::mpl::bool_<IsReclaiming> >
+{};
+
 /** Defines the \b allocator type of a data structure.
  * */
 template <class Alloc>
@@ -55,6 +55,17 @@ typedef parameter::parameters<boost::parameter::optional<tag::allocator>,
  *  - \ref boost::lockfree::allocator, defaults to \c boost::lockfree::allocator<std::allocator<void>> \n
  *    Specifies the allocator that is used for the internal freelist
  *
+ *  - \ref boost::lockfree::thread_cached, defaults to \c boost::lockfree::thread_cached<false> \n
+ *    Places per-thread caches of free nodes in front of the internal freelist, which reduces the contention on the
+ *    freelist when many threads push and pop. Nodes cached by one thread are not immediately available to other
+ *    threads, so the queue may hold more nodes than with a plain freelist. Has no effect on fixed-sized queues.
+ *
+ *  - \ref boost::lockfree::reclaim_memory, defaults to \c boost::lockfree::reclaim_memory<false> \n
+ *    Returns nodes to the allocator once no thread can access them any more, using epoch-based reclamation. Only as
+ *    many free nodes as have been reserved are kept in the freelist. Popped nodes become available to bounded
+ *    operations once they have been reclaimed. Has no effect on fixed-sized queues and takes
+ *    precedence over \c thread_cached.
+ *
  *  \b Requirements:
  *   - T must have a copy constructor
  *   - T must have a trivial assignment operator
@@ -79,6 +90,8 @@ private:
     static const bool has_capacity = detail::extract_capacity<bound_args>::has_capacity;
     static const size_t capacity = detail::extract_capacity<bound_args>::capacity;
     static const bool fixed_sized = detail::extract_fixed_sized<bound_args>::value;
+    static const bool thread_cached = detail::extract_thread_cached<bound_args>::value;
+    static const bool reclaim_memory = detail::extract_reclaim_memory<bound_args>::value;
     static const bool node_based = !(has_capacity || fixed_sized);
     static const bool compile_time_sized = has_capacity;
 
@@ -108,7 +121,8 @@ private:
     };
 
     typedef typename detail::extract_allocator<bound_args, node>::type node_allocator;
-    typedef typename detail::select_freelist<node, node_allocator, compile_time_sized, fixed_sized, capacity>::type pool_t;
+    typedef typename detail::select_freelist<node, node_allocator, compile_time_sized, fixed_sized, capacity,
+                                             thread_cached, reclaim_memory>::type pool_t;
     typedef typename pool_t::tagged_node_handle tagged_node_handle;
     typedef typename detail::select_tagged_handle<node, node_based>::handle_type handle_type;
 
@@ -269,6 +283,7 @@ private:
     {
         using detail::likely;
 
+        typename pool_t::operation_guard guard(pool);
         node * n = pool.template construct<true, Bounded>(t, pool.null_handle());
         handle_type node_handle = pool.get_handle(n);
 
@@ -357,6 +372,7 @@ public:
     bool pop (U & ret)
     {
         using detail::likely;
+        typename pool_t::operation_guard guard(pool);
         for (;;) {
             tagged_node_handle head = head_.load(memory_order_acquire);
             node * head_ptr = pool.get_pointer(head);
@@ -0,0 +1,585 @@
+//  lock-free segmented queue, distributing the slots of linked array segments
+//  between threads with fetch-and-add, after
+//  Morrison, A. and Afek, Y., "Fast concurrent queues for x86 processors"
+//  and Yang, C. and Mellor-Crummey, J., "A wait-free queue as fast as fetch-and-add"
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_LOCKFREE_SEGMENTED_QUEUE_HPP_INCLUDED
+#define BOOST_LOCKFREE_SEGMENTED_QUEUE_HPP_INCLUDED
+
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/has_trivial_assign.hpp>
+#include <boost/type_traits/has_trivial_destructor.hpp>
+
+#include <boost/lockfree/detail/atomic.hpp>
+#include <boost/lockfree/detail/branch_hints.hpp>
+#include <boost/lockfree/detail/copy_payload.hpp>
+#include <boost/lockfree/detail/freelist.hpp>
+#include <boost/lockfree/detail/parameter.hpp>
+#include <boost/lockfree/detail/tagged_ptr.hpp>
+
+namespace boost    {
+namespace lockfree {
+namespace detail   {
+
+typedef parameter::parameters<boost::parameter::optional<tag::allocator>,
+                              boost::parameter::optional<tag::capacity>
+                             > segmented_queue_signature;
+
+class segmented_queue_tester;
+
+} /* namespace detail */
+
+
+/** The segmented_queue class provides a multi-writer/multi-reader queue, pushing and popping is lock-free,
+ *  construction/destruction has to be synchronized.
+ *
+ *  Elements are stored in arrays of slots (segments), which are linked into a list. Instead of competing for the
+ *  head or tail of the queue, producers and consumers claim slots by advancing a per-segment index, so that
+ *  concurrent operations proceed on adjacent slots in parallel. Producers advance it with fetch-and-add, consumers
+ *  with compare-and-swap, as they must not claim a slot of a segment that has been recycled in the meantime. When
+ *  the tail segment is full, a new segment is appended. Segments are recycled via a freelist once all of their slots
+ *  have been consumed, and are not returned to the OS before the queue is destroyed.
+ *
+ *  Compared to \ref boost::lockfree::queue, no memory is allocated per element and far fewer compare-and-swap
+ *  operations fail under contention. In return, a pop that claims the slot of an element which is just being
+ *  written by a concurrent push has to wait for the push to complete.
+ *
+ *  \b Policies:
+ *  - \ref boost::lockfree::capacity, optional \n
+ *    If this template argument is passed to the options, the size of the queue is set at compile-time.\n
+ *    The segments for \c capacity elements are allocated when the queue is constructed and push operations fail
+ *    instead of allocating further segments. Slots that are skipped by concurrent pops are not reused, so a push
+ *    may fail slightly before \c capacity elements have been stored.
+ *
+ *  - \ref boost::lockfree::allocator, defaults to \c boost::lockfree::allocator<std::allocator<void>> \n
+ *    Specifies the allocator that is used for the segments
+ *
+ *  \b Requirements:
+ *   - T must have a default constructor
+ *   - T must have a copy constructor
+ *   - T must have a trivial assignment operator
+ *   - T must have a trivial destructor
+ *
+ * */
+#ifndef BOOST_DOXYGEN_INVOKED
+template <typename T,
+          class A0 = boost::parameter::void_,
+          class A1 = boost::parameter::void_>
+#else
+template <typename T, ...Options>
+#endif
+class segmented_queue:
+    boost::noncopyable
+{
+private:
+#ifndef BOOST_DOXYGEN_INVOKED
+    BOOST_STATIC_ASSERT((boost::has_trivial_destructor<T>::value));
+    BOOST_STATIC_ASSERT((boost::has_trivial_assign<T>::value));
+
+    typedef typename detail::segmented_queue_signature::bind<A0, A1>::type bound_args;
+
+    static const bool has_capacity = detail::extract_capacity<bound_args>::has_capacity;
+    static const size_t capacity = detail::extract_capacity<bound_args>::capacity;
+
+    static const size_t segment_size = 256;
+
+    /* Each time a segment is taken from the freelist, it is assigned a new generation. The generation is stored
+     * in the upper bits of its indices and slot states, so that a thread which is still holding a pointer to a
+     * segment that has since been recycled cannot modify the current generation of the segment by mistake.
+     *
+     * A pop claims a slot only if the dequeue index still has the generation that the pop read while the segment
+     * was the head, as it would otherwise take an element from the tail of the queue before older ones. A push
+     * that claims a slot of the current generation stores its element in the tail segment (or in a segment that
+     * is about to be appended), since a segment that has been filled never has free slots again. */
+    typedef boost::uint32_t generation_t;
+
+    static boost::uint64_t make_index(generation_t generation, boost::uint32_t index)
+    {
+        return (boost::uint64_t(generation) << 32) | index;
+    }
+
+    static generation_t index_generation(boost::uint64_t index)
+    {
+        return generation_t(index >> 32);
+    }
+
+    static size_t slot_index(boost::uint64_t index)
+    {
+        return size_t(index & 0xffffffffu);
+    }
+
+    /* whether all slots of a segment that have been claimed by pushes have also been claimed by pops */
+    static bool all_claimed(boost::uint64_t dequeue_index, boost::uint64_t enqueue_index)
+    {
+        size_t pushed = slot_index(enqueue_index);
+        if (pushed > segment_size)
+            pushed = segment_size;
+        return slot_index(dequeue_index) >= pushed;
+    }
+
+    enum slot_state
+    {
+        slot_empty,
+        slot_writing,
+        slot_ready,
+        slot_consumed
+    };
+
+    static boost::uint64_t make_state(generation_t generation, slot_state state)
+    {
+        return (boost::uint64_t(generation) << 2) | state;
+    }
+
+    struct slot
+    {
+        /* Claims an empty slot for a push. Fails if the slot has already been skipped by the pop that claimed
+         * the same index. */
+        bool write(generation_t generation, T const & t)
+        {
+            boost::uint64_t empty = make_state(generation, slot_empty);
+            if (!state.compare_exchange_strong(empty, make_state(generation, slot_writing)))
+                return false;
+            data = t;
+            state.store(make_state(generation, slot_ready), memory_order_release);
+            return true;
+        }
+
+        /* Consumes the element of a slot, or marks the slot as skipped if its push has not claimed it yet. */
+        template <typename U>
+        bool consume(generation_t generation, U & ret)
+        {
+            boost::uint64_t current = make_state(generation, slot_empty);
+            if (state.compare_exchange_strong(current, make_state(generation, slot_consumed)))
+                return false;
+
+            /* the push that claimed the slot is still writing the element */
+            while (current != make_state(generation, slot_ready))
+                current = state.load(memory_order_acquire);
+
+            detail::copy_payload(data, ret);
+            state.store(make_state(generation, slot_consumed), memory_order_relaxed);
+            return true;
+        }
+
+        atomic<boost::uint64_t> state;
+        T data;
+    };
+
+    struct segment;
+    typedef detail::tagged_ptr<segment> tagged_segment_ptr;
+
+    /* The next pointer of a segment without a successor is a null link, which carries the generation of the
+     * segment in its pointer bits, as well as in its tag, which may be as narrow as 16 bits. A push that appends a
+     * segment expects the null link of the generation that it has read, so that it cannot append to a segment that
+     * has been recycled in the meantime, e.g. to the one that it has just taken from the freelist itself. */
+    static tagged_segment_ptr null_link(generation_t generation)
+    {
+        std::size_t bits = (std::size_t(generation) << 1) | 1;
+        return tagged_segment_ptr(reinterpret_cast<segment*>(bits), typename tagged_segment_ptr::tag_t(generation));
+    }
+
+    static bool is_null_link(tagged_segment_ptr link)
+    {
+        return (reinterpret_cast<std::size_t>(link.get_ptr()) & 1) != 0;
+    }
+
+    struct BOOST_LOCKFREE_CACHELINE_ALIGNMENT segment
+    {
+        /* Threads that are still holding a pointer to a recycled segment may access it at any time, so the
+         * constructor assigns each member once and does not rely on the members being constructed. The
+         * generation is only drawn once the segment has been obtained, so that pushes that fail for lack of
+         * segments do not use up generations. */
+        explicit segment(atomic<generation_t> * generations)
+        {
+            initialize(++*generations, 0);
+        }
+
+        segment(atomic<generation_t> * generations, T const & t)
+        {
+            slots[0].data = t;
+            initialize(++*generations, 1);
+        }
+
+        void initialize(generation_t generation, boost::uint32_t enqueued)
+        {
+            for (size_t i = 0; i != segment_size; ++i)
+                slots[i].state.store(make_state(generation, i < enqueued ? slot_ready : slot_empty),
+                                     memory_order_relaxed);
+            next.store(null_link(generation), memory_order_relaxed);
+            consumed.store(0, memory_order_relaxed);
+            dequeue_index.store(make_index(generation, 0), memory_order_release);
+            enqueue_index.store(make_index(generation, enqueued), memory_order_release);
+        }
+
+        /* the freelist links free segments through their first bytes */
+        char freelist_link[BOOST_LOCKFREE_CACHELINE_BYTES];
+
+        atomic<boost::uint64_t> enqueue_index;
+        char padding1[BOOST_LOCKFREE_CACHELINE_BYTES - sizeof(atomic<boost::uint64_t>)];
+        atomic<boost::uint64_t> dequeue_index;
+        char padding2[BOOST_LOCKFREE_CACHELINE_BYTES - sizeof(atomic<boost::uint64_t>)];
+
+        /* the successor of the segment, or the null link of its generation */
+        atomic<tagged_segment_ptr> next;
+
+        /* the number of slots that have been consumed or skipped, plus one once the segment has been unlinked */
+        atomic<size_t> consumed;
+
+        slot slots[segment_size];
+    };
+
+    typedef typename detail::extract_allocator<bound_args, segment>::type segment_allocator;
+    typedef detail::freelist_stack<segment, segment_allocator> pool_t;
+
+    static size_t segments_for(size_t n)
+    {
+        return (n + segment_size - 1) / segment_size + 1;
+    }
+
+    void initialize(void)
+    {
+        segment * s = pool.template construct<true, false>(&generation_);
+        tagged_segment_ptr first(s, 0);
+        head_.store(first, memory_order_relaxed);
+        tail_.store(first, memory_order_release);
+    }
+
+    /* Records that a slot of the segment has been consumed or that the segment has been unlinked, and recycles
+     * the segment once both have happened for all of its slots. */
+    void release(segment * s)
+    {
+        if (s->consumed.fetch_add(1) == segment_size)
+            pool.template destruct<true>(s);
+    }
+
+    struct implementation_defined
+    {
+        typedef segment_allocator allocator;
+        typedef std::size_t size_type;
+    };
+
+#endif
+
+public:
+    typedef T value_type;
+    typedef typename implementation_defined::allocator allocator;
+    typedef typename implementation_defined::size_type size_type;
+
+    /**
+     * \return true, if implementation is lock-free.
+     *
+     * \warning It only checks, if the queue head and tail, the segment indices and the freelist can be modified in
+     *          a lock-free manner.
+     * */
+    bool is_lock_free (void) const
+    {
+        return head_.is_lock_free() && tail_.is_lock_free() && generation_.is_lock_free() &&
+               head_.load(memory_order_relaxed).get_ptr()->enqueue_index.is_lock_free() && pool.is_lock_free();
+    }
+
+    //! Construct queue
+    // @{
+    segmented_queue(void):
+        head_(tagged_segment_ptr(0, 0)),
+        tail_(tagged_segment_ptr(0, 0)),
+        generation_(0),
+        pool(segment_allocator(), segments_for(capacity))
+    {
+        BOOST_ASSERT(has_capacity);
+        initialize();
+    }
+
+    template <typename U>
+    explicit segmented_queue(typename segment_allocator::template rebind<U>::other const & alloc):
+        head_(tagged_segment_ptr(0, 0)),
+        tail_(tagged_segment_ptr(0, 0)),
+        generation_(0),
+        pool(alloc, segments_for(capacity))
+    {
+        BOOST_STATIC_ASSERT(has_capacity);
+        initialize();
+    }
+
+    explicit segmented_queue(allocator const & alloc):
+        head_(tagged_segment_ptr(0, 0)),
+        tail_(tagged_segment_ptr(0, 0)),
+        generation_(0),
+        pool(alloc, segments_for(capacity))
+    {
+        BOOST_ASSERT(has_capacity);
+        initialize();
+    }
+    // @}
+
+    //! Construct queue, allocate the segments for n elements.
+    // @{
+    explicit segmented_queue(size_type n):
+        head_(tagged_segment_ptr(0, 0)),
+        tail_(tagged_segment_ptr(0, 0)),
+        generation_(0),
+        pool(segment_allocator(), segments_for(n))
+    {
+        BOOST_ASSERT(!has_capacity);
+        initialize();
+    }
+
+    template <typename U>
+    segmented_queue(size_type n, typename segment_allocator::template rebind<U>::other const & alloc):
+        head_(tagged_segment_ptr(0, 0)),
+        tail_(tagged_segment_ptr(0, 0)),
+        generation_(0),
+        pool(alloc, segments_for(n))
+    {
+        BOOST_STATIC_ASSERT(!has_capacity);
+        initialize();
+    }
+    // @}
+
+    /** Allocate the segments for n further elements and add them to the freelist.
+     *
+     * \note thread-safe, may block if memory allocator blocks
+     * */
+    void reserve(size_type n)
+    {
+        pool.template reserve<true>(segments_for(n) - 1);
+    }
+
+    /** Allocate the segments for n further elements and add them to the freelist.
+     *
+     * \note not thread-safe, may block if memory allocator blocks
+     * */
+    void reserve_unsafe(size_type n)
+    {
+        pool.template reserve<false>(segments_for(n) - 1);
+    }
+
+    /** Destroys queue, free all segments.
+     * */
+    ~segmented_queue(void)
+    {
+        segment * s = head_.load(memory_order_relaxed).get_ptr();
+        for (;;) {
+            tagged_segment_ptr next = s->next.load(memory_order_relaxed);
+            pool.template destruct<false>(s);
+            if (is_null_link(next))
+                break;
+            s = next.get_ptr();
+        }
+    }
+
+    /** Check if the queue is empty
+     *
+     * \return true, if the queue is empty, false otherwise
+     * \note The result is only accurate, if no other thread modifies the queue. Therefore it is rarely practical to use this
+     *       value in program logic.
+     * */
+    bool empty(void)
+    {
+        for (;;) {
+            tagged_segment_ptr head = head_.load(memory_order_acquire);
+            segment * head_segment = head.get_ptr();
+            boost::uint64_t dequeue_index = head_segment->dequeue_index.load(memory_order_acquire);
+            boost::uint64_t enqueue_index = head_segment->enqueue_index.load(memory_order_acquire);
+            tagged_segment_ptr next = head_segment->next.load(memory_order_acquire);
+
+            if (head == head_.load(memory_order_acquire))
+                return all_claimed(dequeue_index, enqueue_index) && is_null_link(next);
+        }
+    }
+
+    /** Pushes object t to the queue.
+     *
+     * \post object will be pushed to the queue, if a slot is available or a new segment can be allocated
+     * \returns true, if the push operation is successful.
+     *
+     * \note Thread-safe. If the tail segment is full and the freelist is exhausted, a new segment will be allocated
+     *                    from the OS, unless the queue has a compile-time capacity. This may not be lock-free.
+     * */
+    bool push(T const & t)
+    {
+        return do_push<has_capacity>(t);
+    }
+
+    /** Pushes object t to the queue.
+     *
+     * \post object will be pushed to the queue, if a slot is available or a segment can be taken from the freelist
+     * \returns true, if the push operation is successful.
+     *
+     * \note Thread-safe and non-blocking. If the tail segment is full and the freelist is exhausted, operation will fail
+     * */
+    bool bounded_push(T const & t)
+    {
+        return do_push<true>(t);
+    }
+
+private:
+#ifndef BOOST_DOXYGEN_INVOKED
+    template <bool Bounded>
+    bool do_push(T const & t)
+    {
+        using detail::likely;
+
+        /* once allocated, a new segment already holds t and is never returned to the freelist, as a thread
+         * holding a stale pointer may have pushed into it. it is appended at the first attempt that succeeds. */
+        segment * new_segment = 0;
+
+        for (;;) {
+            tagged_segment_ptr tail = tail_.load(memory_order_acquire);
+            segment * tail_segment = tail.get_ptr();
+
+            if (new_segment == 0) {
+                boost::uint64_t index = tail_segment->enqueue_index.fetch_add(1);
+                if (likely(slot_index(index) < segment_size)) {
+                    if (tail_segment->slots[slot_index(index)].write(index_generation(index), t))
+                        return true;
+                    continue;
+                }
+            }
+
+            tagged_segment_ptr next = tail_segment->next.load(memory_order_acquire);
+            if (tail != tail_.load(memory_order_acquire))
+                continue;
+
+            if (is_null_link(next)) {
+                if (new_segment == 0) {
+                    new_segment = pool.template construct<true, Bounded>(&generation_, t);
+                    if (new_segment == 0)
+                        return false;
+                }
+
+                tagged_segment_ptr new_next(new_segment, next.get_tag());
+                if (tail_segment->next.compare_exchange_strong(next, new_next)) {
+                    tagged_segment_ptr new_tail(new_segment, tail.get_tag() + 1);
+                    tail_.compare_exchange_strong(tail, new_tail);
+                    return true;
+                }
+            } else {
+                tagged_segment_ptr new_tail(next.get_ptr(), tail.get_tag() + 1);
+                tail_.compare_exchange_strong(tail, new_tail);
+            }
+        }
+    }
+#endif
+
+public:
+    /** Pops object from queue.
+     *
+     * \post if pop operation is successful, object will be copied to ret.
+     * \returns true, if the pop operation is successful, false if queue was empty.
+     *
+     * \note Thread-safe. Waits if the claimed element is still being written by a concurrent push
+     * */
+    bool pop (T & ret)
+    {
+        return pop<T>(ret);
+    }
+
+    /** Pops object from queue.
+     *
+     * \pre type U must be constructible by T and copyable, or T must be convertible to U
+     * \post if pop operation is successful, object will be copied to ret.
+     * \returns true, if the pop operation is successful, false if queue was empty.
+     *
+     * \note Thread-safe. Waits if the claimed element is still being written by a concurrent push
+     * */
+    template <typename U>
+    bool pop (U & ret)
+    {
+        for (;;) {
+            tagged_segment_ptr head = head_.load(memory_order_acquire);
+            segment * head_segment = head.get_ptr();
+
+            boost::uint64_t dequeue_index = head_segment->dequeue_index.load(memory_order_acquire);
+            boost::uint64_t enqueue_index = head_segment->enqueue_index.load(memory_order_acquire);
+            tagged_segment_ptr next = head_segment->next.load(memory_order_acquire);
+            if (head != head_.load(memory_order_acquire))
+                continue;
+
+            if (all_claimed(dequeue_index, enqueue_index) && is_null_link(next))
+                return false;
+
+            pop_result result = pop_from(head, dequeue_index, ret);
+            if (result != pop_retry)
+                return result == pop_success;
+        }
+    }
+
+private:
+#ifndef BOOST_DOXYGEN_INVOKED
+    friend class detail::segmented_queue_tester;
+
+    enum pop_result
+    {
+        pop_retry,
+        pop_empty,
+        pop_success
+    };
+
+    /* Pops from the head segment, given the head and its dequeue index as read before the head was validated. */
+    template <typename U>
+    pop_result pop_from(tagged_segment_ptr head, boost::uint64_t dequeue_index, U & ret)
+    {
+        using detail::likely;
+
+        segment * head_segment = head.get_ptr();
+
+        boost::uint64_t index = dequeue_index;
+        while (likely(slot_index(index) < segment_size)) {
+            if (head_segment->dequeue_index.compare_exchange_weak(index, index + 1)) {
+                bool success = head_segment->slots[slot_index(index)].consume(index_generation(index), ret);
+                release(head_segment);
+                return success ? pop_success : pop_retry;
+            }
+
+            /* the segment has been recycled since it was read */
+            if (index_generation(index) != index_generation(dequeue_index))
+                return pop_retry;
+        }
+
+        /* all slots of the head segment have been claimed */
+        tagged_segment_ptr next = head_segment->next.load(memory_order_acquire);
+        if (head != head_.load(memory_order_acquire))
+            return pop_retry;
+
+        if (is_null_link(next))
+            return pop_empty;
+
+        /* the tail must not fall behind the head, as the head segment is recycled once it is unlinked */
+        tagged_segment_ptr tail = tail_.load(memory_order_acquire);
+        if (tail.get_ptr() == head_segment) {
+            tagged_segment_ptr new_tail(next.get_ptr(), tail.get_tag() + 1);
+            tail_.compare_exchange_strong(tail, new_tail);
+            return pop_retry;
+        }
+
+        tagged_segment_ptr new_head(next.get_ptr(), head.get_tag() + 1);
+        if (head_.compare_exchange_strong(head, new_head))
+            release(head_segment);
+        return pop_retry;
+    }
+#endif
+
+private:
+#ifndef BOOST_DOXYGEN_INVOKED
+    atomic<tagged_segment_ptr> head_;
+    static const int padding_size = BOOST_LOCKFREE_CACHELINE_BYTES - sizeof(tagged_segment_ptr);
+    char padding1[padding_size];
+    atomic<tagged_segment_ptr> tail_;
+    char padding2[padding_size];
+
+    atomic<generation_t> generation_;
+    pool_t pool;
+#endif
+};
+
+} /* namespace lockfree */
+} /* namespace boost */
+
+#endif /* BOOST_LOCKFREE_SEGMENTED_QUEUE_HPP_INCLUDED */
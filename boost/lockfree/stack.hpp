@@ -52,6 +52,17 @@ typedef parameter::parameters<boost::parameter::optional<tag::allocator>,
  *  - \c boost::lockfree::allocator<>, defaults to \c boost::lockfree::allocator<std::allocator<void>> <br>
  *    Specifies the allocator that is used for the internal freelist
  *
+ *  - \c boost::lockfree::thread_cached<>, defaults to \c boost::lockfree::thread_cached<false> <br>
+ *    Places per-thread caches of free nodes in front of the internal freelist, which reduces the contention on the
+ *    freelist when many threads push and pop. Nodes cached by one thread are not immediately available to other
+ *    threads, so the stack may hold more nodes than with a plain freelist. Has no effect on fixed-sized stacks.
+ *
+ *  - \c boost::lockfree::reclaim_memory<>, defaults to \c boost::lockfree::reclaim_memory<false> <br>
+ *    Returns nodes to the allocator once no thread can access them any more, using epoch-based reclamation. Only as
+ *    many free nodes as have been reserved are kept in the freelist. Popped nodes become available to bounded
+ *    operations once they have been reclaimed. Has no effect on fixed-sized stacks and takes
+ *    precedence over \c thread_cached.
+ *
  *  \b Requirements:
  *  - T must have a copy constructor
  * */
@@ -76,6 +87,8 @@ private:
     static const bool has_capacity = detail::extract_capacity<bound_args>::has_capacity;
     static const size_t capacity = detail::extract_capacity<bound_args>::capacity;
     static const bool fixed_sized = detail::extract_fixed_sized<bound_args>::value;
+    static const bool thread_cached = detail::extract_thread_cached<bound_args>::value;
+    static const bool reclaim_memory = detail::extract_reclaim_memory<bound_args>::value;
     static const bool node_based = !(has_capacity || fixed_sized);
     static const bool compile_time_sized = has_capacity;
 
@@ -91,7 +104,8 @@ private:
     };
 
     typedef typename detail::extract_allocator<bound_args, node>::type node_allocator;
-    typedef typename detail::select_freelist<node, node_allocator, compile_time_sized, fixed_sized, capacity>::type pool_t;
+    typedef typename detail::select_freelist<node, node_allocator, compile_time_sized, fixed_sized, capacity,
+                                             thread_cached, reclaim_memory>::type pool_t;
     typedef typename pool_t::tagged_node_handle tagged_node_handle;
 
     // check compile-time capacity
@@ -302,6 +316,7 @@ private:
     template <bool Bounded>
     bool do_push(T const & v)
     {
+        typename pool_t::operation_guard guard(pool);
         node * newnode = pool.template construct<true, Bounded>(v);
         if (newnode == 0)
             return false;
@@ -317,6 +332,7 @@ private:
         node * end_node;
         ConstIterator ret;
 
+        typename pool_t::operation_guard guard(pool);
         tie(new_top_node, end_node) = prepare_node_list<true, Bounded>(begin, end, ret);
         if (new_top_node)
             link_nodes_atomic(new_top_node, end_node);
@@ -425,6 +441,7 @@ public:
     bool pop(U & ret)
     {
         BOOST_STATIC_ASSERT((boost::is_convertible<T, U>::value));
+        typename pool_t::operation_guard guard(pool);
         tagged_node_handle old_tos = tos.load(detail::memory_order_consume);
 
         for (;;) {
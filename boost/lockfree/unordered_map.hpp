@@ -0,0 +1,605 @@
+//  lock-free hash map, based on split-ordered lists, after
+//  Shalev, O. and Shavit, N., "Split-ordered lists: lock-free extensible hash tables"
+//  and Michael, M. M., "High performance dynamic lock-free hash tables and list-based sets"
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_LOCKFREE_UNORDERED_MAP_HPP_INCLUDED
+#define BOOST_LOCKFREE_UNORDERED_MAP_HPP_INCLUDED
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include <boost/cstdint.hpp>
+#include <boost/detail/thread_hash.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <boost/lockfree/detail/atomic.hpp>
+#include <boost/lockfree/detail/epoch_reclamation.hpp>
+#include <boost/lockfree/detail/prefix.hpp>
+#include <boost/lockfree/detail/tagged_ptr.hpp>
+
+namespace boost    {
+namespace lockfree {
+namespace detail   {
+
+inline std::size_t reverse_bits(std::size_t value)
+{
+    boost::uint64_t v = value;
+    v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+    v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+    v = ((v >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    v = ((v >> 8) & 0x00FF00FF00FF00FFULL) | ((v & 0x00FF00FF00FF00FFULL) << 8);
+    v = ((v >> 16) & 0x0000FFFF0000FFFFULL) | ((v & 0x0000FFFF0000FFFFULL) << 16);
+    v = (v >> 32) | (v << 32);
+    return static_cast<std::size_t>(v >> (64 - sizeof(std::size_t) * 8));
+}
+
+inline std::size_t floor_log2(std::size_t value)
+{
+    std::size_t result = 0;
+    while (value >>= 1)
+        ++result;
+    return result;
+}
+
+} /* namespace detail */
+
+/** The unordered_map class provides a multi-writer/multi-reader hash map, lookups, insertion and erasure are
+ *  lock-free, construction/destruction has to be synchronized.
+ *
+ *  All elements are kept in a single lock-free linked list, which is sorted by the bit-reversed hash values of the
+ *  keys. A bucket is a pointer to a sentinel node in the list, so that the elements of a bucket form a contiguous
+ *  part of the list. When the number of elements exceeds twice the number of buckets, the number of buckets is
+ *  doubled. This does not move any element: due to the bit-reversed order, each new bucket splits an existing one,
+ *  and its sentinel is inserted into the list when the bucket is first accessed. So the map grows without blocking
+ *  concurrent operations.
+ *
+ *  Erased elements are destroyed and returned to the allocator once no concurrent operation can access them any
+ *  more, which is detected with epoch-based reclamation.
+ *
+ *  Elements can not be modified in place. \c visit passes a const reference to an element to a function object,
+ *  which may be called concurrently with other threads visiting or erasing the element.
+ *
+ *  \b Requirements:
+ *  - Key and T must be copy constructible
+ *  - Hash and Pred must be callable concurrently from several threads
+ * */
+template <typename Key,
+          typename T,
+          typename Hash = boost::hash<Key>,
+          typename Pred = std::equal_to<Key>,
+          typename Alloc = std::allocator<std::pair<const Key, T> >
+         >
+class unordered_map:
+    boost::noncopyable
+{
+public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::pair<const Key, T> value_type;
+    typedef Hash hasher;
+    typedef Pred key_equal;
+    typedef Alloc allocator_type;
+    typedef std::size_t size_type;
+
+private:
+#ifndef BOOST_DOXYGEN_INVOKED
+    /* the lowest bit of a link marks the node that contains it as erased */
+    typedef std::size_t link_type;
+
+    struct node
+    {
+        explicit node(std::size_t key):
+            so_key(key)
+        {
+            next.store(0, memory_order_relaxed);
+        }
+
+        /* overwritten by the epoch_domain when the node is retired, so that concurrent readers can still follow
+         * next */
+        detail::tagged_ptr<node> reclamation_link;
+
+        atomic<link_type> next;
+
+        /* the split-order key: the bit-reversed hash value, whose lowest bit is set for elements and cleared for
+         * bucket sentinels */
+        std::size_t so_key;
+    };
+
+    struct element:
+        node
+    {
+        element(std::size_t key, value_type const & v):
+            node(key), value(v)
+        {}
+
+        value_type value;
+    };
+
+    typedef typename Alloc::template rebind<node>::other node_allocator;
+    typedef typename Alloc::template rebind<element>::other element_allocator;
+    typedef detail::epoch_domain<> domain_type;
+    typedef typename domain_type::guard guard;
+
+    static const std::size_t bits = sizeof(std::size_t) * 8;
+    static const std::size_t max_load_factor = 2;
+    static const std::size_t counter_count = 16;
+
+    static node * get_pointer(link_type link)
+    {
+        return reinterpret_cast<node*>(link & ~link_type(1));
+    }
+
+    static link_type make_link(node * n)
+    {
+        return reinterpret_cast<link_type>(n);
+    }
+
+    static bool is_marked(link_type link)
+    {
+        return link & 1;
+    }
+
+    static std::size_t element_key(std::size_t hash)
+    {
+        return detail::reverse_bits(hash) | 1;
+    }
+
+    static std::size_t sentinel_key(std::size_t bucket)
+    {
+        return detail::reverse_bits(bucket);
+    }
+
+    static std::size_t parent_bucket(std::size_t bucket)
+    {
+        return bucket & ~(std::size_t(1) << detail::floor_log2(bucket));
+    }
+
+    /* bucket b is stored in segment floor_log2(b), segment 0 holds buckets 0 and 1 */
+    static std::size_t segment_index(std::size_t bucket)
+    {
+        return bucket < 2 ? 0 : detail::floor_log2(bucket);
+    }
+
+    static std::size_t segment_size(std::size_t segment)
+    {
+        return segment == 0 ? 2 : std::size_t(1) << segment;
+    }
+
+    static std::size_t segment_offset(std::size_t bucket)
+    {
+        return bucket < 2 ? bucket : bucket - (std::size_t(1) << detail::floor_log2(bucket));
+    }
+
+    struct counter
+    {
+        atomic<std::size_t> value;
+        char padding[BOOST_LOCKFREE_CACHELINE_BYTES - sizeof(atomic<std::size_t>)];
+    };
+
+    /* the position in the list found by search: *prev links to current */
+    struct position
+    {
+        atomic<link_type> * prev;
+        node * current;
+    };
+#endif
+
+public:
+    /** Construct an unordered_map with at least n buckets. */
+    explicit unordered_map(size_type n = 16, hasher const & hf = hasher(), key_equal const & eq = key_equal(),
+                           allocator_type const & alloc = allocator_type()):
+        hash_(hf), eq_(eq), node_alloc_(alloc), element_alloc_(alloc), domain_(&reclaim_element, this)
+    {
+        std::size_t buckets = 2;
+        while (buckets < n && buckets < (std::size_t(1) << (bits - 2)))
+            buckets *= 2;
+        bucket_count_.store(buckets, memory_order_relaxed);
+
+        for (std::size_t i = 0; i != bits; ++i)
+            segments_[i].store(NULL, memory_order_relaxed);
+        for (std::size_t i = 0; i != counter_count; ++i)
+            counters_[i].value.store(0, memory_order_relaxed);
+
+        node * head = new_sentinel(0);
+        bucket(0).store(head, memory_order_release);
+    }
+
+    /** Destroys the unordered_map and all of its elements. */
+    ~unordered_map(void)
+    {
+        node * n = bucket(0).load(memory_order_relaxed);
+        while (n) {
+            node * next = get_pointer(n->next.load(memory_order_relaxed));
+            if (n->so_key & 1)
+                destroy_element(static_cast<element*>(n));
+            else {
+                n->~node();
+                node_alloc_.deallocate(n, 1);
+            }
+            n = next;
+        }
+
+        for (std::size_t i = 0; i != bits; ++i)
+            delete[] segments_[i].load(memory_order_relaxed);
+    }
+
+    /** \return true, if implementation is lock-free.
+     *
+     * \warning It only checks, if the links of the list, the bucket directory and the element counters can be
+     *          modified in a lock-free manner.
+     * */
+    bool is_lock_free(void) const
+    {
+        return bucket_count_.is_lock_free() && segments_[0].is_lock_free() &&
+               counters_[0].value.is_lock_free() && domain_.is_lock_free();
+    }
+
+    /** Inserts a copy of value, unless an element with an equivalent key exists.
+     *
+     * \returns true, if the element has been inserted
+     *
+     * \note Thread-safe and non-blocking, but the node of the element is allocated from the allocator
+     * */
+    bool insert(value_type const & value)
+    {
+        std::size_t hash = hash_(value.first);
+        element * e = new_element(element_key(hash), value);
+
+        {
+            guard g(domain_);
+            node * head = get_sentinel(hash & (bucket_count_.load(memory_order_acquire) - 1), g);
+            if (insert_node(head, e, &e->value.first, g)) {
+                added(1);
+                return true;
+            }
+        }
+
+        destroy_element(e);
+        return false;
+    }
+
+    /** Inserts (key, value), unless an element with an equivalent key exists.
+     *
+     * \returns true, if the element has been inserted
+     *
+     * \note Thread-safe and non-blocking, but the node of the element is allocated from the allocator
+     * */
+    bool insert(key_type const & key, mapped_type const & value)
+    {
+        return insert(value_type(key, value));
+    }
+
+    /** Erases the element with a key equivalent to key.
+     *
+     * \returns the number of erased elements (0 or 1)
+     *
+     * \note Thread-safe and non-blocking
+     * */
+    size_type erase(key_type const & key)
+    {
+        std::size_t hash = hash_(key);
+        std::size_t so_key = element_key(hash);
+
+        guard g(domain_);
+        node * head = get_sentinel(hash & (bucket_count_.load(memory_order_acquire) - 1), g);
+
+        for (;;) {
+            position pos;
+            if (!search(head, so_key, &key, g, pos))
+                return 0;
+
+            node * current = pos.current;
+            link_type next = current->next.load(memory_order_acquire);
+            if (is_marked(next))
+                continue;
+
+            /* logically delete the node by marking its link, then unlink it */
+            if (!current->next.compare_exchange_strong(next, next | 1))
+                continue;
+
+            link_type expected = make_link(current);
+            if (pos.prev->compare_exchange_strong(expected, next))
+                g.retire(current);
+            else
+                search(head, so_key, &key, g, pos);
+
+            added(-1);
+            return 1;
+        }
+    }
+
+    /** Looks up the element with a key equivalent to key and copies its mapped value to ret.
+     *
+     * \returns true, if the element has been found
+     *
+     * \note Thread-safe and lock-free
+     * */
+    bool find(key_type const & key, mapped_type & ret) const
+    {
+        return visit(key, copy_mapped(ret));
+    }
+
+    /** \returns the number of elements with a key equivalent to key (0 or 1)
+     *
+     * \note Thread-safe and lock-free
+     * */
+    size_type count(key_type const & key) const
+    {
+        return visit(key, ignore_element()) ? 1 : 0;
+    }
+
+    /** Calls f(value), where value is a const reference to the element with a key equivalent to key.
+     *
+     * \returns true, if the element has been found
+     *
+     * \note Thread-safe and lock-free, unless f blocks. The element is not destroyed before f returns, even if it
+     *       is erased concurrently.
+     * */
+    template <typename Functor>
+    bool visit(key_type const & key, Functor const & f) const
+    {
+        std::size_t hash = hash_(key);
+        std::size_t so_key = element_key(hash);
+
+        guard g(domain_);
+        node * n = get_sentinel(hash & (bucket_count_.load(memory_order_acquire) - 1), g);
+
+        for (;;) {
+            link_type next = n->next.load(memory_order_acquire);
+            node * current = get_pointer(next);
+            if (!current || current->so_key > so_key)
+                return false;
+
+            if (current->so_key == so_key) {
+                element * e = static_cast<element*>(current);
+                if (eq_(e->value.first, key)) {
+                    if (is_marked(current->next.load(memory_order_acquire)))
+                        return false;
+                    f(e->value);
+                    return true;
+                }
+            }
+            n = current;
+        }
+    }
+
+    /** Calls f(value) for each element, where value is a const reference to the element.
+     *
+     * \note Thread-safe and lock-free, unless f blocks. Elements that are inserted or erased concurrently may or may
+     *       not be visited.
+     * */
+    template <typename Functor>
+    void visit_all(Functor const & f) const
+    {
+        guard g(domain_);
+        node * n = bucket(0).load(memory_order_acquire);
+
+        for (;;) {
+            link_type next = n->next.load(memory_order_acquire);
+            node * current = get_pointer(next);
+            if (!current)
+                return;
+
+            if ((current->so_key & 1) && !is_marked(current->next.load(memory_order_acquire)))
+                f(static_cast<element*>(current)->value);
+            n = current;
+        }
+    }
+
+    /** \returns the number of elements
+     *
+     * \note Thread-safe, but the result is only accurate if no other thread modifies the map.
+     * */
+    size_type size(void) const
+    {
+        /* a counter wraps around when a thread erases elements that another thread has inserted */
+        std::size_t result = 0;
+        for (std::size_t i = 0; i != counter_count; ++i)
+            result += counters_[i].value.load(memory_order_relaxed);
+        return static_cast<std::ptrdiff_t>(result) < 0 ? 0 : result;
+    }
+
+    /** Check if the unordered_map is empty
+     *
+     * \note Thread-safe, but the result is only accurate if no other thread modifies the map.
+     * */
+    bool empty(void) const
+    {
+        return size() == 0;
+    }
+
+    /** \returns the number of buckets
+     *
+     * \note Thread-safe
+     * */
+    size_type bucket_count(void) const
+    {
+        return bucket_count_.load(memory_order_relaxed);
+    }
+
+private:
+#ifndef BOOST_DOXYGEN_INVOKED
+    struct copy_mapped
+    {
+        explicit copy_mapped(mapped_type & ret):
+            ret_(ret)
+        {}
+
+        void operator()(value_type const & value) const
+        {
+            ret_ = value.second;
+        }
+
+        mapped_type & ret_;
+    };
+
+    struct ignore_element
+    {
+        void operator()(value_type const &) const
+        {}
+    };
+
+    atomic<node*> & bucket(std::size_t index) const
+    {
+        std::size_t segment = segment_index(index);
+        atomic<node*> * buckets = segments_[segment].load(memory_order_acquire);
+        if (!buckets) {
+            std::size_t size = segment_size(segment);
+            atomic<node*> * allocated = new atomic<node*>[size];
+            for (std::size_t i = 0; i != size; ++i)
+                allocated[i].store(NULL, memory_order_relaxed);
+
+            if (segments_[segment].compare_exchange_strong(buckets, allocated))
+                buckets = allocated;
+            else
+                delete[] allocated;
+        }
+        return buckets[segment_offset(index)];
+    }
+
+    /* returns the sentinel of a bucket, inserting it into the list first if the bucket has not been used, yet */
+    node * get_sentinel(std::size_t index, guard & g) const
+    {
+        atomic<node*> & slot = bucket(index);
+        node * sentinel = slot.load(memory_order_acquire);
+        if (sentinel)
+            return sentinel;
+
+        node * parent = get_sentinel(parent_bucket(index), g);
+        node * new_node = new_sentinel(sentinel_key(index));
+        if (insert_node(parent, new_node, NULL, g))
+            sentinel = new_node;
+        else {
+            /* another thread has inserted the sentinel */
+            position pos;
+            search(parent, new_node->so_key, NULL, g, pos);
+            sentinel = pos.current;
+            new_node->~node();
+            node_alloc_.deallocate(new_node, 1);
+        }
+
+        slot.store(sentinel, memory_order_release);
+        return sentinel;
+    }
+
+    node * new_sentinel(std::size_t so_key) const
+    {
+        node * n = node_alloc_.allocate(1);
+        new(n) node(so_key);
+        return n;
+    }
+
+    element * new_element(std::size_t so_key, value_type const & value)
+    {
+        element * e = element_alloc_.allocate(1);
+        try {
+            new(e) element(so_key, value);
+        } catch (...) {
+            element_alloc_.deallocate(e, 1);
+            throw;
+        }
+        return e;
+    }
+
+    void destroy_element(element * e)
+    {
+        e->~element();
+        element_alloc_.deallocate(e, 1);
+    }
+
+    static void reclaim_element(void * context, void * n)
+    {
+        static_cast<unordered_map*>(context)->destroy_element(static_cast<element*>(static_cast<node*>(n)));
+    }
+
+    bool matches(node * n, std::size_t so_key, key_type const * key) const
+    {
+        return n->so_key == so_key && (!key || eq_(static_cast<element*>(n)->value.first, *key));
+    }
+
+    /* Finds the node with the given split-order key (and key for elements) in the list starting at head, unlinking
+     * erased nodes on the way. Returns true if the node has been found at pos.current, otherwise pos.current is the
+     * first node that follows it in the list. */
+    bool search(node * head, std::size_t so_key, key_type const * key, guard & g, position & pos) const
+    {
+    retry:
+        pos.prev = &head->next;
+        pos.current = get_pointer(pos.prev->load(memory_order_acquire));
+
+        for (;;) {
+            node * current = pos.current;
+            if (!current)
+                return false;
+
+            link_type next = current->next.load(memory_order_acquire);
+            if (is_marked(next)) {
+                link_type expected = make_link(current);
+                if (!pos.prev->compare_exchange_strong(expected, next & ~link_type(1)))
+                    goto retry;
+                g.retire(current);
+                pos.current = get_pointer(next);
+                continue;
+            }
+
+            if (current->so_key > so_key)
+                return false;
+            if (matches(current, so_key, key))
+                return true;
+
+            pos.prev = &current->next;
+            pos.current = get_pointer(next);
+        }
+    }
+
+    /* inserts n into the list starting at head, returns false if an equivalent node exists */
+    bool insert_node(node * head, node * n, key_type const * key, guard & g) const
+    {
+        for (;;) {
+            position pos;
+            if (search(head, n->so_key, key, g, pos))
+                return false;
+
+            link_type expected = make_link(pos.current);
+            n->next.store(expected, memory_order_relaxed);
+            if (pos.prev->compare_exchange_strong(expected, make_link(n)))
+                return true;
+        }
+    }
+
+    /* counts added or removed elements and doubles the number of buckets, if the load factor gets too high */
+    void added(std::ptrdiff_t count)
+    {
+        counter & c = counters_[boost::detail::current_thread_hash() % counter_count];
+        std::size_t value = c.value.fetch_add(count, memory_order_relaxed) + count;
+        if (count < 0 || value % 64 != 0)
+            return;
+
+        std::size_t buckets = bucket_count_.load(memory_order_relaxed);
+        if (size() > buckets * max_load_factor && buckets < (std::size_t(1) << (bits - 2)))
+            bucket_count_.compare_exchange_strong(buckets, buckets * 2);
+    }
+
+    hasher hash_;
+    key_equal eq_;
+    /* the buckets and their sentinels are created on first use, which may be by a const lookup */
+    mutable node_allocator node_alloc_;
+    element_allocator element_alloc_;
+
+    atomic<std::size_t> bucket_count_;
+    mutable atomic<atomic<node*>*> segments_[bits];
+    counter counters_[counter_count];
+    mutable domain_type domain_;
+#endif
+};
+
+} /* namespace lockfree */
+} /* namespace boost */
+
+#endif /* BOOST_LOCKFREE_UNORDERED_MAP_HPP_INCLUDED */
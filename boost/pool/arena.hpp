@@ -0,0 +1,419 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org for updates, documentation, and revision history.
+
+#ifndef BOOST_POOL_ARENA_HPP
+#define BOOST_POOL_ARENA_HPP
+
+/*!
+  \file
+  \brief Provides a template type boost::arena<UserAllocator>, a monotonic allocator
+  for objects of any type which are all released at once,
+  and boost::arena_allocator<T, UserAllocator>, a Standard Allocator on top of it.
+*/
+
+#include <boost/pool/poolfwd.hpp>
+
+// boost::default_user_allocator_new_delete
+#include <boost/pool/pool.hpp>
+
+#include <boost/throw_exception.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/has_trivial_destructor.hpp>
+#include <boost/type_traits/type_with_alignment.hpp>
+
+// std::numeric_limits
+#include <boost/limits.hpp>
+// new, std::bad_alloc
+#include <new>
+// std::max
+#include <algorithm>
+
+namespace boost {
+
+/*! \brief A monotonic allocator for objects of any type, which releases all of its objects at once.
+
+\details
+
+<b>UserAllocator</b>
+Defines the allocator that the arena will use to allocate memory blocks from the system.
+See <a href="boost_pool/pool/pooling.html#boost_pool.pool.pooling.user_allocator">User Allocators</a> for details.
+
+An arena hands out memory by advancing a pointer through its current memory block,
+and allocates a new block when the current one is exhausted.
+The size of the blocks is doubled each time, up to an optional maximum.
+Memory is never freed individually: all of it is released when the arena is destroyed
+or when \ref purge_memory or \ref clear is called.
+
+Objects created with \ref construct are destroyed at that point, in reverse order of their construction.
+For this purpose, construct registers the destructor of each object whose type has a non-trivial destructor
+in a list that is allocated from the arena itself; objects with trivial destructors cost no bookkeeping.
+Releasing an arena is thus a linear walk over the registered destructors plus freeing the blocks,
+independent of how many objects with trivial destructors it holds.
+
+This makes arenas a good fit for request-scoped allocation: create an arena (or \ref clear a reused one)
+for each request, allocate all objects of the request from it, and release them together
+when the request has been served.
+
+An arena is not thread-safe.
+*/
+template <typename UserAllocator>
+class arena
+{
+  public:
+    typedef UserAllocator user_allocator; //!< User allocator.
+    typedef typename UserAllocator::size_type size_type; //!< An unsigned integral type that can represent the size of the largest object to be allocated.
+    typedef typename UserAllocator::difference_type difference_type; //!< A signed integral type that can represent the difference of any two pointers.
+
+    BOOST_STATIC_CONSTANT(size_type, default_alignment = alignment_of<detail::max_align>::value); //!< The alignment of memory returned by malloc(n).
+
+  private:
+    arena(const arena &);
+    void operator=(const arena &);
+
+    // Placed at the start of each memory block.
+    struct block_header
+    {
+      block_header * prev;
+      size_type size;
+    };
+
+    // An entry in the list of objects to destroy.
+    struct destructor_record
+    {
+      destructor_record * prev;
+      void (*destroy)(void *);
+      void * object;
+    };
+
+    template <typename T>
+    static void destroy_object(void * const object)
+    {
+      static_cast<T *>(object)->~T();
+    }
+
+    static size_type header_size()
+    { //! \returns the size of block_header, rounded up to the default alignment.
+      return (sizeof(block_header) + default_alignment - 1) / default_alignment * default_alignment;
+    }
+
+  public:
+    explicit arena(const size_type arg_next_size = 4096, const size_type arg_max_size = 0)
+    :
+    blocks(0), ptr(0), end(0), destructors(0),
+    next_size(arg_next_size), start_size(arg_next_size), max_size(arg_max_size)
+    { //! Constructs a new empty arena.
+      //! \param arg_next_size The size of the first memory block in bytes.
+      //! \param arg_max_size The maximum size of a memory block in bytes, 0 for no limit.
+      //! Larger blocks are allocated for requests that do not fit into a block of this size.
+    }
+
+    ~arena()
+    { //! Destroys all objects created by construct and frees all memory blocks.
+      purge_memory();
+    }
+
+    void * malloc BOOST_PREVENT_MACRO_SUBSTITUTION(const size_type n, const size_type alignment = default_alignment)
+    { //! Allocates n bytes.
+      //! \param alignment A power of two, the alignment of the returned memory.
+      //! \returns A pointer to the memory, or 0 if out-of-memory or if n is too large for any memory block.
+      size_type padding = static_cast<size_type>(-reinterpret_cast<std::size_t>(ptr)) & (alignment - 1);
+      const size_type available = static_cast<size_type>(end - ptr);
+      if (ptr == 0 || padding > available || n > available - padding)
+      {
+        if (!add_block(n, alignment))
+          return 0;
+        padding = static_cast<size_type>(-reinterpret_cast<std::size_t>(ptr)) & (alignment - 1);
+      }
+
+      char * const ret = ptr + padding;
+      ptr = ret + n;
+      return ret;
+    }
+
+    template <typename T>
+    T * construct()
+    { //! \returns A pointer to a default-constructed object of type T, or 0 if out-of-memory.
+      //! The object is destroyed when the arena is released.
+      destructor_record * record;
+      void * const p = allocate_object<T>(record);
+      if (p == 0)
+        return 0;
+      return register_object(new (p) T(), record);
+    }
+
+    template <typename T, typename A0>
+    T * construct(const A0 & a0)
+    { //! \returns A pointer to an object of type T constructed from a0, or 0 if out-of-memory.
+      destructor_record * record;
+      void * const p = allocate_object<T>(record);
+      if (p == 0)
+        return 0;
+      return register_object(new (p) T(a0), record);
+    }
+
+    template <typename T, typename A0, typename A1>
+    T * construct(const A0 & a0, const A1 & a1)
+    { //! \returns A pointer to an object of type T constructed from a0 and a1, or 0 if out-of-memory.
+      destructor_record * record;
+      void * const p = allocate_object<T>(record);
+      if (p == 0)
+        return 0;
+      return register_object(new (p) T(a0, a1), record);
+    }
+
+    template <typename T, typename A0, typename A1, typename A2>
+    T * construct(const A0 & a0, const A1 & a1, const A2 & a2)
+    { //! \returns A pointer to an object of type T constructed from a0, a1 and a2, or 0 if out-of-memory.
+      destructor_record * record;
+      void * const p = allocate_object<T>(record);
+      if (p == 0)
+        return 0;
+      return register_object(new (p) T(a0, a1, a2), record);
+    }
+
+    template <typename T, typename A0, typename A1, typename A2, typename A3>
+    T * construct(const A0 & a0, const A1 & a1, const A2 & a2, const A3 & a3)
+    { //! \returns A pointer to an object of type T constructed from a0, a1, a2 and a3, or 0 if out-of-memory.
+      destructor_record * record;
+      void * const p = allocate_object<T>(record);
+      if (p == 0)
+        return 0;
+      return register_object(new (p) T(a0, a1, a2, a3), record);
+    }
+
+    void clear()
+    { //! Destroys all objects created by construct and makes all memory available again.
+      //! Keeps the most recently allocated memory block for reuse and frees the others.
+      //! That block is not necessarily the largest, as blocks made for large requests may precede it.
+      destroy_objects();
+      if (blocks == 0)
+        return;
+
+      while (blocks->prev != 0)
+      {
+        block_header * const prev = blocks->prev;
+        blocks->prev = prev->prev;
+        (UserAllocator::free)(reinterpret_cast<char *>(prev));
+      }
+      ptr = reinterpret_cast<char *>(blocks) + header_size();
+    }
+
+    bool purge_memory()
+    { //! Destroys all objects created by construct and frees all memory blocks.
+      //! \returns true if memory was actually deallocated.
+      destroy_objects();
+
+      const bool ret = blocks != 0;
+      while (blocks != 0)
+      {
+        block_header * const prev = blocks->prev;
+        (UserAllocator::free)(reinterpret_cast<char *>(blocks));
+        blocks = prev;
+      }
+      ptr = end = 0;
+      next_size = start_size;
+      return ret;
+    }
+
+    size_type get_next_size() const
+    { //! \returns The size of the next memory block in bytes.
+      return next_size;
+    }
+    void set_next_size(const size_type x)
+    { //! Set the size of the next memory block in bytes.
+      next_size = start_size = x;
+    }
+    size_type get_max_size() const
+    { //! \returns The maximum size of a memory block in bytes.
+      return max_size;
+    }
+    void set_max_size(const size_type x)
+    { //! Set the maximum size of a memory block in bytes, 0 for no limit.
+      max_size = x;
+    }
+
+  private:
+    bool add_block(const size_type n, const size_type alignment)
+    { //! Allocates a memory block that can hold n bytes with the given alignment.
+      //! \returns false if out-of-memory, or if the size of the block would overflow size_type.
+      const size_type overhead = header_size() + (alignment > default_alignment ? alignment : 0);
+      if (n > (std::numeric_limits<size_type>::max)() - overhead)
+        return false;
+      const size_type needed = overhead + n;
+      size_type size = next_size;
+      if (size < needed)
+        size = needed;
+
+      char * const block = (UserAllocator::malloc)(size);
+      if (block == 0)
+        return false;
+
+      block_header * const header = reinterpret_cast<block_header *>(static_cast<void *>(block));
+      header->prev = blocks;
+      header->size = size;
+      blocks = header;
+      ptr = block + header_size();
+      end = block + size;
+
+      if (next_size <= (std::numeric_limits<size_type>::max)() / 2)
+        next_size <<= 1;
+      if (max_size != 0 && next_size > max_size)
+        next_size = (std::max)(max_size, start_size);
+      return true;
+    }
+
+    template <typename T>
+    void * allocate_object(destructor_record * & record)
+    { //! Allocates memory for an object of type T, preceded by its destructor record if T has a non-trivial destructor.
+      record = 0;
+      if (has_trivial_destructor<T>::value)
+        return (malloc)(sizeof(T), alignment_of<T>::value);
+
+      const size_type offset = (sizeof(destructor_record) + alignment_of<T>::value - 1)
+          / alignment_of<T>::value * alignment_of<T>::value;
+      char * const p = static_cast<char *>((malloc)(offset + sizeof(T),
+          (std::max)(alignment_of<destructor_record>::value, alignment_of<T>::value)));
+      if (p == 0)
+        return 0;
+      record = reinterpret_cast<destructor_record *>(static_cast<void *>(p));
+      return p + offset;
+    }
+
+    template <typename T>
+    T * register_object(T * const object, destructor_record * const record)
+    { //! Adds the destructor record, which allocate_object has allocated, to the list of objects to destroy.
+      //! Only called after the constructor has completed, so that objects whose constructor has thrown
+      //! are not destroyed.
+      if (record != 0)
+      {
+        record->prev = destructors;
+        record->destroy = &destroy_object<T>;
+        record->object = object;
+        destructors = record;
+      }
+      return object;
+    }
+
+    void destroy_objects()
+    { //! Destroys the registered objects in reverse order of their construction.
+      while (destructors != 0)
+      {
+        destructor_record * const record = destructors;
+        destructors = record->prev;
+        record->destroy(record->object);
+      }
+    }
+
+    block_header * blocks;
+    char * ptr;
+    char * end;
+    destructor_record * destructors;
+    size_type next_size;
+    size_type start_size;
+    size_type max_size;
+};
+
+/*! \brief A C++ Standard Library conforming allocator that allocates from an arena.
+
+Deallocation does nothing; the memory is released with the arena, which has to outlive the allocator
+and all containers that use it. Allocators are equal if they refer to the same arena.
+Allocation throws std::bad_alloc if the arena is out of memory.
+*/
+template <typename T, typename UserAllocator>
+class arena_allocator
+{
+  public:
+    typedef T value_type;
+    typedef UserAllocator user_allocator;
+    typedef value_type * pointer;
+    typedef const value_type * const_pointer;
+    typedef value_type & reference;
+    typedef const value_type & const_reference;
+    typedef typename arena<UserAllocator>::size_type size_type;
+    typedef typename arena<UserAllocator>::difference_type difference_type;
+
+    //! \brief Nested class rebind allows for transformation from
+    //! arena_allocator<T> to arena_allocator<U>.
+    template <typename U>
+    struct rebind
+    {
+      typedef arena_allocator<U, UserAllocator> other;
+    };
+
+  public:
+    explicit arena_allocator(arena<UserAllocator> & a)
+    : source(&a)
+    { //! Constructs an allocator that allocates from a.
+    }
+
+    // Not explicit, mimicking std::allocator [20.4.1]
+    template <typename U>
+    arena_allocator(const arena_allocator<U, UserAllocator> & other)
+    : source(&other.get_arena())
+    {
+    }
+
+    arena<UserAllocator> & get_arena() const
+    { //! \returns the arena that this allocator allocates from.
+      return *source;
+    }
+
+    static pointer address(reference r)
+    { return &r; }
+    static const_pointer address(const_reference s)
+    { return &s; }
+    static size_type max_size()
+    { return (std::numeric_limits<size_type>::max)() / sizeof(T); }
+    void construct(const pointer ptr, const value_type & t)
+    { new (ptr) T(t); }
+    void destroy(const pointer ptr)
+    {
+      ptr->~T();
+      (void) ptr; // Avoid unused variable warning.
+    }
+
+    bool operator==(const arena_allocator & other) const
+    { return source == other.source; }
+    bool operator!=(const arena_allocator & other) const
+    { return source != other.source; }
+
+    pointer allocate(const size_type n)
+    {
+      if (n > max_size())
+        boost::throw_exception(std::bad_alloc());
+      const pointer ret = static_cast<pointer>((source->malloc)(n * sizeof(T), alignment_of<T>::value));
+      if (ret == 0)
+        boost::throw_exception(std::bad_alloc());
+      return ret;
+    }
+    pointer allocate(const size_type n, const void * const)
+    { return allocate(n); }
+    static void deallocate(const pointer, const size_type)
+    { //! Does nothing: the memory is released with the arena.
+    }
+
+  private:
+    arena<UserAllocator> * source;
+};
+
+/*! \brief Specialization of arena_allocator<void>, required to make the allocator standard-conforming. */
+template <typename UserAllocator>
+class arena_allocator<void, UserAllocator>
+{
+  public:
+    typedef void*       pointer;
+    typedef const void* const_pointer;
+    typedef void        value_type;
+
+    template <class U> struct rebind
+    {
+      typedef arena_allocator<U, UserAllocator> other;
+    };
+};
+
+} // namespace boost
+
+#endif
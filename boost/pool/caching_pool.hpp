@@ -0,0 +1,413 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org for updates, documentation, and revision history.
+
+#ifndef BOOST_CACHING_POOL_HPP
+#define BOOST_CACHING_POOL_HPP
+
+/*!
+  \file
+  \brief The <tt>caching_pool</tt> class provides a singleton allocator for chunks of any size,
+  which scales with the number of threads.
+
+  \details Header caching_pool.hpp provides a template class <tt>caching_pool</tt>,
+  which rounds requests up to one of a set of size classes and serves each size class
+  from per-thread caches, which exchange chunks with a shared pool in batches.
+*/
+
+#include <boost/pool/poolfwd.hpp>
+
+// boost::pool
+#include <boost/pool/pool.hpp>
+// boost::details::pool::guard
+#include <boost/pool/detail/guard.hpp>
+
+#include <boost/type_traits/aligned_storage.hpp>
+// boost::detail::current_thread_hash
+#include <boost/detail/thread_hash.hpp>
+
+namespace boost {
+
+namespace details {
+namespace pool {
+
+//! Maps request sizes to the size classes of caching_pool: multiples of 16 bytes up to 128 bytes,
+//! then four classes for each power of two up to 4096 bytes.
+struct size_classes
+{
+  BOOST_STATIC_CONSTANT(std::size_t, count = 28); //!< The number of size classes.
+  BOOST_STATIC_CONSTANT(std::size_t, max_size = 4096); //!< The size of the largest size class.
+
+  static std::size_t index(const std::size_t bytes)
+  { //! \returns the index of the smallest size class that holds bytes.
+    //! \pre bytes <= max_size
+    if (bytes <= 128)
+      return bytes == 0 ? 0 : (bytes - 1) / 16;
+
+    std::size_t log = 7;
+    while (((bytes - 1) >> (log + 1)) != 0)
+      ++log;
+    return 8 + (log - 7) * 4 + ((bytes - 1) >> (log - 2)) - 4;
+  }
+
+  static std::size_t size(const std::size_t index)
+  { //! \returns the size of the chunks of a size class.
+    if (index < 8)
+      return (index + 1) * 16;
+    const std::size_t step = index - 8;
+    return (step % 4 + 5) << (step / 4 + 5);
+  }
+};
+
+} // namespace pool
+} // namespace details
+
+ /*!
+ The caching_pool class allocates chunks of any size from a set of size classes,
+ using per-thread caches in front of one shared pool per size class.
+ Template parameters are as follows:
+
+ <b>Tag</b> User-specified type to uniquely identify this pool: allows different unbounded sets of caching pools to exist.
+
+ <B>UserAllocator</b> User allocator, default = default_user_allocator_new_delete.
+
+ <b>Mutex</B> This class is the type of mutex used to protect the caches and the shared pools.
+ Can be any Boost.Thread Mutex type or <tt>boost::details::pool::null_mutex</tt>.
+
+ <b>CacheCount</b> The number of caches, default = 16.
+
+ <b>BatchSize</b> The number of chunks that a cache exchanges with the shared pool at once, default = 32.
+
+  <b>Notes:</b>
+
+  Requests are rounded up to the next size class (see <tt>details::pool::size_classes</tt>):
+  multiples of 16 bytes up to 128 bytes, and four classes per power of two up to 4096 bytes.
+  Larger requests are passed to UserAllocator directly.
+  Unlike the ordered_malloc(n) function of pool, a request for an array is thus never
+  served by searching a free list for contiguous chunks.
+
+  A thread uses the cache selected by its identity, and the next one if that cache is in use
+  by another thread, so that usually no two threads contend for a cache.
+  If both are in use, the thread accesses the shared pool of the size class instead.
+  A cache holds up to 2 * BatchSize chunks per size class.
+  An empty cache takes a batch of BatchSize chunks from the shared pool,
+  and a full cache returns a batch to it, both with a single lock of the shared pool.
+  Since chunks are exchanged with the shared pool, a chunk may be freed by another thread
+  than the one that allocated it, e.g. by the consumer of a producer/consumer queue.
+
+  As with singleton_pool, the caching_pool <b>is never freed</b>, and it is thread-safe if there is
+  only one thread running before main() begins and after main() ends.
+
+  If BOOST_POOL_VALGRIND is defined, the caches are bypassed, so that every chunk is returned to the
+  shared pool (which then uses the system allocator directly) when it is freed.
+  */
+
+template <typename Tag,
+    typename UserAllocator,
+    typename Mutex,
+    unsigned CacheCount,
+    unsigned BatchSize>
+class caching_pool
+{
+  public:
+    typedef Tag tag; //!< The Tag template parameter uniquely identifies this pool.
+    typedef Mutex mutex; //!< The type of mutex used to synchonise access to the caches and the shared pools.
+    typedef UserAllocator user_allocator; //!< The user-allocator used by this pool, default = <tt>default_user_allocator_new_delete</tt>.
+    typedef typename pool<UserAllocator>::size_type size_type; //!< size_type of user allocator.
+    typedef typename pool<UserAllocator>::difference_type difference_type; //!< difference_type of user allocator.
+
+    BOOST_STATIC_CONSTANT(unsigned, cache_count = CacheCount); //!< The number of caches.
+    BOOST_STATIC_CONSTANT(unsigned, batch_size = BatchSize); //!< The number of chunks exchanged with the shared pool at once.
+
+  private:
+    caching_pool();
+
+    typedef details::pool::size_classes size_classes;
+
+    static void * & nextof(void * const ptr)
+    { //! \returns the link to the next chunk in a list of chunks.
+      return *(static_cast<void **>(ptr));
+    }
+
+    static void * & next_batch(void * const ptr)
+    { //! \returns the link to the next batch, stored after nextof in the first chunk of a batch.
+      return *(static_cast<void **>(ptr) + 1);
+    }
+
+    struct chunk_list
+    {
+      void * first;
+      size_type size;
+    };
+
+    // The shared pool of a size class, which also keeps the batches returned by full caches.
+    struct central_pool: public Mutex, public pool<UserAllocator>
+    {
+      explicit central_pool(const size_type chunk_size)
+      : pool<UserAllocator>(chunk_size, BatchSize * 2), batches(0) {}
+
+      void * batches;
+    };
+
+    struct cache: public Mutex
+    {
+      cache()
+      {
+        for (std::size_t i = 0; i < size_classes::count; ++i)
+        {
+          lists[i].first = 0;
+          lists[i].size = 0;
+        }
+      }
+
+      chunk_list lists[size_classes::count];
+      char padding[64]; // avoids false sharing with the next cache
+    };
+
+    struct pool_type
+    {
+      pool_type()
+      {
+        for (std::size_t i = 0; i < size_classes::count; ++i)
+          new (&central[i]) central_pool(size_classes::size(i));
+      }
+
+      typedef boost::aligned_storage<sizeof(central_pool), boost::alignment_of<central_pool>::value> central_storage;
+
+      central_pool & get_central(const std::size_t index)
+      {
+        return *static_cast<central_pool *>(static_cast<void *>(&central[index]));
+      }
+
+      central_storage central[size_classes::count];
+      cache caches[CacheCount];
+    };
+
+  public:
+    static void * malloc BOOST_PREVENT_MACRO_SUBSTITUTION(const size_type n)
+    { //! Allocates a chunk of at least n bytes.
+      //! \returns a pointer to the chunk, or 0 if out-of-memory.
+      if (n > size_classes::max_size)
+        return (UserAllocator::malloc)(n);
+
+      pool_type & p = get_pool();
+      const std::size_t class_index = size_classes::index(n);
+#ifndef BOOST_POOL_VALGRIND
+      cache * const c = claim_cache(p);
+      if (c != 0)
+      {
+        chunk_list & list = c->lists[class_index];
+        if (list.first == 0)
+          refill(p.get_central(class_index), list);
+
+        void * const ret = list.first;
+        if (ret != 0)
+        {
+          list.first = nextof(ret);
+          --list.size;
+        }
+        c->unlock();
+        return ret;
+      }
+#endif
+      central_pool & central = p.get_central(class_index);
+      details::pool::guard<Mutex> g(central);
+      return (central.malloc)();
+    }
+
+    static void free BOOST_PREVENT_MACRO_SUBSTITUTION(void * const ptr, const size_type n)
+    { //! Frees a chunk that has been allocated by malloc(n).
+      //! \pre ptr has been returned by malloc(n) of this caching_pool and has not been freed since.
+      if (n > size_classes::max_size)
+      {
+        (UserAllocator::free)(static_cast<char *>(ptr));
+        return;
+      }
+
+      pool_type & p = get_pool();
+      const std::size_t class_index = size_classes::index(n);
+#ifndef BOOST_POOL_VALGRIND
+      cache * const c = claim_cache(p);
+      if (c != 0)
+      {
+        chunk_list & list = c->lists[class_index];
+        nextof(ptr) = list.first;
+        list.first = ptr;
+        if (++list.size == 2 * BatchSize)
+          flush(p.get_central(class_index), list);
+        c->unlock();
+        return;
+      }
+#endif
+      central_pool & central = p.get_central(class_index);
+      details::pool::guard<Mutex> g(central);
+      (central.free)(ptr);
+    }
+
+    static bool is_from(void * const ptr, const size_type n)
+    { //! \returns true if ptr has been allocated by malloc(n) of this caching_pool, even if it has been freed since.
+      //! Always false if n is larger than the largest size class.
+      if (n > size_classes::max_size)
+        return false;
+
+      central_pool & central = get_pool().get_central(size_classes::index(n));
+      details::pool::guard<Mutex> g(central);
+      return central.is_from(ptr);
+    }
+
+    static void release_caches()
+    { //! Returns the chunks of all caches to the shared pools, e.g. before a program becomes single-threaded.
+      pool_type & p = get_pool();
+      for (unsigned i = 0; i < CacheCount; ++i)
+      {
+        details::pool::guard<Mutex> g(p.caches[i]);
+        for (std::size_t j = 0; j < size_classes::count; ++j)
+        {
+          chunk_list & list = p.caches[i].lists[j];
+          if (list.first == 0)
+            continue;
+
+          central_pool & central = p.get_central(j);
+          details::pool::guard<Mutex> central_guard(central);
+          while (list.first != 0)
+          {
+            void * const chunk = list.first;
+            list.first = nextof(chunk);
+            (central.free)(chunk);
+          }
+          list.size = 0;
+        }
+      }
+    }
+
+    static bool purge_memory()
+    { //! Frees all chunks of the shared pools and the caches, even if they are still in use.
+      //! \returns true if memory was actually deallocated.
+      pool_type & p = get_pool();
+      for (unsigned i = 0; i < CacheCount; ++i)
+      {
+        details::pool::guard<Mutex> g(p.caches[i]);
+        for (std::size_t j = 0; j < size_classes::count; ++j)
+        {
+          p.caches[i].lists[j].first = 0;
+          p.caches[i].lists[j].size = 0;
+        }
+      }
+
+      bool ret = false;
+      for (std::size_t j = 0; j < size_classes::count; ++j)
+      {
+        central_pool & central = p.get_central(j);
+        details::pool::guard<Mutex> g(central);
+        central.batches = 0;
+        ret = central.purge_memory() || ret;
+      }
+      return ret;
+    }
+
+  private:
+    static cache * claim_cache(pool_type & p)
+    { //! Locks the cache of the calling thread, or the next one if another thread holds it.
+      //! \returns the locked cache, or 0 if both are in use.
+      const std::size_t slot = boost::detail::current_thread_hash();
+      for (unsigned i = 0; i < 2; ++i)
+      {
+        cache & c = p.caches[(slot + i) % CacheCount];
+        if (c.try_lock())
+          return &c;
+      }
+      return 0;
+    }
+
+    static void refill(central_pool & central, chunk_list & list)
+    { //! Moves a batch of chunks from the shared pool to an empty list.
+      details::pool::guard<Mutex> g(central);
+      if (central.batches != 0)
+      {
+        list.first = central.batches;
+        list.size = BatchSize;
+        central.batches = next_batch(central.batches);
+        return;
+      }
+
+      for (unsigned i = 0; i < BatchSize; ++i)
+      {
+        void * const chunk = (central.malloc)();
+        if (chunk == 0)
+          break;
+        nextof(chunk) = list.first;
+        list.first = chunk;
+        ++list.size;
+      }
+    }
+
+    static void flush(central_pool & central, chunk_list & list)
+    { //! Moves the least recently freed half of a full list to the shared pool as a batch.
+      void * last_kept = list.first;
+      for (unsigned i = 1; i < list.size - BatchSize; ++i)
+        last_kept = nextof(last_kept);
+      void * const batch = nextof(last_kept);
+      nextof(last_kept) = 0;
+      list.size -= BatchSize;
+
+      details::pool::guard<Mutex> g(central);
+      next_batch(batch) = central.batches;
+      central.batches = batch;
+    }
+
+    typedef boost::aligned_storage<sizeof(pool_type), boost::alignment_of<pool_type>::value> storage_type;
+    static storage_type storage;
+
+    static pool_type & get_pool()
+    {
+      static bool f = false;
+      if(!f)
+      {
+         // This code *must* be called before main() starts,
+         // and when only one thread is executing.
+         f = true;
+         new (&storage) pool_type;
+      }
+
+      // The following line does nothing else than force the instantiation
+      //  of caching_pool::create_object, whose constructor is
+      //  called before main() begins.
+      create_object.do_nothing();
+
+      return *static_cast<pool_type *>(static_cast<void *>(&storage));
+    }
+
+    struct object_creator
+    {
+      object_creator()
+      {  // This constructor does nothing more than ensure that get_pool()
+         //  is called before main() begins, thus creating the pools
+         //  before multithreading race issues can come up.
+         caching_pool<Tag, UserAllocator, Mutex, CacheCount, BatchSize>::get_pool();
+      }
+      inline void do_nothing() const
+      {
+      }
+    };
+    static object_creator create_object;
+}; // class caching_pool
+
+template <typename Tag,
+    typename UserAllocator,
+    typename Mutex,
+    unsigned CacheCount,
+    unsigned BatchSize>
+typename caching_pool<Tag, UserAllocator, Mutex, CacheCount, BatchSize>::storage_type caching_pool<Tag, UserAllocator, Mutex, CacheCount, BatchSize>::storage;
+
+template <typename Tag,
+    typename UserAllocator,
+    typename Mutex,
+    unsigned CacheCount,
+    unsigned BatchSize>
+typename caching_pool<Tag, UserAllocator, Mutex, CacheCount, BatchSize>::object_creator caching_pool<Tag, UserAllocator, Mutex, CacheCount, BatchSize>::create_object;
+
+} // namespace boost
+
+#endif
@@ -13,12 +13,12 @@
 /*!
   \file
   \brief C++ Standard Library compatible pool-based allocators.
-  \details  This header provides two template types - 
-  \ref pool_allocator and \ref fast_pool_allocator -
+  \details  This header provides three template types - 
+  \ref pool_allocator, \ref fast_pool_allocator and \ref caching_pool_allocator -
   that can be used for fast and efficient memory allocation
   in conjunction with the C++ Standard Library containers.
 
-  These types both satisfy the Standard Allocator requirements [20.1.5]
+  These types all satisfy the Standard Allocator requirements [20.1.5]
   and the additional requirements in [20.1.5/4],
   so they can be used with either Standard or user-supplied containers.
 
@@ -76,6 +76,8 @@ STLport (with any compiler), ver. 4.0 and earlier.
 
 // boost::singleton_pool
 #include <boost/pool/singleton_pool.hpp>
+// boost::caching_pool
+#include <boost/pool/caching_pool.hpp>
 
 #include <boost/detail/workaround.hpp>
 
@@ -483,6 +485,169 @@ public:
     };
 };
 
+//! Simple tag type used by caching_pool_allocator as a template parameter to the underlying caching_pool.
+struct caching_pool_allocator_tag
+{
+};
+
+ /*! \brief A C++ Standard Library conforming allocator for containers of any kind, which scales with the number of threads.
+
+  <tt>caching_pool_allocator</tt> allocates from a caching_pool, which rounds each request up to a size class
+  and serves it from a per-thread cache. All instantiations share the same caching_pool,
+  so that <tt>caching_pool_allocator<T></tt> serves arrays of T as efficiently as single objects:
+  use it with node-based containers such as <tt>std::list</tt> as well as with <tt>std::vector</tt>.
+  Requests for more than 4096 bytes are passed to UserAllocator directly.
+
+  Chunks may be deallocated by a different thread than the one that allocated them.
+
+  The template parameters are defined as follows:
+
+  <b>T</b> Type of object to allocate/deallocate.
+
+  <b>UserAllocator</b>. Defines the method that the underlying caching_pool will use to allocate memory from the system.
+  See <a href="boost_pool/pool/pooling.html#boost_pool.pool.pooling.user_allocator">User Allocators</a> for details.
+
+  <b>Mutex</b> Allows the user to determine the type of synchronization to be used on the underlying <tt>caching_pool</tt>.
+
+   \attention
+  The underlying caching_pool used by the this allocator
+  constructs a pool instance that
+  <b>is never freed</b>.  This means that memory allocated
+  by the allocator can be still used after main() has
+  completed, but may mean that some memory checking programs
+  will complain about leaks.
+
+ */
+
+template <typename T,
+    typename UserAllocator,
+    typename Mutex>
+class caching_pool_allocator
+{
+  public:
+    typedef T value_type;
+    typedef UserAllocator user_allocator;
+    typedef Mutex mutex;
+
+    typedef value_type * pointer;
+    typedef const value_type * const_pointer;
+    typedef value_type & reference;
+    typedef const value_type & const_reference;
+    typedef typename pool<UserAllocator>::size_type size_type;
+    typedef typename pool<UserAllocator>::difference_type difference_type;
+
+    //! \brief Nested class rebind allows for transformation from
+    //! caching_pool_allocator<T> to caching_pool_allocator<U>.
+    //!
+    //! Nested class rebind allows for transformation from
+    //! caching_pool_allocator<T> to caching_pool_allocator<U> via the member
+    //! typedef other.
+    template <typename U>
+    struct rebind
+    {
+      typedef caching_pool_allocator<U, UserAllocator, Mutex> other;
+    };
+
+  private:
+    typedef caching_pool<caching_pool_allocator_tag, UserAllocator, Mutex> pool_type;
+
+  public:
+    caching_pool_allocator()
+    {
+      //! Ensures construction of the underlying caching_pool IFF an
+      //! instance of this allocator is constructed during global
+      //! initialization. See ticket #2359 for a complete explanation
+      //! at http://svn.boost.org/trac/boost/ticket/2359 .
+      pool_type::is_from(0, 0);
+    }
+
+    // Default copy constructor used.
+
+    // Default assignment operator used.
+
+    // Not explicit, mimicking std::allocator [20.4.1]
+    template <typename U>
+    caching_pool_allocator(const caching_pool_allocator<U, UserAllocator, Mutex> &)
+    {
+      //! Ensures construction of the underlying caching_pool IFF an
+      //! instance of this allocator is constructed during global
+      //! initialization. See ticket #2359 for a complete explanation
+      //! at http://svn.boost.org/trac/boost/ticket/2359 .
+      pool_type::is_from(0, 0);
+    }
+
+    // Default destructor used.
+
+    static pointer address(reference r)
+    { return &r; }
+    static const_pointer address(const_reference s)
+    { return &s; }
+    static size_type max_size()
+    { return (std::numeric_limits<size_type>::max)() / sizeof(T); }
+    void construct(const pointer ptr, const value_type & t)
+    { new (ptr) T(t); }
+    void destroy(const pointer ptr)
+    { //! Destroy ptr using destructor.
+      ptr->~T();
+      (void) ptr; // Avoid unused variable warning.
+    }
+
+    bool operator==(const caching_pool_allocator &) const
+    { return true; }
+    bool operator!=(const caching_pool_allocator &) const
+    { return false; }
+
+    static pointer allocate(const size_type n)
+    {
+      if (n > max_size())
+        boost::throw_exception(std::bad_alloc());
+      const pointer ret = static_cast<pointer>(
+          (pool_type::malloc)(n * sizeof(T)) );
+      if (ret == 0)
+        boost::throw_exception(std::bad_alloc());
+      return ret;
+    }
+    static pointer allocate(const size_type n, const void * const)
+    { //! Allocate memory .
+      return allocate(n);
+    }
+    static void deallocate(const pointer ptr, const size_type n)
+    { //! Deallocate memory.
+
+#ifdef BOOST_NO_PROPER_STL_DEALLOCATE
+      if (ptr == 0 || n == 0)
+        return;
+#endif
+      (pool_type::free)(ptr, n * sizeof(T));
+    }
+};
+
+/*!  \brief Specialization of caching_pool_allocator<void>.
+
+Specialization of caching_pool_allocator<void> required to make the allocator standard-conforming.
+*/
+template<
+    typename UserAllocator,
+    typename Mutex>
+class caching_pool_allocator<void, UserAllocator, Mutex>
+{
+public:
+    typedef void*       pointer;
+    typedef const void* const_pointer;
+    typedef void        value_type;
+
+    //! \brief Nested class rebind allows for transformation from
+    //! caching_pool_allocator<T> to caching_pool_allocator<U>.
+    //!
+    //! Nested class rebind allows for transformation from
+    //! caching_pool_allocator<T> to caching_pool_allocator<U> via the member
+    //! typedef other.
+    template <class U> struct rebind
+    {
+        typedef caching_pool_allocator<U, UserAllocator, Mutex> other;
+    };
+};
+
 } // namespace boost
 
 #endif
@@ -46,6 +46,15 @@ class pool;
 template <typename T, typename UserAllocator = default_user_allocator_new_delete>
 class object_pool;
 
+//
+// Location: <boost/pool/arena.hpp>
+//
+template <typename UserAllocator = default_user_allocator_new_delete>
+class arena;
+
+template <typename T, typename UserAllocator = default_user_allocator_new_delete>
+class arena_allocator;
+
 //
 // Location: <boost/pool/singleton_pool.hpp>
 //
@@ -56,6 +65,16 @@ template <typename Tag, unsigned RequestedSize,
     unsigned MaxSize = 0>
 class singleton_pool;
 
+//
+// Location: <boost/pool/caching_pool.hpp>
+//
+template <typename Tag,
+    typename UserAllocator = default_user_allocator_new_delete,
+    typename Mutex = details::pool::default_mutex,
+    unsigned CacheCount = 16,
+    unsigned BatchSize = 32>
+class caching_pool;
+
 //
 // Location: <boost/pool/pool_alloc.hpp>
 //
@@ -77,6 +96,13 @@ template <typename T,
     unsigned MaxSize = 0>
 class fast_pool_allocator;
 
+struct caching_pool_allocator_tag;
+
+template <typename T,
+    typename UserAllocator = default_user_allocator_new_delete,
+    typename Mutex = details::pool::default_mutex>
+class caching_pool_allocator;
+
 } // namespace boost
 
 #endif
@@ -38,6 +38,9 @@ namespace std{
 #include <boost/serialization/detail/stack_constructor.hpp>
 #include <boost/serialization/collection_size_type.hpp>
 #include <boost/serialization/item_version_type.hpp>
+#include <boost/serialization/array.hpp>
+#include <boost/type_traits/remove_const.hpp>
+#include <boost/mpl/bool.hpp>
 
 namespace boost{
 namespace serialization {
@@ -159,6 +162,60 @@ inline void load_collection(Archive & ar, Container &s)
     }
 }
 
+// contiguous containers - the counterpart of save_contiguous_collection.
+// Some library versions wrote an item version after the count even for
+// the block format - the caller knows which (see vector.hpp).
+
+template<class Archive, class Container>
+inline void load_contiguous_collection(
+    Archive & ar, 
+    Container &s, 
+    bool /* item_versioned */,
+    mpl::false_
+){
+    load_collection<
+        Archive,
+        Container,
+        archive_input_seq<Archive, Container>,
+        reserve_imp<Container>
+    >(ar, s);
+}
+
+template<class Archive, class Container>
+inline void load_contiguous_collection(
+    Archive & ar, 
+    Container &s, 
+    bool item_versioned,
+    mpl::true_
+){
+    collection_size_type count(s.size());
+    ar >> BOOST_SERIALIZATION_NVP(count);
+    s.resize(count);
+    unsigned int item_version=0;
+    if(item_versioned) {
+        ar >> BOOST_SERIALIZATION_NVP(item_version);
+    }
+    if(! s.empty())
+        ar >> make_array(& s[0], s.size());
+}
+
+template<class Archive, class Container>
+inline void load_contiguous_collection(
+    Archive & ar, 
+    Container &s, 
+    bool item_versioned
+){
+    typedef BOOST_DEDUCED_TYPENAME 
+    boost::serialization::use_array_optimization<Archive>::template apply<
+        BOOST_DEDUCED_TYPENAME remove_const<
+            BOOST_DEDUCED_TYPENAME Container::value_type
+        >::type 
+    >::type use_optimized;
+    load_contiguous_collection<Archive, Container>(
+        ar, s, item_versioned, use_optimized()
+    );
+}
+
 } // namespace stl 
 } // namespace serialization
 } // namespace boost
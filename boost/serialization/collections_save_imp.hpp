@@ -24,6 +24,9 @@
 #include <boost/serialization/version.hpp>
 #include <boost/serialization/collection_size_type.hpp>
 #include <boost/serialization/item_version_type.hpp>
+#include <boost/serialization/array.hpp>
+#include <boost/type_traits/remove_const.hpp>
+#include <boost/mpl/bool.hpp>
 
 namespace boost{
 namespace serialization {
@@ -65,6 +68,43 @@ inline void save_collection(Archive & ar, const Container &s)
     }
 }
 
+// contiguous containers - std::vector and the like.  Archives which can
+// save an array of the value type as a single block (see array.hpp) get
+// the count followed by the block, others the usual collection.
+
+template<class Archive, class Container>
+inline void save_contiguous_collection(
+    Archive & ar, 
+    const Container &s, 
+    mpl::false_
+){
+    save_collection<Archive, Container>(ar, s);
+}
+
+template<class Archive, class Container>
+inline void save_contiguous_collection(
+    Archive & ar, 
+    const Container &s, 
+    mpl::true_
+){
+    const collection_size_type count(s.size());
+    ar << BOOST_SERIALIZATION_NVP(count);
+    if(! s.empty())
+        ar << make_array(& s[0], s.size());
+}
+
+template<class Archive, class Container>
+inline void save_contiguous_collection(Archive & ar, const Container &s)
+{
+    typedef BOOST_DEDUCED_TYPENAME 
+    boost::serialization::use_array_optimization<Archive>::template apply<
+        BOOST_DEDUCED_TYPENAME remove_const<
+            BOOST_DEDUCED_TYPENAME Container::value_type
+        >::type 
+    >::type use_optimized;
+    save_contiguous_collection<Archive, Container>(ar, s, use_optimized());
+}
+
 } // namespace stl 
 } // namespace serialization
 } // namespace boost
@@ -0,0 +1,76 @@
+#ifndef  BOOST_SERIALIZATION_CONTAINER_VECTOR_HPP
+#define BOOST_SERIALIZATION_CONTAINER_VECTOR_HPP
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+# pragma once
+#endif
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// container_vector.hpp: serialization for boost::container::vector
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org for updates, documentation, and revision history.
+
+// The archive format is that of std::vector so that either container can
+// be loaded from what the other has saved.
+
+#include <boost/config.hpp>
+#include <boost/container/vector.hpp>
+
+#include <boost/serialization/vector.hpp> // BOOST_SERIALIZATION_VECTOR_VERSIONED
+#include <boost/serialization/collections_save_imp.hpp>
+#include <boost/serialization/collections_load_imp.hpp>
+#include <boost/serialization/split_free.hpp>
+
+namespace boost {
+namespace serialization {
+
+template<class Archive, class U, class Allocator>
+inline void save(
+    Archive & ar,
+    const boost::container::vector<U, Allocator> &t,
+    const unsigned int /* file_version */
+){
+    boost::serialization::stl::save_contiguous_collection<
+        Archive, boost::container::vector<U, Allocator>
+    >(ar, t);
+}
+
+template<class Archive, class U, class Allocator>
+inline void load(
+    Archive & ar,
+    boost::container::vector<U, Allocator> &t,
+    const unsigned int /* file_version */
+){
+    boost::serialization::stl::load_contiguous_collection<
+        Archive, boost::container::vector<U, Allocator>
+    >(
+        ar,
+        t,
+        BOOST_SERIALIZATION_VECTOR_VERSIONED(ar.get_library_version())
+    );
+}
+
+// split non-intrusive serialization function member into separate
+// non intrusive save/load member functions
+template<class Archive, class U, class Allocator>
+inline void serialize(
+    Archive & ar,
+    boost::container::vector<U, Allocator> & t,
+    const unsigned int file_version
+){
+    boost::serialization::split_free(ar, t, file_version);
+}
+
+} // serialization
+} // namespace boost
+
+#include <boost/serialization/collection_traits.hpp>
+
+BOOST_SERIALIZATION_COLLECTION_TRAITS(boost::container::vector)
+
+#endif // BOOST_SERIALIZATION_CONTAINER_VECTOR_HPP
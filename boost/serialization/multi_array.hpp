@@ -0,0 +1,132 @@
+#ifndef  BOOST_SERIALIZATION_MULTI_ARRAY_HPP
+#define BOOST_SERIALIZATION_MULTI_ARRAY_HPP
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+# pragma once
+#endif
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// multi_array.hpp: serialization for boost::multi_array
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org for updates, documentation, and revision history.
+
+// The shape - extent and index base of each dimension - and the storage
+// order are saved first, followed by the elements in the order they are
+// stored in memory.  Archives which support it write the elements as a
+// single block (see array.hpp).  On loading, an array with a different
+// storage order receives the elements by index.
+
+#include <algorithm> // std::equal
+#include <cstddef> // size_t
+
+#include <boost/config.hpp>
+#include <boost/array.hpp>
+#include <boost/multi_array.hpp>
+
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_free.hpp>
+#include <boost/serialization/array.hpp>
+#include <boost/serialization/collection_size_type.hpp>
+
+namespace boost {
+namespace serialization {
+
+template<class Archive, class T, std::size_t N, class Allocator>
+inline void save(
+    Archive & ar,
+    const boost::multi_array<T, N, Allocator> &t,
+    const unsigned int /* file_version */
+){
+    typedef BOOST_DEDUCED_TYPENAME
+        boost::multi_array<T, N, Allocator>::index index;
+    for(std::size_t i = 0; i < N; ++i){
+        const collection_size_type extent(t.shape()[i]);
+        const index index_base = t.index_bases()[i];
+        ar << BOOST_SERIALIZATION_NVP(extent);
+        ar << BOOST_SERIALIZATION_NVP(index_base);
+    }
+    for(std::size_t i = 0; i < N; ++i){
+        const unsigned int ordering =
+            static_cast<unsigned int>(t.storage_order().ordering(i));
+        const bool ascending = t.storage_order().ascending(i);
+        ar << BOOST_SERIALIZATION_NVP(ordering);
+        ar << BOOST_SERIALIZATION_NVP(ascending);
+    }
+    if(0 != t.num_elements())
+        ar << make_array(t.data(), t.num_elements());
+}
+
+template<class Archive, class T, std::size_t N, class Allocator>
+inline void load(
+    Archive & ar,
+    boost::multi_array<T, N, Allocator> &t,
+    const unsigned int /* file_version */
+){
+    typedef boost::multi_array<T, N, Allocator> array_type;
+    typedef BOOST_DEDUCED_TYPENAME array_type::index index;
+    typedef BOOST_DEDUCED_TYPENAME array_type::size_type size_type;
+
+    boost::array<size_type, N> extents;
+    boost::array<index, N> index_bases;
+    for(std::size_t i = 0; i < N; ++i){
+        collection_size_type extent;
+        index index_base;
+        ar >> BOOST_SERIALIZATION_NVP(extent);
+        ar >> BOOST_SERIALIZATION_NVP(index_base);
+        extents[i] = extent;
+        index_bases[i] = index_base;
+    }
+    boost::array<size_type, N> orderings;
+    boost::array<bool, N> ascendings;
+    for(std::size_t i = 0; i < N; ++i){
+        unsigned int ordering;
+        bool ascending;
+        ar >> BOOST_SERIALIZATION_NVP(ordering);
+        ar >> BOOST_SERIALIZATION_NVP(ascending);
+        orderings[i] = ordering;
+        ascendings[i] = ascending;
+    }
+    const boost::general_storage_order<N> order(
+        orderings.begin(),
+        ascendings.begin()
+    );
+
+    // resize copies the current contents, so skip it when the shape
+    // is right already
+    if(! std::equal(extents.begin(), extents.end(), t.shape()))
+        t.resize(extents);
+    t.reindex(index_bases);
+
+    if(order == t.storage_order()){
+        // the usual case - the elements go straight into place
+        if(0 != t.num_elements())
+            ar >> make_array(t.data(), t.num_elements());
+        return;
+    }
+    array_type tmp(extents, order);
+    tmp.reindex(index_bases);
+    if(0 != tmp.num_elements())
+        ar >> make_array(tmp.data(), tmp.num_elements());
+    t = tmp;
+}
+
+// split non-intrusive serialization function member into separate
+// non intrusive save/load member functions
+template<class Archive, class T, std::size_t N, class Allocator>
+inline void serialize(
+    Archive & ar,
+    boost::multi_array<T, N, Allocator> & t,
+    const unsigned int file_version
+){
+    boost::serialization::split_free(ar, t, file_version);
+}
+
+} // serialization
+} // namespace boost
+
+#endif // BOOST_SERIALIZATION_MULTI_ARRAY_HPP
@@ -0,0 +1,333 @@
+#ifndef BOOST_SERIALIZATION_PARALLEL_VECTOR_HPP
+#define BOOST_SERIALIZATION_PARALLEL_VECTOR_HPP
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+# pragma once
+#endif
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// parallel_vector.hpp: save and load the elements of a vector on several
+// threads
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org for updates, documentation, and revision history.
+
+// The elements are divided into one chunk per thread.  Each chunk is
+// saved by its own thread to a binary_buffer_oarchive and the results
+// are written one after the other, preceded by an index of the number of
+// elements and bytes in each chunk.  Loading reads the chunks and then
+// loads them on as many threads as are asked for.
+//
+//  oa << boost::serialization::make_parallel_vector(v);
+//  ia >> boost::serialization::make_parallel_vector(v, 4);
+//
+// As each chunk is a separate archive, elements must not refer to each
+// other: the element type must not be tracked.  The chunks are native
+// binary data whatever the archive they are written to, and are held in
+// memory while the whole vector is saved or loaded.  Each chunk is
+// written in pieces of bounded size, so that loading never allocates much
+// more memory than the archive actually holds, whatever its index says.
+//
+// Programs using this header must be linked with Boost.Thread.
+
+#include <algorithm> // std::min
+#include <cstddef> // std::size_t
+#include <vector>
+
+#include <boost/config.hpp>
+#if defined(BOOST_NO_STDC_NAMESPACE)
+namespace std{
+    using ::size_t;
+} // namespace std
+#endif
+
+#include <boost/static_assert.hpp>
+#include <boost/detail/no_exceptions_support.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/array.hpp>
+#include <boost/serialization/binary_object.hpp>
+#include <boost/serialization/collection_size_type.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/throw_exception.hpp>
+#include <boost/serialization/tracking.hpp>
+#include <boost/serialization/wrapper.hpp>
+
+#include <boost/archive/archive_exception.hpp>
+#include <boost/archive/binary_buffer_oarchive.hpp>
+#include <boost/archive/binary_buffer_iarchive.hpp>
+
+namespace boost {
+namespace serialization {
+
+namespace parallel_detail {
+
+template<class T>
+struct save_chunk
+{
+    const T * m_first;
+    std::size_t m_count;
+    std::vector<char> * m_buffer;
+    void operator()() const {
+        boost::archive::binary_buffer_oarchive oa(* m_buffer);
+        oa << make_array(m_first, m_count);
+    }
+};
+
+template<class T>
+struct load_chunk
+{
+    T * m_first;
+    std::size_t m_count;
+    const std::vector<char> * m_buffer;
+    void operator()() const {
+        boost::archive::binary_buffer_iarchive ia(* m_buffer);
+        ia >> make_array(m_first, m_count);
+    }
+};
+
+// run every nth task from the first, keeping the first exception thrown
+template<class Task>
+struct run_tasks
+{
+    const Task * m_first;
+    std::size_t m_count;
+    std::size_t m_stride;
+    boost::exception_ptr * m_error;
+    void operator()() const {
+        BOOST_TRY {
+            for(std::size_t i = 0; i < m_count; i += m_stride)
+                m_first[i]();
+        }
+        BOOST_CATCH(const boost::archive::archive_exception & e){
+            // current_exception() would lose the type of this one
+            * m_error = boost::copy_exception(e);
+        }
+        BOOST_CATCH(...){
+            * m_error = boost::current_exception();
+        }
+        BOOST_CATCH_END
+    }
+};
+
+// run the tasks on up to the given number of threads, one of which is
+// the calling thread, and rethrow any exception once all have finished
+template<class Task>
+void
+run(const std::vector<Task> & tasks, std::size_t threads){
+    if(tasks.empty())
+        return;
+    if(tasks.size() < threads)
+        threads = tasks.size();
+    if(0 == threads)
+        threads = 1;
+    std::vector<boost::exception_ptr> errors(threads);
+    std::vector<run_tasks<Task> > runs(threads);
+    for(std::size_t i = 0; i < threads; ++i){
+        runs[i].m_first = & tasks[i];
+        runs[i].m_count = tasks.size() - i;
+        runs[i].m_stride = threads;
+        runs[i].m_error = & errors[i];
+    }
+    boost::thread_group group;
+    BOOST_TRY {
+        for(std::size_t i = 1; i < threads; ++i)
+            group.create_thread(runs[i]);
+    }
+    BOOST_CATCH(...){
+        // the threads use runs and errors, so must finish first
+        group.join_all();
+        BOOST_RETHROW
+    }
+    BOOST_CATCH_END
+    runs[0]();
+    group.join_all();
+    for(std::size_t i = 0; i < threads; ++i)
+        if(errors[i])
+            boost::rethrow_exception(errors[i]);
+}
+
+// the largest piece of a chunk written as one binary object
+const std::size_t piece_size = 1 << 20;
+
+inline std::size_t
+default_threads(){
+    const unsigned int n = boost::thread::hardware_concurrency();
+    return 0 == n ? 1 : n;
+}
+
+} // namespace parallel_detail
+
+template<class T, class Allocator>
+class parallel_vector :
+    public wrapper_traits<const parallel_vector<T, Allocator> >
+{
+    // each chunk is a separate archive, so objects in one can't be
+    // referred to from another
+    BOOST_STATIC_ASSERT(
+        track_never == tracking_level< T >::value
+    );
+    std::vector<T, Allocator> & m_t;
+    std::size_t m_threads;
+public:
+    template<class Archive>
+    void save(Archive & ar, const unsigned int /* file_version */) const {
+        const std::size_t count = m_t.size();
+        std::size_t chunks = (0 == m_threads)
+            ? parallel_detail::default_threads()
+            : m_threads;
+        if(count < chunks)
+            chunks = count;
+        std::vector<std::vector<char> > buffers(chunks);
+        std::vector<parallel_detail::save_chunk< T > > tasks(chunks);
+        std::size_t first = 0;
+        for(std::size_t i = 0; i < chunks; ++i){
+            tasks[i].m_first = & m_t[first];
+            // spread the remainder over the first chunks
+            tasks[i].m_count = count / chunks + (i < count % chunks ? 1 : 0);
+            tasks[i].m_buffer = & buffers[i];
+            first += tasks[i].m_count;
+        }
+        parallel_detail::run(tasks, chunks);
+
+        const collection_size_type c(count);
+        ar << make_nvp("count", c);
+        const collection_size_type n(chunks);
+        ar << make_nvp("chunks", n);
+        // the index
+        for(std::size_t i = 0; i < chunks; ++i){
+            const collection_size_type elements(tasks[i].m_count);
+            const collection_size_type size(buffers[i].size());
+            ar << BOOST_SERIALIZATION_NVP(elements);
+            ar << BOOST_SERIALIZATION_NVP(size);
+        }
+        for(std::size_t i = 0; i < chunks; ++i){
+            const std::size_t size = buffers[i].size();
+            for(std::size_t offset = 0; offset < size;){
+                const std::size_t piece = (std::min)(
+                    parallel_detail::piece_size, size - offset
+                );
+                ar << make_nvp(
+                    "chunk",
+                    make_binary_object(& buffers[i][offset], piece)
+                );
+                offset += piece;
+            }
+            // release the memory as soon as it can be
+            std::vector<char>().swap(buffers[i]);
+        }
+    }
+    template<class Archive>
+    void load(Archive & ar, const unsigned int /* file_version */) const {
+        collection_size_type c;
+        ar >> make_nvp("count", c);
+        collection_size_type n;
+        ar >> make_nvp("chunks", n);
+        const std::size_t count = c;
+        const std::size_t chunks = n;
+        if(count < chunks)
+            boost::serialization::throw_exception(
+                boost::archive::archive_exception(
+                    boost::archive::archive_exception::input_stream_error
+                )
+            );
+        // nothing is allocated in proportion to the counts and sizes read
+        // until data that bears them out has been read: the index grows as
+        // it is read and the chunks as their pieces are read
+        std::vector<parallel_detail::load_chunk< T > > tasks;
+        std::vector<std::size_t> sizes;
+        std::size_t total = 0;
+        for(std::size_t i = 0; i < chunks; ++i){
+            collection_size_type elements;
+            collection_size_type size;
+            ar >> BOOST_SERIALIZATION_NVP(elements);
+            ar >> BOOST_SERIALIZATION_NVP(size);
+            if(count - total < elements)
+                boost::serialization::throw_exception(
+                    boost::archive::archive_exception(
+                        boost::archive::archive_exception::input_stream_error
+                    )
+                );
+            tasks.push_back(parallel_detail::load_chunk< T >());
+            tasks.back().m_count = elements;
+            total += elements;
+            sizes.push_back(size);
+        }
+        if(total != count)
+            boost::serialization::throw_exception(
+                boost::archive::archive_exception(
+                    boost::archive::archive_exception::input_stream_error
+                )
+            );
+        std::vector<std::vector<char> > buffers(chunks);
+        for(std::size_t i = 0; i < chunks; ++i){
+            std::vector<char> & buffer = buffers[i];
+            while(buffer.size() < sizes[i]){
+                const std::size_t offset = buffer.size();
+                const std::size_t piece = (std::min)(
+                    parallel_detail::piece_size, sizes[i] - offset
+                );
+                buffer.resize(offset + piece);
+                ar >> make_nvp(
+                    "chunk",
+                    make_binary_object(& buffer[offset], piece)
+                );
+            }
+            tasks[i].m_buffer = & buffer;
+        }
+
+        m_t.clear();
+        m_t.resize(count);
+        total = 0;
+        for(std::size_t i = 0; i < chunks; ++i){
+            tasks[i].m_first = & m_t[total];
+            total += tasks[i].m_count;
+        }
+        parallel_detail::run(
+            tasks,
+            (0 == m_threads) ? parallel_detail::default_threads() : m_threads
+        );
+    }
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+    // the number of threads to use, or 0 for as many as the hardware has
+    parallel_vector(std::vector<T, Allocator> & t, std::size_t threads) :
+        m_t(t),
+        m_threads(threads)
+    {}
+};
+
+template<class T, class Allocator>
+inline
+#ifndef BOOST_NO_FUNCTION_TEMPLATE_ORDERING
+const
+#endif
+parallel_vector<T, Allocator>
+make_parallel_vector(std::vector<T, Allocator> & t, std::size_t threads = 0){
+    return parallel_vector<T, Allocator>(t, threads);
+}
+
+// for saving only
+template<class T, class Allocator>
+inline
+#ifndef BOOST_NO_FUNCTION_TEMPLATE_ORDERING
+const
+#endif
+parallel_vector<T, Allocator>
+make_parallel_vector(const std::vector<T, Allocator> & t, std::size_t threads = 0){
+    return parallel_vector<T, Allocator>(
+        const_cast<std::vector<T, Allocator> &>(t),
+        threads
+    );
+}
+
+} // namespace serialization
+} // namespace boost
+
+#endif // BOOST_SERIALIZATION_PARALLEL_VECTOR_HPP
@@ -58,9 +58,9 @@ inline void save(
     const unsigned int /* file_version */,
     mpl::false_
 ){
-    boost::serialization::stl::save_collection<Archive, STD::vector<U, Allocator> >(
-        ar, t
-    );
+    boost::serialization::stl::save_contiguous_collection<
+        Archive, STD::vector<U, Allocator> 
+    >(ar, t, mpl::false_());
 }
 
 template<class Archive, class U, class Allocator>
@@ -70,14 +70,9 @@ inline void load(
     const unsigned int /* file_version */,
     mpl::false_
 ){
-    boost::serialization::stl::load_collection<
-        Archive,
-        std::vector<U, Allocator>,
-        boost::serialization::stl::archive_input_seq<
-            Archive, STD::vector<U, Allocator> 
-        >,
-        boost::serialization::stl::reserve_imp<STD::vector<U, Allocator> >
-    >(ar, t);
+    boost::serialization::stl::load_contiguous_collection<
+        Archive, STD::vector<U, Allocator> 
+    >(ar, t, false, mpl::false_());
 }
 
 // the optimized versions
@@ -89,10 +84,9 @@ inline void save(
     const unsigned int /* file_version */,
     mpl::true_
 ){
-    const collection_size_type count(t.size());
-    ar << BOOST_SERIALIZATION_NVP(count);
-    if (!t.empty())
-        ar << make_array(detail::get_data(t),t.size());
+    boost::serialization::stl::save_contiguous_collection<
+        Archive, STD::vector<U, Allocator> 
+    >(ar, t, mpl::true_());
 }
 
 template<class Archive, class U, class Allocator>
@@ -102,16 +96,15 @@ inline void load(
     const unsigned int /* file_version */,
     mpl::true_
 ){
-    collection_size_type count(t.size());
-    ar >> BOOST_SERIALIZATION_NVP(count);
-    t.resize(count);
-    unsigned int item_version=0;
-    if(BOOST_SERIALIZATION_VECTOR_VERSIONED(ar.get_library_version())) {
-        ar >> BOOST_SERIALIZATION_NVP(item_version);
-    }
-    if (!t.empty())
-        ar >> make_array(detail::get_data(t),t.size());
-  }
+    boost::serialization::stl::load_contiguous_collection<
+        Archive, STD::vector<U, Allocator> 
+    >(
+        ar, 
+        t, 
+        BOOST_SERIALIZATION_VECTOR_VERSIONED(ar.get_library_version()),
+        mpl::true_()
+    );
+}
 
 // dispatch to either default or optimized versions
 
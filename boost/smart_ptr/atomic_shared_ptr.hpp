@@ -0,0 +1,337 @@
+#ifndef BOOST_SMART_PTR_ATOMIC_SHARED_PTR_HPP_INCLUDED
+#define BOOST_SMART_PTR_ATOMIC_SHARED_PTR_HPP_INCLUDED
+
+//
+//  atomic_shared_ptr.hpp
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+//  See http://www.boost.org/libs/smart_ptr/atomic_shared_ptr.html for documentation.
+//
+
+#include <boost/config.hpp>
+#include <boost/assert.hpp>
+#include <boost/memory_order.hpp>
+#include <boost/smart_ptr/shared_ptr.hpp>
+
+#if !defined( BOOST_SP_NO_LOCKFREE_ATOMIC_SHARED_PTR ) && ( defined( __x86_64__ ) || defined( _M_X64 ) )
+# define BOOST_SP_LOCKFREE_ATOMIC_SHARED_PTR
+#endif
+
+#if defined( BOOST_SP_LOCKFREE_ATOMIC_SHARED_PTR )
+# include <boost/atomic.hpp>
+# include <boost/cstdint.hpp>
+#endif
+
+namespace boost
+{
+
+//
+//  atomic_shared_ptr
+//
+//  A shared_ptr that can be loaded and stored by several threads
+//  concurrently, without the spinlock pool that atomic_load and
+//  atomic_store use for plain shared_ptr objects.
+//
+//  The value is kept in a heap allocated box. A single word packs the
+//  pointer to the current box, in its lower 48 bits, with the number of
+//  loads in progress on that box, in its upper 16 bits. A load increments
+//  this number, copies the shared_ptr from the box and decrements it
+//  again. A store replaces the word and moves the number of loads in
+//  progress to a count in the old box; the last of these loads, or the
+//  store if there are none, deletes the old box. Boxes are never stored
+//  twice, so a box cannot reappear in the word while a load is in
+//  progress on it.
+//
+//  On platforms without spare pointer bits, the spinlock pool is used.
+//
+
+template<class T> class atomic_shared_ptr
+{
+private:
+
+    atomic_shared_ptr( atomic_shared_ptr const & );
+    atomic_shared_ptr & operator= ( atomic_shared_ptr const & );
+
+#if defined( BOOST_SP_LOCKFREE_ATOMIC_SHARED_PTR )
+
+    struct box
+    {
+        shared_ptr<T> p_;
+        boost::atomic< long > count_; // load references moved here when the box is replaced
+
+        explicit box( shared_ptr<T> & p ): count_( 0 )
+        {
+            p_.swap( p );
+        }
+    };
+
+    typedef boost::uint64_t word_type;
+
+    static word_type one()
+    {
+        return word_type( 1 ) << 48;
+    }
+
+    static box * get_box( word_type w )
+    {
+        return reinterpret_cast< box * >( w & ( one() - 1 ) );
+    }
+
+    static long get_count( word_type w )
+    {
+        return static_cast< long >( w >> 48 );
+    }
+
+    static word_type make_word( box * b )
+    {
+        return reinterpret_cast< word_type >( b );
+    }
+
+    // an empty value is stored as a null box
+
+    static box * make_box( shared_ptr<T> & p )
+    {
+        return p._internal_equiv( shared_ptr<T>() )? 0: new box( p );
+    }
+
+    static bool equiv( box * b, shared_ptr<T> const & p )
+    {
+        return b != 0? b->p_._internal_equiv( p ): p._internal_equiv( shared_ptr<T>() );
+    }
+
+    // takes a load reference on the current box; no reference is taken on
+    // a null box, which nobody could release safely
+
+    box * acquire() const
+    {
+        word_type w = word_.load( boost::memory_order_relaxed );
+
+        for( ;; )
+        {
+            if( get_box( w ) == 0 )
+            {
+                return 0;
+            }
+
+            BOOST_ASSERT( get_count( w ) != 0xFFFF );
+
+            if( word_.compare_exchange_weak( w, w + one(), boost::memory_order_acquire, boost::memory_order_relaxed ) )
+            {
+                return get_box( w );
+            }
+        }
+    }
+
+    void release( box * b ) const
+    {
+        word_type w = word_.load( boost::memory_order_relaxed );
+
+        while( get_box( w ) == b )
+        {
+            if( word_.compare_exchange_weak( w, w - one(), boost::memory_order_release, boost::memory_order_relaxed ) )
+            {
+                return;
+            }
+        }
+
+        // b has been replaced, and the count of b holds this reference
+
+        if( b->count_.fetch_sub( 1, boost::memory_order_acq_rel ) == 1 )
+        {
+            delete b;
+        }
+    }
+
+    // disposes of a replaced box with n loads still in progress
+
+    static void retire( box * b, long n )
+    {
+        if( b != 0 && b->count_.fetch_add( n, boost::memory_order_acq_rel ) == -n )
+        {
+            delete b;
+        }
+    }
+
+    mutable boost::atomic< word_type > word_;
+
+#else
+
+    shared_ptr<T> p_;
+
+#endif
+
+public:
+
+    typedef shared_ptr<T> value_type;
+
+#if defined( BOOST_SP_LOCKFREE_ATOMIC_SHARED_PTR )
+
+    atomic_shared_ptr() BOOST_NOEXCEPT : word_( 0 )
+    {
+    }
+
+    explicit atomic_shared_ptr( shared_ptr<T> r ): word_( make_word( make_box( r ) ) )
+    {
+    }
+
+    ~atomic_shared_ptr()
+    {
+        delete get_box( word_.load( boost::memory_order_acquire ) );
+    }
+
+    bool is_lock_free() const BOOST_NOEXCEPT
+    {
+        return true;
+    }
+
+    shared_ptr<T> load( memory_order /*mo*/ = memory_order_seq_cst ) const
+    {
+        box * b = acquire();
+
+        if( b == 0 )
+        {
+            return shared_ptr<T>();
+        }
+
+        shared_ptr<T> r( b->p_ );
+        release( b );
+
+        return r;
+    }
+
+    shared_ptr<T> exchange( shared_ptr<T> r, memory_order /*mo*/ = memory_order_seq_cst )
+    {
+        word_type const x = word_.exchange( make_word( make_box( r ) ), boost::memory_order_acq_rel );
+        box * b = get_box( x );
+
+        // r is empty now
+
+        if( b != 0 )
+        {
+            if( get_count( x ) == 0 )
+            {
+                b->p_.swap( r );
+                delete b;
+            }
+            else
+            {
+                r = b->p_;
+                retire( b, get_count( x ) );
+            }
+        }
+
+        return r;
+    }
+
+    bool compare_exchange_strong( shared_ptr<T> & v, shared_ptr<T> w, memory_order /*success*/ = memory_order_seq_cst, memory_order /*failure*/ = memory_order_seq_cst )
+    {
+        box * nb = make_box( w );
+
+        for( ;; )
+        {
+            box * b = acquire();
+
+            if( !equiv( b, v ) )
+            {
+                shared_ptr<T> tmp;
+
+                if( b != 0 )
+                {
+                    tmp = b->p_;
+                    release( b );
+                }
+
+                tmp.swap( v );
+                delete nb;
+
+                return false;
+            }
+
+            if( b == 0 )
+            {
+                word_type x = 0;
+
+                if( word_.compare_exchange_strong( x, make_word( nb ), boost::memory_order_acq_rel, boost::memory_order_relaxed ) )
+                {
+                    return true;
+                }
+
+                continue;
+            }
+
+            word_type x = word_.load( boost::memory_order_relaxed );
+
+            while( get_box( x ) == b )
+            {
+                if( word_.compare_exchange_weak( x, make_word( nb ), boost::memory_order_acq_rel, boost::memory_order_relaxed ) )
+                {
+                    // the loads in progress include this one
+                    retire( b, get_count( x ) - 1 );
+                    return true;
+                }
+            }
+
+            release( b );
+        }
+    }
+
+#else
+
+    atomic_shared_ptr() BOOST_NOEXCEPT
+    {
+    }
+
+    explicit atomic_shared_ptr( shared_ptr<T> r ) BOOST_NOEXCEPT
+    {
+        p_.swap( r );
+    }
+
+    bool is_lock_free() const BOOST_NOEXCEPT
+    {
+        return false;
+    }
+
+    shared_ptr<T> load( memory_order /*mo*/ = memory_order_seq_cst ) const
+    {
+        return boost::atomic_load( &p_ );
+    }
+
+    shared_ptr<T> exchange( shared_ptr<T> r, memory_order /*mo*/ = memory_order_seq_cst )
+    {
+        return boost::atomic_exchange( &p_, r ); // std::move( r )
+    }
+
+    bool compare_exchange_strong( shared_ptr<T> & v, shared_ptr<T> w, memory_order /*success*/ = memory_order_seq_cst, memory_order /*failure*/ = memory_order_seq_cst )
+    {
+        return boost::atomic_compare_exchange( &p_, &v, w ); // std::move( w )
+    }
+
+#endif
+
+    void store( shared_ptr<T> r, memory_order mo = memory_order_seq_cst )
+    {
+        exchange( r, mo ); // std::move( r )
+    }
+
+    bool compare_exchange_weak( shared_ptr<T> & v, shared_ptr<T> w, memory_order success = memory_order_seq_cst, memory_order failure = memory_order_seq_cst )
+    {
+        return compare_exchange_strong( v, w, success, failure ); // std::move( w )
+    }
+
+    operator shared_ptr<T>() const
+    {
+        return load();
+    }
+
+    void operator=( shared_ptr<T> r )
+    {
+        store( r ); // std::move( r )
+    }
+};
+
+} // namespace boost
+
+#endif  // #ifndef BOOST_SMART_PTR_ATOMIC_SHARED_PTR_HPP_INCLUDED
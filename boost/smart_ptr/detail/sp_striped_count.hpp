@@ -0,0 +1,222 @@
+#ifndef BOOST_SMART_PTR_DETAIL_SP_STRIPED_COUNT_HPP_INCLUDED
+#define BOOST_SMART_PTR_DETAIL_SP_STRIPED_COUNT_HPP_INCLUDED
+
+// MS compatible compilers support #pragma once
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+# pragma once
+#endif
+
+//
+//  detail/sp_striped_count.hpp
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+//  The reference count of striped_owner_ptr and striped_shared_ptr.
+//
+//  While the owner is alive, the object cannot be destroyed, so the
+//  references held by striped_shared_ptr copies are counted on one of
+//  several stripes, selected by the calling thread, each on its own
+//  cache line. Increments and decrements need not happen on the same
+//  stripe; only the sum matters.
+//
+//  When the owner releases its reference, it closes every stripe and
+//  moves the sum of the stripes to the central count. From then on
+//  all threads count on the central count, and the thread that drops
+//  it to zero destroys the object.
+//
+//  The central count starts at a large bias rather than at zero, so
+//  that decrements on already closed stripes cannot drop it to zero
+//  before the owner has moved the sum of the stripes to it.
+//
+
+#include <boost/config.hpp>
+#include <boost/checked_delete.hpp>
+#include <boost/atomic.hpp>
+#include <boost/detail/thread_hash.hpp>
+#include <climits>
+#include <cstddef>
+
+#ifndef BOOST_SP_STRIPED_COUNT_STRIPES
+# define BOOST_SP_STRIPED_COUNT_STRIPES 16
+#endif
+
+namespace boost
+{
+
+namespace detail
+{
+
+// the stripe of the calling thread
+
+inline std::size_t sp_thread_stripe()
+{
+    return boost::detail::current_thread_hash() % BOOST_SP_STRIPED_COUNT_STRIPES;
+}
+
+class sp_striped_count_base
+{
+private:
+
+    sp_striped_count_base( sp_striped_count_base const & );
+    sp_striped_count_base & operator= ( sp_striped_count_base const & );
+
+    struct stripe
+    {
+        boost::atomic< long > count_;
+        char pad_[ 64 - sizeof( boost::atomic< long > ) ]; // one cache line per stripe
+    };
+
+    static long closed()
+    {
+        return LONG_MIN;
+    }
+
+    static long bias()
+    {
+        return LONG_MAX / 2;
+    }
+
+    boost::atomic< long > central_;
+    stripe stripes_[ BOOST_SP_STRIPED_COUNT_STRIPES ];
+
+public:
+
+    sp_striped_count_base(): central_( bias() )
+    {
+        for( int i = 0; i < BOOST_SP_STRIPED_COUNT_STRIPES; ++i )
+        {
+            stripes_[ i ].count_.store( 0, boost::memory_order_relaxed );
+        }
+    }
+
+    virtual ~sp_striped_count_base() // nothrow
+    {
+    }
+
+    // dispose() is called when the count drops to zero; it destroys the
+    // object and this
+
+    virtual void dispose() = 0; // nothrow
+
+    void add_ref() // nothrow
+    {
+        boost::atomic< long > & count = stripes_[ sp_thread_stripe() ].count_;
+        long v = count.load( boost::memory_order_relaxed );
+
+        for( ;; )
+        {
+            if( v == closed() )
+            {
+                central_.fetch_add( 1, boost::memory_order_relaxed );
+                return;
+            }
+
+            if( count.compare_exchange_weak( v, v + 1, boost::memory_order_relaxed ) )
+            {
+                return;
+            }
+        }
+    }
+
+    void release() // nothrow
+    {
+        boost::atomic< long > & count = stripes_[ sp_thread_stripe() ].count_;
+        long v = count.load( boost::memory_order_relaxed );
+
+        for( ;; )
+        {
+            if( v == closed() )
+            {
+                if( central_.fetch_sub( 1, boost::memory_order_acq_rel ) == 1 )
+                {
+                    dispose();
+                }
+
+                return;
+            }
+
+            // release, so that the owner that closes the stripe sees the
+            // accesses of this thread to the object
+
+            if( count.compare_exchange_weak( v, v - 1, boost::memory_order_release, boost::memory_order_relaxed ) )
+            {
+                return;
+            }
+        }
+    }
+
+    void release_owner() // nothrow
+    {
+        long sum = 0;
+
+        for( int i = 0; i < BOOST_SP_STRIPED_COUNT_STRIPES; ++i )
+        {
+            sum += stripes_[ i ].count_.exchange( closed(), boost::memory_order_acq_rel );
+        }
+
+        long const delta = sum - bias();
+
+        if( central_.fetch_add( delta, boost::memory_order_acq_rel ) + delta == 0 )
+        {
+            dispose();
+        }
+    }
+
+    // the number of references, including the owner; only a snapshot
+    // while other threads copy or destroy pointers
+
+    long use_count() const // nothrow
+    {
+        long n = central_.load( boost::memory_order_acquire );
+
+        if( stripes_[ 0 ].count_.load( boost::memory_order_relaxed ) == closed() )
+        {
+            return n;
+        }
+
+        n = n - bias() + 1;
+
+        for( int i = 0; i < BOOST_SP_STRIPED_COUNT_STRIPES; ++i )
+        {
+            long const v = stripes_[ i ].count_.load( boost::memory_order_relaxed );
+
+            if( v != closed() )
+            {
+                n += v;
+            }
+        }
+
+        return n;
+    }
+};
+
+template< class X > class sp_striped_count_impl_p: public sp_striped_count_base
+{
+private:
+
+    X * px_;
+
+    sp_striped_count_impl_p( sp_striped_count_impl_p const & );
+    sp_striped_count_impl_p & operator= ( sp_striped_count_impl_p const & );
+
+public:
+
+    explicit sp_striped_count_impl_p( X * px ): px_( px )
+    {
+    }
+
+    virtual void dispose() // nothrow
+    {
+        boost::checked_delete( px_ );
+        delete this;
+    }
+};
+
+} // namespace detail
+
+} // namespace boost
+
+#endif  // #ifndef BOOST_SMART_PTR_DETAIL_SP_STRIPED_COUNT_HPP_INCLUDED
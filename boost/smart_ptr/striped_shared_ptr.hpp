@@ -0,0 +1,297 @@
+#ifndef BOOST_SMART_PTR_STRIPED_SHARED_PTR_HPP_INCLUDED
+#define BOOST_SMART_PTR_STRIPED_SHARED_PTR_HPP_INCLUDED
+
+//
+//  striped_shared_ptr.hpp
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+//  See http://www.boost.org/libs/smart_ptr/striped_shared_ptr.html for documentation.
+//
+
+#include <boost/config.hpp>
+
+#include <boost/assert.hpp>
+#include <boost/checked_delete.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/smart_ptr/detail/sp_striped_count.hpp>
+
+#include <boost/config/no_tr1/functional.hpp>           // for std::less
+#include <new>                                          // for std::bad_alloc
+
+namespace boost
+{
+
+template<class T> class striped_shared_ptr;
+
+//
+//  striped_owner_ptr
+//
+//  Sole owner of an object that is read through striped_shared_ptr
+//  copies. The object is destroyed when the owner and all copies are
+//  gone. While the owner is alive, copying and destroying a
+//  striped_shared_ptr only touches a counter that is shared with the
+//  few threads that map to the same stripe.
+//
+
+template<class T> class striped_owner_ptr
+{
+private:
+
+    typedef striped_owner_ptr this_type;
+
+    striped_owner_ptr( striped_owner_ptr const & );
+    striped_owner_ptr & operator= ( striped_owner_ptr const & );
+
+public:
+
+    typedef T element_type;
+
+    striped_owner_ptr() BOOST_NOEXCEPT : px( 0 ), pn( 0 )
+    {
+    }
+
+    template<class Y> explicit striped_owner_ptr( Y * p ): px( p ), pn( 0 ) // Y must be complete
+    {
+        if( p == 0 ) return;
+
+#ifndef BOOST_NO_EXCEPTIONS
+
+        try
+        {
+            pn = new boost::detail::sp_striped_count_impl_p<Y>( p );
+        }
+        catch(...)
+        {
+            boost::checked_delete( p );
+            throw;
+        }
+
+#else
+
+        pn = new boost::detail::sp_striped_count_impl_p<Y>( p );
+
+        if( pn == 0 )
+        {
+            boost::checked_delete( p );
+            boost::throw_exception( std::bad_alloc() );
+        }
+
+#endif
+    }
+
+    ~striped_owner_ptr()
+    {
+        if( pn != 0 ) pn->release_owner();
+    }
+
+    void reset() BOOST_NOEXCEPT
+    {
+        this_type().swap( *this );
+    }
+
+    template<class Y> void reset( Y * p ) // Y must be complete
+    {
+        BOOST_ASSERT( p == 0 || p != px ); // catch self-reset errors
+        this_type( p ).swap( *this );
+    }
+
+    T * get() const BOOST_NOEXCEPT
+    {
+        return px;
+    }
+
+    T & operator*() const
+    {
+        BOOST_ASSERT( px != 0 );
+        return *px;
+    }
+
+    T * operator->() const
+    {
+        BOOST_ASSERT( px != 0 );
+        return px;
+    }
+
+// implicit conversion to "bool"
+#include <boost/smart_ptr/detail/operator_bool.hpp>
+
+    // only a snapshot while other threads copy or destroy pointers
+    long use_count() const BOOST_NOEXCEPT
+    {
+        return pn != 0? pn->use_count(): 0;
+    }
+
+    void swap( striped_owner_ptr & other ) BOOST_NOEXCEPT
+    {
+        T * tmp = px;
+        px = other.px;
+        other.px = tmp;
+
+        boost::detail::sp_striped_count_base * tmp2 = pn;
+        pn = other.pn;
+        other.pn = tmp2;
+    }
+
+private:
+
+    template<class Y> friend class striped_shared_ptr;
+
+    T * px;
+    boost::detail::sp_striped_count_base * pn;
+};
+
+//
+//  striped_shared_ptr
+//
+//  A shared reference to an object owned by a striped_owner_ptr, which
+//  keeps the object alive after the owner is gone.
+//
+
+template<class T> class striped_shared_ptr
+{
+private:
+
+    typedef striped_shared_ptr this_type;
+
+public:
+
+    typedef T element_type;
+
+    striped_shared_ptr() BOOST_NOEXCEPT : px( 0 ), pn( 0 )
+    {
+    }
+
+    striped_shared_ptr( striped_owner_ptr<T> const & r ) BOOST_NOEXCEPT : px( r.px ), pn( r.pn )
+    {
+        if( pn != 0 ) pn->add_ref();
+    }
+
+    striped_shared_ptr( striped_shared_ptr const & r ) BOOST_NOEXCEPT : px( r.px ), pn( r.pn )
+    {
+        if( pn != 0 ) pn->add_ref();
+    }
+
+    ~striped_shared_ptr()
+    {
+        if( pn != 0 ) pn->release();
+    }
+
+#if !defined( BOOST_NO_CXX11_RVALUE_REFERENCES )
+
+    striped_shared_ptr( striped_shared_ptr && r ) BOOST_NOEXCEPT : px( r.px ), pn( r.pn )
+    {
+        r.px = 0;
+        r.pn = 0;
+    }
+
+    striped_shared_ptr & operator=( striped_shared_ptr && r ) BOOST_NOEXCEPT
+    {
+        this_type( static_cast< striped_shared_ptr && >( r ) ).swap( *this );
+        return *this;
+    }
+
+#endif
+
+    striped_shared_ptr & operator=( striped_shared_ptr const & r ) BOOST_NOEXCEPT
+    {
+        this_type( r ).swap( *this );
+        return *this;
+    }
+
+    striped_shared_ptr & operator=( striped_owner_ptr<T> const & r ) BOOST_NOEXCEPT
+    {
+        this_type( r ).swap( *this );
+        return *this;
+    }
+
+    void reset() BOOST_NOEXCEPT
+    {
+        this_type().swap( *this );
+    }
+
+    T * get() const BOOST_NOEXCEPT
+    {
+        return px;
+    }
+
+    T & operator*() const
+    {
+        BOOST_ASSERT( px != 0 );
+        return *px;
+    }
+
+    T * operator->() const
+    {
+        BOOST_ASSERT( px != 0 );
+        return px;
+    }
+
+// implicit conversion to "bool"
+#include <boost/smart_ptr/detail/operator_bool.hpp>
+
+    // only a snapshot while other threads copy or destroy pointers
+    long use_count() const BOOST_NOEXCEPT
+    {
+        return pn != 0? pn->use_count(): 0;
+    }
+
+    void swap( striped_shared_ptr & other ) BOOST_NOEXCEPT
+    {
+        T * tmp = px;
+        px = other.px;
+        other.px = tmp;
+
+        boost::detail::sp_striped_count_base * tmp2 = pn;
+        pn = other.pn;
+        other.pn = tmp2;
+    }
+
+private:
+
+    T * px;
+    boost::detail::sp_striped_count_base * pn;
+};
+
+template<class T, class U> inline bool operator==( striped_shared_ptr<T> const & a, striped_shared_ptr<U> const & b ) BOOST_NOEXCEPT
+{
+    return a.get() == b.get();
+}
+
+template<class T, class U> inline bool operator!=( striped_shared_ptr<T> const & a, striped_shared_ptr<U> const & b ) BOOST_NOEXCEPT
+{
+    return a.get() != b.get();
+}
+
+template<class T> inline bool operator<( striped_shared_ptr<T> const & a, striped_shared_ptr<T> const & b ) BOOST_NOEXCEPT
+{
+    return std::less<T *>()( a.get(), b.get() );
+}
+
+template<class T> inline void swap( striped_owner_ptr<T> & a, striped_owner_ptr<T> & b ) BOOST_NOEXCEPT
+{
+    a.swap( b );
+}
+
+template<class T> inline void swap( striped_shared_ptr<T> & a, striped_shared_ptr<T> & b ) BOOST_NOEXCEPT
+{
+    a.swap( b );
+}
+
+// mem_fn support
+
+template<class T> inline T * get_pointer( striped_owner_ptr<T> const & p ) BOOST_NOEXCEPT
+{
+    return p.get();
+}
+
+template<class T> inline T * get_pointer( striped_shared_ptr<T> const & p ) BOOST_NOEXCEPT
+{
+    return p.get();
+}
+
+} // namespace boost
+
+#endif  // #ifndef BOOST_SMART_PTR_STRIPED_SHARED_PTR_HPP_INCLUDED
@@ -0,0 +1,176 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_DETAIL_FUTEX_HPP
+#define BOOST_THREAD_DETAIL_FUTEX_HPP
+
+#include <boost/thread/detail/config.hpp>
+
+#if ! defined BOOST_THREAD_LINUX
+#error "futex based synchronization primitives are only available on Linux"
+#endif
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#if defined BOOST_THREAD_USES_DATETIME
+#include <boost/thread/thread_time.hpp>
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+#include <boost/chrono/duration.hpp>
+#include <boost/chrono/time_point.hpp>
+#include <boost/chrono/ceil.hpp>
+#endif
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <time.h>
+#include <cerrno>
+#include <climits>
+#include <limits>
+
+#include <boost/config/abi_prefix.hpp>
+
+#ifndef BOOST_THREAD_FUTEX_MAX_SPIN
+#define BOOST_THREAD_FUTEX_MAX_SPIN 100
+#endif
+
+namespace boost
+{
+  namespace thread_detail
+  {
+    typedef boost::atomic<unsigned> futex_word;
+
+    BOOST_STATIC_ASSERT(sizeof(futex_word) == sizeof(int));
+
+    inline int* futex_address(futex_word& word)
+    {
+      return reinterpret_cast<int*>(&word);
+    }
+
+    /**
+     * Effects: Blocks while word holds expected, until woken or until the
+     * CLOCK_MONOTONIC time deadline, if it is not null. May return
+     * spuriously.
+     *
+     * Return: false if the deadline has passed, true otherwise.
+     */
+    inline bool futex_wait(futex_word& word, unsigned expected, struct timespec const* deadline)
+    {
+      int const res = ::syscall(SYS_futex, futex_address(word),
+          FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, expected, deadline, 0, FUTEX_BITSET_MATCH_ANY);
+      return !(res == -1 && errno == ETIMEDOUT);
+    }
+
+    /**
+     * Effects: Wakes at most count threads blocked on word.
+     */
+    inline void futex_wake(futex_word& word, int count)
+    {
+      ::syscall(SYS_futex, futex_address(word), FUTEX_WAKE | FUTEX_PRIVATE_FLAG, count, 0, 0, 0);
+    }
+
+    /**
+     * Effects: If word still holds expected, wakes one thread blocked on
+     * word and moves all others to wait on target instead.
+     *
+     * Return: false if word did not hold expected, and nothing was done.
+     */
+    inline bool futex_requeue(futex_word& word, unsigned expected, futex_word& target)
+    {
+      int const res = ::syscall(SYS_futex, futex_address(word),
+          FUTEX_CMP_REQUEUE | FUTEX_PRIVATE_FLAG, 1, static_cast<long>(INT_MAX),
+          futex_address(target), expected);
+      return res != -1;
+    }
+
+    /**
+     * Return: The CLOCK_MONOTONIC time ns nanoseconds from now.
+     */
+    inline struct timespec futex_deadline_after(boost::int64_t ns)
+    {
+      // a hundred years
+      boost::int64_t const max_ns = static_cast<boost::int64_t>(1000000000) * 3600 * 24 * 365 * 100;
+      struct timespec ts;
+      ::clock_gettime(CLOCK_MONOTONIC, &ts);
+      ns = ns < 0 ? 0 : ns > max_ns ? max_ns : ns;
+      ns += ts.tv_nsec;
+      ts.tv_sec += static_cast<time_t>(ns / 1000000000);
+      ts.tv_nsec = static_cast<long>(ns % 1000000000);
+      return ts;
+    }
+
+#if defined BOOST_THREAD_USES_DATETIME
+    inline struct timespec futex_deadline(system_time const& abs_time)
+    {
+      if (abs_time.is_pos_infinity())
+        return futex_deadline_after((std::numeric_limits<boost::int64_t>::max)());
+      return futex_deadline_after((abs_time - get_system_time()).total_microseconds() * 1000);
+    }
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    struct timespec futex_deadline(chrono::duration<Rep, Period> const& rel_time)
+    {
+      return futex_deadline_after(chrono::ceil<chrono::nanoseconds>(rel_time).count());
+    }
+
+    template <class Clock, class Duration>
+    struct timespec futex_deadline(chrono::time_point<Clock, Duration> const& abs_time)
+    {
+      return futex_deadline(abs_time - Clock::now());
+    }
+#endif
+
+    inline void futex_pause()
+    {
+#if defined(__i386__) || defined(__x86_64__)
+      __asm__ __volatile__("pause" ::: "memory");
+#else
+      __asm__ __volatile__("" ::: "memory");
+#endif
+    }
+
+    /**
+     * The number of iterations a thread spins on a contended futex word
+     * before it blocks, adapted to the spinning that recently succeeded,
+     * in the manner of glibc's adaptive mutexes. Nothing is spun on a
+     * single CPU, where the owner cannot release the word while we spin.
+     */
+    class futex_spin
+    {
+    public:
+      futex_spin() : estimate_(0)
+      {
+      }
+
+      int limit() const
+      {
+        static long const cpus = ::sysconf(_SC_NPROCESSORS_ONLN);
+        if (cpus < 2)
+          return 0;
+        int const n = estimate_.load(boost::memory_order_relaxed) * 2 + 10;
+        return n < BOOST_THREAD_FUTEX_MAX_SPIN ? n : BOOST_THREAD_FUTEX_MAX_SPIN;
+      }
+
+      /**
+       * Effects: Records that the last spin took n iterations, or gave up
+       * after limit() iterations.
+       */
+      void update(int n)
+      {
+        int const e = estimate_.load(boost::memory_order_relaxed);
+        estimate_.store(e + (n - e) / 8, boost::memory_order_relaxed);
+      }
+
+    private:
+      boost::atomic<int> estimate_;
+    };
+  }
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif // header
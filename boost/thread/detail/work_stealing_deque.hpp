@@ -0,0 +1,196 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_DETAIL_WORK_STEALING_DEQUE_HPP
+#define BOOST_THREAD_DETAIL_WORK_STEALING_DEQUE_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/atomic.hpp>
+#include <cstddef>
+#include <vector>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  namespace thread_detail
+  {
+
+    /**
+     * A Chase-Lev work-stealing deque of pointers.
+     *
+     * The owning thread pushes and takes elements at the bottom of the deque
+     * without locking, while any other thread may steal elements from the top.
+     * The circular buffer grows when full. Buffers that have been replaced are
+     * kept until the deque is destroyed, as a concurrent thief may still be
+     * reading from them.
+     *
+     * See D. Chase and Y. Lev, "Dynamic Circular Work-Stealing Deque", SPAA
+     * 2005, and N. M. Le et al., "Correct and Efficient Work-Stealing for Weak
+     * Memory Models", PPoPP 2013, for the memory ordering used here.
+     */
+    template <typename T>
+    class work_stealing_deque
+    {
+    public:
+      explicit work_stealing_deque(std::size_t initial_capacity = 256) :
+        top_(0), bottom_(0), buffer_(0)
+      {
+        std::size_t capacity = 1;
+        while (capacity < initial_capacity)
+          capacity *= 2;
+        buffer_.store(new buffer(capacity), memory_order_relaxed);
+      }
+
+      ~work_stealing_deque()
+      {
+        delete buffer_.load(memory_order_relaxed);
+        for (std::size_t i = 0; i < retired_.size(); ++i)
+          delete retired_[i];
+      }
+
+      /**
+       * Adds an element at the bottom of the deque. Must only be called by the
+       * owning thread.
+       */
+      void push(T* value)
+      {
+        long b = bottom_.load(memory_order_relaxed);
+        long t = top_.load(memory_order_acquire);
+        buffer* a = buffer_.load(memory_order_relaxed);
+        if (b - t > static_cast<long>(a->size) - 1)
+        {
+          a = grow(a, t, b);
+        }
+        a->put(b, value);
+        atomic_thread_fence(memory_order_release);
+        bottom_.store(b + 1, memory_order_relaxed);
+      }
+
+      /**
+       * Removes the element at the bottom of the deque, returning 0 if the
+       * deque is empty. Must only be called by the owning thread.
+       */
+      T* take()
+      {
+        long b = bottom_.load(memory_order_relaxed) - 1;
+        buffer* a = buffer_.load(memory_order_relaxed);
+        bottom_.store(b, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        long t = top_.load(memory_order_relaxed);
+        if (t <= b)
+        {
+          T* value = a->get(b);
+          if (t == b)
+          {
+            // The last element, which a thief may be trying to take as well.
+            if (!top_.compare_exchange_strong(t, t + 1,
+                memory_order_seq_cst, memory_order_relaxed))
+            {
+              value = 0;
+            }
+            bottom_.store(b + 1, memory_order_relaxed);
+          }
+          return value;
+        }
+        bottom_.store(b + 1, memory_order_relaxed);
+        return 0;
+      }
+
+      /**
+       * Removes the element at the top of the deque, returning 0 if the deque
+       * is empty or if another thread took the element first. May be called by
+       * any thread.
+       */
+      T* steal()
+      {
+        long t = top_.load(memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        long b = bottom_.load(memory_order_acquire);
+        if (t < b)
+        {
+          buffer* a = buffer_.load(memory_order_acquire);
+          T* value = a->get(t);
+          if (!top_.compare_exchange_strong(t, t + 1,
+              memory_order_seq_cst, memory_order_relaxed))
+          {
+            return 0;
+          }
+          return value;
+        }
+        return 0;
+      }
+
+      /**
+       * Returns whether the deque appears to be empty. The result may be out of
+       * date by the time it is returned, unless called by the owning thread
+       * while no other thread is stealing. The loads are sequentially
+       * consistent so that a thread going idle, which announces itself and
+       * then calls this function, cannot miss an element pushed by an owner
+       * that then checks for idle threads.
+       */
+      bool empty() const
+      {
+        long b = bottom_.load(memory_order_seq_cst);
+        long t = top_.load(memory_order_seq_cst);
+        return b <= t;
+      }
+
+    private:
+      work_stealing_deque(work_stealing_deque const&);
+      work_stealing_deque& operator=(work_stealing_deque const&);
+
+      struct buffer
+      {
+        explicit buffer(std::size_t n) :
+          size(n), mask(n - 1), elements(new atomic<T*>[n])
+        {
+        }
+
+        ~buffer()
+        {
+          delete[] elements;
+        }
+
+        T* get(long i) const
+        {
+          return elements[i & mask].load(memory_order_relaxed);
+        }
+
+        void put(long i, T* value)
+        {
+          elements[i & mask].store(value, memory_order_relaxed);
+        }
+
+        std::size_t size;
+        std::size_t mask;
+        atomic<T*>* elements;
+      };
+
+      buffer* grow(buffer* a, long t, long b)
+      {
+        retired_.reserve(retired_.size() + 1);
+        buffer* n = new buffer(a->size * 2);
+        for (long i = t; i < b; ++i)
+          n->put(i, a->get(i));
+        retired_.push_back(a);
+        buffer_.store(n, memory_order_release);
+        return n;
+      }
+
+      atomic<long> top_;
+      char pad_[64];
+      atomic<long> bottom_;
+      atomic<buffer*> buffer_;
+
+      // Replaced buffers, accessed only by the owning thread.
+      std::vector<buffer*> retired_;
+    };
+
+  } // namespace thread_detail
+} // namespace boost
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
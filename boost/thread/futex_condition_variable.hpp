@@ -0,0 +1,176 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_FUTEX_CONDITION_VARIABLE_HPP
+#define BOOST_THREAD_FUTEX_CONDITION_VARIABLE_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/detail/futex.hpp>
+#include <boost/thread/detail/delete.hpp>
+#include <boost/thread/futex_mutex.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/cv_status.hpp>
+#include <boost/thread/exceptions.hpp>
+#include <boost/throw_exception.hpp>
+#include <cerrno>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  /**
+   * A condition variable for futex_mutex, built on a Linux futex: a
+   * sequence number that every notification increments, and on which the
+   * waiters block. Notifications that find no waiters do not enter the
+   * kernel. notify_all() wakes a single waiter and moves the others to wait
+   * on the mutex, where each is woken in turn as the previous one unlocks
+   * it, instead of waking them all to contend for the mutex at once.
+   *
+   * All concurrent waits must use the same mutex. Waits are not
+   * interruption points.
+   */
+  class futex_condition_variable
+  {
+  public:
+    BOOST_THREAD_NO_COPYABLE(futex_condition_variable)
+
+    futex_condition_variable() : seq_(0), waiters_(0), mutex_(0)
+    {
+    }
+
+    void wait(unique_lock<futex_mutex>& m)
+    {
+      do_wait_until(m, 0);
+    }
+
+    template <typename Predicate>
+    void wait(unique_lock<futex_mutex>& m, Predicate pred)
+    {
+      while (!pred())
+        do_wait_until(m, 0);
+    }
+
+#if defined BOOST_THREAD_USES_DATETIME
+    bool timed_wait(unique_lock<futex_mutex>& m, system_time const& abs_time)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(abs_time);
+      return do_wait_until(m, &deadline);
+    }
+
+    template <typename Duration>
+    bool timed_wait(unique_lock<futex_mutex>& m, Duration const& wait_duration)
+    {
+      return timed_wait(m, get_system_time() + wait_duration);
+    }
+
+    template <typename Predicate>
+    bool timed_wait(unique_lock<futex_mutex>& m, system_time const& abs_time, Predicate pred)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(abs_time);
+      return wait_until_deadline(m, deadline, pred);
+    }
+
+    template <typename Duration, typename Predicate>
+    bool timed_wait(unique_lock<futex_mutex>& m, Duration const& wait_duration, Predicate pred)
+    {
+      return timed_wait(m, get_system_time() + wait_duration, pred);
+    }
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Clock, class Duration>
+    cv_status wait_until(unique_lock<futex_mutex>& m,
+        const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(abs_time);
+      return do_wait_until(m, &deadline) ? cv_status::no_timeout : cv_status::timeout;
+    }
+
+    template <class Clock, class Duration, class Predicate>
+    bool wait_until(unique_lock<futex_mutex>& m,
+        const chrono::time_point<Clock, Duration>& abs_time, Predicate pred)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(abs_time);
+      return wait_until_deadline(m, deadline, pred);
+    }
+
+    template <class Rep, class Period>
+    cv_status wait_for(unique_lock<futex_mutex>& m,
+        const chrono::duration<Rep, Period>& rel_time)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(rel_time);
+      return do_wait_until(m, &deadline) ? cv_status::no_timeout : cv_status::timeout;
+    }
+
+    template <class Rep, class Period, class Predicate>
+    bool wait_for(unique_lock<futex_mutex>& m,
+        const chrono::duration<Rep, Period>& rel_time, Predicate pred)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(rel_time);
+      return wait_until_deadline(m, deadline, pred);
+    }
+#endif
+
+    void notify_one() BOOST_NOEXCEPT
+    {
+      seq_.fetch_add(1);
+      if (waiters_.load() != 0)
+        thread_detail::futex_wake(seq_, 1);
+    }
+
+    void notify_all() BOOST_NOEXCEPT
+    {
+      unsigned const seq = seq_.fetch_add(1) + 1;
+      if (waiters_.load() != 0)
+      {
+        futex_mutex* const mtx = mutex_.load();
+        if (!thread_detail::futex_requeue(seq_, seq, mtx->state_))
+          thread_detail::futex_wake(seq_, INT_MAX);
+      }
+    }
+
+  private:
+    /**
+     * Effects: Unlocks m, blocks until notified, until the deadline if it
+     * is not null, or spuriously, and locks m again.
+     *
+     * Return: false if the deadline has passed.
+     */
+    bool do_wait_until(unique_lock<futex_mutex>& m, struct timespec const* deadline)
+    {
+      if (!m.owns_lock())
+      {
+        boost::throw_exception(condition_error(EPERM, "futex_condition_variable wait: mutex not locked"));
+      }
+      futex_mutex* const mtx = m.mutex();
+      mutex_.store(mtx);
+      waiters_.fetch_add(1);
+      unsigned const seq = seq_.load();
+      mtx->unlock();
+      bool const notimeout = thread_detail::futex_wait(seq_, seq, deadline);
+      waiters_.fetch_sub(1);
+      mtx->lock_contended();
+      return notimeout;
+    }
+
+    template <typename Predicate>
+    bool wait_until_deadline(unique_lock<futex_mutex>& m, struct timespec const& deadline,
+        Predicate pred)
+    {
+      while (!pred())
+      {
+        if (!do_wait_until(m, &deadline))
+          return pred();
+      }
+      return true;
+    }
+
+    thread_detail::futex_word seq_;
+    boost::atomic<unsigned> waiters_;
+    boost::atomic<futex_mutex*> mutex_;
+  };
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif // header
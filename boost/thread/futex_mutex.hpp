@@ -0,0 +1,116 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_FUTEX_MUTEX_HPP
+#define BOOST_THREAD_FUTEX_MUTEX_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/detail/futex.hpp>
+#include <boost/thread/detail/delete.hpp>
+#include <boost/thread/lockable_traits.hpp>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  class futex_condition_variable;
+
+  /**
+   * A mutex built on a Linux futex: a word that is 0 when unlocked, 1 when
+   * locked and 2 when locked with possible waiters. Locking and unlocking
+   * an uncontended futex_mutex are single atomic operations; only unlocking
+   * a mutex with waiters enters the kernel.
+   *
+   * A thread that finds the mutex locked first spins for a while, as many
+   * iterations as recently sufficed to see it unlocked, and then blocks.
+   *
+   * futex_mutex models Lockable. Unlike boost::mutex it has no native_handle,
+   * and it is used with futex_condition_variable or condition_variable_any.
+   */
+  class futex_mutex
+  {
+  public:
+    BOOST_THREAD_NO_COPYABLE(futex_mutex)
+
+    futex_mutex() : state_(0)
+    {
+    }
+
+    void lock()
+    {
+      unsigned expected = 0;
+      if (!state_.compare_exchange_strong(expected, 1, boost::memory_order_acquire))
+      {
+        if (!spin_lock())
+          lock_contended();
+      }
+    }
+
+    bool try_lock()
+    {
+      unsigned expected = 0;
+      return state_.compare_exchange_strong(expected, 1, boost::memory_order_acquire);
+    }
+
+    void unlock()
+    {
+      if (state_.exchange(0, boost::memory_order_release) == 2)
+        thread_detail::futex_wake(state_, 1);
+    }
+
+  private:
+    friend class futex_condition_variable;
+
+    bool spin_lock()
+    {
+      int const limit = spin_.limit();
+      for (int n = 0; n < limit; ++n)
+      {
+        thread_detail::futex_pause();
+        unsigned expected = 0;
+        if (state_.load(boost::memory_order_relaxed) == 0
+            && state_.compare_exchange_weak(expected, 1, boost::memory_order_acquire))
+        {
+          spin_.update(n);
+          return true;
+        }
+      }
+      if (limit)
+        spin_.update(limit);
+      return false;
+    }
+
+    // Locks with state 2, so that the unlock wakes the next waiter, if any.
+    // The waiters of a futex_condition_variable that are woken by
+    // notify_all() wait here, and each wakes the next one in turn.
+    void lock_contended()
+    {
+      while (state_.exchange(2, boost::memory_order_acquire) != 0)
+        thread_detail::futex_wait(state_, 2, 0);
+    }
+
+    thread_detail::futex_word state_;
+    thread_detail::futex_spin spin_;
+  };
+
+  namespace sync
+  {
+#ifdef BOOST_THREAD_NO_AUTO_DETECT_MUTEX_TYPES
+    template<>
+    struct is_basic_lockable<futex_mutex>
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+    template<>
+    struct is_lockable<futex_mutex>
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+#endif
+  }
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif // header
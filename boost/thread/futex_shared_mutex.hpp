@@ -0,0 +1,495 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_FUTEX_SHARED_MUTEX_HPP
+#define BOOST_THREAD_FUTEX_SHARED_MUTEX_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/detail/futex.hpp>
+#include <boost/thread/detail/delete.hpp>
+#include <boost/thread/lockable_traits.hpp>
+#if defined BOOST_THREAD_USES_DATETIME
+#include <boost/thread/thread_time.hpp>
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+#include <boost/chrono/system_clocks.hpp>
+#endif
+#include <climits>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  /**
+   * A shared_mutex built on Linux futexes, with the interface of the
+   * generic boost::shared_mutex, that is used instead of it when
+   * BOOST_THREAD_PROVIDES_FUTEX_SHARED_MUTEX is defined.
+   *
+   * The whole state is one word: the number of shared owners and the
+   * upgrade, exclusive and exclusive-waiting bits. Every lock and unlock
+   * that does not have to wait is a single atomic operation on the word,
+   * and enters the kernel only if some thread is blocked. Threads that
+   * want shared or upgrade ownership block on the state word itself;
+   * threads that want exclusive ownership block on a sequence number that
+   * is incremented whenever they might be able to proceed.
+   *
+   * As with the generic shared_mutex, a waiting exclusive locker stops new
+   * shared and upgrade owners, and no lock function is an interruption
+   * point.
+   */
+  class futex_shared_mutex
+  {
+  public:
+    BOOST_THREAD_NO_COPYABLE(futex_shared_mutex)
+
+    futex_shared_mutex() :
+      state_(0), shared_waiters_(0), exclusive_seq_(0), exclusive_waiters_(0),
+      converters_(0)
+    {
+    }
+
+    // Shared ownership
+
+    void lock_shared()
+    {
+      unsigned s = state_.load(boost::memory_order_relaxed);
+      if ((s & (exclusive_ | exclusive_waiting_))
+          || !state_.compare_exchange_weak(s, s + 1, boost::memory_order_acquire))
+      {
+        wait_shared(exclusive_ | exclusive_waiting_, 1, 0);
+      }
+    }
+
+    bool try_lock_shared()
+    {
+      return try_shared(exclusive_ | exclusive_waiting_, 1);
+    }
+
+#if defined BOOST_THREAD_USES_DATETIME
+    bool timed_lock_shared(system_time const& timeout)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(timeout);
+      return wait_shared(exclusive_ | exclusive_waiting_, 1, &deadline);
+    }
+
+    template <typename TimeDuration>
+    bool timed_lock_shared(TimeDuration const& relative_time)
+    {
+      return timed_lock_shared(get_system_time() + relative_time);
+    }
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    bool try_lock_shared_for(const chrono::duration<Rep, Period>& rel_time)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(rel_time);
+      return wait_shared(exclusive_ | exclusive_waiting_, 1, &deadline);
+    }
+
+    template <class Clock, class Duration>
+    bool try_lock_shared_until(const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(abs_time);
+      return wait_shared(exclusive_ | exclusive_waiting_, 1, &deadline);
+    }
+#endif
+
+    void unlock_shared()
+    {
+      unsigned const s = state_.fetch_sub(1);
+      if ((s & readers_) == 1)
+        wake_exclusive_waiters();
+      else if ((s & readers_) == 2 && converters_.load() != 0)
+        wake_exclusive_waiters();
+    }
+
+    // Exclusive ownership
+
+    void lock()
+    {
+      unsigned s = 0;
+      if (!state_.compare_exchange_strong(s, exclusive_, boost::memory_order_acquire))
+        wait_exclusive(readers_ | upgrade_ | exclusive_, 0, 0);
+    }
+
+#if defined BOOST_THREAD_USES_DATETIME
+    bool timed_lock(system_time const& timeout)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(timeout);
+      return wait_exclusive(readers_ | upgrade_ | exclusive_, 0, &deadline);
+    }
+
+    template <typename TimeDuration>
+    bool timed_lock(TimeDuration const& relative_time)
+    {
+      return timed_lock(get_system_time() + relative_time);
+    }
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    bool try_lock_for(const chrono::duration<Rep, Period>& rel_time)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(rel_time);
+      return wait_exclusive(readers_ | upgrade_ | exclusive_, 0, &deadline);
+    }
+
+    template <class Clock, class Duration>
+    bool try_lock_until(const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(abs_time);
+      return wait_exclusive(readers_ | upgrade_ | exclusive_, 0, &deadline);
+    }
+#endif
+
+    bool try_lock()
+    {
+      return try_exclusive(readers_ | upgrade_ | exclusive_, 0);
+    }
+
+    void unlock()
+    {
+      release_exclusive(0);
+      wake_exclusive_waiters();
+    }
+
+    // Upgrade ownership
+
+    void lock_upgrade()
+    {
+      unsigned s = state_.load(boost::memory_order_relaxed);
+      if ((s & (exclusive_ | exclusive_waiting_ | upgrade_))
+          || !state_.compare_exchange_weak(s, s + upgrade_, boost::memory_order_acquire))
+      {
+        wait_shared(exclusive_ | exclusive_waiting_ | upgrade_, upgrade_, 0);
+      }
+    }
+
+#if defined BOOST_THREAD_USES_DATETIME
+    bool timed_lock_upgrade(system_time const& timeout)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(timeout);
+      return wait_shared(exclusive_ | exclusive_waiting_ | upgrade_, upgrade_, &deadline);
+    }
+
+    template <typename TimeDuration>
+    bool timed_lock_upgrade(TimeDuration const& relative_time)
+    {
+      return timed_lock_upgrade(get_system_time() + relative_time);
+    }
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    bool try_lock_upgrade_for(const chrono::duration<Rep, Period>& rel_time)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(rel_time);
+      return wait_shared(exclusive_ | exclusive_waiting_ | upgrade_, upgrade_, &deadline);
+    }
+
+    template <class Clock, class Duration>
+    bool try_lock_upgrade_until(const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(abs_time);
+      return wait_shared(exclusive_ | exclusive_waiting_ | upgrade_, upgrade_, &deadline);
+    }
+#endif
+
+    bool try_lock_upgrade()
+    {
+      return try_shared(exclusive_ | exclusive_waiting_ | upgrade_, upgrade_);
+    }
+
+    void unlock_upgrade()
+    {
+      state_.fetch_sub(upgrade_);
+      wake_shared_waiters();
+      wake_exclusive_waiters();
+    }
+
+    // Upgrade <-> Exclusive
+
+    void unlock_upgrade_and_lock()
+    {
+      wait_exclusive(readers_, 0, 0);
+    }
+
+    void unlock_and_lock_upgrade()
+    {
+      release_exclusive(upgrade_);
+    }
+
+    bool try_unlock_upgrade_and_lock()
+    {
+      return try_exclusive(readers_ | exclusive_waiting_, 0);
+    }
+
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    bool try_unlock_upgrade_and_lock_for(const chrono::duration<Rep, Period>& rel_time)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(rel_time);
+      return wait_exclusive(readers_, 0, &deadline);
+    }
+
+    template <class Clock, class Duration>
+    bool try_unlock_upgrade_and_lock_until(const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(abs_time);
+      return wait_exclusive(readers_, 0, &deadline);
+    }
+#endif
+
+    // Shared <-> Exclusive
+
+    void unlock_and_lock_shared()
+    {
+      release_exclusive(1);
+    }
+
+#ifdef BOOST_THREAD_PROVIDES_SHARED_MUTEX_UPWARDS_CONVERSIONS
+    bool try_unlock_shared_and_lock()
+    {
+      return try_exclusive(~0u, 1);
+    }
+
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    bool try_unlock_shared_and_lock_for(const chrono::duration<Rep, Period>& rel_time)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(rel_time);
+      return wait_shared_to_exclusive(&deadline);
+    }
+
+    template <class Clock, class Duration>
+    bool try_unlock_shared_and_lock_until(const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(abs_time);
+      return wait_shared_to_exclusive(&deadline);
+    }
+#endif
+#endif
+
+    // Shared <-> Upgrade
+
+    void unlock_upgrade_and_lock_shared()
+    {
+      state_.fetch_add(1 - upgrade_);
+      wake_shared_waiters();
+    }
+
+#ifdef BOOST_THREAD_PROVIDES_SHARED_MUTEX_UPWARDS_CONVERSIONS
+    bool try_unlock_shared_and_lock_upgrade()
+    {
+      return try_shared(exclusive_ | exclusive_waiting_ | upgrade_, upgrade_ - 1);
+    }
+
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    bool try_unlock_shared_and_lock_upgrade_for(const chrono::duration<Rep, Period>& rel_time)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(rel_time);
+      return wait_shared(exclusive_ | exclusive_waiting_ | upgrade_, upgrade_ - 1, &deadline);
+    }
+
+    template <class Clock, class Duration>
+    bool try_unlock_shared_and_lock_upgrade_until(const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      struct timespec const deadline = thread_detail::futex_deadline(abs_time);
+      return wait_shared(exclusive_ | exclusive_waiting_ | upgrade_, upgrade_ - 1, &deadline);
+    }
+#endif
+#endif
+
+  private:
+    // The state word. The upgrade owner is not counted among the readers.
+    static const unsigned readers_ = 0x1fffffff;
+    static const unsigned upgrade_ = 0x20000000;
+    static const unsigned exclusive_ = 0x40000000;
+    static const unsigned exclusive_waiting_ = 0x80000000;
+
+    // Adds delta to the state if none of the blocking bits is set.
+    bool try_shared(unsigned blocking, unsigned delta)
+    {
+      unsigned s = state_.load(boost::memory_order_relaxed);
+      while (!(s & blocking))
+      {
+        if (state_.compare_exchange_weak(s, s + delta, boost::memory_order_acquire))
+          return true;
+      }
+      return false;
+    }
+
+    // Replaces the state with exclusive_ if the bits in mask equal expected.
+    // exclusive_waiting_ is kept, so that the shared owners that it stopped
+    // do not overtake the next exclusive owner.
+    bool try_exclusive(unsigned mask, unsigned expected)
+    {
+      unsigned s = state_.load(boost::memory_order_relaxed);
+      while ((s & mask) == expected)
+      {
+        if (state_.compare_exchange_weak(s, exclusive_ | (s & exclusive_waiting_),
+            boost::memory_order_acquire))
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // Replaces the state of an exclusive owner with s, and keeps stopping
+    // new shared owners while exclusive lockers wait. The last waiter to
+    // leave clears exclusive_waiting_ if we set it after it left.
+    void release_exclusive(unsigned s)
+    {
+      if (exclusive_waiters_.load() != 0)
+      {
+        state_.store(s | exclusive_waiting_);
+        if (exclusive_waiters_.load() != 0)
+          return;
+        state_.fetch_and(~exclusive_waiting_);
+      }
+      else
+      {
+        state_.store(s);
+      }
+      wake_shared_waiters();
+    }
+
+    // Spins, then blocks on the state word, until none of the blocking bits
+    // is set and delta is added to the state, or until the deadline.
+    bool wait_shared(unsigned blocking, unsigned delta, struct timespec const* deadline)
+    {
+      int const limit = spin_.limit();
+      for (int n = 0; n < limit; ++n)
+      {
+        thread_detail::futex_pause();
+        if (try_shared(blocking, delta))
+        {
+          spin_.update(n);
+          return true;
+        }
+      }
+      if (limit)
+        spin_.update(limit);
+
+      shared_waiters_.fetch_add(1);
+      for (;;)
+      {
+        unsigned s = state_.load();
+        if (!(s & blocking))
+        {
+          if (state_.compare_exchange_weak(s, s + delta))
+            break;
+          continue;
+        }
+        if (!thread_detail::futex_wait(state_, s, deadline))
+        {
+          shared_waiters_.fetch_sub(1);
+          return try_shared(blocking, delta);
+        }
+      }
+      shared_waiters_.fetch_sub(1);
+      return true;
+    }
+
+    // Spins, then blocks on exclusive_seq_, until the bits in mask equal
+    // expected and the state is replaced with exclusive_, or until the
+    // deadline. Sets exclusive_waiting_ while blocked.
+    bool wait_exclusive(unsigned mask, unsigned expected, struct timespec const* deadline)
+    {
+      int const limit = spin_.limit();
+      for (int n = 0; n < limit; ++n)
+      {
+        thread_detail::futex_pause();
+        if (try_exclusive(mask, expected))
+        {
+          spin_.update(n);
+          return true;
+        }
+      }
+      if (limit)
+        spin_.update(limit);
+
+      exclusive_waiters_.fetch_add(1);
+      for (;;)
+      {
+        unsigned const seq = exclusive_seq_.load();
+        unsigned s = state_.load();
+        if ((s & mask) == expected)
+        {
+          if (state_.compare_exchange_weak(s, exclusive_ | (s & exclusive_waiting_)))
+            break;
+          continue;
+        }
+        if (!(s & exclusive_waiting_))
+          state_.fetch_or(exclusive_waiting_);
+        if (!thread_detail::futex_wait(exclusive_seq_, seq, deadline))
+        {
+          if (try_exclusive(mask, expected))
+            break;
+          // let shared owners in again, unless others are still waiting
+          if (exclusive_waiters_.fetch_sub(1) == 1)
+          {
+            state_.fetch_and(~exclusive_waiting_);
+            wake_shared_waiters();
+          }
+          return false;
+        }
+      }
+      exclusive_waiters_.fetch_sub(1);
+      return true;
+    }
+
+    // Waits until the calling thread is the only shared owner, which the
+    // last but one shared owner to leave tells only if someone waits so.
+    bool wait_shared_to_exclusive(struct timespec const* deadline)
+    {
+      converters_.fetch_add(1);
+      bool const res = wait_exclusive(readers_ | upgrade_ | exclusive_, 1, deadline);
+      converters_.fetch_sub(1);
+      return res;
+    }
+
+    void wake_shared_waiters()
+    {
+      if (shared_waiters_.load() != 0)
+        thread_detail::futex_wake(state_, INT_MAX);
+    }
+
+    void wake_exclusive_waiters()
+    {
+      if (exclusive_waiters_.load() != 0)
+      {
+        exclusive_seq_.fetch_add(1);
+        thread_detail::futex_wake(exclusive_seq_, INT_MAX);
+      }
+    }
+
+    thread_detail::futex_word state_;
+    boost::atomic<unsigned> shared_waiters_;
+    thread_detail::futex_word exclusive_seq_;
+    boost::atomic<unsigned> exclusive_waiters_;
+    boost::atomic<unsigned> converters_;
+    thread_detail::futex_spin spin_;
+  };
+
+  namespace sync
+  {
+#ifdef BOOST_THREAD_NO_AUTO_DETECT_MUTEX_TYPES
+    template<>
+    struct is_basic_lockable<futex_shared_mutex>
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+    template<>
+    struct is_lockable<futex_shared_mutex>
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+#endif
+  }
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif // header
@@ -32,6 +32,7 @@
 #include <boost/thread/detail/is_convertible.hpp>
 #include <boost/type_traits/remove_reference.hpp>
 #include <boost/type_traits/remove_cv.hpp>
+#include <boost/type_traits/is_same.hpp>
 #include <boost/mpl/if.hpp>
 #include <boost/config.hpp>
 #include <boost/throw_exception.hpp>
@@ -190,6 +191,9 @@ namespace boost
         template <typename F, typename R, typename C>
         struct future_continuation;
 
+        template <typename Ex, typename F, typename R, typename C>
+        struct future_executor_continuation;
+
 #endif
 
         struct relocker
@@ -1379,6 +1383,8 @@ namespace boost
 #if defined BOOST_THREAD_PROVIDES_FUTURE_CONTINUATION
         template <typename, typename, typename>
         friend struct detail::future_continuation;
+        template <typename, typename, typename, typename>
+        friend struct detail::future_executor_continuation;
 #endif
 #if defined BOOST_THREAD_PROVIDES_SIGNATURE_PACKAGED_TASK
         template <class> friend class packaged_task; // todo check if this works in windows
@@ -1465,6 +1471,17 @@ namespace boost
         template<typename F>
         inline BOOST_THREAD_FUTURE<typename boost::result_of<F(BOOST_THREAD_FUTURE&)>::type>
         then(launch policy, BOOST_THREAD_RV_REF(F) func);
+
+        // Schedules func(*this) to run by calling ex.execute() once this
+        // future is ready, instead of running it on the thread that makes the
+        // future ready. The associated state is moved to the continuation, so
+        // this future is no longer valid once then() returns.
+        template<typename Ex, typename F>
+        inline typename disable_if<
+          is_same<typename remove_cv<Ex>::type, launch>,
+          BOOST_THREAD_FUTURE<typename boost::result_of<F(BOOST_THREAD_FUTURE&)>::type>
+        >::type
+        then(Ex& ex, F func);
 #endif
     };
 
@@ -3131,6 +3148,95 @@ namespace boost
         future_continuation& operator=(future_continuation const&);
       };
 #endif
+
+      template <typename R, typename C, typename F>
+      void set_continuation_value(promise<R>& next, C& continuation, F& parent)
+      {
+        next.set_value(continuation(parent));
+      }
+
+      template <typename C, typename F>
+      void set_continuation_value(promise<void>& next, C& continuation, F& parent)
+      {
+        continuation(parent);
+        next.set_value();
+      }
+
+      // A continuation that is handed to an executor once the parent future is
+      // ready. The parent future, the continuation function and the promise are
+      // kept in a separate state object, which lives until the executor has run
+      // the continuation.
+      template <typename Ex, typename F, typename R, typename C>
+      struct future_executor_continuation : future_continuation_base
+      {
+        struct state
+        {
+          F parent;
+          C continuation;
+          promise<R> next;
+
+          state(F& f, C const& c) :
+            parent(),
+            continuation(c),
+            next()
+          {
+            parent.swap(f);
+          }
+
+          void run()
+          {
+            try
+            {
+              set_continuation_value(next, continuation, parent);
+            }
+            catch (...)
+            {
+              next.set_exception(boost::current_exception());
+            }
+          }
+        };
+
+        struct run_state
+        {
+          shared_ptr<state> state_;
+
+          explicit run_state(shared_ptr<state> const& s) : state_(s) {}
+
+          void operator()()
+          {
+            state_->run();
+          }
+        };
+
+        Ex& executor;
+        shared_ptr<state> state_;
+
+        future_executor_continuation(Ex& ex, F& f, C const& c) :
+          executor(ex),
+          state_(new state(f, c))
+        {}
+
+        void do_continuation(boost::unique_lock<boost::mutex>& lk)
+        {
+          // The state owns the parent future, whose associated state owns this
+          // continuation, so the reference is released here to break the cycle.
+          shared_ptr<state> s;
+          s.swap(state_);
+          lk.unlock();
+          try
+          {
+            executor.execute(run_state(s));
+          }
+          catch (...)
+          {
+            s->next.set_exception(boost::current_exception());
+          }
+        }
+      private:
+
+        future_executor_continuation(future_executor_continuation const&);
+        future_executor_continuation& operator=(future_executor_continuation const&);
+      };
   }
 
   ////////////////////////////////
@@ -3243,6 +3349,40 @@ namespace boost
   }
 #endif
 
+  ////////////////////////////////
+  // template<typename Ex, typename F>
+  // auto future<R>::then(Ex& ex, F func) -> BOOST_THREAD_FUTURE<decltype(func(*this))>;
+  ////////////////////////////////
+
+  template <typename R>
+  template <typename Ex, typename F>
+  inline typename disable_if<
+    is_same<typename remove_cv<Ex>::type, launch>,
+    BOOST_THREAD_FUTURE<typename boost::result_of<F(BOOST_THREAD_FUTURE<R>&)>::type>
+  >::type
+  BOOST_THREAD_FUTURE<R>::then(Ex& ex, F func)
+  {
+
+    typedef typename boost::result_of<F(BOOST_THREAD_FUTURE<R>&)>::type future_type;
+    typedef detail::future_executor_continuation<Ex, BOOST_THREAD_FUTURE<R>, future_type, F> continuation_type;
+
+    if (this->future_)
+    {
+      // The associated state is moved into the continuation, so keep a
+      // reference to it while the continuation is being attached.
+      future_ptr fut = this->future_;
+      boost::unique_lock<boost::mutex> lock(fut->mutex);
+      continuation_type* ptr = new continuation_type(ex, *this, func);
+      BOOST_THREAD_FUTURE<future_type> next = ptr->state_->next.get_future();
+      fut->set_continuation_ptr(ptr, lock);
+      return ::boost::move(next);
+    } else {
+      // fixme what to do when the future has no associated state?
+      return BOOST_THREAD_FUTURE<future_type>();
+    }
+
+  }
+
 #endif
 
 }
@@ -0,0 +1,336 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_RCU_VALUE_HPP
+#define BOOST_THREAD_RCU_VALUE_HPP
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/detail/move.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/detail/thread_hash.hpp>
+#include <cstddef>
+#include <vector>
+
+#include <boost/config/abi_prefix.hpp>
+
+#ifndef BOOST_THREAD_RCU_READER_SLOTS
+#define BOOST_THREAD_RCU_READER_SLOTS 32
+#endif
+
+namespace boost
+{
+  namespace thread_detail
+  {
+    /**
+     * The reader counts of one slot of an rcu_value, one per phase, on a
+     * cache line of their own.
+     */
+    struct rcu_reader_slot
+    {
+      boost::atomic<std::size_t> count_[2];
+      char pad_[64 - 2 * sizeof(boost::atomic<std::size_t>)];
+
+      rcu_reader_slot()
+      {
+        count_[0].store(0, boost::memory_order_relaxed);
+        count_[1].store(0, boost::memory_order_relaxed);
+      }
+    };
+
+    /**
+     * Returns the reader slot of the calling thread. Threads that share a
+     * slot share a cache line, but are otherwise counted correctly.
+     */
+    inline std::size_t rcu_thread_slot()
+    {
+      return boost::detail::current_thread_hash() % BOOST_THREAD_RCU_READER_SLOTS;
+    }
+  }
+
+  template <typename T, typename Lockable>
+  class rcu_value;
+
+  /**
+   * A read-side critical section of an rcu_value: a pointer to the version
+   * of the value that was current when it was created. The version is not
+   * reclaimed while the rcu_read_ptr exists, even if newer versions are
+   * published in the meantime.
+   */
+  template <typename T>
+  class rcu_read_ptr
+  {
+  public:
+    typedef T value_type;
+
+    BOOST_THREAD_MOVABLE_ONLY( rcu_read_ptr )
+
+    rcu_read_ptr(BOOST_THREAD_RV_REF(rcu_read_ptr) other) :
+      count_(BOOST_THREAD_RV(other).count_), value_(BOOST_THREAD_RV(other).value_)
+    {
+      BOOST_THREAD_RV(other).count_ = 0;
+      BOOST_THREAD_RV(other).value_ = 0;
+    }
+
+    ~rcu_read_ptr()
+    {
+      if (count_)
+        count_->fetch_sub(1, boost::memory_order_release);
+    }
+
+    const T* operator->() const
+    {
+      return value_;
+    }
+
+    const T& operator*() const
+    {
+      return *value_;
+    }
+
+    const T* get() const
+    {
+      return value_;
+    }
+
+  private:
+    template <typename, typename> friend class rcu_value;
+
+    rcu_read_ptr(boost::atomic<std::size_t>& count, const T* value) :
+      count_(&count), value_(value)
+    {
+    }
+
+    boost::atomic<std::size_t>* count_;
+    const T* value_;
+  };
+
+  /**
+   * A value that many threads read and few threads replace, in the manner
+   * of read-copy-update.
+   *
+   * Readers get a snapshot of the current version without waiting: they
+   * increment a counter that is shared only with the threads that hash to
+   * the same of BOOST_THREAD_RCU_READER_SLOTS slots, and load a pointer.
+   * Writers are serialized by a Lockable. They publish a new version by
+   * replacing the pointer and retire the old version, which is deleted
+   * once no reader can still hold it.
+   *
+   * Readers count themselves in one of two phases. To reclaim versions,
+   * a writer waits until no reader is counted in the phase that readers
+   * are not entering, and makes this the phase that readers enter. A
+   * version that was retired before two such flips cannot be held by any
+   * reader any more. Writers reclaim versions without waiting when they
+   * publish, and synchronize() waits until every retired version is
+   * reclaimed.
+   */
+  template <typename T, typename Lockable = mutex>
+  class rcu_value
+  {
+  public:
+    typedef T value_type;
+    typedef Lockable lockable_type;
+
+    /**
+     * Requires: T is DefaultConstructible
+     */
+    rcu_value() :
+      current_(new T()), phase_(0), flips_(0)
+    {
+    }
+
+    /**
+     * Requires: T is CopyConstructible
+     */
+    explicit rcu_value(T const& value) :
+      current_(new T(value)), phase_(0), flips_(0)
+    {
+    }
+
+    /**
+     * Requires: No rcu_read_ptr of this object exists.
+     *
+     * Effects: Deletes the current and all retired versions.
+     */
+    ~rcu_value()
+    {
+      delete current_.load(boost::memory_order_relaxed);
+      for (std::size_t i = 0; i < retired_.size(); ++i)
+        delete retired_[i].value_;
+    }
+
+    /**
+     * Effects: Enters a read-side critical section, which lasts as long as
+     * the returned rcu_read_ptr. Never blocks.
+     *
+     * Return: A pointer to the current version.
+     */
+    rcu_read_ptr<T> read() const
+    {
+      boost::atomic<std::size_t>& count =
+          slots_[thread_detail::rcu_thread_slot()].count_[phase_.load()];
+      count.fetch_add(1);
+      return BOOST_THREAD_MAKE_RV_REF((rcu_read_ptr<T>(count, current_.load())));
+    }
+
+    /**
+     * Return: A pointer to the current version, as read().
+     */
+    rcu_read_ptr<T> operator->() const
+    {
+      return read();
+    }
+
+    /**
+     * Requires: T is CopyConstructible
+     *
+     * Return: A copy of the current version.
+     */
+    T get() const
+    {
+      rcu_read_ptr<T> p = read();
+      return *p;
+    }
+
+    /**
+     * Requires: T is CopyConstructible
+     *
+     * Effects: Publishes a copy of value as the new version and retires the
+     * previous one. Readers that enter after publish() returns see the new
+     * version.
+     */
+    void publish(T const& value)
+    {
+      T* p = new T(value);
+      lock_guard<lockable_type> lk(mtx_);
+      replace(p);
+    }
+
+    rcu_value& operator=(T const& value)
+    {
+      publish(value);
+      return *this;
+    }
+
+    /**
+     * Requires: T is CopyConstructible
+     *
+     * Effects: Copies the current version, applies f to the copy and
+     * publishes it, while holding the lock of the writers. If f throws, the
+     * current version is not replaced.
+     */
+    template <typename F>
+    void update(F f)
+    {
+      lock_guard<lockable_type> lk(mtx_);
+      T* p = new T(*current_.load(boost::memory_order_relaxed));
+      try
+      {
+        f(*p);
+      }
+      catch (...)
+      {
+        delete p;
+        throw;
+      }
+      replace(p);
+    }
+
+    /**
+     * Requires: The calling thread is in no read-side critical section of
+     * this object.
+     *
+     * Effects: Waits until all versions retired before the call have been
+     * reclaimed.
+     */
+    void synchronize()
+    {
+      for (;;)
+      {
+        {
+          lock_guard<lockable_type> lk(mtx_);
+          reclaim();
+          if (retired_.empty())
+            return;
+        }
+        this_thread::yield();
+      }
+    }
+
+  private:
+    rcu_value(rcu_value const&);
+    rcu_value& operator=(rcu_value const&);
+
+    struct retired_version
+    {
+      T* value_;
+      boost::uint64_t flips_;   // the flips before it was retired
+    };
+
+    // Publishes p and retires the current version. Called with mtx_ locked.
+    void replace(T* p)
+    {
+      retired_version r;
+      r.flips_ = flips_;
+      try
+      {
+        retired_.reserve(retired_.size() + 1);
+      }
+      catch (...)
+      {
+        delete p;
+        throw;
+      }
+      r.value_ = current_.exchange(p);
+      retired_.push_back(r);
+      reclaim();
+    }
+
+    bool has_readers(unsigned phase) const
+    {
+      for (std::size_t i = 0; i < BOOST_THREAD_RCU_READER_SLOTS; ++i)
+      {
+        if (slots_[i].count_[phase].load() != 0)
+          return true;
+      }
+      return false;
+    }
+
+    // Flips the phase as far as readers allow and the oldest retired version
+    // needs, and deletes the versions that no reader can hold. Called with
+    // mtx_ locked.
+    void reclaim()
+    {
+      while (!retired_.empty() && retired_.front().flips_ + 2 > flips_)
+      {
+        unsigned const next = 1 - phase_.load(boost::memory_order_relaxed);
+        if (has_readers(next))
+          break;
+        phase_.store(next);
+        ++flips_;
+      }
+
+      std::size_t n = 0;
+      while (n < retired_.size() && retired_[n].flips_ + 2 <= flips_)
+        delete retired_[n++].value_;
+      retired_.erase(retired_.begin(), retired_.begin() + n);
+    }
+
+    mutable thread_detail::rcu_reader_slot slots_[BOOST_THREAD_RCU_READER_SLOTS];
+    boost::atomic<T*> current_;
+    boost::atomic<unsigned> phase_;
+    boost::uint64_t flips_;
+    std::vector<retired_version> retired_;
+    lockable_type mtx_;
+  };
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif // header
@@ -18,7 +18,17 @@
 #include <boost/thread/win32/shared_mutex.hpp>
 #endif
 #elif defined(BOOST_THREAD_PLATFORM_PTHREAD)
+#if defined(BOOST_THREAD_PROVIDES_FUTEX_SHARED_MUTEX) && defined(BOOST_THREAD_LINUX)
+#include <boost/thread/futex_shared_mutex.hpp>
+namespace boost
+{
+  typedef futex_shared_mutex shared_mutex;
+  typedef futex_shared_mutex upgrade_mutex;
+}
+#define BOOST_THREAD_SHARED_MUTEX_IS_FUTEX_SHARED_MUTEX
+#else
 #include <boost/thread/pthread/shared_mutex.hpp>
+#endif
 #else
 #error "Boost threads unavailable on this platform"
 #endif
@@ -29,7 +39,8 @@ namespace boost
 {
   namespace sync
   {
-#ifdef BOOST_THREAD_NO_AUTO_DETECT_MUTEX_TYPES
+#if defined BOOST_THREAD_NO_AUTO_DETECT_MUTEX_TYPES \
+ && ! defined BOOST_THREAD_SHARED_MUTEX_IS_FUTEX_SHARED_MUTEX
     template<>
     struct is_basic_lockable<shared_mutex>
     {
@@ -0,0 +1,445 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_THREAD_POOL_HPP
+#define BOOST_THREAD_THREAD_POOL_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/detail/work_stealing_deque.hpp>
+#include <boost/thread/exceptions.hpp>
+#include <boost/thread/future.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/atomic.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/utility/result_of.hpp>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  namespace thread_detail
+  {
+    struct thread_pool_task
+    {
+      virtual ~thread_pool_task() {}
+      virtual void run() = 0;
+    };
+
+    template <typename F>
+    struct thread_pool_closure : thread_pool_task
+    {
+      F f_;
+
+      explicit thread_pool_closure(F const& f) : f_(f) {}
+
+      void run()
+      {
+        f_();
+      }
+    };
+
+    template <typename R, typename F>
+    struct thread_pool_future_task : thread_pool_task
+    {
+      F f_;
+      promise<R> promise_;
+
+      explicit thread_pool_future_task(F const& f) : f_(f) {}
+
+      void run()
+      {
+        try
+        {
+          promise_.set_value(f_());
+        }
+        catch (...)
+        {
+          promise_.set_exception(boost::current_exception());
+        }
+      }
+    };
+
+    template <typename F>
+    struct thread_pool_future_task<void, F> : thread_pool_task
+    {
+      F f_;
+      promise<void> promise_;
+
+      explicit thread_pool_future_task(F const& f) : f_(f) {}
+
+      void run()
+      {
+        try
+        {
+          f_();
+          promise_.set_value();
+        }
+        catch (...)
+        {
+          promise_.set_exception(boost::current_exception());
+        }
+      }
+    };
+  }
+
+  /**
+   * A fixed-size pool of threads that run submitted tasks.
+   *
+   * Each thread has its own work-stealing deque. Tasks submitted from a pool
+   * thread are pushed on to that thread's deque and run most-recent-first by
+   * it, while idle threads steal the oldest tasks from the deques of the other
+   * threads. Tasks submitted from other threads are placed on a shared queue.
+   * This suits fork/join algorithms, where a task splits its work into
+   * sub-tasks and waits for their results using reschedule_until().
+   *
+   * When continuations are enabled (BOOST_THREAD_PROVIDES_FUTURE_CONTINUATION),
+   * f.then(pool, c) runs the continuation c as a task on the pool instead of on
+   * the thread that makes f ready.
+   */
+  class thread_pool
+  {
+  public:
+    /**
+     * Effects: Creates a pool of thread_count threads, or of one thread per
+     * hardware thread if thread_count is zero.
+     *
+     * Throws: thread_resource_error if a thread cannot be created.
+     */
+    explicit thread_pool(unsigned thread_count = 0) :
+      current_(&thread_pool::null_cleanup),
+      queued_(0),
+      idle_(0),
+      closed_(false)
+    {
+      if (thread_count == 0)
+        thread_count = thread::hardware_concurrency();
+      if (thread_count == 0)
+        thread_count = 1;
+
+      try
+      {
+        workers_.reserve(thread_count);
+        for (unsigned i = 0; i < thread_count; ++i)
+          workers_.push_back(new worker(i));
+        for (unsigned i = 0; i < thread_count; ++i)
+          threads_.create_thread(worker_function(this, workers_[i]));
+      }
+      catch (...)
+      {
+        close();
+        threads_.join_all();
+        delete_workers();
+        throw;
+      }
+    }
+
+    /**
+     * Effects: Closes the pool, waits for the queued tasks to complete and
+     * joins the threads.
+     */
+    ~thread_pool()
+    {
+      close();
+      threads_.join_all();
+      delete_workers();
+    }
+
+    /**
+     * Effects: Schedules f() to run on the pool.
+     *
+     * Returns: A future that is made ready with the result of f(), or with the
+     * exception thrown by it.
+     *
+     * Throws: thread_resource_error if the pool has been closed and this
+     * function is not called from one of the pool's threads.
+     */
+    template <typename F>
+    BOOST_THREAD_FUTURE<typename boost::result_of<F()>::type>
+    submit(F f)
+    {
+      typedef typename boost::result_of<F()>::type result_type;
+      typedef thread_detail::thread_pool_future_task<result_type, F> task_type;
+      task_type* t = new task_type(f);
+      BOOST_THREAD_FUTURE<result_type> result;
+      try
+      {
+        result = t->promise_.get_future();
+        schedule(t);
+      }
+      catch (...)
+      {
+        delete t;
+        throw;
+      }
+      return ::boost::move(result);
+    }
+
+    /**
+     * Effects: Schedules f() to run on the pool. If f() throws an exception,
+     * std::terminate() is called.
+     *
+     * Throws: thread_resource_error if the pool has been closed and this
+     * function is not called from one of the pool's threads.
+     */
+    template <typename F>
+    void execute(F f)
+    {
+      thread_detail::thread_pool_task* t =
+          new thread_detail::thread_pool_closure<F>(f);
+      try
+      {
+        schedule(t);
+      }
+      catch (...)
+      {
+        delete t;
+        throw;
+      }
+    }
+
+    /**
+     * Effects: Runs one queued task on the calling thread, if there is one.
+     *
+     * Returns: Whether a task was run.
+     */
+    bool try_executing_one()
+    {
+      worker* w = current_.get();
+      if (thread_detail::thread_pool_task* t = find_task(w))
+      {
+        run(t);
+        return true;
+      }
+      return false;
+    }
+
+    /**
+     * Effects: Runs queued tasks on the calling thread until pred() returns
+     * true. This allows a task to wait for the sub-tasks it has submitted
+     * without blocking a pool thread.
+     */
+    template <typename Pred>
+    void reschedule_until(Pred const& pred)
+    {
+      while (!pred())
+      {
+        if (!try_executing_one())
+          this_thread::yield();
+      }
+    }
+
+    /**
+     * Effects: Prevents tasks from being submitted from outside the pool. The
+     * tasks already queued, and any that they submit, are still run.
+     */
+    void close()
+    {
+      boost::lock_guard<boost::mutex> lock(mutex_);
+      closed_ = true;
+      wakeup_.notify_all();
+    }
+
+    /**
+     * Returns: Whether close() has been called.
+     */
+    bool closed()
+    {
+      boost::lock_guard<boost::mutex> lock(mutex_);
+      return closed_;
+    }
+
+    /**
+     * Returns: The number of threads in the pool.
+     */
+    std::size_t size() const
+    {
+      return workers_.size();
+    }
+
+  private:
+    thread_pool(thread_pool const&);
+    thread_pool& operator=(thread_pool const&);
+
+    struct worker
+    {
+      explicit worker(unsigned index) :
+        victim_seed_(index * 2654435761u + 1)
+      {
+      }
+
+      thread_detail::work_stealing_deque<thread_detail::thread_pool_task> deque_;
+      unsigned victim_seed_;
+    };
+
+    struct worker_function
+    {
+      thread_pool* pool_;
+      worker* worker_;
+
+      worker_function(thread_pool* pool, worker* w) : pool_(pool), worker_(w) {}
+
+      void operator()()
+      {
+        pool_->worker_loop(worker_);
+      }
+    };
+
+    static void null_cleanup(worker*)
+    {
+    }
+
+    void schedule(thread_detail::thread_pool_task* t)
+    {
+      if (worker* w = current_.get())
+      {
+        w->deque_.push(t);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (idle_.load(memory_order_relaxed) > 0)
+        {
+          boost::lock_guard<boost::mutex> lock(mutex_);
+          wakeup_.notify_one();
+        }
+      }
+      else
+      {
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        if (closed_)
+        {
+          boost::throw_exception(thread_resource_error(
+              system::errc::operation_not_permitted,
+              "boost::thread_pool: the pool is closed"));
+        }
+        queue_.push_back(t);
+        queued_.fetch_add(1, memory_order_seq_cst);
+        if (idle_.load(memory_order_relaxed) > 0)
+          wakeup_.notify_one();
+      }
+    }
+
+    thread_detail::thread_pool_task* find_task(worker* w)
+    {
+      if (w)
+      {
+        if (thread_detail::thread_pool_task* t = w->deque_.take())
+          return t;
+      }
+
+      if (queued_.load(memory_order_relaxed) > 0)
+      {
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        if (!queue_.empty())
+        {
+          thread_detail::thread_pool_task* t = queue_.front();
+          queue_.pop_front();
+          queued_.fetch_sub(1, memory_order_relaxed);
+          return t;
+        }
+      }
+
+      // Steal from the other threads, starting at a pseudo-random victim.
+      std::size_t n = workers_.size();
+      std::size_t start = 0;
+      if (w)
+      {
+        w->victim_seed_ = w->victim_seed_ * 1103515245u + 12345u;
+        start = (w->victim_seed_ >> 16) % n;
+      }
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        worker* victim = workers_[(start + i) % n];
+        if (victim != w)
+        {
+          if (thread_detail::thread_pool_task* t = victim->deque_.steal())
+            return t;
+        }
+      }
+
+      return 0;
+    }
+
+    // Whether any task is queued. Must be called with the mutex held.
+    bool has_queued_tasks() const
+    {
+      if (!queue_.empty())
+        return true;
+      for (std::size_t i = 0; i < workers_.size(); ++i)
+        if (!workers_[i]->deque_.empty())
+          return true;
+      return false;
+    }
+
+    static void run(thread_detail::thread_pool_task* t)
+    {
+      struct task_deleter
+      {
+        thread_detail::thread_pool_task* t_;
+        ~task_deleter() { delete t_; }
+      } deleter = { t };
+      t->run();
+    }
+
+    void worker_loop(worker* w)
+    {
+      current_.reset(w);
+      for (;;)
+      {
+        if (thread_detail::thread_pool_task* t = find_task(w))
+        {
+          run(t);
+          continue;
+        }
+
+        // Nothing was found. Register as idle before checking once more, so
+        // that a thread pushing a task either sees this thread as idle or has
+        // its task seen by the check.
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        idle_.fetch_add(1, memory_order_seq_cst);
+        if (!has_queued_tasks())
+        {
+          if (closed_)
+          {
+            idle_.fetch_sub(1, memory_order_relaxed);
+            break;
+          }
+          wakeup_.wait(lock);
+        }
+        idle_.fetch_sub(1, memory_order_relaxed);
+      }
+      current_.reset();
+    }
+
+    void delete_workers()
+    {
+      for (std::size_t i = 0; i < workers_.size(); ++i)
+        delete workers_[i];
+      workers_.clear();
+    }
+
+    std::vector<worker*> workers_;
+    thread_group threads_;
+    thread_specific_ptr<worker> current_;
+
+    // Protects the shared queue, the closed flag and the sleeping threads.
+    boost::mutex mutex_;
+    boost::condition_variable wakeup_;
+    std::deque<thread_detail::thread_pool_task*> queue_;
+    atomic<std::size_t> queued_;
+    atomic<unsigned> idle_;
+    bool closed_;
+  };
+
+} // namespace boost
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -0,0 +1,419 @@
+//
+// coalescing_write_stream.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include <boost/asio/coalescing_write_stream.hpp>
+
+#include <boost/bind.hpp>
+#include <cstring>
+#include <vector>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/placeholders.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/system/system_error.hpp>
+#include <boost/thread/thread.hpp>
+#include "unit_test.hpp"
+
+// A stream that counts the asynchronous write operations made on a socket.
+class counting_stream
+{
+public:
+  typedef boost::asio::ip::tcp::socket::lowest_layer_type lowest_layer_type;
+
+  explicit counting_stream(boost::asio::ip::tcp::socket& socket)
+    : socket_(socket),
+      write_count_(0)
+  {
+  }
+
+  lowest_layer_type& lowest_layer()
+  {
+    return socket_.lowest_layer();
+  }
+
+  const lowest_layer_type& lowest_layer() const
+  {
+    return socket_.lowest_layer();
+  }
+
+  boost::asio::io_service& get_io_service()
+  {
+    return socket_.get_io_service();
+  }
+
+  void close()
+  {
+    socket_.close();
+  }
+
+  boost::system::error_code close(boost::system::error_code& ec)
+  {
+    return socket_.close(ec);
+  }
+
+  template <typename ConstBufferSequence>
+  std::size_t write_some(const ConstBufferSequence& buffers)
+  {
+    return socket_.write_some(buffers);
+  }
+
+  template <typename ConstBufferSequence>
+  std::size_t write_some(const ConstBufferSequence& buffers,
+      boost::system::error_code& ec)
+  {
+    return socket_.write_some(buffers, ec);
+  }
+
+  template <typename ConstBufferSequence, typename WriteHandler>
+  void async_write_some(const ConstBufferSequence& buffers,
+      WriteHandler handler)
+  {
+    ++write_count_;
+    socket_.async_write_some(buffers, handler);
+  }
+
+  template <typename MutableBufferSequence>
+  std::size_t read_some(const MutableBufferSequence& buffers)
+  {
+    return socket_.read_some(buffers);
+  }
+
+  template <typename MutableBufferSequence>
+  std::size_t read_some(const MutableBufferSequence& buffers,
+      boost::system::error_code& ec)
+  {
+    return socket_.read_some(buffers, ec);
+  }
+
+  template <typename MutableBufferSequence, typename ReadHandler>
+  void async_read_some(const MutableBufferSequence& buffers,
+      ReadHandler handler)
+  {
+    socket_.async_read_some(buffers, handler);
+  }
+
+  std::size_t write_count() const
+  {
+    return write_count_;
+  }
+
+private:
+  boost::asio::ip::tcp::socket& socket_;
+  std::size_t write_count_;
+};
+
+typedef boost::asio::coalescing_write_stream<counting_stream> stream_type;
+
+void connect_sockets(boost::asio::io_service& io_service,
+    boost::asio::ip::tcp::socket& client_socket,
+    boost::asio::ip::tcp::socket& server_socket)
+{
+  boost::asio::ip::tcp::acceptor acceptor(io_service,
+      boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), 0));
+  boost::asio::ip::tcp::endpoint server_endpoint = acceptor.local_endpoint();
+  server_endpoint.address(boost::asio::ip::address_v4::loopback());
+
+  client_socket.connect(server_endpoint);
+  acceptor.accept(server_socket);
+}
+
+void test_sync_operations()
+{
+  using namespace std; // For memcmp.
+
+  boost::asio::io_service io_service;
+  boost::asio::ip::tcp::socket client(io_service);
+  boost::asio::ip::tcp::socket server(io_service);
+  connect_sockets(io_service, client, server);
+
+  stream_type client_socket(client);
+  stream_type server_socket(server);
+
+  const char write_data[]
+    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+  const boost::asio::const_buffer write_buf = boost::asio::buffer(write_data);
+
+  std::size_t bytes_written = 0;
+  while (bytes_written < sizeof(write_data))
+  {
+    bytes_written += client_socket.write_some(
+        boost::asio::buffer(write_buf + bytes_written));
+  }
+
+  char read_data[sizeof(write_data)];
+  const boost::asio::mutable_buffer read_buf = boost::asio::buffer(read_data);
+
+  std::size_t bytes_read = 0;
+  while (bytes_read < sizeof(read_data))
+  {
+    bytes_read += server_socket.read_some(
+        boost::asio::buffer(read_buf + bytes_read));
+  }
+
+  BOOST_CHECK(bytes_written == sizeof(write_data));
+  BOOST_CHECK(bytes_read == sizeof(read_data));
+  BOOST_CHECK(memcmp(write_data, read_data, sizeof(write_data)) == 0);
+
+  server_socket.close();
+  boost::system::error_code error;
+  bytes_read = client_socket.read_some(
+      boost::asio::buffer(read_buf), error);
+
+  BOOST_CHECK(bytes_read == 0);
+  BOOST_CHECK(error == boost::asio::error::eof);
+
+  client_socket.close(error);
+}
+
+void handle_write(const boost::system::error_code& e,
+    std::size_t bytes_transferred, std::size_t expected_bytes,
+    std::vector<int>* order, int id)
+{
+  BOOST_CHECK(!e);
+  if (e)
+    throw boost::system::system_error(e); // Terminate test.
+  BOOST_CHECK(bytes_transferred == expected_bytes);
+  order->push_back(id);
+}
+
+void handle_write_error(const boost::system::error_code& e,
+    std::size_t bytes_transferred, int* count)
+{
+  BOOST_CHECK(e);
+  BOOST_CHECK(bytes_transferred == 0);
+  ++(*count);
+}
+
+void handle_empty_write(const boost::system::error_code& e,
+    std::size_t bytes_transferred, int* count)
+{
+  BOOST_CHECK(!e);
+  BOOST_CHECK(bytes_transferred == 0);
+  ++(*count);
+}
+
+void handle_read(const boost::system::error_code& e,
+    std::size_t bytes_transferred, std::size_t expected_bytes)
+{
+  BOOST_CHECK(!e);
+  BOOST_CHECK(bytes_transferred == expected_bytes);
+}
+
+void test_async_operations()
+{
+  using namespace std; // For memcmp.
+
+  boost::asio::io_service io_service;
+  boost::asio::ip::tcp::socket client(io_service);
+  boost::asio::ip::tcp::socket server(io_service);
+  connect_sockets(io_service, client, server);
+
+  stream_type client_socket(client);
+  stream_type server_socket(server);
+
+  // Writes started together are written using a single operation on the next
+  // layer, in the order in which they were started.
+  const char write_data[]
+    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+  std::vector<int> order;
+  std::size_t total_bytes = 0;
+  for (int i = 0; i < 10; ++i)
+  {
+    client_socket.async_write_some(
+        boost::asio::buffer(write_data + i, 5),
+        boost::bind(handle_write, boost::asio::placeholders::error,
+          boost::asio::placeholders::bytes_transferred,
+          std::size_t(5), &order, i));
+    total_bytes += 5;
+  }
+
+  int empty_count = 0;
+  client_socket.async_write_some(boost::asio::null_buffers(),
+      boost::bind(handle_empty_write, boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred, &empty_count));
+
+  io_service.run();
+  io_service.reset();
+
+  BOOST_CHECK(client_socket.next_layer().write_count() == 1);
+  BOOST_CHECK(order.size() == 10);
+  for (std::size_t i = 0; i < order.size(); ++i)
+    BOOST_CHECK(order[i] == static_cast<int>(i));
+  BOOST_CHECK(empty_count == 1);
+
+  std::vector<char> read_data(total_bytes);
+  boost::asio::async_read(server_socket, boost::asio::buffer(read_data),
+      boost::bind(handle_read, boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred, total_bytes));
+  io_service.run();
+  io_service.reset();
+
+  for (std::size_t i = 0; i < 10; ++i)
+    BOOST_CHECK(memcmp(&read_data[i * 5], write_data + i, 5) == 0);
+
+  // A write with more buffers than can be gathered into a single operation on
+  // the next layer is written using several operations, but its data is not
+  // interleaved with that of the following writes.
+  std::vector<boost::asio::const_buffer> many_buffers;
+  for (int i = 0; i < 100; ++i)
+    many_buffers.push_back(boost::asio::buffer(write_data + (i % 52), 1));
+
+  order.clear();
+  client_socket.async_write_some(many_buffers,
+      boost::bind(handle_write, boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred,
+        std::size_t(100), &order, 0));
+  client_socket.async_write_some(boost::asio::buffer(write_data, 10),
+      boost::bind(handle_write, boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred,
+        std::size_t(10), &order, 1));
+
+  io_service.run();
+  io_service.reset();
+
+  BOOST_CHECK(client_socket.next_layer().write_count() == 3);
+  BOOST_CHECK(order.size() == 2);
+  BOOST_CHECK(order.size() == 2 && order[0] == 0 && order[1] == 1);
+
+  read_data.resize(110);
+  boost::asio::async_read(server_socket, boost::asio::buffer(read_data),
+      boost::bind(handle_read, boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred, std::size_t(110)));
+  io_service.run();
+  io_service.reset();
+
+  for (std::size_t i = 0; i < 100; ++i)
+    BOOST_CHECK(read_data[i] == write_data[i % 52]);
+  BOOST_CHECK(memcmp(&read_data[100], write_data, 10) == 0);
+
+  // Queued writes fail if the next layer is closed.
+  int error_count = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    client_socket.async_write_some(boost::asio::buffer(write_data),
+        boost::bind(handle_write_error, boost::asio::placeholders::error,
+          boost::asio::placeholders::bytes_transferred, &error_count));
+  }
+  client_socket.close();
+
+  io_service.run();
+  io_service.reset();
+
+  BOOST_CHECK(error_count == 3);
+}
+
+void start_thread_writes(stream_type* stream,
+    boost::asio::io_service::strand* s, const char* data, int remaining);
+
+void handle_thread_write(const boost::system::error_code& e,
+    std::size_t bytes_transferred, stream_type* stream,
+    boost::asio::io_service::strand* s, const char* data, int remaining)
+{
+  BOOST_CHECK(!e);
+  BOOST_CHECK(bytes_transferred == 16);
+  if (!e && remaining > 0)
+    start_thread_writes(stream, s, data, remaining);
+}
+
+void start_thread_writes(stream_type* stream,
+    boost::asio::io_service::strand* s, const char* data, int remaining)
+{
+  // Each write is a 16-byte record consisting of a single repeated character.
+  stream->async_write_some(boost::asio::buffer(data, 16),
+      s->wrap(boost::bind(handle_thread_write,
+          boost::asio::placeholders::error,
+          boost::asio::placeholders::bytes_transferred,
+          stream, s, data, remaining - 1)));
+}
+
+void io_service_run(boost::asio::io_service* io_service)
+{
+  io_service->run();
+}
+
+void test_concurrent_writes()
+{
+  boost::asio::io_service io_service;
+  boost::asio::ip::tcp::socket client(io_service);
+  boost::asio::ip::tcp::socket server(io_service);
+  connect_sockets(io_service, client, server);
+
+  stream_type client_socket(client);
+
+  const int writers = 4;
+  const int writes_per_writer = 200;
+  const char data[writers][16] = {
+    { 'A', 'A', 'A', 'A', 'A', 'A', 'A', 'A',
+      'A', 'A', 'A', 'A', 'A', 'A', 'A', 'A' },
+    { 'B', 'B', 'B', 'B', 'B', 'B', 'B', 'B',
+      'B', 'B', 'B', 'B', 'B', 'B', 'B', 'B' },
+    { 'C', 'C', 'C', 'C', 'C', 'C', 'C', 'C',
+      'C', 'C', 'C', 'C', 'C', 'C', 'C', 'C' },
+    { 'D', 'D', 'D', 'D', 'D', 'D', 'D', 'D',
+      'D', 'D', 'D', 'D', 'D', 'D', 'D', 'D' } };
+
+  boost::asio::io_service::strand s0(io_service);
+  boost::asio::io_service::strand s1(io_service);
+  boost::asio::io_service::strand s2(io_service);
+  boost::asio::io_service::strand s3(io_service);
+  boost::asio::io_service::strand* strands[writers] = { &s0, &s1, &s2, &s3 };
+
+  for (int i = 0; i < writers; ++i)
+  {
+    strands[i]->post(boost::bind(start_thread_writes,
+          &client_socket, strands[i], data[i], writes_per_writer));
+  }
+
+  boost::thread thread1(boost::bind(io_service_run, &io_service));
+  boost::thread thread2(boost::bind(io_service_run, &io_service));
+  boost::thread thread3(boost::bind(io_service_run, &io_service));
+  io_service.run();
+  thread1.join();
+  thread2.join();
+  thread3.join();
+
+  // Every record must have been written without being interleaved with any
+  // other record.
+  std::vector<char> read_data(writers * writes_per_writer * 16);
+  boost::asio::read(server, boost::asio::buffer(read_data));
+
+  int counts[writers] = { 0, 0, 0, 0 };
+  for (std::size_t i = 0; i < read_data.size(); i += 16)
+  {
+    char c = read_data[i];
+    BOOST_CHECK(c >= 'A' && c < 'A' + writers);
+    for (std::size_t j = 1; j < 16; ++j)
+      BOOST_CHECK(read_data[i + j] == c);
+    if (c >= 'A' && c < 'A' + writers)
+      ++counts[c - 'A'];
+  }
+
+  for (int i = 0; i < writers; ++i)
+    BOOST_CHECK(counts[i] == writes_per_writer);
+  BOOST_CHECK(client_socket.next_layer().write_count()
+      <= std::size_t(writers * writes_per_writer));
+}
+
+test_suite* init_unit_test_suite(int, char*[])
+{
+  test_suite* test = BOOST_TEST_SUITE("coalescing_write_stream");
+  test->add(BOOST_TEST_CASE(&test_sync_operations));
+  test->add(BOOST_TEST_CASE(&test_async_operations));
+  test->add(BOOST_TEST_CASE(&test_concurrent_writes));
+  return test;
+}
@@ -17,6 +17,8 @@
 #include <boost/asio/io_service.hpp>
 
 #include <sstream>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/bind.hpp>
 #include <boost/asio/deadline_timer.hpp>
@@ -254,6 +256,170 @@ void io_service_test()
   BOOST_CHECK(exception_count == 2);
 }
 
+void locked_increment_chain(io_service* ios,
+    boost::mutex* mutex, int* count, int remaining)
+{
+  {
+    boost::mutex::scoped_lock lock(*mutex);
+    ++(*count);
+  }
+
+  if (remaining > 1)
+  {
+    ios->post(boost::bind(locked_increment_chain,
+          ios, mutex, count, remaining - 1));
+  }
+}
+
+void timer_increment(boost::shared_ptr<deadline_timer>,
+    boost::mutex* mutex, int* count)
+{
+  boost::mutex::scoped_lock lock(*mutex);
+  ++(*count);
+}
+
+void start_timers(io_service* ios, boost::mutex* mutex, int* count)
+{
+  // Timer operations started on one thread complete on that thread's queue,
+  // from where they may be stolen by other threads.
+  for (int i = 0; i < 10; ++i)
+  {
+    boost::shared_ptr<deadline_timer> t(new deadline_timer(*ios,
+          boost::posix_time::milliseconds(10 * i)));
+    t->async_wait(boost::bind(timer_increment, t, mutex, count));
+  }
+}
+
+void io_service_work_stealing_test()
+{
+  io_service ios(BOOST_ASIO_CONCURRENCY_HINT_WORK_STEALING_QUEUES(4));
+  int count = 0;
+
+  ios.post(boost::bind(increment, &count));
+  ios.post(boost::bind(increment, &count));
+  ios.post(boost::bind(increment, &count));
+
+  // No handlers can be called until run() is called.
+  BOOST_CHECK(!ios.stopped());
+  BOOST_CHECK(count == 0);
+
+  ios.run();
+
+  // The run() call will not return until all work has finished.
+  BOOST_CHECK(ios.stopped());
+  BOOST_CHECK(count == 3);
+
+  count = 10;
+  ios.reset();
+  ios.post(boost::bind(decrement_to_zero, &ios, &count));
+  ios.run();
+
+  // The run() call will not return until all work has finished.
+  BOOST_CHECK(ios.stopped());
+  BOOST_CHECK(count == 0);
+
+  count = 10;
+  ios.reset();
+  ios.post(boost::bind(nested_decrement_to_zero, &ios, &count));
+  ios.run();
+
+  // The run() call will not return until all work has finished.
+  BOOST_CHECK(ios.stopped());
+  BOOST_CHECK(count == 0);
+
+  count = 0;
+  ios.reset();
+  io_service::work* w = new io_service::work(ios);
+  ios.post(boost::bind(&io_service::stop, &ios));
+  ios.run();
+
+  // The only operation executed should have been to stop run().
+  BOOST_CHECK(ios.stopped());
+  BOOST_CHECK(count == 0);
+  delete w;
+
+  boost::mutex mutex;
+  count = 0;
+  ios.reset();
+  for (int i = 0; i < 8; ++i)
+    ios.post(boost::bind(locked_increment_chain, &ios, &mutex, &count, 1000));
+  ios.post(boost::bind(start_timers, &ios, &mutex, &count));
+  boost::thread thread1(boost::bind(io_service_run, &ios));
+  boost::thread thread2(boost::bind(io_service_run, &ios));
+  boost::thread thread3(boost::bind(io_service_run, &ios));
+  ios.run();
+  thread1.join();
+  thread2.join();
+  thread3.join();
+
+  // The run() calls will not return until all work has finished.
+  BOOST_CHECK(ios.stopped());
+  BOOST_CHECK(count == 8010);
+}
+
+void io_service_concurrency_hint_test()
+{
+  // Counts too large for their fields are reduced to the maximum, rather than
+  // wrapping around.
+  BOOST_CHECK(BOOST_ASIO_CONCURRENCY_HINT_QUEUES(
+        BOOST_ASIO_CONCURRENCY_HINT_WORK_STEALING_QUEUES(4)) == 4);
+  BOOST_CHECK(BOOST_ASIO_CONCURRENCY_HINT_QUEUES(
+        BOOST_ASIO_CONCURRENCY_HINT_WORK_STEALING_QUEUES(256))
+      == BOOST_ASIO_CONCURRENCY_HINT_MAX_QUEUES);
+  BOOST_CHECK(BOOST_ASIO_CONCURRENCY_HINT_QUEUES(
+        BOOST_ASIO_CONCURRENCY_HINT_WORK_STEALING_QUEUES(300))
+      == BOOST_ASIO_CONCURRENCY_HINT_MAX_QUEUES);
+  BOOST_CHECK(BOOST_ASIO_CONCURRENCY_HINT_REACTORS(
+        BOOST_ASIO_CONCURRENCY_HINT_MULTI_REACTOR(4)) == 4);
+  BOOST_CHECK(BOOST_ASIO_CONCURRENCY_HINT_REACTORS(
+        BOOST_ASIO_CONCURRENCY_HINT_MULTI_REACTOR(64))
+      == BOOST_ASIO_CONCURRENCY_HINT_MAX_REACTORS);
+}
+
+void allocate_twice(bool* same_block)
+{
+  void* p1 = asio_handler_allocate(64, same_block);
+  asio_handler_deallocate(p1, 64, same_block);
+  void* p2 = asio_handler_allocate(64, same_block);
+  asio_handler_deallocate(p2, 64, same_block);
+  *same_block = (p1 == p2);
+}
+
+void io_service_recycling_allocator_test()
+{
+  io_service ios(BOOST_ASIO_CONCURRENCY_HINT_RECYCLING_ALLOCATOR);
+  bool same_block = false;
+
+  ios.post(boost::bind(allocate_twice, &same_block));
+  ios.run();
+
+#if !defined(BOOST_ASIO_HAS_IOCP)
+  // A block freed by a thread running the io_service is reused by that
+  // thread's next allocation of the same size.
+  BOOST_CHECK(same_block);
+#endif // !defined(BOOST_ASIO_HAS_IOCP)
+
+  // Blocks may be allocated by one thread and freed by another.
+  io_service ios2(BOOST_ASIO_CONCURRENCY_HINT_RECYCLING_ALLOCATOR
+      | BOOST_ASIO_CONCURRENCY_HINT_WORK_STEALING_QUEUES(4));
+  boost::mutex mutex;
+  int count = 0;
+  for (int i = 0; i < 8; ++i)
+    ios2.post(boost::bind(locked_increment_chain, &ios2, &mutex, &count, 1000));
+  ios2.post(boost::bind(start_timers, &ios2, &mutex, &count));
+  boost::thread thread1(boost::bind(io_service_run, &ios2));
+  boost::thread thread2(boost::bind(io_service_run, &ios2));
+  boost::thread thread3(boost::bind(io_service_run, &ios2));
+  ios2.run();
+  thread1.join();
+  thread2.join();
+  thread3.join();
+
+  // The run() calls will not return until all work has finished.
+  BOOST_CHECK(ios2.stopped());
+  BOOST_CHECK(count == 8010);
+}
+
 class test_service : public boost::asio::io_service::service
 {
 public:
@@ -328,6 +494,9 @@ test_suite* init_unit_test_suite(int, char*[])
 {
   test_suite* test = BOOST_TEST_SUITE("io_service");
   test->add(BOOST_TEST_CASE(&io_service_test));
+  test->add(BOOST_TEST_CASE(&io_service_work_stealing_test));
+  test->add(BOOST_TEST_CASE(&io_service_concurrency_hint_test));
+  test->add(BOOST_TEST_CASE(&io_service_recycling_allocator_test));
   test->add(BOOST_TEST_CASE(&io_service_service_test));
   return test;
 }
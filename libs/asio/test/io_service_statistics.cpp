@@ -0,0 +1,192 @@
+//
+// io_service_statistics.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include <boost/asio/io_service_statistics.hpp>
+
+#include <cstring>
+#include <boost/bind.hpp>
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/thread/thread.hpp>
+#include "unit_test.hpp"
+
+using namespace boost::asio;
+
+const io_service_statistics::operation* find_operation(
+    const io_service_statistics& stats,
+    const char* object_type, const char* name)
+{
+  for (std::size_t i = 0; i < stats.operations().size(); ++i)
+  {
+    const io_service_statistics::operation& op = stats.operations()[i];
+    if (std::strcmp(op.object_type(), object_type) == 0
+        && std::strcmp(op.name(), name) == 0)
+      return &op;
+  }
+  return 0;
+}
+
+void increment(int* count)
+{
+  ++(*count);
+}
+
+void wait_handler(int* count, const boost::system::error_code&)
+{
+  ++(*count);
+}
+
+void io_service_run(io_service* ios)
+{
+  ios->run();
+}
+
+void io_service_statistics_histogram_test()
+{
+  io_service_statistics::histogram h;
+
+  BOOST_CHECK(h.size() == io_service_statistics::histogram::bucket_count);
+  BOOST_CHECK(h.count() == 0);
+  BOOST_CHECK(h.percentile(50) == 0);
+
+  for (std::size_t i = 0; i < h.size(); ++i)
+    BOOST_CHECK(h[i] == 0);
+
+  BOOST_CHECK(io_service_statistics::histogram::bucket_limit(0) == 2);
+  BOOST_CHECK(io_service_statistics::histogram::bucket_limit(9) == 1024);
+  BOOST_CHECK(io_service_statistics::histogram::bucket_limit(h.size() - 1)
+      == ~boost::uint64_t(0));
+
+  io_service_statistics stats;
+  BOOST_CHECK(stats.operations().empty());
+  BOOST_CHECK(stats.count() == 0);
+  BOOST_CHECK(stats.queue_wait().count() == 0);
+  BOOST_CHECK(stats.execution().count() == 0);
+}
+
+void io_service_statistics_recording_test()
+{
+  io_service ios;
+  int count = 0;
+
+  // Nothing is recorded until statistics are enabled.
+  ios.post(boost::bind(increment, &count));
+  ios.run();
+  BOOST_CHECK(count == 1);
+  BOOST_CHECK(ios.statistics().operations().empty());
+
+  ios.enable_statistics();
+
+  count = 0;
+  ios.reset();
+  for (int i = 0; i < 100; ++i)
+    ios.post(boost::bind(increment, &count));
+  deadline_timer t(ios, boost::posix_time::milliseconds(1));
+  t.async_wait(boost::bind(wait_handler, &count, _1));
+  ios.run();
+  BOOST_CHECK(count == 101);
+
+#if defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+  io_service_statistics stats = ios.statistics();
+
+  const io_service_statistics::operation* post_op =
+    find_operation(stats, "io_service", "post");
+  BOOST_CHECK(post_op != 0);
+  if (post_op)
+  {
+    BOOST_CHECK(post_op->count() == 100);
+    BOOST_CHECK(post_op->execution().count() == 100);
+    BOOST_CHECK(post_op->queue_wait().count() == 100);
+    BOOST_CHECK(post_op->execution().percentile(50)
+        <= post_op->execution().percentile(99));
+  }
+
+  const io_service_statistics::operation* wait_op =
+    find_operation(stats, "deadline_timer", "async_wait");
+  BOOST_CHECK(wait_op != 0);
+  if (wait_op)
+  {
+    BOOST_CHECK(wait_op->count() == 1);
+    BOOST_CHECK(wait_op->queue_wait().count() == 1);
+  }
+
+  BOOST_CHECK(stats.count() == 101);
+  BOOST_CHECK(stats.execution().count() == 101);
+
+  // Handlers invoked while statistics are disabled are not recorded.
+  ios.disable_statistics();
+  ios.reset();
+  ios.post(boost::bind(increment, &count));
+  ios.run();
+  BOOST_CHECK(count == 102);
+  BOOST_CHECK(ios.statistics().count() == 101);
+
+  // Recording resumes from the previous values.
+  ios.enable_statistics();
+  ios.reset();
+  ios.post(boost::bind(increment, &count));
+  ios.run();
+  BOOST_CHECK(count == 103);
+  BOOST_CHECK(ios.statistics().count() == 102);
+#else // defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+  BOOST_CHECK(ios.statistics().operations().empty());
+#endif // defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+}
+
+void io_service_statistics_thread_test()
+{
+  io_service ios(BOOST_ASIO_CONCURRENCY_HINT_WORK_STEALING_QUEUES(4));
+  io_service::strand s(ios);
+  int count = 0;
+
+  ios.enable_statistics();
+  for (int i = 0; i < 1000; ++i)
+    ios.post(s.wrap(boost::bind(increment, &count)));
+
+  boost::thread thread1(boost::bind(io_service_run, &ios));
+  boost::thread thread2(boost::bind(io_service_run, &ios));
+  boost::thread thread3(boost::bind(io_service_run, &ios));
+  ios.run();
+  thread1.join();
+  thread2.join();
+  thread3.join();
+
+  BOOST_CHECK(count == 1000);
+
+#if defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+  // The counts recorded by each thread are combined in the snapshot.
+  io_service_statistics stats = ios.statistics();
+  const io_service_statistics::operation* post_op =
+    find_operation(stats, "io_service", "post");
+  BOOST_CHECK(post_op != 0);
+  if (post_op)
+    BOOST_CHECK(post_op->count() == 1000);
+
+  // The strand's internal operations have no name and are not recorded.
+  for (std::size_t i = 0; i < stats.operations().size(); ++i)
+    BOOST_CHECK(stats.operations()[i].name()[0] != 0);
+#endif // defined(BOOST_ASIO_HAS_HANDLER_STATISTICS)
+}
+
+test_suite* init_unit_test_suite(int, char*[])
+{
+  test_suite* test = BOOST_TEST_SUITE("io_service_statistics");
+  test->add(BOOST_TEST_CASE(&io_service_statistics_histogram_test));
+  test->add(BOOST_TEST_CASE(&io_service_statistics_recording_test));
+  test->add(BOOST_TEST_CASE(&io_service_statistics_thread_test));
+  return test;
+}
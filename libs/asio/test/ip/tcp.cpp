@@ -21,7 +21,11 @@
 
 #include <boost/array.hpp>
 #include <boost/bind.hpp>
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
 #include <cstring>
+#include <vector>
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/placeholders.hpp>
 #include <boost/asio/read.hpp>
@@ -343,6 +347,10 @@ void test()
     socket1.async_receive(mutable_buffers, in_flags, &receive_handler);
     socket1.async_receive(null_buffers(), in_flags, &receive_handler);
 
+#if defined(BOOST_ASIO_HAS_SEND_FILE)
+    socket1.async_send_file(0, 0, 0, &send_handler);
+#endif // defined(BOOST_ASIO_HAS_SEND_FILE)
+
     socket1.write_some(buffer(mutable_char_buffer));
     socket1.write_some(buffer(const_char_buffer));
     socket1.write_some(mutable_buffers);
@@ -437,14 +445,12 @@ void handle_read_eof(const boost::system::error_code& err,
   BOOST_CHECK(bytes_transferred == 0);
 }
 
-void test()
+void test_with_io_service(boost::asio::io_service& ios)
 {
   using namespace std; // For memcmp.
   using namespace boost::asio;
   namespace ip = boost::asio::ip;
 
-  io_service ios;
-
   ip::tcp::acceptor acceptor(ios, ip::tcp::endpoint(ip::tcp::v4(), 0));
   ip::tcp::endpoint server_endpoint = acceptor.local_endpoint();
   server_endpoint.address(ip::address_v4::loopback());
@@ -544,10 +550,185 @@ void test()
   BOOST_CHECK(read_eof_completed);
 }
 
+void test()
+{
+  boost::asio::io_service ios;
+  test_with_io_service(ios);
+}
+
+void test_multi_reactor()
+{
+  boost::asio::io_service ios(BOOST_ASIO_CONCURRENCY_HINT_MULTI_REACTOR(2));
+  test_with_io_service(ios);
+}
+
+void test_hashed_multi_reactor_work_stealing()
+{
+  boost::asio::io_service ios(
+      BOOST_ASIO_CONCURRENCY_HINT_HASHED_MULTI_REACTOR(3)
+      | BOOST_ASIO_CONCURRENCY_HINT_WORK_STEALING_QUEUES(2));
+  test_with_io_service(ios);
+}
+
 } // namespace ip_tcp_socket_runtime
 
 //------------------------------------------------------------------------------
 
+// ip_tcp_socket_send_file_runtime test
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks the runtime operation of the async_send_file
+// function of the ip::tcp::socket class.
+
+namespace ip_tcp_socket_send_file_runtime {
+
+#if defined(BOOST_ASIO_HAS_SEND_FILE)
+
+void handle_transfer(const boost::system::error_code& err,
+    size_t bytes_transferred, boost::system::error_code* out_err,
+    size_t* out_bytes_transferred)
+{
+  *out_err = err;
+  *out_bytes_transferred = bytes_transferred;
+}
+
+void test()
+{
+  using namespace std; // For tmpfile, fwrite, fflush, fclose and signal.
+  using namespace boost::asio;
+  namespace ip = boost::asio::ip;
+
+  // A file large enough that it must be sent in several pieces.
+  std::vector<char> file_data(1024 * 1024 + 123);
+  for (std::size_t i = 0; i < file_data.size(); ++i)
+    file_data[i] = static_cast<char>(i * 7 + i / 4096);
+  FILE* file = tmpfile();
+  BOOST_CHECK(file != 0);
+  if (!file)
+    return;
+  BOOST_CHECK(fwrite(&file_data[0], 1, file_data.size(), file)
+      == file_data.size());
+  fflush(file);
+  int fd = fileno(file);
+
+  io_service ios;
+
+  ip::tcp::acceptor acceptor(ios, ip::tcp::endpoint(ip::tcp::v4(), 0));
+  ip::tcp::endpoint server_endpoint = acceptor.local_endpoint();
+  server_endpoint.address(ip::address_v4::loopback());
+
+  ip::tcp::socket client_side_socket(ios);
+  ip::tcp::socket server_side_socket(ios);
+
+  client_side_socket.connect(server_endpoint);
+  acceptor.accept(server_side_socket);
+
+  // Keep the send buffer small so that the transfer must wait for the socket
+  // to become writable.
+  server_side_socket.set_option(socket_base::send_buffer_size(8192));
+
+  // Send a range from the middle of the file.
+
+  const std::size_t offset = 1000;
+  const std::size_t size = file_data.size() - 2000;
+  std::vector<char> read_data(size);
+
+  boost::system::error_code send_err, read_err;
+  size_t bytes_sent = 0, bytes_read = 0;
+  server_side_socket.async_send_file(fd, offset, size,
+      boost::bind(handle_transfer, boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred, &send_err, &bytes_sent));
+  boost::asio::async_read(client_side_socket, buffer(read_data),
+      boost::bind(handle_transfer, boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred, &read_err, &bytes_read));
+
+  ios.run();
+
+  BOOST_CHECK(!send_err);
+  BOOST_CHECK(bytes_sent == size);
+  BOOST_CHECK(!read_err);
+  BOOST_CHECK(bytes_read == size);
+  BOOST_CHECK(std::equal(read_data.begin(), read_data.end(),
+        file_data.begin() + offset));
+
+  // A range extending beyond the end of the file sends the remainder of the
+  // file and fails with eof.
+
+  server_side_socket.async_send_file(fd, file_data.size() - 100, 1000,
+      boost::bind(handle_transfer, boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred, &send_err, &bytes_sent));
+  boost::asio::async_read(client_side_socket, buffer(read_data, 100),
+      boost::bind(handle_transfer, boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred, &read_err, &bytes_read));
+
+  ios.reset();
+  ios.run();
+
+  BOOST_CHECK(send_err == boost::asio::error::eof);
+  BOOST_CHECK(bytes_sent == 100);
+  BOOST_CHECK(!read_err);
+  BOOST_CHECK(bytes_read == 100);
+  BOOST_CHECK(std::equal(read_data.begin(), read_data.begin() + 100,
+        file_data.end() - 100));
+
+  // An empty range completes immediately.
+
+  bytes_sent = 1;
+  server_side_socket.async_send_file(fd, 0, 0,
+      boost::bind(handle_transfer, boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred, &send_err, &bytes_sent));
+
+  ios.reset();
+  ios.run();
+
+  BOOST_CHECK(!send_err);
+  BOOST_CHECK(bytes_sent == 0);
+
+  // An offset that cannot be represented as an off_t is rejected.
+
+  bytes_sent = 1;
+  server_side_socket.async_send_file(fd, ~boost::uint64_t(0), 100,
+      boost::bind(handle_transfer, boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred, &send_err, &bytes_sent));
+
+  ios.reset();
+  ios.run();
+
+  BOOST_CHECK(send_err == boost::asio::error::invalid_argument);
+  BOOST_CHECK(bytes_sent == 0);
+
+  // Sending after the connection has been shut down fails without raising
+  // SIGPIPE, which would otherwise terminate the test.
+
+  void (*old_handler)(int) = signal(SIGPIPE, SIG_DFL);
+
+  server_side_socket.shutdown(ip::tcp::socket::shutdown_send);
+  server_side_socket.async_send_file(fd, 0, size,
+      boost::bind(handle_transfer, boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred, &send_err, &bytes_sent));
+
+  ios.reset();
+  ios.run();
+
+  signal(SIGPIPE, old_handler);
+
+  BOOST_CHECK(send_err == boost::asio::error::broken_pipe);
+  BOOST_CHECK(bytes_sent == 0);
+
+  fclose(file);
+}
+
+#else // defined(BOOST_ASIO_HAS_SEND_FILE)
+
+void test()
+{
+}
+
+#endif // defined(BOOST_ASIO_HAS_SEND_FILE)
+
+} // namespace ip_tcp_socket_send_file_runtime
+
+//------------------------------------------------------------------------------
+
 // ip_tcp_acceptor_compile test
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // The following test checks that all public member functions on the class
@@ -833,6 +1014,10 @@ test_suite* init_unit_test_suite(int, char*[])
   test->add(BOOST_TEST_CASE(&ip_tcp_runtime::test));
   test->add(BOOST_TEST_CASE(&ip_tcp_socket_compile::test));
   test->add(BOOST_TEST_CASE(&ip_tcp_socket_runtime::test));
+  test->add(BOOST_TEST_CASE(&ip_tcp_socket_runtime::test_multi_reactor));
+  test->add(BOOST_TEST_CASE(
+        &ip_tcp_socket_runtime::test_hashed_multi_reactor_work_stealing));
+  test->add(BOOST_TEST_CASE(&ip_tcp_socket_send_file_runtime::test));
   test->add(BOOST_TEST_CASE(&ip_tcp_acceptor_compile::test));
   test->add(BOOST_TEST_CASE(&ip_tcp_acceptor_runtime::test));
   test->add(BOOST_TEST_CASE(&ip_tcp_resolver_compile::test));
@@ -18,6 +18,8 @@
 
 #include <boost/bind.hpp>
 #include <cstring>
+#include <string>
+#include <vector>
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/placeholders.hpp>
 #include "../unit_test.hpp"
@@ -299,6 +301,23 @@ void test()
         endpoint, in_flags, &receive_handler);
     socket1.async_receive_from(null_buffers(),
         endpoint, in_flags, &receive_handler);
+
+    std::size_t lengths[1] = { 0 };
+    socket1.async_receive_batch(buffer(mutable_char_buffer),
+        &endpoint, lengths, &receive_handler);
+    socket1.async_receive_batch(buffer(mutable_char_buffer),
+        &endpoint, lengths, in_flags, &receive_handler);
+    socket1.async_receive_batch(buffer(mutable_char_buffer),
+        0, lengths, &receive_handler);
+
+    socket1.async_send_batch(buffer(mutable_char_buffer),
+        &endpoint, &send_handler);
+    socket1.async_send_batch(buffer(const_char_buffer),
+        &endpoint, &send_handler);
+    socket1.async_send_batch(buffer(const_char_buffer),
+        &endpoint, in_flags, &send_handler);
+    socket1.async_send_batch(buffer(const_char_buffer),
+        0, &send_handler);
   }
   catch (std::exception&)
   {
@@ -376,6 +395,147 @@ void test()
 
 //------------------------------------------------------------------------------
 
+// ip_udp_socket_batch_runtime test
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks the runtime operation of the batch send and
+// receive operations of the ip::udp::socket class.
+
+namespace ip_udp_socket_batch_runtime {
+
+// More than socket_base::max_batch_size, so that a send needs more than one
+// system call.
+const std::size_t num_datagrams = 100;
+
+void handle_send_batch(size_t expected_datagrams_sent,
+    const boost::system::error_code& err, size_t datagrams_sent)
+{
+  BOOST_CHECK(!err);
+  BOOST_CHECK(expected_datagrams_sent == datagrams_sent);
+}
+
+struct batch_receiver
+{
+  boost::asio::ip::udp::socket* socket_;
+  std::vector<boost::asio::mutable_buffer> buffers_;
+  boost::asio::ip::udp::endpoint* sender_endpoints_;
+  std::size_t* lengths_;
+  std::vector<std::string>* received_;
+  std::vector<boost::asio::ip::udp::endpoint>* senders_;
+
+  void start()
+  {
+    socket_->async_receive_batch(buffers_, sender_endpoints_, lengths_,
+        boost::bind(&batch_receiver::handle_recv, this,
+          boost::asio::placeholders::error,
+          boost::asio::placeholders::bytes_transferred));
+  }
+
+  void handle_recv(const boost::system::error_code& err,
+      size_t datagrams_recvd)
+  {
+    BOOST_CHECK(!err);
+    BOOST_CHECK(datagrams_recvd > 0);
+    BOOST_CHECK(datagrams_recvd <= buffers_.size());
+    if (err)
+      return;
+
+    for (std::size_t i = 0; i < datagrams_recvd; ++i)
+    {
+      received_->push_back(std::string(
+            boost::asio::buffer_cast<const char*>(buffers_[i]), lengths_[i]));
+      if (sender_endpoints_)
+        senders_->push_back(sender_endpoints_[i]);
+    }
+
+    if (received_->size() < num_datagrams)
+      start();
+  }
+};
+
+std::string make_datagram(std::size_t n)
+{
+  return std::string(n % 26 + 1, static_cast<char>('A' + n % 26));
+}
+
+void test()
+{
+  using namespace boost::asio;
+  namespace ip = boost::asio::ip;
+
+  io_service ios;
+
+  ip::udp::socket s1(ios, ip::udp::endpoint(ip::address_v4::loopback(), 0));
+  ip::udp::socket s2(ios, ip::udp::endpoint(ip::address_v4::loopback(), 0));
+
+  std::vector<std::string> datagrams;
+  std::vector<const_buffer> send_buffers;
+  std::vector<ip::udp::endpoint> destinations;
+  for (std::size_t i = 0; i < num_datagrams; ++i)
+  {
+    datagrams.push_back(make_datagram(i));
+    destinations.push_back(s1.local_endpoint());
+  }
+  for (std::size_t i = 0; i < num_datagrams; ++i)
+    send_buffers.push_back(buffer(datagrams[i]));
+
+  // Receive with fewer buffers than datagrams, so that more than one receive
+  // operation is needed.
+  char recv_data[8][64];
+  ip::udp::endpoint sender_endpoints[8];
+  std::size_t lengths[8];
+  std::vector<std::string> received;
+  std::vector<ip::udp::endpoint> senders;
+  batch_receiver receiver = { &s1, std::vector<mutable_buffer>(),
+    sender_endpoints, lengths, &received, &senders };
+  for (std::size_t i = 0; i < 8; ++i)
+    receiver.buffers_.push_back(buffer(recv_data[i]));
+  receiver.start();
+
+  s2.async_send_batch(send_buffers, &destinations[0],
+      boost::bind(handle_send_batch, num_datagrams,
+        boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred));
+
+  ios.run();
+
+  BOOST_CHECK(received.size() == num_datagrams);
+  BOOST_CHECK(received == datagrams);
+  BOOST_CHECK(senders.size() == num_datagrams);
+  for (std::size_t i = 0; i < senders.size(); ++i)
+    BOOST_CHECK(senders[i] == s2.local_endpoint());
+
+  // Send on a connected socket and receive without the sender endpoints.
+  s2.connect(s1.local_endpoint());
+  received.clear();
+  senders.clear();
+  receiver.sender_endpoints_ = 0;
+  receiver.start();
+
+  s2.async_send_batch(send_buffers, 0,
+      boost::bind(handle_send_batch, num_datagrams,
+        boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred));
+
+  ios.reset();
+  ios.run();
+
+  BOOST_CHECK(received == datagrams);
+  BOOST_CHECK(senders.empty());
+
+  // An empty batch completes immediately.
+  s2.async_send_batch(std::vector<const_buffer>(), 0,
+      boost::bind(handle_send_batch, 0,
+        boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred));
+
+  ios.reset();
+  ios.run();
+}
+
+} // namespace ip_udp_socket_batch_runtime
+
+//------------------------------------------------------------------------------
+
 // ip_udp_resolver_compile test
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // The following test checks that all public member functions on the class
@@ -443,6 +603,9 @@ test_suite* init_unit_test_suite(int, char*[])
   test_suite* test = BOOST_TEST_SUITE("ip/udp");
   test->add(BOOST_TEST_CASE(&ip_udp_socket_compile::test));
   test->add(BOOST_TEST_CASE(&ip_udp_socket_runtime::test));
+#if !defined(BOOST_ASIO_HAS_IOCP)
+  test->add(BOOST_TEST_CASE(&ip_udp_socket_batch_runtime::test));
+#endif // !defined(BOOST_ASIO_HAS_IOCP)
   test->add(BOOST_TEST_CASE(&ip_udp_resolver_compile::test));
   return test;
 }
@@ -0,0 +1,256 @@
+//
+// file_random_read.cpp
+// ~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/posix/random_access_descriptor.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if !defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+# error random_access_descriptor is not supported on this platform.
+#endif // !defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+
+const std::size_t block_size = 4096;
+
+// A simple generator for the block offsets, so that every run of the test
+// reads the same sequence of blocks.
+class block_picker
+{
+public:
+  explicit block_picker(std::size_t blocks)
+    : blocks_(blocks),
+      state_(12345)
+  {
+  }
+
+  boost::uint64_t next()
+  {
+    state_ = state_ * 6364136223846793005ULL + 1442695040888963407ULL;
+    return ((state_ >> 33) % blocks_) * block_size;
+  }
+
+private:
+  std::size_t blocks_;
+  boost::uint64_t state_;
+};
+
+// Keeps a fixed number of 4KB reads outstanding against a file descriptor
+// until the requested number of reads have completed.
+class test_reader
+{
+public:
+  test_reader(boost::asio::io_service& io_service, int file,
+      std::size_t blocks, std::size_t depth, std::size_t reads)
+    : descriptor_(io_service, file),
+      picker_(blocks),
+      depth_(depth),
+      reads_remaining_(reads),
+      buffers_(depth)
+  {
+    for (std::size_t i = 0; i < depth_; ++i)
+    {
+      // O_DIRECT requires the buffers to be aligned.
+      if (::posix_memalign(&buffers_[i], block_size, block_size) != 0)
+      {
+        std::fprintf(stderr, "posix_memalign failed\n");
+        std::exit(1);
+      }
+    }
+  }
+
+  ~test_reader()
+  {
+    descriptor_.release();
+    for (std::size_t i = 0; i < depth_; ++i)
+      std::free(buffers_[i]);
+  }
+
+  void start()
+  {
+    for (std::size_t i = 0; i < depth_ && reads_remaining_ > 0; ++i)
+    {
+      --reads_remaining_;
+      start_read(i);
+    }
+  }
+
+private:
+  struct read_handler
+  {
+    test_reader* this_;
+    std::size_t slot_;
+
+    void operator()(const boost::system::error_code& ec, std::size_t n)
+    {
+      this_->handle_read(slot_, ec, n);
+    }
+  };
+
+  void start_read(std::size_t slot)
+  {
+    read_handler h = { this, slot };
+    descriptor_.async_read_some_at(picker_.next(),
+        boost::asio::buffer(buffers_[slot], block_size), h);
+  }
+
+  void handle_read(std::size_t slot,
+      const boost::system::error_code& ec, std::size_t n)
+  {
+    if (ec || n != block_size)
+    {
+      std::fprintf(stderr, "read failed: %s\n", ec.message().c_str());
+      std::exit(1);
+    }
+
+    if (reads_remaining_ > 0)
+    {
+      --reads_remaining_;
+      start_read(slot);
+    }
+  }
+
+  boost::asio::posix::random_access_descriptor descriptor_;
+  block_picker picker_;
+  std::size_t depth_;
+  std::size_t reads_remaining_;
+  std::vector<void*> buffers_;
+};
+
+void report(const char* name, std::size_t depth,
+    std::size_t reads, boost::posix_time::time_duration duration)
+{
+  double elapsed = duration.total_microseconds() / 1000000.0;
+  std::printf("%-10s %6d outstanding %10.0f reads/sec %10.1f MB/sec\n",
+      name, static_cast<int>(depth), reads / elapsed,
+      reads * block_size / elapsed / 1e6);
+}
+
+void run_sync_test(int file, std::size_t blocks, std::size_t reads)
+{
+  block_picker picker(blocks);
+  std::vector<char> data(block_size);
+
+  boost::posix_time::ptime start =
+    boost::posix_time::microsec_clock::universal_time();
+
+  for (std::size_t i = 0; i < reads; ++i)
+  {
+    ssize_t bytes = ::pread(file, &data[0], block_size,
+        static_cast<off_t>(picker.next()));
+    if (bytes != static_cast<ssize_t>(block_size))
+    {
+      std::fprintf(stderr, "pread failed\n");
+      std::exit(1);
+    }
+  }
+
+  boost::posix_time::ptime stop =
+    boost::posix_time::microsec_clock::universal_time();
+
+  report("pread", 1, reads, stop - start);
+}
+
+void run_async_test(const char* name, int file,
+    std::size_t blocks, std::size_t depth, std::size_t reads)
+{
+  boost::asio::io_service io_service;
+  test_reader reader(io_service, file, blocks, depth, reads);
+
+  boost::posix_time::ptime start =
+    boost::posix_time::microsec_clock::universal_time();
+
+  reader.start();
+  io_service.run();
+
+  boost::posix_time::ptime stop =
+    boost::posix_time::microsec_clock::universal_time();
+
+  report(name, depth, reads, stop - start);
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc != 3 && argc != 4)
+  {
+    std::fprintf(stderr,
+        "Usage: file_random_read <file-size-mb> <max-outstanding> [<reads>]\n"
+        "Performs <reads> (default 100000) random 4KB reads of a test file,\n"
+        "first using synchronous pread calls and then asynchronously with 1,\n"
+        "4, 16, ... up to <max-outstanding> reads in flight. The asynchronous\n"
+        "reads use a buffered descriptor (performed on the service's internal\n"
+        "threads) and an O_DIRECT descriptor (submitted using native AIO\n"
+        "where available).\n"
+        "The test file is created in the current directory.\n");
+    return 1;
+  }
+
+  std::size_t file_size = std::atoi(argv[1]) * std::size_t(1024 * 1024);
+  std::size_t max_depth = std::atoi(argv[2]);
+  std::size_t reads = 100000;
+  if (argc == 4 && std::atoi(argv[3]) > 0)
+    reads = std::atoi(argv[3]);
+
+  std::size_t blocks = file_size / block_size;
+  if (blocks == 0 || max_depth == 0)
+  {
+    std::fprintf(stderr, "invalid arguments\n");
+    return 1;
+  }
+
+  char name[] = "file_random_read.XXXXXX";
+  int file = ::mkstemp(name);
+  if (file == -1)
+  {
+    std::perror("mkstemp");
+    return 1;
+  }
+
+  std::vector<char> data(1024 * 1024, 'x');
+  for (std::size_t n = 0; n < file_size; n += data.size())
+  {
+    std::size_t length = file_size - n < data.size()
+      ? file_size - n : data.size();
+    if (::write(file, &data[0], length) != static_cast<ssize_t>(length))
+    {
+      std::perror("write");
+      ::unlink(name);
+      return 1;
+    }
+  }
+  ::fsync(file);
+
+  int direct_file = -1;
+#if defined(O_DIRECT)
+  direct_file = ::open(name, O_RDONLY | O_DIRECT);
+  if (direct_file == -1)
+    std::perror("open with O_DIRECT");
+#endif // defined(O_DIRECT)
+  ::unlink(name);
+
+  run_sync_test(file, blocks, reads);
+  for (std::size_t depth = 1; depth <= max_depth; depth *= 4)
+  {
+    run_async_test("buffered", file, blocks, depth, reads);
+    if (direct_file != -1)
+      run_async_test("direct", direct_file, blocks, depth, reads);
+  }
+
+  if (direct_file != -1)
+    ::close(direct_file);
+  ::close(file);
+
+  return 0;
+}
@@ -0,0 +1,142 @@
+//
+// io_service_post.cpp
+// ~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/asio/io_service.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "high_res_clock.hpp"
+
+// Each chain repeatedly posts a handler to the io_service, measuring the time
+// between the post() call and the invocation of the handler.
+struct chain
+{
+  boost::asio::io_service* io_service_;
+  std::size_t remaining_;
+  boost::uint64_t posted_at_;
+  boost::uint64_t total_latency_;
+  boost::uint64_t max_latency_;
+  char padding_[64];
+};
+
+struct chain_handler
+{
+  chain* c_;
+
+  void operator()()
+  {
+    boost::uint64_t latency = high_res_clock() - c_->posted_at_;
+    c_->total_latency_ += latency;
+    if (latency > c_->max_latency_)
+      c_->max_latency_ = latency;
+
+    if (--c_->remaining_ > 0)
+    {
+      c_->posted_at_ = high_res_clock();
+      c_->io_service_->post(*this);
+    }
+  }
+};
+
+void run_io_service(boost::asio::io_service* io_service)
+{
+  io_service->run();
+}
+
+void run_test(std::size_t num_threads, std::size_t num_chains,
+    std::size_t posts_per_chain, bool work_stealing)
+{
+  boost::asio::io_service io_service(work_stealing
+      ? BOOST_ASIO_CONCURRENCY_HINT_WORK_STEALING_QUEUES(num_threads)
+      : num_threads);
+
+  std::vector<chain> chains(num_chains);
+  for (std::size_t i = 0; i < num_chains; ++i)
+  {
+    chains[i].io_service_ = &io_service;
+    chains[i].remaining_ = posts_per_chain;
+    chains[i].total_latency_ = 0;
+    chains[i].max_latency_ = 0;
+    chains[i].posted_at_ = high_res_clock();
+    chain_handler h = { &chains[i] };
+    io_service.post(h);
+  }
+
+  boost::posix_time::ptime start =
+    boost::posix_time::microsec_clock::universal_time();
+
+  std::vector<boost::thread*> threads;
+  for (std::size_t i = 1; i < num_threads; ++i)
+    threads.push_back(new boost::thread(
+          boost::bind(run_io_service, &io_service)));
+  io_service.run();
+  for (std::size_t i = 0; i < threads.size(); ++i)
+  {
+    threads[i]->join();
+    delete threads[i];
+  }
+
+  boost::posix_time::ptime stop =
+    boost::posix_time::microsec_clock::universal_time();
+
+  boost::uint64_t total_latency = 0;
+  boost::uint64_t max_latency = 0;
+  for (std::size_t i = 0; i < num_chains; ++i)
+  {
+    total_latency += chains[i].total_latency_;
+    if (chains[i].max_latency_ > max_latency)
+      max_latency = chains[i].max_latency_;
+  }
+
+  double elapsed = (stop - start).total_microseconds() / 1000000.0;
+  double total_posts = static_cast<double>(num_chains) * posts_per_chain;
+
+  std::printf("%-14s %3d threads %10.0f posts/sec %10.0f mean %12.0f max\n",
+      work_stealing ? "work_stealing" : "default",
+      static_cast<int>(num_threads), total_posts / elapsed,
+      static_cast<double>(total_latency) / total_posts,
+      static_cast<double>(max_latency));
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc != 4 && argc != 5)
+  {
+    std::fprintf(stderr,
+        "Usage: io_service_post <chains-per-thread> <posts-per-chain> "
+        "{default|work_stealing|both} [<threads>]\n"
+        "Latencies are reported in high_res_clock units. If <threads> is not "
+        "specified, the test is run with 1, 2, 4, ..., 64 threads.\n");
+    return 1;
+  }
+
+  std::size_t chains_per_thread = std::atoi(argv[1]);
+  std::size_t posts_per_chain = std::atoi(argv[2]);
+  bool run_default = (std::strcmp(argv[3], "work_stealing") != 0);
+  bool run_work_stealing = (std::strcmp(argv[3], "default") != 0);
+
+  std::size_t min_threads = 1, max_threads = 64;
+  if (argc == 5 && std::atoi(argv[4]) > 0)
+    min_threads = max_threads = std::atoi(argv[4]);
+
+  for (std::size_t n = min_threads; n <= max_threads; n *= 2)
+  {
+    if (run_default)
+      run_test(n, n * chains_per_thread, posts_per_chain, false);
+    if (run_work_stealing)
+      run_test(n, n * chains_per_thread, posts_per_chain, true);
+  }
+
+  return 0;
+}
@@ -0,0 +1,232 @@
+//
+// send_file_throughput.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+
+#if !defined(BOOST_ASIO_HAS_SEND_FILE)
+# error async_send_file is not supported on this platform.
+#endif // !defined(BOOST_ASIO_HAS_SEND_FILE)
+
+using boost::asio::ip::tcp;
+
+const std::size_t chunk_size = 65536;
+
+// Sends a file repeatedly over a loopback connection, either using
+// async_send_file or by reading each chunk of the file into memory and then
+// writing it to the socket using async_write. The receiver discards the data.
+class test_session
+{
+public:
+  test_session(boost::asio::io_service& io_service, bool send_file,
+      int file, std::size_t file_size, std::size_t iterations)
+    : send_file_(send_file),
+      sender_(io_service),
+      receiver_(io_service),
+      file_(file),
+      file_size_(file_size),
+      iterations_(iterations),
+      file_offset_(0),
+      bytes_expected_(file_size * iterations),
+      bytes_received_(0),
+      send_data_(chunk_size),
+      recv_data_(chunk_size)
+  {
+    tcp::acceptor acceptor(io_service, tcp::endpoint(tcp::v4(), 0));
+    tcp::endpoint endpoint = acceptor.local_endpoint();
+    endpoint.address(boost::asio::ip::address_v4::loopback());
+    receiver_.connect(endpoint);
+    acceptor.accept(sender_);
+  }
+
+  void start()
+  {
+    start_receive();
+    start_send();
+  }
+
+private:
+  struct send_handler
+  {
+    test_session* this_;
+
+    void operator()(const boost::system::error_code& ec, std::size_t n)
+    {
+      this_->handle_send(ec, n);
+    }
+  };
+
+  struct recv_handler
+  {
+    test_session* this_;
+
+    void operator()(const boost::system::error_code& ec, std::size_t n)
+    {
+      this_->handle_receive(ec, n);
+    }
+  };
+
+  void start_send()
+  {
+    send_handler h = { this };
+    if (send_file_)
+    {
+      sender_.async_send_file(file_, 0, file_size_, h);
+    }
+    else
+    {
+      std::size_t length = file_size_ - file_offset_;
+      if (length > chunk_size)
+        length = chunk_size;
+      ssize_t bytes = ::pread(file_, &send_data_[0],
+          length, static_cast<off_t>(file_offset_));
+      if (bytes <= 0)
+      {
+        std::fprintf(stderr, "read failed\n");
+        std::exit(1);
+      }
+      boost::asio::async_write(sender_,
+          boost::asio::buffer(&send_data_[0], bytes), h);
+    }
+  }
+
+  void handle_send(const boost::system::error_code& ec, std::size_t n)
+  {
+    if (ec)
+    {
+      std::fprintf(stderr, "send failed: %s\n", ec.message().c_str());
+      std::exit(1);
+    }
+
+    file_offset_ += n;
+    if (file_offset_ == file_size_)
+    {
+      file_offset_ = 0;
+      if (--iterations_ == 0)
+        return;
+    }
+
+    start_send();
+  }
+
+  void start_receive()
+  {
+    recv_handler h = { this };
+    receiver_.async_read_some(boost::asio::buffer(recv_data_), h);
+  }
+
+  void handle_receive(const boost::system::error_code& ec, std::size_t n)
+  {
+    if (ec)
+    {
+      std::fprintf(stderr, "receive failed: %s\n", ec.message().c_str());
+      std::exit(1);
+    }
+
+    bytes_received_ += n;
+    if (bytes_received_ < bytes_expected_)
+      start_receive();
+  }
+
+  bool send_file_;
+  tcp::socket sender_;
+  tcp::socket receiver_;
+  int file_;
+  std::size_t file_size_;
+  std::size_t iterations_;
+  std::size_t file_offset_;
+  std::size_t bytes_expected_;
+  std::size_t bytes_received_;
+  std::vector<char> send_data_;
+  std::vector<char> recv_data_;
+};
+
+void run_test(bool send_file, int file,
+    std::size_t file_size, std::size_t iterations)
+{
+  boost::asio::io_service io_service;
+  test_session session(io_service, send_file, file, file_size, iterations);
+
+  boost::posix_time::ptime start =
+    boost::posix_time::microsec_clock::universal_time();
+
+  session.start();
+  io_service.run();
+
+  boost::posix_time::ptime stop =
+    boost::posix_time::microsec_clock::universal_time();
+
+  double elapsed = (stop - start).total_microseconds() / 1000000.0;
+  std::printf("%-10s %10.0f KB file %8d files %10.1f MB/sec %10.0f files/sec\n",
+      send_file ? "send_file" : "read+write", file_size / 1024.0,
+      static_cast<int>(iterations), file_size * iterations / elapsed / 1e6,
+      iterations / elapsed);
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc != 2 && argc != 3)
+  {
+    std::fprintf(stderr,
+        "Usage: send_file_throughput <max-file-size-kb> [<total-mb>]\n"
+        "Files of 1KB, 16KB, 256KB, ... up to the maximum size are each sent\n"
+        "until about <total-mb> megabytes (default 1024) have been transferred."
+        "\nThe test files are created in the current directory.\n");
+    return 1;
+  }
+
+  std::size_t max_file_size = std::atoi(argv[1]) * std::size_t(1024);
+  std::size_t total = 1024 * std::size_t(1024 * 1024);
+  if (argc == 3 && std::atoi(argv[2]) > 0)
+    total = std::atoi(argv[2]) * std::size_t(1024 * 1024);
+
+  for (std::size_t size = 1024; size <= max_file_size; size *= 16)
+  {
+    char name[] = "send_file_throughput.XXXXXX";
+    int file = ::mkstemp(name);
+    if (file == -1)
+    {
+      std::perror("mkstemp");
+      return 1;
+    }
+    ::unlink(name);
+
+    std::vector<char> data(chunk_size, 'x');
+    for (std::size_t n = 0; n < size; n += chunk_size)
+    {
+      std::size_t length = size - n < chunk_size ? size - n : chunk_size;
+      if (::write(file, &data[0], length) != static_cast<ssize_t>(length))
+      {
+        std::perror("write");
+        return 1;
+      }
+    }
+
+    std::size_t iterations = total / size;
+    if (iterations == 0)
+      iterations = 1;
+    if (iterations > 100000)
+      iterations = 100000;
+
+    run_test(false, file, size, iterations);
+    run_test(true, file, size, iterations);
+
+    ::close(file);
+  }
+
+  return 0;
+}
@@ -0,0 +1,113 @@
+//
+// strand_throughput.cpp
+// ~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/thread.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Each chain repeatedly posts a handler through its strand. Several chains
+// share each strand, so that posts contend with the strand's lock holder.
+struct chain_handler
+{
+  boost::asio::io_service::strand* strand_;
+  std::size_t* counter_;
+  std::size_t remaining_;
+
+  void operator()()
+  {
+    ++(*counter_);
+    if (--remaining_ > 0)
+      strand_->post(*this);
+  }
+};
+
+void run_io_service(boost::asio::io_service* io_service)
+{
+  io_service->run();
+}
+
+void run_test(std::size_t num_threads, std::size_t num_strands,
+    std::size_t chains_per_strand, std::size_t posts_per_chain)
+{
+  boost::asio::io_service io_service(num_threads);
+
+  // Each counter is only modified from within its strand.
+  std::vector<boost::asio::io_service::strand*> strands;
+  std::vector<std::size_t> counters(num_strands * 16);
+  for (std::size_t i = 0; i < num_strands; ++i)
+  {
+    strands.push_back(new boost::asio::io_service::strand(io_service));
+    for (std::size_t j = 0; j < chains_per_strand; ++j)
+    {
+      chain_handler h = { strands[i], &counters[i * 16], posts_per_chain };
+      strands[i]->post(h);
+    }
+  }
+
+  boost::posix_time::ptime start =
+    boost::posix_time::microsec_clock::universal_time();
+
+  std::vector<boost::thread*> threads;
+  for (std::size_t i = 1; i < num_threads; ++i)
+    threads.push_back(new boost::thread(
+          boost::bind(run_io_service, &io_service)));
+  io_service.run();
+  for (std::size_t i = 0; i < threads.size(); ++i)
+  {
+    threads[i]->join();
+    delete threads[i];
+  }
+
+  boost::posix_time::ptime stop =
+    boost::posix_time::microsec_clock::universal_time();
+
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < num_strands; ++i)
+  {
+    total += counters[i * 16];
+    delete strands[i];
+  }
+
+  double elapsed = (stop - start).total_microseconds() / 1000000.0;
+  std::printf("%3d threads %6d strands %12.0f handlers/sec\n",
+      static_cast<int>(num_threads), static_cast<int>(num_strands),
+      total / elapsed);
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc != 4 && argc != 5)
+  {
+    std::fprintf(stderr,
+        "Usage: strand_throughput <strands> <chains-per-strand> "
+        "<posts-per-chain> [<threads>]\n"
+        "If <threads> is not specified, the test is run with 1, 2, 4, ..., 64 "
+        "threads. Use 10000 strands to measure many independent strands.\n");
+    return 1;
+  }
+
+  std::size_t num_strands = std::atoi(argv[1]);
+  std::size_t chains_per_strand = std::atoi(argv[2]);
+  std::size_t posts_per_chain = std::atoi(argv[3]);
+
+  std::size_t min_threads = 1, max_threads = 64;
+  if (argc == 5 && std::atoi(argv[4]) > 0)
+    min_threads = max_threads = std::atoi(argv[4]);
+
+  for (std::size_t n = min_threads; n <= max_threads; n *= 2)
+    run_test(n, num_strands, chains_per_strand, posts_per_chain);
+
+  return 0;
+}
@@ -0,0 +1,232 @@
+//
+// tcp_echo_allocations.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using boost::asio::ip::tcp;
+
+// Counts the calls made to the global operator new, so that the number of
+// allocations performed per message can be reported.
+static std::size_t allocation_count = 0;
+
+void* operator new(std::size_t size) throw (std::bad_alloc)
+{
+  ++allocation_count;
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) throw ()
+{
+  std::free(p);
+}
+
+// A client sends a message to a server session, which echoes it back. The
+// client sends the next message as soon as the echo has been read. Neither
+// side's handlers customise memory allocation.
+class echo_pair
+{
+public:
+  echo_pair(boost::asio::io_service& io_service,
+      tcp::acceptor& acceptor, std::size_t message_size,
+      std::size_t messages)
+    : client_(io_service),
+      server_(io_service),
+      client_data_(message_size, 'x'),
+      server_data_(message_size),
+      remaining_(messages),
+      completed_(0)
+  {
+    tcp::endpoint endpoint = acceptor.local_endpoint();
+    endpoint.address(boost::asio::ip::address_v4::loopback());
+    client_.connect(endpoint);
+    acceptor.accept(server_);
+    client_.set_option(tcp::no_delay(true));
+    server_.set_option(tcp::no_delay(true));
+  }
+
+  void start()
+  {
+    start_server_read();
+    start_client_write();
+  }
+
+  std::size_t completed() const
+  {
+    return completed_;
+  }
+
+private:
+  struct client_write_handler
+  {
+    echo_pair* this_;
+
+    void operator()(const boost::system::error_code& ec, std::size_t)
+    {
+      this_->check(ec);
+      this_->start_client_read();
+    }
+  };
+
+  struct client_read_handler
+  {
+    echo_pair* this_;
+
+    void operator()(const boost::system::error_code& ec, std::size_t)
+    {
+      this_->check(ec);
+      ++this_->completed_;
+      if (--this_->remaining_ > 0)
+        this_->start_client_write();
+      else
+        this_->client_.shutdown(tcp::socket::shutdown_send);
+    }
+  };
+
+  struct server_read_handler
+  {
+    echo_pair* this_;
+
+    void operator()(const boost::system::error_code& ec, std::size_t n)
+    {
+      if (ec == boost::asio::error::eof)
+        return;
+      this_->check(ec);
+      this_->start_server_write(n);
+    }
+  };
+
+  struct server_write_handler
+  {
+    echo_pair* this_;
+
+    void operator()(const boost::system::error_code& ec, std::size_t)
+    {
+      this_->check(ec);
+      this_->start_server_read();
+    }
+  };
+
+  void check(const boost::system::error_code& ec)
+  {
+    if (ec)
+    {
+      std::fprintf(stderr, "echo failed: %s\n", ec.message().c_str());
+      std::exit(1);
+    }
+  }
+
+  void start_client_write()
+  {
+    client_write_handler h = { this };
+    boost::asio::async_write(client_, boost::asio::buffer(client_data_), h);
+  }
+
+  void start_client_read()
+  {
+    client_read_handler h = { this };
+    boost::asio::async_read(client_, boost::asio::buffer(client_data_), h);
+  }
+
+  void start_server_read()
+  {
+    server_read_handler h = { this };
+    server_.async_read_some(boost::asio::buffer(server_data_), h);
+  }
+
+  void start_server_write(std::size_t n)
+  {
+    server_write_handler h = { this };
+    boost::asio::async_write(server_,
+        boost::asio::buffer(server_data_, n), h);
+  }
+
+  tcp::socket client_;
+  tcp::socket server_;
+  std::vector<char> client_data_;
+  std::vector<char> server_data_;
+  std::size_t remaining_;
+  std::size_t completed_;
+};
+
+void run_test(bool recycling, std::size_t connections,
+    std::size_t message_size, std::size_t messages)
+{
+  boost::asio::io_service io_service(recycling
+      ? BOOST_ASIO_CONCURRENCY_HINT_RECYCLING_ALLOCATOR : 1);
+  tcp::acceptor acceptor(io_service, tcp::endpoint(tcp::v4(), 0));
+
+  std::vector<echo_pair*> pairs;
+  for (std::size_t i = 0; i < connections; ++i)
+    pairs.push_back(new echo_pair(io_service,
+          acceptor, message_size, messages));
+
+  boost::posix_time::ptime start =
+    boost::posix_time::microsec_clock::universal_time();
+  std::size_t start_allocations = allocation_count;
+
+  for (std::size_t i = 0; i < connections; ++i)
+    pairs[i]->start();
+  io_service.run();
+
+  std::size_t allocations = allocation_count - start_allocations;
+  boost::posix_time::ptime stop =
+    boost::posix_time::microsec_clock::universal_time();
+
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < connections; ++i)
+  {
+    total += pairs[i]->completed();
+    delete pairs[i];
+  }
+
+  double elapsed = (stop - start).total_microseconds() / 1000000.0;
+  std::printf("%-9s %4d connections %6d bytes %12.0f messages/sec"
+      " %8.3f allocations/message\n", recycling ? "recycling" : "default",
+      static_cast<int>(connections), static_cast<int>(message_size),
+      total / elapsed, static_cast<double>(allocations) / (total ? total : 1));
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc != 4)
+  {
+    std::fprintf(stderr,
+        "Usage: tcp_echo_allocations <connections> <message-size> "
+        "<messages-per-connection>\n"
+        "Each test is run with the default handler allocator and with the "
+        "recycling allocator.\n");
+    return 1;
+  }
+
+  std::size_t connections = std::atoi(argv[1]);
+  std::size_t message_size = std::atoi(argv[2]);
+  std::size_t messages = std::atoi(argv[3]);
+
+  if (connections == 0 || message_size == 0 || messages == 0)
+  {
+    std::fprintf(stderr, "Invalid arguments.\n");
+    return 1;
+  }
+
+  run_test(false, connections, message_size, messages);
+  run_test(true, connections, message_size, messages);
+
+  return 0;
+}
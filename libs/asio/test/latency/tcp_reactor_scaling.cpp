@@ -0,0 +1,340 @@
+//
+// tcp_reactor_scaling.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/placeholders.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/detail/atomic_count.hpp>
+#include <boost/thread/thread.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using boost::asio::ip::tcp;
+
+enum { message_size = 64 };
+
+// Counts the clients that have finished, stopping the io_service once all of
+// them are done.
+class completion_counter
+{
+public:
+  completion_counter(boost::asio::io_service& io_service, long total)
+    : io_service_(io_service), total_(total), count_(0)
+  {
+  }
+
+  void done()
+  {
+    if (++count_ == total_)
+      io_service_.stop();
+  }
+
+private:
+  boost::asio::io_service& io_service_;
+  long total_;
+  boost::detail::atomic_count count_;
+};
+
+// Echoes everything it receives until the peer closes the connection.
+class server_session
+{
+public:
+  explicit server_session(boost::asio::io_service& io_service)
+    : socket_(io_service)
+  {
+  }
+
+  tcp::socket& socket()
+  {
+    return socket_;
+  }
+
+  void start()
+  {
+    socket_.async_read_some(boost::asio::buffer(data_),
+        boost::bind(&server_session::handle_read, this,
+          boost::asio::placeholders::error,
+          boost::asio::placeholders::bytes_transferred));
+  }
+
+private:
+  void handle_read(const boost::system::error_code& err, std::size_t n)
+  {
+    if (err)
+    {
+      delete this;
+      return;
+    }
+
+    boost::asio::async_write(socket_, boost::asio::buffer(data_, n),
+        boost::bind(&server_session::handle_write, this,
+          boost::asio::placeholders::error));
+  }
+
+  void handle_write(const boost::system::error_code& err)
+  {
+    if (err)
+    {
+      delete this;
+      return;
+    }
+
+    start();
+  }
+
+  tcp::socket socket_;
+  char data_[message_size];
+};
+
+class server
+{
+public:
+  server(boost::asio::io_service& io_service)
+    : io_service_(io_service),
+      acceptor_(io_service, tcp::endpoint(tcp::v4(), 0))
+  {
+    acceptor_.listen(1024);
+    start_accept();
+  }
+
+  tcp::endpoint endpoint() const
+  {
+    return tcp::endpoint(boost::asio::ip::address_v4::loopback(),
+        acceptor_.local_endpoint().port());
+  }
+
+private:
+  void start_accept()
+  {
+    server_session* s = new server_session(io_service_);
+    acceptor_.async_accept(s->socket(),
+        boost::bind(&server::handle_accept, this, s,
+          boost::asio::placeholders::error));
+  }
+
+  void handle_accept(server_session* s, const boost::system::error_code& err)
+  {
+    if (err)
+    {
+      delete s;
+      return;
+    }
+
+    s->start();
+    start_accept();
+  }
+
+  boost::asio::io_service& io_service_;
+  tcp::acceptor acceptor_;
+};
+
+// Connects once and then performs a number of request/response exchanges.
+class echo_client
+{
+public:
+  echo_client(boost::asio::io_service& io_service,
+      const tcp::endpoint& endpoint, std::size_t exchanges,
+      completion_counter& counter)
+    : socket_(io_service),
+      remaining_(exchanges),
+      counter_(counter)
+  {
+    std::memset(data_, 'x', sizeof(data_));
+    socket_.async_connect(endpoint,
+        boost::bind(&echo_client::handle_write, this,
+          boost::asio::placeholders::error));
+  }
+
+private:
+  void handle_write(const boost::system::error_code& err)
+  {
+    if (err)
+      return finish();
+
+    boost::asio::async_write(socket_, boost::asio::buffer(data_),
+        boost::bind(&echo_client::handle_read, this,
+          boost::asio::placeholders::error));
+  }
+
+  void handle_read(const boost::system::error_code& err)
+  {
+    if (err)
+      return finish();
+
+    boost::asio::async_read(socket_, boost::asio::buffer(data_),
+        boost::bind(&echo_client::handle_response, this,
+          boost::asio::placeholders::error));
+  }
+
+  void handle_response(const boost::system::error_code& err)
+  {
+    if (err || --remaining_ == 0)
+      return finish();
+
+    handle_write(err);
+  }
+
+  void finish()
+  {
+    counter_.done();
+    delete this;
+  }
+
+  tcp::socket socket_;
+  std::size_t remaining_;
+  completion_counter& counter_;
+  char data_[message_size];
+};
+
+// Repeatedly connects, performs a single exchange, and disconnects.
+class churn_client
+{
+public:
+  churn_client(boost::asio::io_service& io_service,
+      const tcp::endpoint& endpoint, std::size_t connections,
+      completion_counter& counter)
+    : socket_(io_service),
+      endpoint_(endpoint),
+      remaining_(connections),
+      counter_(counter)
+  {
+    std::memset(data_, 'x', sizeof(data_));
+    start_connect();
+  }
+
+private:
+  void start_connect()
+  {
+    socket_.async_connect(endpoint_,
+        boost::bind(&churn_client::handle_connect, this,
+          boost::asio::placeholders::error));
+  }
+
+  void handle_connect(const boost::system::error_code& err)
+  {
+    if (err)
+      return finish();
+
+    boost::asio::async_write(socket_, boost::asio::buffer(data_),
+        boost::bind(&churn_client::handle_write, this,
+          boost::asio::placeholders::error));
+  }
+
+  void handle_write(const boost::system::error_code& err)
+  {
+    if (err)
+      return finish();
+
+    boost::asio::async_read(socket_, boost::asio::buffer(data_),
+        boost::bind(&churn_client::handle_read, this,
+          boost::asio::placeholders::error));
+  }
+
+  void handle_read(const boost::system::error_code& err)
+  {
+    boost::system::error_code ignored_ec;
+    socket_.close(ignored_ec);
+
+    if (err || --remaining_ == 0)
+      return finish();
+
+    start_connect();
+  }
+
+  void finish()
+  {
+    counter_.done();
+    delete this;
+  }
+
+  tcp::socket socket_;
+  tcp::endpoint endpoint_;
+  std::size_t remaining_;
+  completion_counter& counter_;
+  char data_[message_size];
+};
+
+void run_io_service(boost::asio::io_service* io_service)
+{
+  io_service->run();
+}
+
+void run_test(std::size_t num_threads, std::size_t num_reactors,
+    std::size_t num_clients, std::size_t iterations, bool churn)
+{
+  boost::asio::io_service io_service(
+      BOOST_ASIO_CONCURRENCY_HINT_MULTI_REACTOR(num_reactors));
+  completion_counter counter(io_service, static_cast<long>(num_clients));
+  server s(io_service);
+
+  for (std::size_t i = 0; i < num_clients; ++i)
+  {
+    if (churn)
+      new churn_client(io_service, s.endpoint(), iterations, counter);
+    else
+      new echo_client(io_service, s.endpoint(), iterations, counter);
+  }
+
+  boost::posix_time::ptime start =
+    boost::posix_time::microsec_clock::universal_time();
+
+  std::vector<boost::thread*> threads;
+  for (std::size_t i = 1; i < num_threads; ++i)
+    threads.push_back(new boost::thread(
+          boost::bind(run_io_service, &io_service)));
+  io_service.run();
+  for (std::size_t i = 0; i < threads.size(); ++i)
+  {
+    threads[i]->join();
+    delete threads[i];
+  }
+
+  boost::posix_time::ptime stop =
+    boost::posix_time::microsec_clock::universal_time();
+
+  double elapsed = (stop - start).total_microseconds() / 1000000.0;
+  double total = static_cast<double>(num_clients) * iterations;
+
+  std::printf("%-5s %3d threads %3d reactors %12.0f %s/sec\n",
+      churn ? "churn" : "echo", static_cast<int>(num_threads),
+      static_cast<int>(num_reactors), total / elapsed,
+      churn ? "connections" : "exchanges");
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc != 6)
+  {
+    std::fprintf(stderr,
+        "Usage: tcp_reactor_scaling <threads> <clients> <iterations> "
+        "{echo|churn} <max-reactors>\n"
+        "The test is run with 0 (a single epoll descriptor), 1, 2, 4, ..., "
+        "<max-reactors> additional reactor instances.\n");
+    return 1;
+  }
+
+  std::size_t num_threads = std::atoi(argv[1]);
+  std::size_t num_clients = std::atoi(argv[2]);
+  std::size_t iterations = std::atoi(argv[3]);
+  bool churn = (std::strcmp(argv[4], "churn") == 0);
+  std::size_t max_reactors = std::atoi(argv[5]);
+
+  run_test(num_threads, 0, num_clients, iterations, churn);
+  for (std::size_t n = 1; n <= max_reactors; n *= 2)
+    run_test(num_threads, n, num_clients, iterations, churn);
+
+  return 0;
+}
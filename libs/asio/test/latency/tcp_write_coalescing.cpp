@@ -0,0 +1,219 @@
+//
+// tcp_write_coalescing.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/asio/coalescing_write_stream.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using boost::asio::ip::tcp;
+
+// Sends bursts of small messages over a loopback connection, the way a server
+// sends a batch of responses. Each message is written either by queueing
+// async_write calls on the socket, one after the other, or by starting all of
+// the burst's writes at once on a coalescing_write_stream. The receiver
+// discards the data.
+class test_session
+{
+public:
+  test_session(boost::asio::io_service& io_service, bool coalesce,
+      std::size_t message_size, std::size_t burst_size, std::size_t bursts)
+    : coalesce_(coalesce),
+      socket_(io_service),
+      stream_(socket_),
+      receiver_(io_service),
+      message_size_(message_size),
+      burst_size_(burst_size),
+      bursts_(bursts),
+      outstanding_(0),
+      next_message_(0),
+      bytes_expected_(message_size * burst_size * bursts),
+      bytes_received_(0),
+      send_data_(message_size * burst_size, 'x'),
+      recv_data_(65536)
+  {
+    tcp::acceptor acceptor(io_service, tcp::endpoint(tcp::v4(), 0));
+    tcp::endpoint endpoint = acceptor.local_endpoint();
+    endpoint.address(boost::asio::ip::address_v4::loopback());
+    receiver_.connect(endpoint);
+    acceptor.accept(socket_);
+    socket_.set_option(tcp::no_delay(true));
+  }
+
+  void start()
+  {
+    start_receive();
+    start_burst();
+  }
+
+private:
+  struct send_handler
+  {
+    test_session* this_;
+
+    void operator()(const boost::system::error_code& ec, std::size_t)
+    {
+      this_->handle_send(ec);
+    }
+  };
+
+  struct recv_handler
+  {
+    test_session* this_;
+
+    void operator()(const boost::system::error_code& ec, std::size_t n)
+    {
+      this_->handle_receive(ec, n);
+    }
+  };
+
+  void start_burst()
+  {
+    if (bursts_ == 0)
+      return;
+    --bursts_;
+
+    if (coalesce_)
+    {
+      // Every message in the burst is written immediately.
+      for (std::size_t i = 0; i < burst_size_; ++i)
+      {
+        send_handler h = { this };
+        stream_.async_write_some(boost::asio::buffer(
+              &send_data_[i * message_size_], message_size_), h);
+      }
+      outstanding_ = burst_size_;
+    }
+    else
+    {
+      // Only one write may be outstanding on the socket at a time, so the
+      // remaining messages wait in the application until it completes.
+      next_message_ = 0;
+      send_next();
+    }
+  }
+
+  void send_next()
+  {
+    send_handler h = { this };
+    boost::asio::async_write(socket_, boost::asio::buffer(
+          &send_data_[next_message_++ * message_size_], message_size_), h);
+    outstanding_ = 1;
+  }
+
+  void handle_send(const boost::system::error_code& ec)
+  {
+    if (ec)
+    {
+      std::fprintf(stderr, "send failed: %s\n", ec.message().c_str());
+      std::exit(1);
+    }
+
+    if (--outstanding_ > 0)
+      return;
+
+    if (!coalesce_ && next_message_ < burst_size_)
+      send_next();
+    else
+      start_burst();
+  }
+
+  void start_receive()
+  {
+    recv_handler h = { this };
+    receiver_.async_read_some(boost::asio::buffer(recv_data_), h);
+  }
+
+  void handle_receive(const boost::system::error_code& ec, std::size_t n)
+  {
+    if (ec)
+    {
+      std::fprintf(stderr, "receive failed: %s\n", ec.message().c_str());
+      std::exit(1);
+    }
+
+    bytes_received_ += n;
+    if (bytes_received_ < bytes_expected_)
+      start_receive();
+  }
+
+  bool coalesce_;
+  tcp::socket socket_;
+  boost::asio::coalescing_write_stream<tcp::socket&> stream_;
+  tcp::socket receiver_;
+  std::size_t message_size_;
+  std::size_t burst_size_;
+  std::size_t bursts_;
+  std::size_t outstanding_;
+  std::size_t next_message_;
+  std::size_t bytes_expected_;
+  std::size_t bytes_received_;
+  std::vector<char> send_data_;
+  std::vector<char> recv_data_;
+};
+
+void run_test(bool coalesce, std::size_t message_size,
+    std::size_t burst_size, std::size_t messages)
+{
+  boost::asio::io_service io_service;
+  test_session session(io_service, coalesce,
+      message_size, burst_size, messages / burst_size);
+
+  boost::posix_time::ptime start =
+    boost::posix_time::microsec_clock::universal_time();
+
+  session.start();
+  io_service.run();
+
+  boost::posix_time::ptime stop =
+    boost::posix_time::microsec_clock::universal_time();
+
+  double elapsed = (stop - start).total_microseconds() / 1000000.0;
+  std::printf("%-10s %6d bytes %4d per burst %12.0f msgs/sec\n",
+      coalesce ? "coalesce" : "write", static_cast<int>(message_size),
+      static_cast<int>(burst_size), messages / elapsed);
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc != 3 && argc != 4)
+  {
+    std::fprintf(stderr,
+        "Usage: tcp_write_coalescing <message-size> <max-burst> [<messages>]\n"
+        "Sends <messages> (default 1000000) messages in bursts of 1, 4, 16,\n"
+        "... up to <max-burst> messages.\n");
+    return 1;
+  }
+
+  std::size_t message_size = std::atoi(argv[1]);
+  std::size_t max_burst = std::atoi(argv[2]);
+  std::size_t messages = 1000000;
+  if (argc == 4 && std::atoi(argv[3]) > 0)
+    messages = std::atoi(argv[3]);
+
+  if (message_size == 0 || max_burst == 0)
+  {
+    std::fprintf(stderr, "invalid arguments\n");
+    return 1;
+  }
+
+  for (std::size_t burst_size = 1; burst_size <= max_burst; burst_size *= 4)
+  {
+    run_test(false, message_size, burst_size, messages);
+    run_test(true, message_size, burst_size, messages);
+  }
+
+  return 0;
+}
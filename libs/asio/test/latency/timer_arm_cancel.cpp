@@ -0,0 +1,114 @@
+//
+// timer_arm_cancel.cpp
+// ~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/asio/basic_deadline_timer.hpp>
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/time_traits.hpp>
+#include <boost/asio/timing_wheel_traits.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+typedef boost::asio::basic_deadline_timer<boost::posix_time::ptime,
+  boost::asio::timing_wheel_traits<
+    boost::asio::time_traits<boost::posix_time::ptime> > > wheel_timer;
+
+struct wait_handler
+{
+  std::size_t* count_;
+
+  void operator()(const boost::system::error_code&)
+  {
+    ++(*count_);
+  }
+};
+
+// Keeps a fixed number of timers armed with timeouts spread over a minute, and
+// repeatedly rearms them. Each rearm cancels the outstanding wait, as happens
+// when an idle timeout is pushed back on every read from a connection.
+template <typename Timer>
+void run_test(const char* name, std::size_t num_timers, std::size_t total_arms)
+{
+  boost::asio::io_service io_service;
+  std::size_t completed = 0;
+  wait_handler h = { &completed };
+
+  boost::posix_time::ptime base =
+    boost::posix_time::microsec_clock::universal_time()
+      + boost::posix_time::seconds(60);
+
+  std::vector<Timer*> timers;
+  for (std::size_t i = 0; i < num_timers; ++i)
+  {
+    timers.push_back(new Timer(io_service));
+    timers[i]->expires_at(base);
+    timers[i]->async_wait(h);
+  }
+
+  boost::posix_time::ptime start =
+    boost::posix_time::microsec_clock::universal_time();
+
+  std::size_t arms = 0;
+  unsigned int seed = 1;
+  while (arms < total_arms)
+  {
+    for (std::size_t i = 0; i < num_timers && arms < total_arms; ++i, ++arms)
+    {
+      seed = seed * 1103515245 + 12345;
+      boost::posix_time::time_duration offset =
+        boost::posix_time::milliseconds((seed >> 8) % 60000);
+      timers[i]->expires_at(base + offset);
+      timers[i]->async_wait(h);
+    }
+
+    // Deliver the cancelled waits.
+    io_service.poll();
+    io_service.reset();
+  }
+
+  boost::posix_time::ptime stop =
+    boost::posix_time::microsec_clock::universal_time();
+
+  for (std::size_t i = 0; i < num_timers; ++i)
+    delete timers[i];
+
+  double elapsed = (stop - start).total_microseconds() / 1000000.0;
+  std::printf("%-6s %8d timers %12.0f arm+cancel/sec %8.1f ns each\n",
+      name, static_cast<int>(num_timers), arms / elapsed,
+      elapsed * 1e9 / arms);
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc != 3 && argc != 4)
+  {
+    std::fprintf(stderr,
+        "Usage: timer_arm_cancel <timers> {heap|wheel|both} [<total-arms>]\n"
+        "The default total number of arms is 10000000.\n");
+    return 1;
+  }
+
+  std::size_t num_timers = std::atoi(argv[1]);
+  bool run_heap = (std::strcmp(argv[2], "wheel") != 0);
+  bool run_wheel = (std::strcmp(argv[2], "heap") != 0);
+  std::size_t total_arms = 10000000;
+  if (argc == 4 && std::atoi(argv[3]) > 0)
+    total_arms = std::atoi(argv[3]);
+
+  if (run_heap)
+    run_test<boost::asio::deadline_timer>("heap", num_timers, total_arms);
+  if (run_wheel)
+    run_test<wheel_timer>("wheel", num_timers, total_arms);
+
+  return 0;
+}
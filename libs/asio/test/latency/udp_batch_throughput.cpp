@@ -0,0 +1,253 @@
+//
+// udp_batch_throughput.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using boost::asio::ip::udp;
+
+// Sends bursts of datagrams over the loopback interface, waiting for each
+// burst to be received before sending the next so that no datagrams are lost.
+// In single mode each datagram is sent and received by a separate operation.
+// In batch mode each burst is sent by one async_send_batch operation and
+// received by as few async_receive_batch operations as possible.
+class test_session
+{
+public:
+  test_session(boost::asio::io_service& io_service, bool batch,
+      std::size_t datagram_size, std::size_t burst_size, std::size_t total)
+    : batch_(batch),
+      receiver_(io_service, udp::endpoint(udp::v4(), 0)),
+      sender_(io_service, udp::endpoint(udp::v4(), 0)),
+      send_data_(burst_size * datagram_size, 'x'),
+      recv_data_(burst_size * datagram_size),
+      sender_endpoints_(burst_size),
+      lengths_(burst_size),
+      destinations_(burst_size),
+      burst_size_(burst_size),
+      total_(total),
+      sent_(0),
+      burst_(0),
+      burst_recvd_(0),
+      recvd_(0),
+      bytes_recvd_(0),
+      recv_ops_(0)
+  {
+    udp::endpoint target = receiver_.local_endpoint();
+    target.address(boost::asio::ip::address_v4::loopback());
+    sender_.connect(target);
+
+    for (std::size_t i = 0; i < burst_size; ++i)
+    {
+      send_buffers_.push_back(boost::asio::buffer(
+            &send_data_[i * datagram_size], datagram_size));
+      recv_buffers_.push_back(boost::asio::buffer(
+            &recv_data_[i * datagram_size], datagram_size));
+      destinations_[i] = target;
+    }
+  }
+
+  void start()
+  {
+    start_send();
+    start_receive();
+  }
+
+  std::size_t datagrams() const
+  {
+    return recvd_;
+  }
+
+  std::size_t bytes() const
+  {
+    return bytes_recvd_;
+  }
+
+  std::size_t receive_operations() const
+  {
+    return recv_ops_;
+  }
+
+private:
+  struct send_handler
+  {
+    test_session* this_;
+
+    void operator()(const boost::system::error_code& ec, std::size_t)
+    {
+      if (ec)
+        std::fprintf(stderr, "send failed: %s\n", ec.message().c_str());
+    }
+  };
+
+  struct recv_handler
+  {
+    test_session* this_;
+
+    void operator()(const boost::system::error_code& ec, std::size_t n)
+    {
+      this_->handle_receive(ec, n);
+    }
+  };
+
+  void start_send()
+  {
+    std::size_t n = total_ - sent_ < burst_size_ ? total_ - sent_ : burst_size_;
+    send_handler h = { this };
+    if (batch_)
+    {
+      std::vector<boost::asio::const_buffer> bufs(
+          send_buffers_.begin(), send_buffers_.begin() + n);
+      sender_.async_send_batch(bufs, &destinations_[0], h);
+    }
+    else
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        sender_.async_send_to(boost::asio::buffer(send_buffers_[i]),
+            destinations_[i], h);
+    }
+    sent_ += n;
+    burst_ = n;
+    burst_recvd_ = 0;
+  }
+
+  void start_receive()
+  {
+    recv_handler h = { this };
+    if (batch_)
+    {
+      std::size_t n = burst_ - burst_recvd_;
+      std::vector<boost::asio::mutable_buffer> bufs(
+          recv_buffers_.begin(), recv_buffers_.begin() + n);
+      receiver_.async_receive_batch(bufs,
+          &sender_endpoints_[0], &lengths_[0], h);
+    }
+    else
+    {
+      receiver_.async_receive_from(
+          boost::asio::buffer(recv_buffers_[0]), sender_endpoints_[0], h);
+    }
+  }
+
+  void handle_receive(const boost::system::error_code& ec, std::size_t n)
+  {
+    if (ec)
+    {
+      std::fprintf(stderr, "receive failed: %s\n", ec.message().c_str());
+      return;
+    }
+
+    ++recv_ops_;
+    if (batch_)
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        bytes_recvd_ += lengths_[i];
+      recvd_ += n;
+      burst_recvd_ += n;
+    }
+    else
+    {
+      bytes_recvd_ += n;
+      ++recvd_;
+      ++burst_recvd_;
+    }
+
+    if (recvd_ == total_)
+      return;
+
+    if (recvd_ == sent_)
+      start_send();
+
+    start_receive();
+  }
+
+  bool batch_;
+  udp::socket receiver_;
+  udp::socket sender_;
+  std::vector<char> send_data_;
+  std::vector<char> recv_data_;
+  std::vector<boost::asio::const_buffer> send_buffers_;
+  std::vector<boost::asio::mutable_buffer> recv_buffers_;
+  std::vector<udp::endpoint> sender_endpoints_;
+  std::vector<std::size_t> lengths_;
+  std::vector<udp::endpoint> destinations_;
+  std::size_t burst_size_;
+  std::size_t total_;
+  std::size_t sent_;
+  std::size_t burst_;
+  std::size_t burst_recvd_;
+  std::size_t recvd_;
+  std::size_t bytes_recvd_;
+  std::size_t recv_ops_;
+};
+
+void run_test(bool batch, std::size_t datagram_size,
+    std::size_t burst_size, std::size_t total)
+{
+  boost::asio::io_service io_service;
+  test_session session(io_service, batch, datagram_size, burst_size, total);
+
+  boost::posix_time::ptime start =
+    boost::posix_time::microsec_clock::universal_time();
+
+  session.start();
+  io_service.run();
+
+  boost::posix_time::ptime stop =
+    boost::posix_time::microsec_clock::universal_time();
+
+  double elapsed = (stop - start).total_microseconds() / 1000000.0;
+  std::printf("%-6s %6d bytes %4d burst %12.0f datagrams/sec %8.1f MB/sec"
+      " %6.1f datagrams/receive\n", batch ? "batch" : "single",
+      static_cast<int>(datagram_size), static_cast<int>(burst_size),
+      session.datagrams() / elapsed, session.bytes() / elapsed / 1e6,
+      static_cast<double>(session.datagrams())
+        / (session.receive_operations() ? session.receive_operations() : 1));
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc != 4 && argc != 5)
+  {
+    std::fprintf(stderr,
+        "Usage: udp_batch_throughput <datagram-size> <burst-size> "
+        "{single|batch|both} [<total-datagrams>]\n"
+        "The burst size must be between 1 and 64. The default total number "
+        "of datagrams is 1000000.\n");
+    return 1;
+  }
+
+  std::size_t datagram_size = std::atoi(argv[1]);
+  std::size_t burst_size = std::atoi(argv[2]);
+  bool run_single = (std::strcmp(argv[3], "batch") != 0);
+  bool run_batch = (std::strcmp(argv[3], "single") != 0);
+  std::size_t total = 1000000;
+  if (argc == 5 && std::atoi(argv[4]) > 0)
+    total = std::atoi(argv[4]);
+
+  if (datagram_size == 0 || burst_size == 0 || burst_size > 64)
+  {
+    std::fprintf(stderr, "Invalid datagram or burst size.\n");
+    return 1;
+  }
+
+  if (run_single)
+    run_test(false, datagram_size, burst_size, total);
+  if (run_batch)
+    run_test(true, datagram_size, burst_size, total);
+
+  return 0;
+}
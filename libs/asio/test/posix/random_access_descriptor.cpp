@@ -0,0 +1,373 @@
+//
+// random_access_descriptor.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include <boost/asio/posix/random_access_descriptor.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <boost/bind.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/read_at.hpp>
+#include <boost/asio/write_at.hpp>
+#include "../unit_test.hpp"
+
+#if defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+# include <fcntl.h>
+# include <unistd.h>
+#endif // defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+
+//------------------------------------------------------------------------------
+
+// posix_random_access_descriptor_compile test
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks that all public member functions on the class
+// posix::random_access_descriptor compile and link correctly. Runtime failures
+// are ignored.
+
+namespace posix_random_access_descriptor_compile {
+
+void write_some_handler(const boost::system::error_code&, std::size_t)
+{
+}
+
+void read_some_handler(const boost::system::error_code&, std::size_t)
+{
+}
+
+void test()
+{
+#if defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+  using namespace boost::asio;
+  namespace posix = boost::asio::posix;
+
+  try
+  {
+    io_service ios;
+    char mutable_char_buffer[128] = "";
+    const char const_char_buffer[128] = "";
+    boost::uint64_t offset = 0;
+    posix::descriptor_base::bytes_readable io_control_command;
+    boost::system::error_code ec;
+
+    // basic_random_access_descriptor constructors.
+
+    posix::random_access_descriptor descriptor1(ios);
+    int native_descriptor1 = -1;
+    posix::random_access_descriptor descriptor2(ios, native_descriptor1);
+
+#if defined(BOOST_ASIO_HAS_MOVE)
+    posix::random_access_descriptor descriptor3(std::move(descriptor2));
+#endif // defined(BOOST_ASIO_HAS_MOVE)
+
+    // basic_random_access_descriptor operators.
+
+#if defined(BOOST_ASIO_HAS_MOVE)
+    descriptor1 = posix::random_access_descriptor(ios);
+    descriptor1 = std::move(descriptor3);
+#endif // defined(BOOST_ASIO_HAS_MOVE)
+
+    // basic_io_object functions.
+
+    io_service& ios_ref = descriptor1.get_io_service();
+    (void)ios_ref;
+
+    // basic_descriptor functions.
+
+    posix::random_access_descriptor::lowest_layer_type& lowest_layer
+      = descriptor1.lowest_layer();
+    (void)lowest_layer;
+
+    int native_descriptor2 = -1;
+    descriptor1.assign(native_descriptor2);
+
+    bool is_open = descriptor1.is_open();
+    (void)is_open;
+
+    descriptor1.close();
+    descriptor1.close(ec);
+
+    posix::random_access_descriptor::native_type native_descriptor3
+      = descriptor1.native();
+    (void)native_descriptor3;
+
+    posix::random_access_descriptor::native_handle_type native_descriptor4
+      = descriptor1.native_handle();
+    (void)native_descriptor4;
+
+    posix::random_access_descriptor::native_handle_type native_descriptor5
+      = descriptor1.release();
+    (void)native_descriptor5;
+
+    descriptor1.cancel();
+    descriptor1.cancel(ec);
+
+    descriptor1.io_control(io_control_command);
+    descriptor1.io_control(io_control_command, ec);
+
+    bool non_blocking1 = descriptor1.non_blocking();
+    (void)non_blocking1;
+    descriptor1.non_blocking(true);
+    descriptor1.non_blocking(false, ec);
+
+    bool non_blocking2 = descriptor1.native_non_blocking();
+    (void)non_blocking2;
+    descriptor1.native_non_blocking(true);
+    descriptor1.native_non_blocking(false, ec);
+
+    // basic_random_access_descriptor functions.
+
+    descriptor1.write_some_at(offset, buffer(mutable_char_buffer));
+    descriptor1.write_some_at(offset, buffer(const_char_buffer));
+    descriptor1.write_some_at(offset, buffer(mutable_char_buffer), ec);
+    descriptor1.write_some_at(offset, buffer(const_char_buffer), ec);
+
+    descriptor1.async_write_some_at(offset,
+        buffer(mutable_char_buffer), write_some_handler);
+    descriptor1.async_write_some_at(offset,
+        buffer(const_char_buffer), write_some_handler);
+
+    descriptor1.read_some_at(offset, buffer(mutable_char_buffer));
+    descriptor1.read_some_at(offset, buffer(mutable_char_buffer), ec);
+
+    descriptor1.async_read_some_at(offset,
+        buffer(mutable_char_buffer), read_some_handler);
+  }
+  catch (std::exception&)
+  {
+  }
+#endif // defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+}
+
+} // namespace posix_random_access_descriptor_compile
+
+//------------------------------------------------------------------------------
+
+// posix_random_access_descriptor_runtime test
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks the runtime operation of the
+// posix::random_access_descriptor class on a temporary file, both with the
+// default flags and, where supported, with O_DIRECT.
+
+namespace posix_random_access_descriptor_runtime {
+
+void handle_io(const boost::system::error_code& err,
+    std::size_t bytes_transferred, boost::system::error_code* out_err,
+    std::size_t* out_bytes_transferred, int* count)
+{
+  *out_err = err;
+  *out_bytes_transferred = bytes_transferred;
+  ++(*count);
+}
+
+#if defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+
+// Open a temporary file, returning its descriptor or -1.
+int open_temporary_file(bool direct)
+{
+  char name[] = "random_access_descriptor.XXXXXX";
+  int fd = ::mkstemp(name);
+  if (fd == -1)
+    return -1;
+  ::unlink(name);
+
+  if (direct)
+  {
+#if defined(O_DIRECT)
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    if (flags != -1 && ::fcntl(fd, F_SETFL, flags | O_DIRECT) != -1)
+      return fd;
+#endif // defined(O_DIRECT)
+    ::close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+// Transfer a block of data of the given size, with buffers and offsets
+// aligned to the size.
+void test_transfer(int fd, std::size_t size)
+{
+  using namespace boost::asio;
+  namespace posix = boost::asio::posix;
+
+  io_service ios;
+  posix::random_access_descriptor descriptor(ios, fd);
+
+  void* write_memory = 0;
+  void* read_memory = 0;
+  BOOST_CHECK(::posix_memalign(&write_memory, size, size) == 0);
+  BOOST_CHECK(::posix_memalign(&read_memory, size, size) == 0);
+  char* write_data = static_cast<char*>(write_memory);
+  char* read_data = static_cast<char*>(read_memory);
+  for (std::size_t i = 0; i < size; ++i)
+    write_data[i] = static_cast<char>('a' + i % 26);
+  std::memset(read_data, 0, size);
+
+  boost::system::error_code err;
+  std::size_t bytes_transferred = 0;
+  int count = 0;
+
+  // Write a block, leaving a hole at the start of the file.
+  async_write_at(descriptor, size, buffer(write_data, size),
+      boost::bind(handle_io, _1, _2, &err, &bytes_transferred, &count));
+  BOOST_CHECK(count == 0);
+  ios.run();
+  BOOST_CHECK(count == 1);
+  BOOST_CHECK(!err);
+  BOOST_CHECK(bytes_transferred == size);
+
+  // Read the block back.
+  ios.reset();
+  async_read_at(descriptor, size, buffer(read_data, size),
+      boost::bind(handle_io, _1, _2, &err, &bytes_transferred, &count));
+  ios.run();
+  BOOST_CHECK(count == 2);
+  BOOST_CHECK(!err);
+  BOOST_CHECK(bytes_transferred == size);
+  BOOST_CHECK(std::memcmp(read_data, write_data, size) == 0);
+
+  // The hole reads back as zeroes.
+  ios.reset();
+  std::memset(read_data, 1, size);
+  descriptor.async_read_some_at(0, buffer(read_data, size),
+      boost::bind(handle_io, _1, _2, &err, &bytes_transferred, &count));
+  ios.run();
+  BOOST_CHECK(count == 3);
+  BOOST_CHECK(!err);
+  BOOST_CHECK(bytes_transferred == size);
+  BOOST_CHECK(read_data[0] == 0 && read_data[size - 1] == 0);
+
+  // Reading at the end of the file reports eof.
+  ios.reset();
+  descriptor.async_read_some_at(2 * size, buffer(read_data, size),
+      boost::bind(handle_io, _1, _2, &err, &bytes_transferred, &count));
+  ios.run();
+  BOOST_CHECK(count == 4);
+  BOOST_CHECK(err == boost::asio::error::eof);
+  BOOST_CHECK(bytes_transferred == 0);
+
+  // Many operations may be outstanding at once.
+  ios.reset();
+  const int operations = 64;
+  for (int i = 0; i < operations; ++i)
+  {
+    descriptor.async_read_some_at(size, buffer(read_data, size),
+        boost::bind(handle_io, _1, _2, &err, &bytes_transferred, &count));
+  }
+  ios.run();
+  BOOST_CHECK(count == 4 + operations);
+  BOOST_CHECK(!err);
+  BOOST_CHECK(bytes_transferred == size);
+
+  // The synchronous operations see the same data.
+  std::memset(read_data, 0, size);
+  std::size_t n = descriptor.read_some_at(size, buffer(read_data, size));
+  BOOST_CHECK(n == size);
+  BOOST_CHECK(std::memcmp(read_data, write_data, size) == 0);
+  n = descriptor.write_some_at(3 * size, buffer(write_data, size), err);
+  BOOST_CHECK(!err);
+  BOOST_CHECK(n == size);
+  n = descriptor.read_some_at(4 * size, buffer(read_data, size), err);
+  BOOST_CHECK(err == boost::asio::error::eof);
+  BOOST_CHECK(n == 0);
+
+  // An empty read completes immediately without reporting eof.
+  ios.reset();
+  descriptor.async_read_some_at(100 * size, buffer(read_data, 0),
+      boost::bind(handle_io, _1, _2, &err, &bytes_transferred, &count));
+  ios.run();
+  BOOST_CHECK(count == 5 + operations);
+  BOOST_CHECK(!err);
+  BOOST_CHECK(bytes_transferred == 0);
+
+  // Operations on a closed descriptor fail.
+  descriptor.close();
+  ios.reset();
+  descriptor.async_read_some_at(0, buffer(read_data, size),
+      boost::bind(handle_io, _1, _2, &err, &bytes_transferred, &count));
+  ios.run();
+  BOOST_CHECK(count == 6 + operations);
+  BOOST_CHECK(err == boost::asio::error::bad_descriptor);
+
+  std::free(write_memory);
+  std::free(read_memory);
+}
+
+// Start operations and destroy the io_service without running it.
+void test_abandon(int fd, std::size_t size)
+{
+  using namespace boost::asio;
+  namespace posix = boost::asio::posix;
+
+  void* memory = 0;
+  BOOST_CHECK(::posix_memalign(&memory, size, size) == 0);
+  std::memset(memory, 'x', size);
+
+  boost::system::error_code err;
+  std::size_t bytes_transferred = 0;
+  int count = 0;
+
+  {
+    io_service ios;
+    posix::random_access_descriptor descriptor(ios, fd);
+    for (int i = 0; i < 16; ++i)
+    {
+      descriptor.async_write_some_at(i * size, buffer(memory, size),
+          boost::bind(handle_io, _1, _2, &err, &bytes_transferred, &count));
+    }
+  }
+
+  BOOST_CHECK(count == 0);
+  std::free(memory);
+}
+
+#endif // defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+
+void test()
+{
+#if defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+  int fd = open_temporary_file(false);
+  BOOST_CHECK(fd != -1);
+  if (fd != -1)
+    test_transfer(fd, 4096);
+
+  fd = open_temporary_file(false);
+  if (fd != -1)
+    test_abandon(fd, 4096);
+
+  // Not all file systems support O_DIRECT.
+  fd = open_temporary_file(true);
+  if (fd != -1)
+    test_transfer(fd, 4096);
+
+  fd = open_temporary_file(true);
+  if (fd != -1)
+    test_abandon(fd, 4096);
+#endif // defined(BOOST_ASIO_HAS_POSIX_RANDOM_ACCESS_DESCRIPTOR)
+}
+
+} // namespace posix_random_access_descriptor_runtime
+
+//------------------------------------------------------------------------------
+test_suite* init_unit_test_suite(int, char*[])
+{
+  test_suite* test = BOOST_TEST_SUITE("posix/random_access_descriptor");
+  test->add(BOOST_TEST_CASE(&posix_random_access_descriptor_compile::test));
+  test->add(BOOST_TEST_CASE(&posix_random_access_descriptor_runtime::test));
+  return test;
+}
@@ -17,8 +17,10 @@
 #include <boost/asio/strand.hpp>
 
 #include <sstream>
+#include <vector>
 #include <boost/thread/thread.hpp>
 #include <boost/bind.hpp>
+#include <boost/detail/atomic_count.hpp>
 #include <boost/asio/deadline_timer.hpp>
 #include <boost/asio/io_service.hpp>
 #include "unit_test.hpp"
@@ -179,9 +181,121 @@ void strand_test()
   BOOST_CHECK(count == 0);
 }
 
+struct strand_state
+{
+  boost::detail::atomic_count active;
+  int next_sequence;
+  int count;
+
+  strand_state() : active(0), next_sequence(0), count(0) {}
+};
+
+void check_sequence(strand_state* state, int sequence)
+{
+  // No other handler may be executing through the same strand.
+  BOOST_CHECK(++state->active == 1);
+
+  // Handlers posted from a single thread must run in the order posted.
+  BOOST_CHECK(sequence == state->next_sequence);
+  state->next_sequence = sequence + 1;
+  ++state->count;
+
+  --state->active;
+}
+
+void check_no_concurrency(strand_state* state)
+{
+  BOOST_CHECK(++state->active == 1);
+  ++state->count;
+  --state->active;
+}
+
+void post_through_copies(strand s, strand_state* state, int n)
+{
+  for (int i = 0; i < n; ++i)
+    s.post(boost::bind(check_no_concurrency, state));
+}
+
+void strand_independence_test()
+{
+  enum { num_strands = 50, num_handlers = 200, num_threads = 4 };
+
+  io_service ios;
+  strand_state states[num_strands];
+
+  {
+    // Each strand is destroyed before its handlers run. The handlers must
+    // still be executed without concurrency and in order.
+    std::vector<strand*> strands;
+    for (int i = 0; i < num_strands; ++i)
+      strands.push_back(new strand(ios));
+
+    for (int j = 0; j < num_handlers; ++j)
+      for (int i = 0; i < num_strands; ++i)
+        strands[i]->post(boost::bind(check_sequence, &states[i], j));
+
+    for (int i = 0; i < num_strands; ++i)
+      delete strands[i];
+  }
+
+  std::vector<boost::thread*> threads;
+  for (int i = 0; i < num_threads; ++i)
+    threads.push_back(new boost::thread(boost::bind(io_service_run, &ios)));
+  for (int i = 0; i < num_threads; ++i)
+  {
+    threads[i]->join();
+    delete threads[i];
+  }
+
+  for (int i = 0; i < num_strands; ++i)
+    BOOST_CHECK(states[i].count == num_handlers);
+
+  // Post to a strand from several threads at once using copies of the strand
+  // object, each of which must refer to the same underlying strand.
+  ios.reset();
+  strand_state shared_state;
+  {
+    strand s(ios);
+    for (int i = 0; i < num_threads; ++i)
+      ios.post(boost::bind(post_through_copies, s,
+            &shared_state, static_cast<int>(num_handlers)));
+  }
+
+  threads.clear();
+  for (int i = 0; i < num_threads; ++i)
+    threads.push_back(new boost::thread(boost::bind(io_service_run, &ios)));
+  for (int i = 0; i < num_threads; ++i)
+  {
+    threads[i]->join();
+    delete threads[i];
+  }
+
+  BOOST_CHECK(shared_state.count == num_threads * num_handlers);
+}
+
+void strand_after_io_service_test()
+{
+  int count = 0;
+  strand* s = 0;
+
+  {
+    io_service ios;
+    s = new strand(ios);
+    s->post(boost::bind(increment, &count));
+  }
+
+  // The pending handler was destroyed with the io_service, and the strand
+  // must still be safe to destroy.
+  delete s;
+
+  BOOST_CHECK(count == 0);
+}
+
 test_suite* init_unit_test_suite(int, char*[])
 {
   test_suite* test = BOOST_TEST_SUITE("strand");
   test->add(BOOST_TEST_CASE(&strand_test));
+  test->add(BOOST_TEST_CASE(&strand_independence_test));
+  test->add(BOOST_TEST_CASE(&strand_after_io_service_test));
   return test;
 }
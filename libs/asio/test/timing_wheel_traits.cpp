@@ -0,0 +1,263 @@
+//
+// timing_wheel_traits.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2012 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include <boost/asio/timing_wheel_traits.hpp>
+
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/asio/basic_deadline_timer.hpp>
+#include <boost/asio/basic_waitable_timer.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/placeholders.hpp>
+#include <boost/asio/time_traits.hpp>
+#include <boost/asio/wait_traits.hpp>
+#include "unit_test.hpp"
+
+#if defined(BOOST_ASIO_HAS_STD_CHRONO)
+# include <chrono>
+#endif // defined(BOOST_ASIO_HAS_STD_CHRONO)
+
+using namespace boost::posix_time;
+
+typedef boost::asio::basic_deadline_timer<ptime,
+  boost::asio::timing_wheel_traits<
+    boost::asio::time_traits<ptime> > > wheel_timer;
+
+// A wheel with a one microsecond tick, so that timers a few hours out are
+// beyond the range of the wheel levels.
+typedef boost::asio::basic_deadline_timer<ptime,
+  boost::asio::timing_wheel_traits<
+    boost::asio::time_traits<ptime>, 1> > fine_wheel_timer;
+
+ptime now()
+{
+  return microsec_clock::universal_time();
+}
+
+void record_expiry(ptime expected, int* count,
+    const boost::system::error_code& ec)
+{
+  BOOST_CHECK(!ec);
+
+  // The timer must not complete before its expiry time.
+  ptime end = now();
+  BOOST_CHECK(expected < end || expected == end);
+
+  ++(*count);
+}
+
+void increment_if_cancelled(int* count, const boost::system::error_code& ec)
+{
+  if (ec == boost::asio::error::operation_aborted)
+    ++(*count);
+}
+
+void timing_wheel_expiry_test()
+{
+  boost::asio::io_service ios;
+  int count = 0;
+
+  ptime start = now();
+
+  wheel_timer t1(ios, seconds(1));
+  t1.wait();
+
+  // The timer must block until after its expiry time.
+  ptime end = now();
+  ptime expected_end = start + seconds(1);
+  BOOST_CHECK(expected_end < end || expected_end == end);
+
+  // Timers that start on each level of the wheel, and a timer whose expiry
+  // has already passed.
+  long delays[] = { -1000, 0, 5, 100, 255, 256, 300, 700, 1500 };
+  const std::size_t num_delays = sizeof(delays) / sizeof(delays[0]);
+  std::vector<wheel_timer*> timers;
+  for (std::size_t i = 0; i < num_delays; ++i)
+  {
+    ptime expiry = now() + milliseconds(delays[i]);
+    timers.push_back(new wheel_timer(ios, expiry));
+    timers.back()->async_wait(boost::bind(record_expiry, expiry, &count,
+          boost::asio::placeholders::error));
+  }
+
+  // With a one microsecond tick these timers must cascade down through the
+  // upper levels of the wheel.
+  fine_wheel_timer t2(ios, now() + milliseconds(300));
+  t2.async_wait(boost::bind(record_expiry, t2.expires_at(), &count,
+        boost::asio::placeholders::error));
+  fine_wheel_timer t3(ios, now() + milliseconds(1200));
+  t3.async_wait(boost::bind(record_expiry, t3.expires_at(), &count,
+        boost::asio::placeholders::error));
+
+  ios.run();
+  BOOST_CHECK(count == static_cast<int>(num_delays) + 2);
+
+  for (std::size_t i = 0; i < timers.size(); ++i)
+    delete timers[i];
+
+  // Rearming an expired timer.
+  count = 0;
+  ptime expiry = now() + milliseconds(10);
+  wheel_timer t4(ios, expiry);
+  t4.async_wait(boost::bind(record_expiry, expiry, &count,
+        boost::asio::placeholders::error));
+
+  ios.reset();
+  ios.run();
+  BOOST_CHECK(count == 1);
+
+  expiry = t4.expires_at() + milliseconds(400);
+  t4.expires_at(expiry);
+  t4.async_wait(boost::bind(record_expiry, expiry, &count,
+        boost::asio::placeholders::error));
+
+  ios.reset();
+  ios.run();
+  BOOST_CHECK(count == 2);
+}
+
+void timing_wheel_cancel_test()
+{
+  boost::asio::io_service ios;
+  int count = 0;
+
+  ptime start = now();
+
+  // Timers spread across all levels of the wheel, the overflow list, and the
+  // list of timers that never expire.
+  std::vector<wheel_timer*> timers;
+  for (int i = 0; i < 1000; ++i)
+  {
+    timers.push_back(new wheel_timer(ios, seconds(10 + i * 37)));
+    timers.back()->async_wait(boost::bind(increment_if_cancelled, &count,
+          boost::asio::placeholders::error));
+  }
+
+  fine_wheel_timer t1(ios, hours(3));
+  t1.async_wait(boost::bind(increment_if_cancelled, &count,
+        boost::asio::placeholders::error));
+
+  wheel_timer t2(ios, ptime(boost::posix_time::pos_infin));
+  t2.async_wait(boost::bind(increment_if_cancelled, &count,
+        boost::asio::placeholders::error));
+
+  // Cancel every other timer, then cancel the remainder by rescheduling them.
+  for (std::size_t i = 0; i < timers.size(); i += 2)
+    BOOST_CHECK(timers[i]->cancel() == 1);
+  for (std::size_t i = 1; i < timers.size(); i += 2)
+    BOOST_CHECK(timers[i]->expires_from_now(seconds(100)) == 1);
+
+  BOOST_CHECK(t1.cancel() == 1);
+  BOOST_CHECK(t2.cancel() == 1);
+
+  ios.run();
+
+  BOOST_CHECK(count == 1002);
+  BOOST_CHECK(now() < start + seconds(5));
+
+  for (std::size_t i = 0; i < timers.size(); ++i)
+    delete timers[i];
+}
+
+void timing_wheel_many_timers_test()
+{
+  boost::asio::io_service ios;
+  int count = 0;
+
+  // Many timers sharing a small number of slots, some of which are cancelled
+  // before they expire.
+  int cancelled = 0;
+  std::vector<wheel_timer*> timers;
+  for (int i = 0; i < 2000; ++i)
+  {
+    ptime expiry = now() + milliseconds(i % 300);
+    timers.push_back(new wheel_timer(ios, expiry));
+    if (i % 3 == 0)
+      timers.back()->async_wait(boost::bind(increment_if_cancelled,
+            &cancelled, boost::asio::placeholders::error));
+    else
+      timers.back()->async_wait(boost::bind(record_expiry, expiry, &count,
+            boost::asio::placeholders::error));
+  }
+
+  for (std::size_t i = 0; i < timers.size(); i += 3)
+    BOOST_CHECK(timers[i]->cancel() == 1);
+
+  ios.run();
+
+  BOOST_CHECK(count == 2000 - 667);
+  BOOST_CHECK(cancelled == 667);
+
+  for (std::size_t i = 0; i < timers.size(); ++i)
+    delete timers[i];
+}
+
+#if defined(BOOST_ASIO_HAS_STD_CHRONO)
+
+typedef boost::asio::basic_waitable_timer<std::chrono::steady_clock,
+  boost::asio::timing_wheel_traits<
+    boost::asio::wait_traits<std::chrono::steady_clock>, 10000> >
+      wheel_steady_timer;
+
+void increment(int* count)
+{
+  ++(*count);
+}
+
+void cancel_steady_timer(wheel_steady_timer* t)
+{
+  std::size_t num_cancelled = t->cancel();
+  BOOST_CHECK(num_cancelled == 1);
+}
+
+void timing_wheel_steady_timer_test()
+{
+  boost::asio::io_service ios;
+  int count = 0;
+
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+
+  wheel_steady_timer t1(ios, std::chrono::milliseconds(250));
+  t1.async_wait(boost::bind(increment, &count));
+
+  wheel_steady_timer t2(ios, std::chrono::seconds(60));
+  t2.async_wait(boost::bind(increment_if_cancelled, &count,
+        boost::asio::placeholders::error));
+
+  wheel_steady_timer t3(ios, std::chrono::milliseconds(100));
+  t3.async_wait(boost::bind(cancel_steady_timer, &t2));
+
+  ios.run();
+
+  BOOST_CHECK(count == 2);
+  BOOST_CHECK(std::chrono::steady_clock::now() - start
+      >= std::chrono::milliseconds(250));
+}
+
+#endif // defined(BOOST_ASIO_HAS_STD_CHRONO)
+
+test_suite* init_unit_test_suite(int, char*[])
+{
+  test_suite* test = BOOST_TEST_SUITE("timing_wheel_traits");
+  test->add(BOOST_TEST_CASE(&timing_wheel_expiry_test));
+  test->add(BOOST_TEST_CASE(&timing_wheel_cancel_test));
+  test->add(BOOST_TEST_CASE(&timing_wheel_many_timers_test));
+#if defined(BOOST_ASIO_HAS_STD_CHRONO)
+  test->add(BOOST_TEST_CASE(&timing_wheel_steady_timer_test));
+#endif // defined(BOOST_ASIO_HAS_STD_CHRONO)
+  return test;
+}
@@ -0,0 +1,117 @@
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+//  Measures the throughput of queue, queue with thread_cached<true>,
+//  segmented_queue and spsc_queue with an equal number of producer and consumer
+//  threads, doubling the total number of threads from 2 up to the given maximum
+//  (default 64). spsc_queue is only measured with one producer and one consumer.
+//
+//  usage: queue_contention [max-threads [elements]]
+
+#include <boost/thread/thread.hpp>
+#include <boost/lockfree/queue.hpp>
+#include <boost/lockfree/segmented_queue.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <cstdio>
+#include <cstdlib>
+
+#include <boost/atomic.hpp>
+
+template <typename Queue>
+struct contention_test
+{
+    Queue & queue;
+    long elements_per_producer;
+    boost::atomic<bool> done;
+    boost::atomic<long> consumed;
+
+    contention_test(Queue & q, long elements):
+        queue(q), elements_per_producer(elements), done(false), consumed(0)
+    {}
+
+    void producer(void)
+    {
+        for (long i = 0; i != elements_per_producer; ++i)
+            while (!queue.push(i))
+                ;
+    }
+
+    void consumer(void)
+    {
+        long value, count = 0;
+        while (!done) {
+            while (queue.pop(value))
+                ++count;
+        }
+
+        while (queue.pop(value))
+            ++count;
+        consumed += count;
+    }
+
+    /* returns the number of elements passed through the queue per second */
+    double run(int producers, int consumers)
+    {
+        boost::thread_group producer_threads, consumer_threads;
+
+        boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+        for (int i = 0; i != consumers; ++i)
+            consumer_threads.create_thread(boost::bind(&contention_test::consumer, this));
+        for (int i = 0; i != producers; ++i)
+            producer_threads.create_thread(boost::bind(&contention_test::producer, this));
+
+        producer_threads.join_all();
+        done = true;
+        consumer_threads.join_all();
+
+        boost::posix_time::ptime stop = boost::posix_time::microsec_clock::universal_time();
+
+        long expected = elements_per_producer * producers;
+        if (consumed != expected) {
+            std::printf("lost elements: %ld of %ld consumed\n", consumed.load(), expected);
+            std::exit(1);
+        }
+        return expected / ((stop - start).total_microseconds() / 1000000.0);
+    }
+};
+
+template <typename Queue>
+double measure(Queue & q, int producers, int consumers, long elements)
+{
+    contention_test<Queue> test(q, elements / producers);
+    return test.run(producers, consumers);
+}
+
+int main(int argc, char* argv[])
+{
+    int max_threads = argc > 1 ? std::atoi(argv[1]) : 64;
+    long elements = argc > 2 ? std::atol(argv[2]) : 4000000;
+
+    std::printf("%8s %16s %16s %16s %16s\n", "threads", "queue", "cached queue", "segmented_queue", "spsc_queue");
+
+    for (int threads = 2; threads <= max_threads; threads *= 2) {
+        int producers = threads / 2;
+        int consumers = threads - producers;
+
+        boost::lockfree::queue<long> q(1024);
+        double queue_rate = measure(q, producers, consumers, elements);
+
+        boost::lockfree::queue<long, boost::lockfree::thread_cached<true> > cq(1024);
+        double cached_rate = measure(cq, producers, consumers, elements);
+
+        boost::lockfree::segmented_queue<long> sq(1024);
+        double segmented_rate = measure(sq, producers, consumers, elements);
+
+        if (threads == 2) {
+            boost::lockfree::spsc_queue<long, boost::lockfree::capacity<65536> > spsc;
+            double spsc_rate = measure(spsc, producers, consumers, elements);
+            std::printf("%8d %16.0f %16.0f %16.0f %16.0f\n", threads, queue_rate, cached_rate, segmented_rate, spsc_rate);
+        } else
+            std::printf("%8d %16.0f %16.0f %16.0f %16s\n", threads, queue_rate, cached_rate, segmented_rate, "-");
+    }
+}
@@ -0,0 +1,143 @@
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+//  Measures the throughput of lockfree::unordered_map and of boost::unordered_map
+//  guarded by a shared_mutex, with a read-heavy workload (90% lookups, 5% inserts,
+//  5% erasures) and a write-heavy workload (10% lookups, 45% inserts, 45%
+//  erasures), doubling the number of threads from 1 up to the given maximum
+//  (default 64).
+//
+//  usage: unordered_map_benchmark [max-threads [operations [keys]]]
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/lockfree/unordered_map.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <cstdio>
+#include <cstdlib>
+
+#include <boost/atomic.hpp>
+
+struct locked_map
+{
+    bool insert(long key, long value)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(mutex);
+        return map.insert(std::make_pair(key, value)).second;
+    }
+
+    bool find(long key, long & value)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(mutex);
+        boost::unordered_map<long, long>::const_iterator it = map.find(key);
+        if (it == map.end())
+            return false;
+        value = it->second;
+        return true;
+    }
+
+    std::size_t erase(long key)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(mutex);
+        return map.erase(key);
+    }
+
+    boost::shared_mutex mutex;
+    boost::unordered_map<long, long> map;
+};
+
+/* the percentage of lookups and inserts, the remaining operations are erasures */
+struct workload
+{
+    const char * name;
+    unsigned lookups;
+    unsigned inserts;
+};
+
+template <typename Map>
+struct benchmark
+{
+    Map & map;
+    workload const & load;
+    long operations_per_thread;
+    long keys;
+    boost::atomic<long> hits;
+
+    benchmark(Map & m, workload const & w, long operations, long key_count):
+        map(m), load(w), operations_per_thread(operations), keys(key_count), hits(0)
+    {}
+
+    void run_thread(unsigned seed)
+    {
+        long found = 0;
+        for (long i = 0; i != operations_per_thread; ++i) {
+            /* linear congruential generator, so that threads do not contend on a shared random number generator */
+            seed = seed * 1664525u + 1013904223u;
+            long key = (seed >> 8) % keys;
+            unsigned operation = (seed >> 4) % 100;
+
+            long value;
+            if (operation < load.lookups)
+                found += map.find(key, value);
+            else if (operation < load.lookups + load.inserts)
+                map.insert(key, key);
+            else
+                map.erase(key);
+        }
+
+        hits += found;
+    }
+
+    /* returns the number of operations per second */
+    double run(int threads)
+    {
+        /* start with half of the keys present, which is the steady state of both workloads */
+        for (long key = 0; key < keys; key += 2)
+            map.insert(key, key);
+
+        boost::thread_group group;
+        boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+        for (int i = 0; i != threads; ++i)
+            group.create_thread(boost::bind(&benchmark::run_thread, this, 12345u + i * 7919u));
+        group.join_all();
+
+        boost::posix_time::ptime stop = boost::posix_time::microsec_clock::universal_time();
+        return operations_per_thread * threads / ((stop - start).total_microseconds() / 1000000.0);
+    }
+};
+
+template <typename Map>
+double measure(workload const & w, int threads, long operations, long keys)
+{
+    Map map;
+    benchmark<Map> test(map, w, operations / threads, keys);
+    return test.run(threads);
+}
+
+int main(int argc, char* argv[])
+{
+    int max_threads = argc > 1 ? std::atoi(argv[1]) : 64;
+    long operations = argc > 2 ? std::atol(argv[2]) : 4000000;
+    long keys = argc > 3 ? std::atol(argv[3]) : 100000;
+
+    const workload workloads[] = {
+        { "read-heavy", 90, 5 },
+        { "write-heavy", 10, 45 }
+    };
+
+    for (int w = 0; w != 2; ++w) {
+        std::printf("%s\n%8s %16s %16s\n", workloads[w].name, "threads", "lockfree", "shared_mutex");
+
+        for (int threads = 1; threads <= max_threads; threads *= 2) {
+            double lockfree_rate = measure<boost::lockfree::unordered_map<long, long> >(workloads[w], threads, operations, keys);
+            double locked_rate = measure<locked_map>(workloads[w], threads, operations, keys);
+            std::printf("%8d %16.0f %16.0f\n", threads, lockfree_rate, locked_rate);
+        }
+    }
+}
@@ -0,0 +1,156 @@
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/lockfree/detail/epoch_reclamation.hpp>
+#include <boost/lockfree/queue.hpp>
+#include <boost/lockfree/stack.hpp>
+#include <boost/thread.hpp>
+
+#define BOOST_TEST_MAIN
+#ifdef BOOST_LOCKFREE_INCLUDE_TESTS
+#include <boost/test/included/unit_test.hpp>
+#else
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <memory>
+#include <set>
+
+using namespace boost;
+using namespace boost::lockfree;
+using namespace std;
+
+namespace {
+
+struct retired_object
+{
+    void * link[2];
+};
+
+std::set<void*> reclaimed;
+
+void reclaim(void * context, void * object)
+{
+    ++*static_cast<int*>(context);
+    reclaimed.insert(object);
+}
+
+boost::lockfree::detail::atomic<long> live_nodes(0);
+
+template <typename T>
+struct counting_allocator:
+    std::allocator<T>
+{
+    template <typename U>
+    struct rebind
+    {
+        typedef counting_allocator<U> other;
+    };
+
+    counting_allocator(void)
+    {}
+
+    template <typename U>
+    counting_allocator(counting_allocator<U> const &)
+    {}
+
+    T * allocate(std::size_t n)
+    {
+        live_nodes += n;
+        return std::allocator<T>::allocate(n);
+    }
+
+    void deallocate(T * p, std::size_t n)
+    {
+        live_nodes -= n;
+        std::allocator<T>::deallocate(p, n);
+    }
+};
+
+typedef boost::lockfree::detail::epoch_domain<> domain_type;
+
+}
+
+BOOST_AUTO_TEST_CASE( epoch_domain_test )
+{
+    int reclaim_count = 0;
+    retired_object objects[4];
+
+    {
+        domain_type domain(&reclaim, &reclaim_count);
+        BOOST_WARN(domain.is_lock_free());
+
+        {
+            domain_type::guard reader(domain);
+            {
+                domain_type::guard g(domain);
+                g.retire(&objects[0]);
+                g.retire(&objects[1]);
+            }
+
+            // the reader may still access the retired objects
+            for (int i = 0; i != 1000; ++i) {
+                domain_type::guard g(domain);
+            }
+            BOOST_REQUIRE_EQUAL(reclaim_count, 0);
+        }
+
+        for (int i = 0; i != 1000; ++i) {
+            domain_type::guard g(domain);
+        }
+        BOOST_REQUIRE_EQUAL(reclaim_count, 2);
+
+        {
+            domain_type::guard g(domain);
+            g.retire(&objects[2]);
+            g.retire(&objects[3]);
+        }
+    }
+
+    // the destructor reclaims the remaining objects
+    BOOST_REQUIRE_EQUAL(reclaim_count, 4);
+    BOOST_REQUIRE_EQUAL(reclaimed.size(), 4u);
+}
+
+template <typename Container>
+void burst_test(void)
+{
+    {
+        Container c(16);
+        long reserved = live_nodes.load();
+        BOOST_REQUIRE(reserved >= 16);
+
+        for (long i = 0; i != 10000; ++i)
+            c.push(i);
+        BOOST_REQUIRE(live_nodes.load() >= 10000);
+
+        long value;
+        for (long i = 0; i != 10000; ++i)
+            BOOST_REQUIRE(c.pop(value));
+        BOOST_REQUIRE(!c.pop(value));
+
+        // the popped nodes are released once the epoch has advanced
+        for (long i = 0; i != 1000; ++i) {
+            c.push(i);
+            BOOST_REQUIRE(c.pop(value));
+        }
+        BOOST_REQUIRE(live_nodes.load() < 100);
+
+        // reserved nodes are kept in the freelist
+        for (long i = 0; i != 1000; ++i)
+            c.pop(value);
+        BOOST_REQUIRE(live_nodes.load() >= reserved);
+    }
+    BOOST_REQUIRE_EQUAL(live_nodes.load(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( queue_reclaim_memory_test )
+{
+    burst_test<queue<long, reclaim_memory<true>, boost::lockfree::allocator<counting_allocator<long> > > >();
+}
+
+BOOST_AUTO_TEST_CASE( stack_reclaim_memory_test )
+{
+    burst_test<stack<long, reclaim_memory<true>, boost::lockfree::allocator<counting_allocator<long> > > >();
+}
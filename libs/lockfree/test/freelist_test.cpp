@@ -23,6 +23,7 @@
 #include <boost/foreach.hpp>
 
 #include <set>
+#include <vector>
 
 #include "test_helpers.hpp"
 
@@ -92,6 +93,8 @@ void run_tests(void)
     run_test<boost::lockfree::detail::freelist_stack<dummy>, true, bounded>();
     run_test<boost::lockfree::detail::freelist_stack<dummy>, false, bounded>();
     run_test<boost::lockfree::detail::fixed_size_freelist<dummy>, true, bounded>();
+    run_test<boost::lockfree::detail::caching_freelist<dummy>, true, bounded>();
+    run_test<boost::lockfree::detail::caching_freelist<dummy>, false, bounded>();
 }
 
 BOOST_AUTO_TEST_CASE( freelist_tests )
@@ -119,6 +122,33 @@ BOOST_AUTO_TEST_CASE( oom_tests )
     oom_test<boost::lockfree::detail::freelist_stack<dummy>, false >();
     oom_test<boost::lockfree::detail::fixed_size_freelist<dummy>, true >();
     oom_test<boost::lockfree::detail::fixed_size_freelist<dummy>, false >();
+    oom_test<boost::lockfree::detail::caching_freelist<dummy>, true >();
+    oom_test<boost::lockfree::detail::caching_freelist<dummy>, false >();
+}
+
+typedef boost::lockfree::detail::caching_freelist<dummy> caching_freelist_type;
+
+void destruct_cached(caching_freelist_type * fl, dummy * node)
+{
+    fl->destruct<true>(node);
+}
+
+BOOST_AUTO_TEST_CASE( caching_freelist_oom_test )
+{
+    // nodes held in the cache of a thread are available to bounded allocations of other threads
+    caching_freelist_type fl(std::allocator<int>(), 8);
+
+    std::vector<dummy*> nodes;
+    for (int i = 0; i != 8; ++i)
+        nodes.push_back(fl.construct<true, true>());
+    BOOST_REQUIRE((fl.construct<true, true>() == NULL));
+
+    boost::thread release_thread(boost::bind(&destruct_cached, &fl, nodes[0]));
+    release_thread.join();
+
+    dummy * allocated = fl.construct<true, true>();
+    BOOST_REQUIRE(allocated == nodes[0]);
+    BOOST_REQUIRE((fl.construct<true, true>() == NULL));
 }
 
 
@@ -223,6 +253,19 @@ BOOST_AUTO_TEST_CASE( bounded_freelist_test )
     run_tester<test_type>();
 }
 
+BOOST_AUTO_TEST_CASE( unbounded_caching_freelist_test )
+{
+    typedef freelist_tester<boost::lockfree::detail::caching_freelist<dummy>, false > test_type;
+    run_tester<test_type>();
+}
+
+
+BOOST_AUTO_TEST_CASE( bounded_caching_freelist_test )
+{
+    typedef freelist_tester<boost::lockfree::detail::caching_freelist<dummy>, true > test_type;
+    run_tester<test_type>();
+}
+
 BOOST_AUTO_TEST_CASE( fixed_size_freelist_test )
 {
     typedef freelist_tester<boost::lockfree::detail::fixed_size_freelist<dummy>, true > test_type;
@@ -0,0 +1,211 @@
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/lockfree/segmented_queue.hpp>
+#include <boost/thread.hpp>
+
+#define BOOST_TEST_MAIN
+#ifdef BOOST_LOCKFREE_INCLUDE_TESTS
+#include <boost/test/included/unit_test.hpp>
+#else
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include "test_common.hpp"
+
+namespace boost    {
+namespace lockfree {
+namespace detail   {
+
+class segmented_queue_tester
+{
+public:
+    /* pops from q like a thread that read the head segment and was delayed before claiming a slot */
+    template <typename Queue, typename Delay, typename U>
+    static bool delayed_pop(Queue & q, Delay delay, U & ret)
+    {
+        typename Queue::tagged_segment_ptr head = q.head_.load();
+        boost::uint64_t dequeue_index = head.get_ptr()->dequeue_index.load();
+
+        delay();
+
+        typename Queue::pop_result result = q.pop_from(head, dequeue_index, ret);
+        if (result != Queue::pop_retry)
+            return result == Queue::pop_success;
+        return q.pop(ret);
+    }
+};
+
+} /* namespace detail */
+} /* namespace lockfree */
+} /* namespace boost */
+
+using namespace boost;
+using namespace boost::lockfree;
+using namespace std;
+
+BOOST_AUTO_TEST_CASE( simple_segmented_queue_test )
+{
+    segmented_queue<int> f(64);
+
+    BOOST_WARN(f.is_lock_free());
+
+    BOOST_REQUIRE(f.empty());
+    f.push(1);
+    f.push(2);
+
+    int i1(0), i2(0);
+
+    BOOST_REQUIRE(f.pop(i1));
+    BOOST_REQUIRE_EQUAL(i1, 1);
+
+    BOOST_REQUIRE(f.pop(i2));
+    BOOST_REQUIRE_EQUAL(i2, 2);
+    BOOST_REQUIRE(f.empty());
+    BOOST_REQUIRE(!f.pop(i1));
+}
+
+BOOST_AUTO_TEST_CASE( simple_segmented_queue_test_capacity )
+{
+    segmented_queue<int, capacity<64> > f;
+
+    BOOST_WARN(f.is_lock_free());
+
+    BOOST_REQUIRE(f.empty());
+    f.push(1);
+    f.push(2);
+
+    int i1(0), i2(0);
+
+    BOOST_REQUIRE(f.pop(i1));
+    BOOST_REQUIRE_EQUAL(i1, 1);
+
+    BOOST_REQUIRE(f.pop(i2));
+    BOOST_REQUIRE_EQUAL(i2, 2);
+    BOOST_REQUIRE(f.empty());
+}
+
+BOOST_AUTO_TEST_CASE( segmented_queue_fifo_across_segments_test )
+{
+    segmented_queue<long> f(0);
+
+    /* several rounds, so that the segments are recycled */
+    for (long round = 0; round != 4; ++round) {
+        for (long i = 0; i != 2000; ++i)
+            BOOST_REQUIRE(f.push(round * 2000 + i));
+
+        BOOST_REQUIRE(!f.empty());
+
+        for (long i = 0; i != 2000; ++i) {
+            long j;
+            BOOST_REQUIRE(f.pop(j));
+            BOOST_REQUIRE_EQUAL(j, round * 2000 + i);
+        }
+        BOOST_REQUIRE(f.empty());
+    }
+}
+
+/* drains the head segment, so that it is recycled, and appends it to the tail again */
+struct recycle_head_segment
+{
+    explicit recycle_head_segment(segmented_queue<long> & q):
+        q(q)
+    {}
+
+    void operator()() const
+    {
+        for (long i = 0; i != 257; ++i) {
+            long j;
+            BOOST_REQUIRE(q.pop(j));
+            BOOST_REQUIRE_EQUAL(j, i);
+        }
+
+        for (long i = 257; i != 513; ++i)
+            BOOST_REQUIRE(q.push(i));
+    }
+
+    segmented_queue<long> & q;
+};
+
+BOOST_AUTO_TEST_CASE( segmented_queue_delayed_pop_test )
+{
+    segmented_queue<long> f(0);
+
+    /* fill the first segment and start the second */
+    for (long i = 0; i != 257; ++i)
+        BOOST_REQUIRE(f.push(i));
+
+    /* the first segment now holds 512, behind 257 to 511 in the second segment */
+    long j;
+    BOOST_REQUIRE(lockfree::detail::segmented_queue_tester::delayed_pop(f, recycle_head_segment(f), j));
+    BOOST_REQUIRE_EQUAL(j, 257);
+
+    for (long i = 258; i != 513; ++i) {
+        BOOST_REQUIRE(f.pop(j));
+        BOOST_REQUIRE_EQUAL(j, i);
+    }
+    BOOST_REQUIRE(f.empty());
+}
+
+BOOST_AUTO_TEST_CASE( segmented_queue_bounded_push_test )
+{
+    segmented_queue<int, capacity<1000> > f;
+
+    int pushed = 0;
+    while (f.push(pushed))
+        ++pushed;
+    BOOST_REQUIRE_GE(pushed, 1000);
+    BOOST_REQUIRE(!f.bounded_push(0));
+
+    /* consuming a whole segment makes room for another one */
+    for (int i = 0; i != pushed; ++i) {
+        int j;
+        BOOST_REQUIRE(f.pop(j));
+        BOOST_REQUIRE_EQUAL(j, i);
+    }
+    BOOST_REQUIRE(f.empty());
+    BOOST_REQUIRE(f.bounded_push(1));
+}
+
+BOOST_AUTO_TEST_CASE( segmented_queue_convert_pop_test )
+{
+    segmented_queue<int*> f(128);
+    BOOST_REQUIRE(f.empty());
+    f.push(new int(1));
+    f.push(new int(2));
+
+    {
+        int * i1;
+
+        BOOST_REQUIRE(f.pop(i1));
+        BOOST_REQUIRE_EQUAL(*i1, 1);
+        delete i1;
+    }
+
+    {
+        boost::shared_ptr<int> i2;
+        BOOST_REQUIRE(f.pop(i2));
+        BOOST_REQUIRE_EQUAL(*i2, 2);
+    }
+
+    BOOST_REQUIRE(f.empty());
+}
+
+BOOST_AUTO_TEST_CASE( segmented_queue_test_unbounded )
+{
+    typedef queue_stress_tester<false> tester_type;
+    boost::scoped_ptr<tester_type> tester(new tester_type(4, 4) );
+
+    segmented_queue<long> q(128);
+    tester->run(q);
+}
+
+BOOST_AUTO_TEST_CASE( segmented_queue_test_bounded )
+{
+    typedef queue_stress_tester<true> tester_type;
+    boost::scoped_ptr<tester_type> tester(new tester_type(4, 4) );
+
+    segmented_queue<long> q(128);
+    tester->run(q);
+}
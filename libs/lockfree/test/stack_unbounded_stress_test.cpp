@@ -24,3 +24,21 @@ BOOST_AUTO_TEST_CASE( stack_test_unbounded )
     boost::lockfree::stack<long> q(128);
     tester->run(q);
 }
+
+BOOST_AUTO_TEST_CASE( stack_test_unbounded_thread_cached )
+{
+    typedef queue_stress_tester<false> tester_type;
+    boost::scoped_ptr<tester_type> tester(new tester_type(4, 4) );
+
+    boost::lockfree::stack<long, boost::lockfree::thread_cached<true> > q(128);
+    tester->run(q);
+}
+
+BOOST_AUTO_TEST_CASE( stack_test_unbounded_reclaim_memory )
+{
+    typedef queue_stress_tester<false> tester_type;
+    boost::scoped_ptr<tester_type> tester(new tester_type(4, 4) );
+
+    boost::lockfree::stack<long, boost::lockfree::reclaim_memory<true> > q(128);
+    tester->run(q);
+}
@@ -0,0 +1,225 @@
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/lockfree/unordered_map.hpp>
+#include <boost/thread.hpp>
+
+#define BOOST_TEST_MAIN
+#ifdef BOOST_LOCKFREE_INCLUDE_TESTS
+#include <boost/test/included/unit_test.hpp>
+#else
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <memory>
+#include <string>
+
+using namespace boost;
+using namespace boost::lockfree;
+using namespace std;
+
+namespace {
+
+boost::lockfree::detail::atomic<long> live_nodes(0);
+
+template <typename T>
+struct counting_allocator:
+    std::allocator<T>
+{
+    template <typename U>
+    struct rebind
+    {
+        typedef counting_allocator<U> other;
+    };
+
+    counting_allocator(void)
+    {}
+
+    template <typename U>
+    counting_allocator(counting_allocator<U> const &)
+    {}
+
+    T * allocate(std::size_t n)
+    {
+        live_nodes += n;
+        return std::allocator<T>::allocate(n);
+    }
+
+    void deallocate(T * p, std::size_t n)
+    {
+        live_nodes -= n;
+        std::allocator<T>::deallocate(p, n);
+    }
+};
+
+/* maps all keys to a few hash values, so that elements with equal hash values share a bucket */
+struct colliding_hash
+{
+    std::size_t operator()(long key) const
+    {
+        return key % 3;
+    }
+};
+
+struct sum_values
+{
+    explicit sum_values(long & sum):
+        sum(sum)
+    {}
+
+    void operator()(std::pair<const long, long> const & value) const
+    {
+        sum += value.second;
+    }
+
+    long & sum;
+};
+
+}
+
+BOOST_AUTO_TEST_CASE( simple_unordered_map_test )
+{
+    unordered_map<long, std::string> m;
+
+    BOOST_WARN(m.is_lock_free());
+    BOOST_REQUIRE(m.empty());
+
+    BOOST_REQUIRE(m.insert(1, "one"));
+    BOOST_REQUIRE(m.insert(std::make_pair(2l, std::string("two"))));
+    BOOST_REQUIRE(!m.insert(1, "uno"));
+    BOOST_REQUIRE_EQUAL(m.size(), 2u);
+
+    std::string value;
+    BOOST_REQUIRE(m.find(1, value));
+    BOOST_REQUIRE_EQUAL(value, "one");
+    BOOST_REQUIRE(m.find(2, value));
+    BOOST_REQUIRE_EQUAL(value, "two");
+    BOOST_REQUIRE(!m.find(3, value));
+    BOOST_REQUIRE_EQUAL(m.count(1), 1u);
+    BOOST_REQUIRE_EQUAL(m.count(3), 0u);
+
+    BOOST_REQUIRE_EQUAL(m.erase(1), 1u);
+    BOOST_REQUIRE_EQUAL(m.erase(1), 0u);
+    BOOST_REQUIRE(!m.find(1, value));
+    BOOST_REQUIRE_EQUAL(m.size(), 1u);
+
+    BOOST_REQUIRE(m.insert(1, "uno"));
+    BOOST_REQUIRE(m.find(1, value));
+    BOOST_REQUIRE_EQUAL(value, "uno");
+}
+
+BOOST_AUTO_TEST_CASE( unordered_map_growth_test )
+{
+    {
+        unordered_map<long, long, boost::hash<long>, std::equal_to<long>,
+                      counting_allocator<std::pair<const long, long> > > m(4);
+        BOOST_REQUIRE_EQUAL(m.bucket_count(), 4u);
+
+        for (long i = 0; i != 10000; ++i)
+            BOOST_REQUIRE(m.insert(i, 2 * i));
+        BOOST_REQUIRE_EQUAL(m.size(), 10000u);
+        BOOST_REQUIRE(m.bucket_count() >= 10000 / 4);
+
+        for (long i = 0; i != 10000; ++i) {
+            long value;
+            BOOST_REQUIRE(m.find(i, value));
+            BOOST_REQUIRE_EQUAL(value, 2 * i);
+        }
+
+        long sum = 0;
+        m.visit_all(sum_values(sum));
+        BOOST_REQUIRE_EQUAL(sum, 10000l * 9999);
+
+        for (long i = 0; i != 10000; i += 2)
+            BOOST_REQUIRE_EQUAL(m.erase(i), 1u);
+        BOOST_REQUIRE_EQUAL(m.size(), 5000u);
+
+        for (long i = 0; i != 10000; ++i)
+            BOOST_REQUIRE_EQUAL(m.count(i), std::size_t(i % 2));
+    }
+    BOOST_REQUIRE_EQUAL(live_nodes.load(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( unordered_map_collision_test )
+{
+    unordered_map<long, long, colliding_hash> m;
+
+    for (long i = 0; i != 300; ++i)
+        BOOST_REQUIRE(m.insert(i, i));
+    for (long i = 0; i != 300; i += 3)
+        BOOST_REQUIRE_EQUAL(m.erase(i), 1u);
+
+    for (long i = 0; i != 300; ++i) {
+        long value = -1;
+        BOOST_REQUIRE_EQUAL(m.find(i, value), i % 3 != 0);
+        if (i % 3 != 0)
+            BOOST_REQUIRE_EQUAL(value, i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( unordered_map_visit_test )
+{
+    unordered_map<long, long> m;
+    m.insert(1, 10);
+
+    long sum = 0;
+    BOOST_REQUIRE(m.visit(1, sum_values(sum)));
+    BOOST_REQUIRE(!m.visit(2, sum_values(sum)));
+    BOOST_REQUIRE_EQUAL(sum, 10);
+}
+
+namespace {
+
+typedef unordered_map<long, long, boost::hash<long>, std::equal_to<long>,
+                      counting_allocator<std::pair<const long, long> > > stress_map;
+
+const long keys_per_thread = 20000;
+
+/* each thread owns a range of keys, which it inserts, looks up and erases, while it also reads the keys of the other
+ * threads */
+void stress_thread(stress_map & m, long thread, long threads, boost::lockfree::detail::atomic<long> & errors)
+{
+    long first = thread * keys_per_thread;
+    for (int round = 0; round != 4; ++round) {
+        for (long i = first; i != first + keys_per_thread; ++i)
+            if (!m.insert(i, i))
+                ++errors;
+
+        for (long i = first; i != first + keys_per_thread; ++i) {
+            long value;
+            if (!m.find(i, value) || value != i)
+                ++errors;
+
+            /* a key of another thread is either absent or maps to itself */
+            long other = (i + keys_per_thread * (1 + i % (threads - 1))) % (threads * keys_per_thread);
+            if (m.find(other, value) && value != other)
+                ++errors;
+        }
+
+        for (long i = first; i != first + keys_per_thread; ++i)
+            if (m.erase(i) != 1)
+                ++errors;
+    }
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( unordered_map_stress_test )
+{
+    const long threads = 4;
+    {
+        stress_map m(2);
+        boost::lockfree::detail::atomic<long> errors(0);
+
+        boost::thread_group group;
+        for (long i = 0; i != threads; ++i)
+            group.create_thread(boost::bind(&stress_thread, boost::ref(m), i, threads, boost::ref(errors)));
+        group.join_all();
+
+        BOOST_REQUIRE_EQUAL(errors.load(), 0);
+        BOOST_REQUIRE(m.empty());
+        BOOST_REQUIRE(m.bucket_count() >= 1024);
+    }
+    BOOST_REQUIRE_EQUAL(live_nodes.load(), 0);
+}
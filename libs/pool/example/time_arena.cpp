@@ -0,0 +1,99 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Compares the time to create a number of objects and to release them all at once
+// with object_pool, arena and new/delete, for objects with trivial and non-trivial destructors.
+//
+// usage: time_arena [objects]
+
+#include <boost/pool/object_pool.hpp>
+#include <boost/pool/arena.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+struct trivial
+{
+  trivial() : a(0), b(0) { }
+
+  long a, b;
+};
+
+struct nontrivial
+{
+  nontrivial() : a(0), b(0) { }
+  ~nontrivial() { ++destroyed; }
+
+  long a, b;
+  static unsigned long destroyed;
+};
+
+unsigned long nontrivial::destroyed = 0;
+
+double seconds(const std::clock_t start)
+{
+  return (std::clock() - start) / static_cast<double>(CLOCKS_PER_SEC);
+}
+
+template <typename T>
+void time_objects(const char * const name, const unsigned long count)
+{
+  double create[3], release[3];
+  std::clock_t start;
+
+  {
+    boost::object_pool<T> * const p = new boost::object_pool<T>();
+    start = std::clock();
+    for (unsigned long i = 0; i < count; ++i)
+      p->construct();
+    create[0] = seconds(start);
+
+    start = std::clock();
+    delete p;
+    release[0] = seconds(start);
+  }
+
+  {
+    boost::arena<> * const a = new boost::arena<>();
+    start = std::clock();
+    for (unsigned long i = 0; i < count; ++i)
+      a->template construct<T>();
+    create[1] = seconds(start);
+
+    start = std::clock();
+    delete a;
+    release[1] = seconds(start);
+  }
+
+  {
+    std::vector<T *> objects;
+    objects.reserve(count);
+    start = std::clock();
+    for (unsigned long i = 0; i < count; ++i)
+      objects.push_back(new T());
+    create[2] = seconds(start);
+
+    start = std::clock();
+    for (unsigned long i = 0; i < count; ++i)
+      delete objects[i];
+    release[2] = seconds(start);
+  }
+
+  std::printf("%s objects: %lu\n", name, count);
+  std::printf("  %-12s %12s %12s\n", "", "create", "release");
+  std::printf("  %-12s %12.3f %12.3f\n", "object_pool", create[0], release[0]);
+  std::printf("  %-12s %12.3f %12.3f\n", "arena", create[1], release[1]);
+  std::printf("  %-12s %12.3f %12.3f\n", "new/delete", create[2], release[2]);
+}
+
+int main(int argc, char * argv[])
+{
+  const unsigned long count = argc > 1 ? std::strtoul(argv[1], 0, 10) : 1000000;
+
+  time_objects<trivial>("trivial", count);
+  time_objects<nontrivial>("non-trivial", count);
+  return 0;
+}
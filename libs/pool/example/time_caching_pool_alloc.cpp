@@ -0,0 +1,165 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Compares caching_pool_allocator with pool_allocator, fast_pool_allocator and malloc
+// in three multi-threaded workloads, doubling the number of threads up to the given maximum:
+//  list:   each thread fills and empties a std::list,
+//  vector: each thread grows a std::vector by push_back,
+//  queue:  pairs of threads pass blocks of 64 bytes from a producer, which allocates them,
+//          to a consumer, which frees them.
+// pool_allocator keeps its free list ordered, so that freeing many blocks in the queue
+//  workload takes quadratic time; hence the small default number of operations.
+//
+// usage: time_caching_pool_alloc [max-threads [operations]]
+
+#include <boost/pool/pool_alloc.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/bind.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <vector>
+
+#include "sys_allocator.hpp"
+
+unsigned long operations = 50000;
+
+template <typename Alloc>
+void list_thread()
+{
+  std::list<int, typename Alloc::template rebind<int>::other> l;
+  for (unsigned long i = 0; i < operations / 1000; ++i)
+  {
+    for (int j = 0; j < 1000; ++j)
+      l.push_back(j);
+    while (!l.empty())
+      l.pop_front();
+  }
+}
+
+template <typename Alloc>
+void vector_thread()
+{
+  for (unsigned long i = 0; i < operations / 1000; ++i)
+  {
+    std::vector<int, typename Alloc::template rebind<int>::other> v;
+    for (int j = 0; j < 1000; ++j)
+      v.push_back(j);
+  }
+}
+
+struct block
+{
+  char data[64];
+};
+
+// Passes blocks from a producer to a consumer in groups of 256, so that the queue itself is
+//  no bottleneck.
+template <typename Alloc>
+struct block_queue
+{
+  typedef typename Alloc::template rebind<block>::other block_allocator;
+  typedef std::vector<block *> group;
+
+  boost::mutex mutex;
+  boost::condition_variable cond;
+  std::list<group> groups;
+  bool done;
+
+  block_queue() : done(false) { }
+
+  void produce()
+  {
+    group g;
+    for (unsigned long i = 0; i < operations; ++i)
+    {
+      g.push_back(block_allocator::allocate(1));
+      if (g.size() == 256 || i + 1 == operations)
+      {
+        boost::mutex::scoped_lock lock(mutex);
+        groups.push_back(group());
+        groups.back().swap(g);
+        cond.notify_one();
+      }
+    }
+    boost::mutex::scoped_lock lock(mutex);
+    done = true;
+    cond.notify_one();
+  }
+
+  void consume()
+  {
+    for (;;)
+    {
+      group g;
+      {
+        boost::mutex::scoped_lock lock(mutex);
+        while (groups.empty() && !done)
+          cond.wait(lock);
+        if (groups.empty())
+          return;
+        g.swap(groups.front());
+        groups.pop_front();
+      }
+      for (std::size_t i = 0; i < g.size(); ++i)
+        block_allocator::deallocate(g[i], 1);
+    }
+  }
+};
+
+// Returns the wall clock time of running the workload in the given number of threads.
+template <typename Alloc>
+double run(const char * const workload, const int threads)
+{
+  boost::thread_group group;
+  std::vector<block_queue<Alloc> *> queues;
+
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+  for (int i = 0; i < threads; ++i)
+  {
+    if (workload[0] == 'l')
+      group.create_thread(&list_thread<Alloc>);
+    else if (workload[0] == 'v')
+      group.create_thread(&vector_thread<Alloc>);
+    else if (i % 2 == 0)
+    {
+      queues.push_back(new block_queue<Alloc>());
+      group.create_thread(boost::bind(&block_queue<Alloc>::produce, queues.back()));
+      group.create_thread(boost::bind(&block_queue<Alloc>::consume, queues.back()));
+    }
+  }
+  group.join_all();
+  boost::posix_time::ptime stop = boost::posix_time::microsec_clock::universal_time();
+
+  for (std::size_t i = 0; i < queues.size(); ++i)
+    delete queues[i];
+  return (stop - start).total_microseconds() / 1000000.0;
+}
+
+int main(int argc, char * argv[])
+{
+  const int max_threads = argc > 1 ? std::atoi(argv[1]) : 4;
+  if (argc > 2)
+    operations = std::atol(argv[2]);
+
+  const char * const workloads[] = { "list", "vector", "queue" };
+  for (int w = 0; w < 3; ++w)
+  {
+    std::printf("%s (seconds)\n%8s %16s %16s %16s %16s\n", workloads[w],
+        "threads", "malloc", "pool_alloc", "fast_pool_alloc", "caching_pool");
+    for (int threads = (w == 2 ? 2 : 1); threads <= max_threads; threads *= 2)
+    {
+      std::printf("%8d %16.3f %16.3f %16.3f %16.3f\n", threads,
+          run<malloc_allocator<int> >(workloads[w], threads),
+          run<boost::pool_allocator<int> >(workloads[w], threads),
+          run<boost::fast_pool_allocator<int> >(workloads[w], threads),
+          run<boost::caching_pool_allocator<int> >(workloads[w], threads));
+    }
+  }
+  return 0;
+}
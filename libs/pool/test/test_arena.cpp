@@ -0,0 +1,196 @@
+/* Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <boost/pool/arena.hpp>
+
+#include <boost/detail/lightweight_test.hpp>
+
+#include <limits>
+#include <list>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "track_allocator.hpp"
+
+// Records the order in which objects are destroyed.
+std::vector<int> destroyed;
+
+struct tracked
+{
+    explicit tracked(int i = 0, bool throw_except = false) : id(i)
+    {
+        if (throw_except)
+            throw std::logic_error("Arbitrary exception");
+    }
+    ~tracked() { destroyed.push_back(id); }
+
+    int id;
+};
+
+struct aligned_pair
+{
+    double d;
+    char c;
+};
+
+void test_malloc()
+{
+    boost::arena<> a(256);
+    char * const p1 = static_cast<char *>((a.malloc)(10));
+    char * const p2 = static_cast<char *>((a.malloc)(10, 1));
+    BOOST_TEST(p1 != 0);
+    BOOST_TEST(reinterpret_cast<std::size_t>(p1) % boost::arena<>::default_alignment == 0);
+    // bump allocation: consecutive requests are adjacent
+    BOOST_TEST(p2 == p1 + 10);
+
+    char * const p3 = static_cast<char *>((a.malloc)(8, 64));
+    BOOST_TEST(reinterpret_cast<std::size_t>(p3) % 64 == 0);
+
+    // larger than a block
+    char * const big = static_cast<char *>((a.malloc)(100000));
+    BOOST_TEST(big != 0);
+    big[0] = big[99999] = 'x';
+
+    // sizes that would overflow with the block overhead fail cleanly
+    const std::size_t huge = (std::numeric_limits<std::size_t>::max)();
+    BOOST_TEST((a.malloc)(huge) == 0);
+    BOOST_TEST((a.malloc)(huge - 8, 64) == 0);
+    BOOST_TEST((a.malloc)(10) != 0);
+
+    BOOST_TEST(a.purge_memory());
+    BOOST_TEST(!a.purge_memory());
+}
+
+void test_construct()
+{
+    destroyed.clear();
+    {
+        boost::arena<> a(64);
+        for (int i = 0; i < 100; ++i)
+        {
+            tracked * const t = a.construct<tracked>(i);
+            BOOST_TEST_EQ(t->id, i);
+        }
+
+        std::string * const s = a.construct<std::string>("request");
+        BOOST_TEST_EQ(*s, "request");
+
+        aligned_pair * const p = a.construct<aligned_pair>();
+        BOOST_TEST(reinterpret_cast<std::size_t>(p) % boost::alignment_of<aligned_pair>::value == 0);
+
+        BOOST_TEST(destroyed.empty());
+    }
+
+    // destroyed in reverse order of construction
+    BOOST_TEST_EQ(destroyed.size(), 100u);
+    for (int i = 0; i < 100; ++i)
+        BOOST_TEST_EQ(destroyed[i], 99 - i);
+}
+
+void test_constructor_throws()
+{
+    destroyed.clear();
+    {
+        boost::arena<> a;
+        a.construct<tracked>(1);
+        try
+        {
+            a.construct<tracked>(2, true);
+            BOOST_ERROR("construct should have thrown");
+        }
+        catch (const std::logic_error &)
+        {
+        }
+        a.construct<tracked>(3);
+    }
+
+    // the object whose constructor has thrown is not destroyed
+    BOOST_TEST_EQ(destroyed.size(), 2u);
+    BOOST_TEST_EQ(destroyed[0], 3);
+    BOOST_TEST_EQ(destroyed[1], 1);
+}
+
+void test_clear()
+{
+    destroyed.clear();
+    boost::arena<> a(128);
+
+    // the first rounds grow the arena until the largest block holds a whole round,
+    //  which the following rounds reuse
+    char * first = 0;
+    for (int round = 0; round < 4; ++round)
+    {
+        for (int i = 0; i < 50; ++i)
+            a.construct<tracked>(i);
+        char * const p = static_cast<char *>((a.malloc)(1));
+        if (round == 2)
+            first = p;
+        else if (round == 3)
+            BOOST_TEST(p == first);
+        a.clear();
+        BOOST_TEST_EQ(destroyed.size(), 50u * (round + 1));
+    }
+}
+
+void test_user_allocator()
+{
+    {
+        boost::arena<track_allocator> a(100);
+        for (int i = 0; i < 1000; ++i)
+            a.construct<tracked>(i);
+        BOOST_TEST(track_allocator::allocated_blocks.size() > 1);
+
+        a.clear();
+        BOOST_TEST_EQ(track_allocator::allocated_blocks.size(), 1u);
+    }
+    BOOST_TEST(track_allocator::ok());
+}
+
+void test_allocator()
+{
+    boost::arena<> a;
+    {
+        boost::arena_allocator<int> alloc(a);
+        std::vector<int, boost::arena_allocator<int> > v(alloc);
+        for (int i = 0; i < 1000; ++i)
+            v.push_back(i);
+        BOOST_TEST_EQ(v[999], 999);
+
+        std::list<int, boost::arena_allocator<int> > l(v.begin(), v.end(), alloc);
+        BOOST_TEST_EQ(l.size(), 1000u);
+
+        boost::arena_allocator<void>::rebind<char>::other c(alloc);
+        BOOST_TEST(&c.get_arena() == &a);
+        BOOST_TEST(boost::arena_allocator<int>(c) == alloc);
+
+        boost::arena<> other;
+        BOOST_TEST(boost::arena_allocator<int>(other) != alloc);
+
+        bool thrown = false;
+        try
+        {
+            c.allocate(c.max_size());
+        }
+        catch (const std::bad_alloc &)
+        {
+            thrown = true;
+        }
+        BOOST_TEST(thrown);
+    }
+    BOOST_TEST(a.purge_memory());
+}
+
+int main()
+{
+    test_malloc();
+    test_construct();
+    test_constructor_throws();
+    test_clear();
+    test_user_allocator();
+    test_allocator();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,186 @@
+/* Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <boost/pool/pool_alloc.hpp>
+#include <boost/thread.hpp>
+
+#include <boost/detail/lightweight_test.hpp>
+
+#include <deque>
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+
+typedef boost::details::pool::size_classes size_classes;
+
+struct test_tag { };
+typedef boost::caching_pool<test_tag> test_pool;
+
+struct single_threaded_tag { };
+typedef boost::caching_pool<single_threaded_tag, boost::default_user_allocator_new_delete,
+    boost::details::pool::null_mutex, 1, 4> single_threaded_pool;
+
+void test_size_classes()
+{
+    BOOST_TEST(size_classes::size(size_classes::count - 1) == size_classes::max_size);
+    for (std::size_t bytes = 1; bytes <= size_classes::max_size; ++bytes)
+    {
+        const std::size_t index = size_classes::index(bytes);
+        BOOST_TEST(index < size_classes::count);
+        BOOST_TEST(size_classes::size(index) >= bytes);
+        BOOST_TEST(index == 0 || size_classes::size(index - 1) < bytes);
+        BOOST_TEST(size_classes::size(index) % 16 == 0);
+    }
+}
+
+template <typename Pool>
+void test_malloc_free(const std::size_t bytes)
+{
+    // several times the capacity of a cache, so that batches are exchanged with the shared pool
+    std::set<char *> chunks;
+    for (int i = 0; i < 1000; ++i)
+    {
+        char * const p = static_cast<char *>((Pool::malloc)(bytes));
+        BOOST_TEST(p != 0);
+        BOOST_TEST(reinterpret_cast<std::size_t>(p) % (bytes < 16 ? 8 : 16) == 0);
+        BOOST_TEST(chunks.insert(p).second);
+        p[0] = p[bytes - 1] = 'x';
+    }
+
+    if (bytes <= size_classes::max_size)
+        BOOST_TEST(Pool::is_from(*chunks.begin(), bytes));
+    else
+        BOOST_TEST(!Pool::is_from(*chunks.begin(), bytes));
+
+    for (std::set<char *>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+        (Pool::free)(*it, bytes);
+
+    // freed chunks are reused
+    std::set<char *> reused;
+    for (int i = 0; i < 1000; ++i)
+        reused.insert(static_cast<char *>((Pool::malloc)(bytes)));
+    if (bytes <= size_classes::max_size)
+    {
+        std::size_t count = 0;
+        for (std::set<char *>::iterator it = reused.begin(); it != reused.end(); ++it)
+            count += chunks.count(*it);
+        BOOST_TEST_EQ(count, reused.size());
+    }
+    for (std::set<char *>::iterator it = reused.begin(); it != reused.end(); ++it)
+        (Pool::free)(*it, bytes);
+}
+
+void test_containers()
+{
+    std::vector<int, boost::caching_pool_allocator<int> > v;
+    for (int i = 0; i < 10000; ++i)
+        v.push_back(i);
+    for (int i = 0; i < 10000; ++i)
+        BOOST_TEST_EQ(v[i], i);
+
+    std::list<int, boost::caching_pool_allocator<int> > l(v.begin(), v.end());
+    BOOST_TEST_EQ(l.size(), 10000u);
+
+    std::map<int, int, std::less<int>, boost::caching_pool_allocator<std::pair<const int, int> > > m;
+    for (int i = 0; i < 1000; ++i)
+        m[i] = i;
+    BOOST_TEST_EQ(m.size(), 1000u);
+
+    boost::caching_pool_allocator<void>::rebind<int>::other a;
+    BOOST_TEST(a == boost::caching_pool_allocator<int>(boost::caching_pool_allocator<char>()));
+}
+
+// A producer allocates chunks, which a consumer frees, so that chunks move between caches.
+struct producer_consumer
+{
+    boost::mutex mutex;
+    std::deque<int *> queue;
+    bool done;
+
+    producer_consumer() : done(false) { }
+
+    void produce()
+    {
+        for (int i = 0; i < 100000; ++i)
+        {
+            int * const p = boost::caching_pool_allocator<int>::allocate(i % 64 + 1);
+            *p = i;
+            boost::mutex::scoped_lock lock(mutex);
+            queue.push_back(p);
+        }
+        boost::mutex::scoped_lock lock(mutex);
+        done = true;
+    }
+
+    void consume()
+    {
+        int expected = 0;
+        for (;;)
+        {
+            int * p;
+            {
+                boost::mutex::scoped_lock lock(mutex);
+                if (queue.empty())
+                {
+                    if (done)
+                        break;
+                    continue;
+                }
+                p = queue.front();
+                queue.pop_front();
+            }
+            BOOST_TEST_EQ(*p, expected);
+            boost::caching_pool_allocator<int>::deallocate(p, expected % 64 + 1);
+            ++expected;
+        }
+        BOOST_TEST_EQ(expected, 100000);
+    }
+};
+
+void run_container_thread()
+{
+    for (int round = 0; round < 20; ++round)
+    {
+        std::list<int, boost::caching_pool_allocator<int> > l;
+        std::vector<int, boost::caching_pool_allocator<int> > v;
+        for (int i = 0; i < 1000; ++i)
+        {
+            l.push_back(i);
+            v.push_back(i);
+        }
+        BOOST_TEST_EQ(l.size(), v.size());
+    }
+}
+
+void test_threads()
+{
+    producer_consumer pc;
+    boost::thread_group threads;
+    threads.create_thread(boost::bind(&producer_consumer::produce, &pc));
+    threads.create_thread(boost::bind(&producer_consumer::consume, &pc));
+    for (int i = 0; i < 4; ++i)
+        threads.create_thread(&run_container_thread);
+    threads.join_all();
+}
+
+int main()
+{
+    test_size_classes();
+
+    const std::size_t sizes[] = { 1, 8, 16, 17, 100, 128, 129, 1000, 4096, 4097, 100000 };
+    for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        test_malloc_free<test_pool>(sizes[i]);
+        test_malloc_free<single_threaded_pool>(sizes[i]);
+    }
+
+    test_containers();
+    test_threads();
+
+    test_pool::release_caches();
+    BOOST_TEST(test_pool::purge_memory());
+
+    return boost::report_errors();
+}
@@ -26,6 +26,8 @@
 #include <boost/pool/object_pool.hpp>
 #include <boost/pool/pool_alloc.hpp>
 #include <boost/pool/singleton_pool.hpp>
+#include <boost/pool/caching_pool.hpp>
+#include <boost/pool/arena.hpp>
 
 template class boost::object_pool<int, boost::default_user_allocator_new_delete>;
 template class boost::object_pool<int, boost::default_user_allocator_malloc_free>;
@@ -37,7 +39,13 @@ template class boost::pool_allocator<int, boost::default_user_allocator_new_dele
 template class boost::pool_allocator<int, boost::default_user_allocator_malloc_free>;
 template class boost::fast_pool_allocator<int, boost::default_user_allocator_new_delete>;
 template class boost::fast_pool_allocator<int, boost::default_user_allocator_malloc_free>;
+template class boost::caching_pool_allocator<int, boost::default_user_allocator_new_delete>;
+template class boost::caching_pool_allocator<int, boost::default_user_allocator_malloc_free>;
 
 template class boost::simple_segregated_storage<unsigned>;
 
 template class boost::singleton_pool<int, 32>;
+template class boost::caching_pool<int>;
+template class boost::arena<boost::default_user_allocator_new_delete>;
+template class boost::arena<boost::default_user_allocator_malloc_free>;
+template class boost::arena_allocator<int>;
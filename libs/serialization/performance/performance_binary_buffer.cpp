@@ -0,0 +1,164 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// performance_binary_buffer.cpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// compare binary_oarchive/binary_iarchive over a stringstream with
+// binary_buffer_oarchive/binary_buffer_iarchive over a std::vector<char>
+// for a batch of small messages, each serialized field by field.
+//
+// usage: performance_binary_buffer [number of messages]
+
+#include <cstddef> // size_t
+#include <cstdio>
+#include <cstdlib> // atoi
+#include <ctime>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#if defined(BOOST_NO_STDC_NAMESPACE)
+namespace std{
+    using ::atoi;
+    using ::clock;
+    using ::clock_t;
+    using ::printf;
+    using ::size_t;
+}
+#endif
+
+#include "../test/test_tools.hpp"
+
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_buffer_oarchive.hpp>
+#include <boost/archive/binary_buffer_iarchive.hpp>
+
+struct message
+{
+    boost::int64_t m_id;
+    int m_kind;
+    double m_price;
+    unsigned long m_quantity;
+    bool m_urgent;
+    std::string m_symbol;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int /* file_version */){
+        ar & m_id;
+        ar & m_kind;
+        ar & m_price;
+        ar & m_quantity;
+        ar & m_urgent;
+        ar & m_symbol;
+    }
+    bool operator==(const message & rhs) const {
+        return m_id == rhs.m_id
+            && m_kind == rhs.m_kind
+            && m_price == rhs.m_price
+            && m_quantity == rhs.m_quantity
+            && m_urgent == rhs.m_urgent
+            && m_symbol == rhs.m_symbol;
+    }
+};
+
+// no class information and no tracking, as is usual for value types
+// stored in large numbers
+BOOST_CLASS_IMPLEMENTATION(message, boost::serialization::object_serializable)
+BOOST_CLASS_TRACKING(message, boost::serialization::track_never)
+
+double
+seconds(std::clock_t start){
+    return static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+}
+
+void
+report(const char * what, double stream_time, double buffer_time, std::size_t bytes){
+    std::printf(
+        "%-6s streambuf %8.3f s %8.1f MB/s   buffer %8.3f s %8.1f MB/s   x%.2f\n",
+        what,
+        stream_time, bytes / stream_time / 1e6,
+        buffer_time, bytes / buffer_time / 1e6,
+        stream_time / buffer_time
+    );
+}
+
+int
+test_main( int argc, char* argv[] )
+{
+    const std::size_t count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    std::vector<message> batch(count);
+    for(std::size_t i = 0; i < count; ++i){
+        message & m = batch[i];
+        m.m_id = i;
+        m.m_kind = static_cast<int>(i % 7);
+        m.m_price = i * 0.25;
+        m.m_quantity = static_cast<unsigned long>(i % 1000);
+        m.m_urgent = (0 == i % 3);
+        m.m_symbol = (0 == i % 2) ? "BOOST" : "SER";
+    }
+
+    std::clock_t start = std::clock();
+    std::ostringstream os;
+    {
+        boost::archive::binary_oarchive oa(os);
+        oa << batch;
+    }
+    const std::string streamed = os.str();
+    const double stream_save = seconds(start);
+
+    start = std::clock();
+    std::vector<char> buffer;
+    {
+        boost::archive::binary_buffer_oarchive oa(buffer);
+        oa << batch;
+    }
+    const double buffer_save = seconds(start);
+    BOOST_CHECK(streamed == std::string(buffer.begin(), buffer.end()));
+
+    // again into the same vector, which keeps its capacity. Sending
+    // batches one after the other, this is the usual case.
+    buffer.clear();
+    start = std::clock();
+    {
+        boost::archive::binary_buffer_oarchive oa(buffer);
+        oa << batch;
+    }
+    const double buffer_resave = seconds(start);
+    BOOST_CHECK(streamed == std::string(buffer.begin(), buffer.end()));
+
+    start = std::clock();
+    std::vector<message> streamed_batch;
+    {
+        std::istringstream is(streamed);
+        boost::archive::binary_iarchive ia(is);
+        ia >> streamed_batch;
+    }
+    const double stream_load = seconds(start);
+
+    start = std::clock();
+    std::vector<message> buffered_batch;
+    {
+        boost::archive::binary_buffer_iarchive ia(buffer);
+        ia >> buffered_batch;
+    }
+    const double buffer_load = seconds(start);
+    BOOST_CHECK(batch == streamed_batch);
+    BOOST_CHECK(batch == buffered_batch);
+
+    std::printf("%u messages, %u bytes\n",
+        static_cast<unsigned int>(count),
+        static_cast<unsigned int>(buffer.size())
+    );
+    report("save", stream_save, buffer_save, buffer.size());
+    report("resave", stream_save, buffer_resave, buffer.size());
+    report("load", stream_load, buffer_load, buffer.size());
+    return EXIT_SUCCESS;
+}
+
+// EOF
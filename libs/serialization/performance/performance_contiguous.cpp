@@ -0,0 +1,174 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// performance_contiguous.cpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// measure the block copy of contiguous containers of a plain struct
+// against saving and loading the same struct member by member.  The two
+// structs below differ only in that the second is marked bitwise
+// serializable.
+//
+// usage: performance_contiguous [number of elements]
+
+#include <algorithm> // std::min
+#include <cstddef> // size_t
+#include <cstdio>
+#include <cstdlib> // atoi
+#include <ctime>
+#include <vector>
+
+#include <boost/config.hpp>
+#if defined(BOOST_NO_STDC_NAMESPACE)
+namespace std{
+    using ::atoi;
+    using ::clock;
+    using ::clock_t;
+    using ::printf;
+    using ::size_t;
+}
+#endif
+
+#include "../test/test_tools.hpp"
+
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/container_vector.hpp>
+#include <boost/serialization/multi_array.hpp>
+#include <boost/serialization/is_bitwise_serializable.hpp>
+
+#include <boost/archive/binary_buffer_oarchive.hpp>
+#include <boost/archive/binary_buffer_iarchive.hpp>
+
+template<int Tag>
+struct point
+{
+    double m_x;
+    double m_y;
+    double m_z;
+    int m_id;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int /* file_version */){
+        ar & m_x;
+        ar & m_y;
+        ar & m_z;
+        ar & m_id;
+    }
+    bool operator==(const point & rhs) const {
+        return m_x == rhs.m_x
+            && m_y == rhs.m_y
+            && m_z == rhs.m_z
+            && m_id == rhs.m_id;
+    }
+};
+
+typedef point<0> member_point;
+typedef point<1> bitwise_point;
+
+BOOST_CLASS_IMPLEMENTATION(member_point, boost::serialization::object_serializable)
+BOOST_CLASS_TRACKING(member_point, boost::serialization::track_never)
+BOOST_CLASS_IMPLEMENTATION(bitwise_point, boost::serialization::object_serializable)
+BOOST_CLASS_TRACKING(bitwise_point, boost::serialization::track_never)
+BOOST_IS_BITWISE_SERIALIZABLE(bitwise_point)
+
+double
+seconds(std::clock_t start){
+    return static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+}
+
+// save and load t a few times over, returning the best times.  The
+// buffer and t1 are reused so that allocation doesn't hide the cost
+// of the serialization itself.
+template<class T>
+void
+round_trip(const T & t, T & t1, double & save_time, double & load_time){
+    std::vector<char> buffer;
+    save_time = load_time = 1e9;
+    for(int i = 0; i < 5; ++i){
+        buffer.clear();
+        std::clock_t start = std::clock();
+        {
+            boost::archive::binary_buffer_oarchive oa(buffer);
+            oa << t;
+        }
+        save_time = (std::min)(save_time, seconds(start));
+        start = std::clock();
+        {
+            boost::archive::binary_buffer_iarchive ia(buffer);
+            ia >> t1;
+        }
+        load_time = (std::min)(load_time, seconds(start));
+    }
+}
+
+template<class Point>
+void
+fill(Point * p, std::size_t count){
+    for(std::size_t i = 0; i < count; ++i){
+        p[i].m_x = i * 0.5;
+        p[i].m_y = i * 0.25;
+        p[i].m_z = i * 0.125;
+        p[i].m_id = static_cast<int>(i);
+    }
+}
+
+void
+report(
+    const char * what,
+    double member_save, double member_load,
+    double bitwise_save, double bitwise_load
+){
+    std::printf(
+        "%-24s save %7.3f s -> %7.3f s x%6.2f   load %7.3f s -> %7.3f s x%6.2f\n",
+        what,
+        member_save, bitwise_save, member_save / bitwise_save,
+        member_load, bitwise_load, member_load / bitwise_load
+    );
+}
+
+template<class Member, class Bitwise>
+void
+compare(const char * what, Member & m, Bitwise & b){
+    Member m1(m);
+    Bitwise b1(b);
+    double ms, ml, bs, bl;
+    round_trip(m, m1, ms, ml);
+    round_trip(b, b1, bs, bl);
+    BOOST_CHECK(m == m1);
+    BOOST_CHECK(b == b1);
+    report(what, ms, ml, bs, bl);
+}
+
+int
+test_main( int argc, char* argv[] )
+{
+    const std::size_t count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    std::printf("%u elements of %u bytes, member by member -> block\n",
+        static_cast<unsigned int>(count),
+        static_cast<unsigned int>(sizeof(bitwise_point))
+    );
+    {
+        std::vector<member_point> m(count);
+        std::vector<bitwise_point> b(count);
+        fill(& m[0], count);
+        fill(& b[0], count);
+        compare("std::vector", m, b);
+    }
+    {
+        boost::container::vector<member_point> m(count);
+        boost::container::vector<bitwise_point> b(count);
+        fill(& m[0], count);
+        fill(& b[0], count);
+        compare("boost::container::vector", m, b);
+    }
+    {
+        boost::multi_array<member_point, 2> m(boost::extents[count / 100][100]);
+        boost::multi_array<bitwise_point, 2> b(boost::extents[count / 100][100]);
+        fill(m.data(), m.num_elements());
+        fill(b.data(), b.num_elements());
+        compare("boost::multi_array", m, b);
+    }
+    return EXIT_SUCCESS;
+}
+
+// EOF
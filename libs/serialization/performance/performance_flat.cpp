@@ -0,0 +1,179 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// performance_flat.cpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// compare reading a few fields of a large archive by loading it with
+// binary_iarchive against reading them in place from a memory mapped
+// flat_oarchive file with flat_view.
+//
+// usage: performance_flat [number of records]
+
+#include <cstddef> // size_t, NULL
+#include <cstdio>
+#include <cstdlib> // atoi
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#if defined(BOOST_NO_STDC_NAMESPACE)
+namespace std{
+    using ::atoi;
+    using ::clock;
+    using ::clock_t;
+    using ::printf;
+    using ::remove;
+    using ::size_t;
+}
+#endif
+
+#include "../test/test_tools.hpp"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/flat_oarchive.hpp>
+#include <boost/archive/flat_view.hpp>
+
+struct record
+{
+    int m_id;
+    double m_price;
+    std::string m_symbol;
+    std::vector<double> m_history;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int /* file_version */){
+        ar & boost::serialization::make_nvp("id", m_id);
+        ar & boost::serialization::make_nvp("price", m_price);
+        ar & boost::serialization::make_nvp("symbol", m_symbol);
+        ar & boost::serialization::make_nvp("history", m_history);
+    }
+};
+
+double
+seconds(std::clock_t start){
+    return static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+}
+
+int
+test_main( int argc, char* argv[] )
+{
+    const std::size_t count = argc > 1 ? std::atoi(argv[1]) : 200000;
+    std::vector<record> records(count);
+    for(std::size_t i = 0; i < count; ++i){
+        record & r = records[i];
+        r.m_id = static_cast<int>(i);
+        r.m_price = i * 0.25;
+        r.m_symbol = (0 == i % 2) ? "BOOST" : "SERIALIZATION";
+        r.m_history.assign(16, i * 0.5);
+    }
+    const std::size_t wanted = count / 2;
+    double expected_sum = 0;
+    for(std::size_t i = 0; i < count; ++i)
+        expected_sum += records[i].m_price;
+
+    // tmpnam may return the same name each time
+    BOOST_REQUIRE(NULL != boost::archive::tmpnam(NULL));
+    const std::string binary_name
+        = std::string(boost::archive::tmpnam(NULL)) + ".binary";
+    const char * binary_file = binary_name.c_str();
+    {
+        std::ofstream os(binary_file, std::ios::binary);
+        boost::archive::binary_oarchive oa(os);
+        oa << records;
+    }
+    const std::string flat_name
+        = std::string(boost::archive::tmpnam(NULL)) + ".flat";
+    const char * flat_file = flat_name.c_str();
+    {
+        std::ofstream os(flat_file, std::ios::binary);
+        boost::archive::flat_oarchive oa(os);
+        oa << boost::serialization::make_nvp("records", records);
+    }
+
+    // one field of one record
+    std::clock_t start = std::clock();
+    double binary_one;
+    {
+        std::vector<record> loaded;
+        std::ifstream is(binary_file, std::ios::binary);
+        boost::archive::binary_iarchive ia(is);
+        ia >> loaded;
+        binary_one = loaded[wanted].m_price;
+    }
+    const double binary_one_time = seconds(start);
+
+    start = std::clock();
+    double flat_one;
+    {
+        boost::interprocess::file_mapping f(
+            flat_file, boost::interprocess::read_only
+        );
+        boost::interprocess::mapped_region m(f, boost::interprocess::read_only);
+        boost::archive::flat_view v(m.get_address(), m.get_size());
+        const boost::archive::flat_table root = v.root();
+        const boost::archive::flat_table r
+            = root.object(root.find("records")).object(wanted);
+        flat_one = r.value<double>(r.find("price"));
+    }
+    const double flat_one_time = seconds(start);
+    BOOST_CHECK(records[wanted].m_price == binary_one);
+    BOOST_CHECK(records[wanted].m_price == flat_one);
+
+    // one field of every record
+    start = std::clock();
+    double binary_sum = 0;
+    {
+        std::vector<record> loaded;
+        std::ifstream is(binary_file, std::ios::binary);
+        boost::archive::binary_iarchive ia(is);
+        ia >> loaded;
+        for(std::size_t i = 0; i < loaded.size(); ++i)
+            binary_sum += loaded[i].m_price;
+    }
+    const double binary_sum_time = seconds(start);
+
+    start = std::clock();
+    double flat_sum = 0;
+    {
+        boost::interprocess::file_mapping f(
+            flat_file, boost::interprocess::read_only
+        );
+        boost::interprocess::mapped_region m(f, boost::interprocess::read_only);
+        boost::archive::flat_view v(m.get_address(), m.get_size());
+        const boost::archive::flat_table root = v.root();
+        const boost::archive::flat_table rs = root.object(root.find("records"));
+        // every record has the same layout, so look the field up once
+        const std::size_t price = rs.object(0).find("price");
+        for(std::size_t i = 0; i < rs.size(); ++i)
+            flat_sum += rs.object(i).value<double>(price);
+    }
+    const double flat_sum_time = seconds(start);
+    BOOST_CHECK(expected_sum == binary_sum);
+    BOOST_CHECK(expected_sum == flat_sum);
+
+    std::printf("%u records\n", static_cast<unsigned int>(count));
+    std::printf("%-12s binary_iarchive %8.4f s   flat_view %8.4f s   x%.1f\n",
+        "one field", binary_one_time, flat_one_time,
+        binary_one_time / flat_one_time
+    );
+    std::printf("%-12s binary_iarchive %8.4f s   flat_view %8.4f s   x%.1f\n",
+        "every record", binary_sum_time, flat_sum_time,
+        binary_sum_time / flat_sum_time
+    );
+    std::remove(binary_file);
+    std::remove(flat_file);
+    return EXIT_SUCCESS;
+}
+
+// EOF
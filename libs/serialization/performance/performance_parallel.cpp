@@ -0,0 +1,153 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// performance_parallel.cpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// measure saving and loading a large vector of untracked records with
+// make_parallel_vector on increasing numbers of threads, against saving
+// and loading it in the usual way.  Times are elapsed rather than
+// processor time.
+//
+// usage: performance_parallel [number of records] [maximum threads]
+//
+// each record is about 200 bytes, so 10000000 records make a snapshot
+// of about 2GB.
+
+#include <algorithm> // std::min
+#include <cstddef> // size_t
+#include <cstdio>
+#include <cstdlib> // atoi
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#if defined(BOOST_NO_STDC_NAMESPACE)
+namespace std{
+    using ::atoi;
+    using ::printf;
+    using ::size_t;
+}
+#endif
+
+#include "../test/test_tools.hpp"
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/parallel_vector.hpp>
+
+#include <boost/archive/binary_buffer_oarchive.hpp>
+#include <boost/archive/binary_buffer_iarchive.hpp>
+
+struct record
+{
+    int m_id;
+    double m_position[3];
+    std::string m_name;
+    std::vector<float> m_samples;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int /* file_version */){
+        ar & m_id;
+        ar & m_position;
+        ar & m_name;
+        ar & m_samples;
+    }
+    bool operator==(const record & rhs) const {
+        return m_id == rhs.m_id
+            && m_name == rhs.m_name
+            && m_samples == rhs.m_samples;
+    }
+};
+
+BOOST_CLASS_IMPLEMENTATION(record, boost::serialization::object_serializable)
+BOOST_CLASS_TRACKING(record, boost::serialization::track_never)
+
+double
+seconds(const boost::posix_time::ptime & start){
+    return (boost::posix_time::microsec_clock::universal_time() - start)
+        .total_microseconds() / 1e6;
+}
+
+// save and load v a few times over with the given number of threads, or
+// in the usual way if that is zero, returning the best times
+void
+round_trip(
+    const std::vector<record> & v,
+    std::size_t threads,
+    std::vector<char> & buffer,
+    double & save_time,
+    double & load_time
+){
+    save_time = load_time = 1e9;
+    for(int i = 0; i < 3; ++i){
+        // each snapshot is written to fresh memory, as the chunks are
+        std::vector<char>().swap(buffer);
+        boost::posix_time::ptime start
+            = boost::posix_time::microsec_clock::universal_time();
+        {
+            boost::archive::binary_buffer_oarchive oa(buffer);
+            if(0 == threads)
+                oa << v;
+            else
+                oa << boost::serialization::make_parallel_vector(v, threads);
+        }
+        save_time = (std::min)(save_time, seconds(start));
+        std::vector<record> v1;
+        start = boost::posix_time::microsec_clock::universal_time();
+        {
+            boost::archive::binary_buffer_iarchive ia(buffer);
+            if(0 == threads)
+                ia >> v1;
+            else
+                ia >> boost::serialization::make_parallel_vector(v1, threads);
+        }
+        load_time = (std::min)(load_time, seconds(start));
+        BOOST_CHECK(v == v1);
+    }
+}
+
+int
+test_main( int argc, char* argv[] )
+{
+    const std::size_t count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const std::size_t max_threads = argc > 2
+        ? std::atoi(argv[2])
+        : boost::serialization::parallel_detail::default_threads();
+
+    std::vector<record> v(count);
+    for(std::size_t i = 0; i < count; ++i){
+        record & r = v[i];
+        r.m_id = static_cast<int>(i);
+        r.m_position[0] = i * 0.5;
+        r.m_position[1] = i * 0.25;
+        r.m_position[2] = i * 0.125;
+        r.m_name = "record " + std::string(i % 32, 'x');
+        r.m_samples.assign(32, static_cast<float>(i));
+    }
+
+    std::vector<char> buffer;
+    double serial_save, serial_load;
+    round_trip(v, 0, buffer, serial_save, serial_load);
+    std::printf("%u records, %u MB\n",
+        static_cast<unsigned int>(count),
+        static_cast<unsigned int>(buffer.size() >> 20)
+    );
+    std::printf("serial     save %7.3f s             load %7.3f s\n",
+        serial_save, serial_load
+    );
+    for(std::size_t threads = 1; threads <= max_threads; threads *= 2){
+        double save_time, load_time;
+        round_trip(v, threads, buffer, save_time, load_time);
+        std::printf(
+            "%2u threads save %7.3f s x%5.2f   load %7.3f s x%5.2f\n",
+            static_cast<unsigned int>(threads),
+            save_time, serial_save / save_time,
+            load_time, serial_load / load_time
+        );
+    }
+    return EXIT_SUCCESS;
+}
+
+// EOF
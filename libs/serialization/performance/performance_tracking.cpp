@@ -0,0 +1,142 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// performance_tracking.cpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// measure the cost of object tracking when saving a large graph of
+// objects linked by shared_ptr, and of a vector of the same objects
+// saved directly - which are tracked too, since the class is also
+// serialized through pointers.  Each is saved as is, after a call to
+// reserve_tracked_objects and with the track_pointers_only flag.
+//
+// usage: performance_tracking [number of objects]
+
+#include <algorithm> // std::min
+#include <cstddef> // size_t
+#include <cstdio>
+#include <cstdlib> // atoi
+#include <ctime>
+#include <vector>
+
+#include <boost/config.hpp>
+#if defined(BOOST_NO_STDC_NAMESPACE)
+namespace std{
+    using ::atoi;
+    using ::clock;
+    using ::clock_t;
+    using ::printf;
+    using ::size_t;
+}
+#endif
+
+#include "../test/test_tools.hpp"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+
+#include <boost/archive/binary_buffer_oarchive.hpp>
+#include <boost/archive/binary_buffer_iarchive.hpp>
+
+class node
+{
+    friend class boost::serialization::access;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int /* file_version */){
+        ar & m_value;
+        ar & m_links;
+    }
+public:
+    int m_value;
+    // links only to nodes created earlier, which keeps the recursion
+    // shallow when the graph is saved in order of creation
+    std::vector<boost::shared_ptr<node> > m_links;
+};
+
+typedef std::vector<boost::shared_ptr<node> > graph;
+
+double
+seconds(std::clock_t start){
+    return static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+}
+
+// the best of a few saves of t
+template<class T>
+double
+save(const T & t, unsigned int flags, std::size_t reserve, std::vector<char> & buffer){
+    double result = 1e9;
+    for(int i = 0; i < 5; ++i){
+        buffer.clear();
+        const std::clock_t start = std::clock();
+        {
+            boost::archive::binary_buffer_oarchive oa(buffer, flags);
+            if(0 < reserve)
+                oa.reserve_tracked_objects(reserve);
+            oa << t;
+        }
+        result = (std::min)(result, seconds(start));
+    }
+    return result;
+}
+
+template<class T>
+void
+compare(const char * what, const T & t, std::size_t count){
+    std::vector<char> buffer;
+    const double plain = save(t, 0, 0, buffer);
+    const double reserved = save(t, 0, count, buffer);
+    const double pointers_only = save(
+        t, boost::archive::track_pointers_only, 0, buffer
+    );
+    std::printf(
+        "%-16s save %7.3f s   reserved %7.3f s   track_pointers_only %7.3f s\n",
+        what, plain, reserved, pointers_only
+    );
+}
+
+int
+test_main( int argc, char* argv[] )
+{
+    const std::size_t count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    std::printf("%u objects\n", static_cast<unsigned int>(count));
+
+    graph g(count);
+    unsigned int seed = 1;
+    for(std::size_t i = 0; i < count; ++i){
+        g[i].reset(new node);
+        g[i]->m_value = static_cast<int>(i);
+        for(std::size_t j = 0; 0 < i && j < 2; ++j){
+            seed = seed * 1103515245 + 12345;
+            g[i]->m_links.push_back(g[(seed >> 8) % i]);
+        }
+    }
+    compare("shared_ptr graph", g, count);
+
+    std::vector<node> nodes(count);
+    for(std::size_t i = 0; i < count; ++i)
+        nodes[i].m_value = static_cast<int>(i);
+    compare("vector of nodes", nodes, count);
+
+    // check that the graph survives the round trip
+    std::vector<char> buffer;
+    save(g, 0, count, buffer);
+    graph g1;
+    {
+        boost::archive::binary_buffer_iarchive ia(buffer);
+        ia >> g1;
+    }
+    BOOST_REQUIRE(g.size() == g1.size());
+    for(std::size_t i = 0; i < count; ++i){
+        BOOST_CHECK(g1[i]->m_value == g[i]->m_value);
+        BOOST_CHECK(g1[i]->m_links.size() == g[i]->m_links.size());
+        for(std::size_t j = 0; j < g[i]->m_links.size(); ++j)
+            BOOST_CHECK(
+                g1[i]->m_links[j] == g1[g[i]->m_links[j]->m_value]
+            );
+    }
+    return EXIT_SUCCESS;
+}
+
+// EOF
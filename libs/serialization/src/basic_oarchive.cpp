@@ -12,6 +12,8 @@
 
 #include <boost/assert.hpp>
 #include <set>
+#include <vector>
+#include <utility> // std::pair
 #include <cstddef> // NULL
 
 #include <boost/limits.hpp>
@@ -44,6 +46,69 @@ namespace boost {
 namespace archive {
 namespace detail {
 
+// open addressing hash table with linear probing.  The entries are held
+// in a single vector so that, unlike a std::set, nothing is allocated
+// for each one - which matters when an archive tracks millions of
+// objects.  An Entry is empty() only when default constructed, and
+// provides hash() and matches(). Entries are never removed.
+template<class Entry>
+class hash_table
+{
+    std::vector<Entry> m_slots; // size is zero or a power of 2
+    std::size_t m_size;
+
+    // the slot holding an entry matching e, or the empty one where it
+    // would go
+    std::size_t probe(const Entry & e) const {
+        const std::size_t mask = m_slots.size() - 1;
+        std::size_t i = e.hash() & mask;
+        while(! m_slots[i].empty() && ! m_slots[i].matches(e))
+            i = (i + 1) & mask;
+        return i;
+    }
+    void rehash(std::size_t capacity){
+        std::vector<Entry> slots(capacity);
+        m_slots.swap(slots);
+        for(std::size_t i = 0; i < slots.size(); ++i)
+            if(! slots[i].empty())
+                m_slots[probe(slots[i])] = slots[i];
+    }
+public:
+    hash_table() :
+        m_size(0)
+    {}
+    std::size_t size() const {
+        return m_size;
+    }
+    // make room for count entries without rehashing
+    void reserve(std::size_t count){
+        std::size_t capacity = 64;
+        // keep the table at most half full
+        while(capacity / 2 < count)
+            capacity *= 2;
+        if(m_slots.size() < capacity)
+            rehash(capacity);
+    }
+    // return NULL if not found
+    Entry * find(const Entry & e){
+        if(m_slots.empty())
+            return NULL;
+        Entry & slot = m_slots[probe(e)];
+        return slot.empty() ? NULL : & slot;
+    }
+    // the result is valid only until the next insertion
+    std::pair<Entry *, bool> insert(const Entry & e){
+        BOOST_ASSERT(! e.empty());
+        reserve(m_size + 1);
+        Entry & slot = m_slots[probe(e)];
+        if(! slot.empty())
+            return std::pair<Entry *, bool>(& slot, false);
+        slot = e;
+        ++m_size;
+        return std::pair<Entry *, bool>(& slot, true);
+    }
+};
+
 class basic_oarchive_impl {
     friend class basic_oarchive;
     unsigned int m_flags;
@@ -57,15 +122,20 @@ class basic_oarchive_impl {
         class_id_type class_id;
         object_id_type object_id;
 
-        bool operator<(const aobject &rhs) const
-        {
-            BOOST_ASSERT(NULL != address);
-            BOOST_ASSERT(NULL != rhs.address);
-            if( address < rhs.address )
-                return true;
-            if( address > rhs.address )
-                return false;
-            return class_id < rhs.class_id;
+        bool empty() const {
+            return NULL == address;
+        }
+        std::size_t hash() const {
+            // the low bits of an address are mostly alignment, so mix in
+            // the higher ones
+            std::size_t h = reinterpret_cast<std::size_t>(address);
+            h ^= h >> 16;
+            h *= 0x45d9f3b;
+            h ^= h >> 16;
+            return h + static_cast<int>(class_id);
+        }
+        bool matches(const aobject & rhs) const {
+            return address == rhs.address && class_id == rhs.class_id;
         }
         aobject & operator=(const aobject & rhs)
         {
@@ -85,10 +155,14 @@ class basic_oarchive_impl {
         {}
         aobject() : address(NULL){}
     };
-    // keyed on class_id, address
-    typedef std::set<aobject> object_set_type;
+    // keyed on address, class_id
+    typedef hash_table<aobject> object_set_type;
     object_set_type object_set;
 
+    // the number of object ids given out so far.  This is more than the
+    // size of the object_set when the track_pointers_only flag is used.
+    std::size_t object_count;
+
     //////////////////////////////////////////////////////////////////////
     // information about each serialized class saved
     // keyed on type_info
@@ -128,9 +202,36 @@ class basic_oarchive_impl {
     typedef std::set<cobject_type> cobject_info_set_type;
     cobject_info_set_type cobject_info_set;
 
-    // list of objects initially stored as pointers - used to detect errors
-    // keyed on object id
-    std::set<object_id_type> stored_pointers;
+    // the entries of the cobject_info_set keyed on the address of the
+    // serializer.  The set itself compares extended_type_info, which
+    // has to be used where a type may have several serializers (one per
+    // DLL), but is too slow to use for every object saved.
+    struct cobject_ref
+    {
+        const basic_oserializer * m_bos_ptr;
+        const cobject_type * m_cobject;
+        bool empty() const {
+            return NULL == m_bos_ptr;
+        }
+        std::size_t hash() const {
+            return reinterpret_cast<std::size_t>(m_bos_ptr) / sizeof(void *);
+        }
+        bool matches(const cobject_ref & rhs) const {
+            return m_bos_ptr == rhs.m_bos_ptr;
+        }
+        cobject_ref(
+            const basic_oserializer * bos_ptr = NULL,
+            const cobject_type * cobject = NULL
+        ) :
+            m_bos_ptr(bos_ptr),
+            m_cobject(cobject)
+        {}
+    };
+    hash_table<cobject_ref> cobject_refs;
+
+    // true for objects initially stored as pointers - used to detect errors
+    // indexed by object id
+    std::vector<bool> stored_pointers;
 
     // address of the most recent object serialized as a poiner
     // whose data itself is now pending serialization
@@ -139,6 +240,7 @@ class basic_oarchive_impl {
 
     basic_oarchive_impl(unsigned int flags) :
         m_flags(flags),
+        object_count(0),
         pending_object(NULL),
         pending_bos(NULL)
     {}
@@ -148,6 +250,11 @@ class basic_oarchive_impl {
     const basic_oserializer *  
     find(const serialization::extended_type_info &ti) const;
 
+    object_id_type new_object_id(){
+        stored_pointers.push_back(false);
+        return object_id_type(object_count++);
+    }
+
 //public:
     const cobject_type &
     register_type(const basic_oserializer & bos);
@@ -235,9 +342,13 @@ inline const basic_oarchive_impl::cobject_type &
 basic_oarchive_impl::register_type(
     const basic_oserializer & bos
 ){
+    const cobject_ref * ref = cobject_refs.find(cobject_ref(& bos));
+    if(NULL != ref)
+        return *(ref->m_cobject);
     cobject_type co(cobject_info_set.size(), bos);
     std::pair<cobject_info_set_type::const_iterator, bool>
         result = cobject_info_set.insert(co);
+    cobject_refs.insert(cobject_ref(& bos, & *(result.first)));
     return *(result.first);
 }
 
@@ -275,26 +386,36 @@ basic_oarchive_impl::save_object(
         return;
     }
 
-    // look for an existing object id
-    object_id_type oid(object_set.size());
     // lookup to see if this object has already been written to the archive
-    basic_oarchive_impl::aobject ao(t, co.m_class_id, oid);
-    std::pair<basic_oarchive_impl::object_set_type::const_iterator, bool>
-        aresult = object_set.insert(ao);
-    oid = aresult.first->object_id;
+    basic_oarchive_impl::aobject ao(
+        t,
+        co.m_class_id,
+        object_id_type(object_count)
+    );
+    const basic_oarchive_impl::aobject * found;
+    if(m_flags & track_pointers_only){
+        // only objects saved through pointers are added to the table
+        found = object_set.find(ao);
+    }
+    else{
+        std::pair<basic_oarchive_impl::aobject *, bool>
+            aresult = object_set.insert(ao);
+        found = aresult.second ? NULL : aresult.first;
+    }
 
     // if its a new object
-    if(aresult.second){
+    if(NULL == found){
         // write out the object id
-        ar.vsave(oid);
+        ar.vsave(new_object_id());
         ar.end_preamble();
         // and data
         (bos.save_object_data)(ar, t);
         return;
     }
 
+    const object_id_type oid = found->object_id;
     // check that it wasn't originally stored through a pointer
-    if(stored_pointers.end() != stored_pointers.find(oid)){
+    if(stored_pointers[oid]){
         // this has to be a user error.  loading such an archive
         // would create duplicate objects
         boost::serialization::throw_exception(
@@ -364,10 +485,10 @@ basic_oarchive_impl::save_pointer(
         return;
     }
 
-    object_id_type oid(object_set.size());
+    object_id_type oid(object_count);
     // lookup to see if this object has already been written to the archive
     basic_oarchive_impl::aobject ao(t, co.m_class_id, oid);
-    std::pair<basic_oarchive_impl::object_set_type::const_iterator, bool>
+    std::pair<basic_oarchive_impl::aobject *, bool>
         aresult = object_set.insert(ao);
     oid = aresult.first->object_id;
     // if the saved object already exists
@@ -379,6 +500,7 @@ basic_oarchive_impl::save_pointer(
         return;
     }
 
+    new_object_id();
     // append id of this object to preamble
     ar.vsave(oid);
     ar.end_preamble();
@@ -389,8 +511,8 @@ basic_oarchive_impl::save_pointer(
     pending_object = t;
     pending_bos = & bpos_ptr->get_basic_serializer();
     bpos_ptr->save_object_ptr(ar, t);
-    // add to the set of object initially stored through pointers
-    stored_pointers.insert(oid);
+    // mark it as an object initially stored through a pointer
+    stored_pointers[oid] = true;
 }
 
 } // namespace detail
@@ -446,6 +568,12 @@ basic_oarchive::get_flags() const{
     return pimpl->m_flags;
 }
 
+BOOST_ARCHIVE_DECL(void)
+basic_oarchive::reserve_tracked_objects(std::size_t count){
+    pimpl->object_set.reserve(count);
+    pimpl->stored_pointers.reserve(count);
+}
+
 BOOST_ARCHIVE_DECL(void) 
 basic_oarchive::end_preamble(){
 }
@@ -0,0 +1,28 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// binary_buffer_iarchive.cpp:
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org for updates, documentation, and revision history.
+
+#define BOOST_ARCHIVE_SOURCE
+#include <boost/archive/binary_buffer_iarchive.hpp>
+#include <boost/archive/detail/archive_serializer_map.hpp>
+
+#include <boost/archive/impl/archive_serializer_map.ipp>
+#include <boost/archive/impl/basic_binary_buffer_iprimitive.ipp>
+#include <boost/archive/impl/basic_binary_iarchive.ipp>
+
+namespace boost {
+namespace archive {
+
+// explicitly instantiate for this type of buffer
+template class detail::archive_serializer_map<binary_buffer_iarchive>;
+template class basic_binary_buffer_iprimitive<binary_buffer_iarchive>;
+template class basic_binary_iarchive<binary_buffer_iarchive> ;
+template class binary_buffer_iarchive_impl<binary_buffer_iarchive>;
+
+} // namespace archive
+} // namespace boost
@@ -0,0 +1,230 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// flat_oarchive.cpp:
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org for updates, documentation, and revision history.
+
+#if (defined _MSC_VER) && (_MSC_VER == 1200)
+#  pragma warning (disable : 4786) // too long name, harmless warning
+#endif
+
+#include <cstddef> // NULL
+#include <ostream>
+
+#include <boost/config.hpp>
+#include <boost/detail/no_exceptions_support.hpp>
+#include <boost/integer_traits.hpp>
+
+#define BOOST_ARCHIVE_SOURCE
+#include <boost/archive/flat_oarchive.hpp>
+
+namespace boost {
+namespace archive {
+
+void
+flat_oarchive::write(const void * address, std::size_t count){
+    m_os.write(static_cast<const char *>(address), count);
+    if(m_os.fail())
+        boost::serialization::throw_exception(
+            archive_exception(archive_exception::output_stream_error)
+        );
+    m_position += count;
+}
+
+void
+flat_oarchive::align(std::size_t alignment){
+    static const char zeros[16] = { 0 };
+    std::size_t padding = (alignment - m_position % alignment) % alignment;
+    while(0 < padding){
+        const std::size_t n = padding < sizeof(zeros) ? padding : sizeof(zeros);
+        write(zeros, n);
+        padding -= n;
+    }
+}
+
+boost::uint32_t
+flat_oarchive::offset() const {
+    // offsets are 32 bits
+    if(boost::integer_traits<boost::uint32_t>::const_max < m_position)
+        boost::serialization::throw_exception(
+            archive_exception(
+                archive_exception::output_stream_error,
+                "flat archive larger than 4GB"
+            )
+        );
+    return static_cast<boost::uint32_t>(m_position);
+}
+
+boost::uint32_t
+flat_oarchive::save_name(const char * name){
+    if(NULL == name)
+        return 0;
+    std::map<const char *, boost::uint32_t>::const_iterator it
+        = m_names.find(name);
+    if(m_names.end() != it)
+        return it->second;
+    const boost::uint32_t result = offset();
+    write(name, std::char_traits<char>::length(name) + 1);
+    m_names.insert(std::make_pair(name, result));
+    return result;
+}
+
+void
+flat_oarchive::add_field(
+    const char * name,
+    flat_kind kind,
+    boost::uint32_t offset,
+    std::size_t count,
+    std::size_t size
+){
+    if(boost::integer_traits<boost::uint16_t>::const_max < size)
+        boost::serialization::throw_exception(
+            archive_exception(
+                archive_exception::other_exception,
+                "flat archive element larger than 64KB"
+            )
+        );
+    if(boost::integer_traits<boost::uint32_t>::const_max < count)
+        boost::serialization::throw_exception(
+            archive_exception(
+                archive_exception::output_stream_error,
+                "flat archive larger than 4GB"
+            )
+        );
+    flat_entry e;
+    e.m_offset = offset;
+    e.m_name = save_name(name);
+    e.m_count = static_cast<boost::uint32_t>(count);
+    e.m_kind = static_cast<boost::uint16_t>(kind);
+    e.m_size = static_cast<boost::uint16_t>(size);
+    m_objects[m_depth].push_back(e);
+}
+
+void
+flat_oarchive::save_data(
+    flat_kind kind,
+    const void * address,
+    std::size_t count,
+    std::size_t size,
+    std::size_t alignment
+){
+    const char * name = take_name();
+    align(alignment);
+    const boost::uint32_t position = offset();
+    write(address, count * size);
+    if(flat_string == kind)
+        write("", 1);
+    add_field(name, kind, position, count, size);
+}
+
+const char *
+flat_oarchive::begin_object(){
+    ++m_depth;
+    if(m_objects.size() == m_depth)
+        m_objects.push_back(std::vector<flat_entry>());
+    m_objects[m_depth].clear();
+    return take_name();
+}
+
+void
+flat_oarchive::end_object(const char * name){
+    const std::vector<flat_entry> & fields = m_objects[m_depth];
+    align(4);
+    const boost::uint32_t position = offset();
+    const boost::uint32_t count = static_cast<boost::uint32_t>(fields.size());
+    write(& count, sizeof(count));
+    if(! fields.empty())
+        write(& fields[0], fields.size() * sizeof(flat_entry));
+    --m_depth;
+    add_field(name, flat_object, position, count, 0);
+}
+
+bool
+flat_oarchive::find_pointer(const void * address){
+    std::map<const void *, flat_entry>::const_iterator it
+        = m_pointers.find(address);
+    if(m_pointers.end() == it)
+        return false;
+    // a pointer back to an object being written would need a forward
+    // reference, which the format doesn't have
+    if(flat_null == it->second.m_kind)
+        boost::serialization::throw_exception(
+            archive_exception(
+                archive_exception::pointer_conflict,
+                "cycle in flat archive"
+            )
+        );
+    flat_entry e = it->second;
+    e.m_name = save_name(take_name());
+    m_objects[m_depth].push_back(e);
+    return true;
+}
+
+void
+flat_oarchive::begin_pointer(const void * address){
+    flat_entry e;
+    e.m_offset = 0;
+    e.m_name = 0;
+    e.m_count = 0;
+    e.m_kind = flat_null;
+    e.m_size = 0;
+    m_pointers.insert(std::make_pair(address, e));
+}
+
+void
+flat_oarchive::end_pointer(const void * address){
+    m_pointers[address] = m_objects[m_depth].back();
+}
+
+void
+flat_oarchive::windup(){
+    // the root object, which holds whatever was saved with operator<<
+    const std::vector<flat_entry> & fields = m_objects[0];
+    align(4);
+    const boost::uint32_t root = offset();
+    const boost::uint32_t count = static_cast<boost::uint32_t>(fields.size());
+    write(& count, sizeof(count));
+    if(! fields.empty())
+        write(& fields[0], fields.size() * sizeof(flat_entry));
+    write(& root, sizeof(root));
+    write(flat_signature, sizeof(flat_signature));
+    m_os.flush();
+}
+
+BOOST_ARCHIVE_DECL(BOOST_PP_EMPTY())
+flat_oarchive::flat_oarchive(std::ostream & os) :
+    m_os(os),
+    m_position(0),
+    m_name(NULL),
+    m_objects(1),
+    m_depth(0)
+{
+    write(flat_signature, sizeof(flat_signature));
+    const unsigned char sizes[4] = {
+        sizeof(int), sizeof(long), sizeof(float), sizeof(double)
+    };
+    write(sizes, sizeof(sizes));
+    const boost::uint32_t endian = 1;
+    write(& endian, sizeof(endian));
+    write(& flat_format_version, sizeof(flat_format_version));
+}
+
+BOOST_ARCHIVE_DECL(BOOST_PP_EMPTY())
+flat_oarchive::~flat_oarchive(){
+    // an object left open means that saving it threw, so leave the
+    // archive without a trailer rather than let it look complete.  A
+    // failure to write the trailer shows in the state of the stream.
+    if(0 != m_depth)
+        return;
+    BOOST_TRY{
+        windup();
+    }
+    BOOST_CATCH(...){}
+    BOOST_CATCH_END
+}
+
+} // namespace archive
+} // namespace boost
@@ -0,0 +1,221 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// flat_view.cpp:
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org for updates, documentation, and revision history.
+
+#if (defined _MSC_VER) && (_MSC_VER == 1200)
+#  pragma warning (disable : 4786) // too long name, harmless warning
+#endif
+
+#include <cstddef> // NULL
+#include <cstring> // std::memcmp, std::memchr, std::strcmp
+
+#include <boost/config.hpp>
+#if defined(BOOST_NO_STDC_NAMESPACE)
+namespace std{
+    using ::memcmp;
+    using ::memchr;
+    using ::strcmp;
+} // namespace std
+#endif
+
+#include <boost/serialization/throw_exception.hpp>
+
+#define BOOST_ARCHIVE_SOURCE
+#include <boost/archive/archive_exception.hpp>
+#include <boost/archive/flat_view.hpp>
+
+namespace boost {
+namespace archive {
+
+namespace {
+
+void
+corrupt(const char * what){
+    boost::serialization::throw_exception(
+        archive_exception(archive_exception::input_stream_error, what)
+    );
+}
+
+// true if count elements of the given size starting at offset lie within
+// an archive of the given size.  Written so as not to overflow.
+bool
+within(
+    std::size_t archive_size,
+    std::size_t offset,
+    std::size_t count,
+    std::size_t size
+){
+    if(archive_size < offset)
+        return false;
+    const std::size_t available = archive_size - offset;
+    return 0 == size || count <= available / size;
+}
+
+} // namespace
+
+BOOST_ARCHIVE_DECL(BOOST_PP_EMPTY())
+flat_table::flat_table(
+    const char * base,
+    std::size_t size,
+    boost::uint32_t offset
+) :
+    m_base(base),
+    m_size(size),
+    m_fields(NULL),
+    m_count(0)
+{
+    if(0 != offset % 4 || ! within(size, offset, 1, sizeof(boost::uint32_t)))
+        corrupt("flat archive object");
+    const boost::uint32_t count
+        = * reinterpret_cast<const boost::uint32_t *>(base + offset);
+    if(! within(size, std::size_t(offset) + 4, count, sizeof(flat_entry)))
+        corrupt("flat archive object");
+    m_fields = reinterpret_cast<const flat_entry *>(base + offset + 4);
+    m_count = count;
+}
+
+BOOST_ARCHIVE_DECL(const flat_entry &)
+flat_table::field(
+    std::size_t i,
+    flat_kind kind,
+    std::size_t size,
+    std::size_t alignment
+) const {
+    if(m_count <= i)
+        boost::serialization::throw_exception(
+            archive_exception(
+                archive_exception::other_exception,
+                "no such field in flat archive"
+            )
+        );
+    const flat_entry & e = m_fields[i];
+    if(kind != e.m_kind || (flat_object != kind && size != e.m_size))
+        boost::serialization::throw_exception(
+            archive_exception(
+                archive_exception::other_exception,
+                "wrong type for field in flat archive",
+                name(i)
+            )
+        );
+    const std::size_t count = (flat_string == kind) ? e.m_count + 1
+        : (flat_value == kind) ? 1
+        : e.m_count;
+    if(0 != e.m_offset % alignment || ! within(m_size, e.m_offset, count, size))
+        corrupt("flat archive field");
+    return e;
+}
+
+BOOST_ARCHIVE_DECL(const char *)
+flat_table::name(std::size_t i) const {
+    if(m_count <= i)
+        return NULL;
+    const boost::uint32_t offset = m_fields[i].m_name;
+    if(0 == offset)
+        return NULL;
+    // the name must be terminated within the archive
+    if(m_size <= offset
+    || NULL == std::memchr(m_base + offset, '\0', m_size - offset))
+        corrupt("flat archive name");
+    return m_base + offset;
+}
+
+BOOST_ARCHIVE_DECL(flat_kind)
+flat_table::kind(std::size_t i) const {
+    if(m_count <= i)
+        boost::serialization::throw_exception(
+            archive_exception(
+                archive_exception::other_exception,
+                "no such field in flat archive"
+            )
+        );
+    return static_cast<flat_kind>(m_fields[i].m_kind);
+}
+
+BOOST_ARCHIVE_DECL(std::size_t)
+flat_table::find(const char * name) const {
+    for(std::size_t i = 0; i < m_count; ++i){
+        const char * n = this->name(i);
+        if(NULL != n && 0 == std::strcmp(n, name))
+            return i;
+    }
+    return m_count;
+}
+
+BOOST_ARCHIVE_DECL(boost::iterator_range<const char *>)
+flat_table::string(std::size_t i) const {
+    const flat_entry & e = field(i, flat_string, 1, 1);
+    const char * s = m_base + e.m_offset;
+    if('\0' != s[e.m_count])
+        corrupt("flat archive string");
+    return boost::iterator_range<const char *>(s, s + e.m_count);
+}
+
+BOOST_ARCHIVE_DECL(flat_table)
+flat_table::object(std::size_t i) const {
+    const flat_entry & e = field(i, flat_object, 0, 4);
+    return flat_table(m_base, m_size, e.m_offset);
+}
+
+BOOST_ARCHIVE_DECL(BOOST_PP_EMPTY())
+flat_view::flat_view(const void * address, std::size_t size) :
+    m_base(static_cast<const char *>(address)),
+    m_size(size),
+    m_root(0)
+{
+    if(size < flat_header_size + flat_trailer_size
+    || 0 != std::memcmp(m_base, flat_signature, sizeof(flat_signature))
+    || 0 != std::memcmp(
+        m_base + size - sizeof(flat_signature),
+        flat_signature,
+        sizeof(flat_signature)
+    ))
+        boost::serialization::throw_exception(
+            archive_exception(archive_exception::invalid_signature)
+        );
+    // all reads are in place, so the archive must be aligned at least
+    // as well as the offsets within it
+    if(0 != reinterpret_cast<std::size_t>(m_base) % 8 || 0 != size % 4)
+        boost::serialization::throw_exception(
+            archive_exception(
+                archive_exception::incompatible_native_format,
+                "flat archive not aligned"
+            )
+        );
+    const unsigned char * sizes
+        = reinterpret_cast<const unsigned char *>(m_base + 4);
+    if(sizeof(int) != sizes[0]
+    || sizeof(long) != sizes[1]
+    || sizeof(float) != sizes[2]
+    || sizeof(double) != sizes[3])
+        boost::serialization::throw_exception(
+            archive_exception(
+                archive_exception::incompatible_native_format,
+                "type sizes"
+            )
+        );
+    if(1 != * reinterpret_cast<const boost::uint32_t *>(m_base + 8))
+        boost::serialization::throw_exception(
+            archive_exception(
+                archive_exception::incompatible_native_format,
+                "endian setting"
+            )
+        );
+    if(flat_format_version
+    < * reinterpret_cast<const boost::uint32_t *>(m_base + 12))
+        boost::serialization::throw_exception(
+            archive_exception(archive_exception::unsupported_version)
+        );
+    m_root = * reinterpret_cast<const boost::uint32_t *>(
+        m_base + size - flat_trailer_size
+    );
+    // check the root object now rather than on first use
+    (void)flat_table(m_base, m_size, m_root);
+}
+
+} // namespace archive
+} // namespace boost
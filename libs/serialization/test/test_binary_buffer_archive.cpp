@@ -0,0 +1,147 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// test_binary_buffer_archive.cpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// should pass compilation and execution
+
+#include <cstddef> // NULL
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test_tools.hpp"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <boost/archive/binary_buffer_oarchive.hpp>
+#include <boost/archive/binary_buffer_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/archive_exception.hpp>
+
+#include "A.hpp"
+#include "A.ipp"
+
+struct node
+{
+    int m_value;
+    boost::shared_ptr<node> m_next;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int /* file_version */){
+        ar & m_value;
+        ar & m_next;
+    }
+};
+
+// write a bit of everything
+template<class OArchive>
+void save(OArchive & oa, const A & a, const std::vector<double> & v)
+{
+    const std::string s("contiguous");
+    boost::shared_ptr<node> list(new node);
+    list->m_value = 1;
+    list->m_next.reset(new node);
+    list->m_next->m_value = 2;
+    oa << a << v << s << list;
+}
+
+template<class IArchive>
+void load_and_check(IArchive & ia, const A & a, const std::vector<double> & v)
+{
+    A a1;
+    std::vector<double> v1;
+    std::string s1;
+    boost::shared_ptr<node> list1;
+    ia >> a1 >> v1 >> s1 >> list1;
+    BOOST_CHECK(a == a1);
+    BOOST_CHECK(v == v1);
+    BOOST_CHECK(s1 == "contiguous");
+    BOOST_REQUIRE(NULL != list1.get());
+    BOOST_CHECK(1 == list1->m_value);
+    BOOST_REQUIRE(NULL != list1->m_next.get());
+    BOOST_CHECK(2 == list1->m_next->m_value);
+    BOOST_CHECK(NULL == list1->m_next->m_next.get());
+}
+
+int
+test_main( int /* argc */, char* /* argv */[] )
+{
+    const A a;
+    std::vector<double> v;
+    for(int i = 0; i < 10000; ++i)
+        v.push_back(i * 0.5);
+
+    // round trip through a vector which must grow several times
+    std::vector<char> buffer;
+    {
+        boost::archive::binary_buffer_oarchive oa(buffer);
+        save(oa, a, v);
+    }
+    {
+        boost::archive::binary_buffer_iarchive ia(buffer);
+        load_and_check(ia, a, v);
+    }
+
+    // the format is that of binary_oarchive - both ways
+    std::stringstream ss;
+    {
+        boost::archive::binary_oarchive oa(ss);
+        save(oa, a, v);
+    }
+    const std::string streamed = ss.str();
+    BOOST_CHECK(streamed == std::string(buffer.begin(), buffer.end()));
+    {
+        boost::archive::binary_buffer_iarchive ia(streamed.data(), streamed.size());
+        load_and_check(ia, a, v);
+    }
+    {
+        std::istringstream is(std::string(buffer.begin(), buffer.end()));
+        boost::archive::binary_iarchive ia(is);
+        load_and_check(ia, a, v);
+    }
+
+    // output is appended to what the buffer holds already
+    std::vector<char> appended(3, 'x');
+    {
+        boost::archive::binary_buffer_oarchive oa(
+            appended,
+            boost::archive::no_header
+        );
+        oa << a;
+    }
+    BOOST_CHECK(3 < appended.size());
+    BOOST_CHECK('x' == appended[2]);
+    {
+        A a1;
+        boost::archive::binary_buffer_iarchive ia(
+            & appended[3],
+            appended.size() - 3,
+            boost::archive::no_header
+        );
+        ia >> a1;
+        BOOST_CHECK(a == a1);
+    }
+
+    // reading past the end of the block throws
+    bool thrown = false;
+    try{
+        A a1;
+        std::vector<double> v1;
+        boost::archive::binary_buffer_iarchive ia(& buffer[0], buffer.size() / 2);
+        ia >> a1 >> v1;
+    }
+    catch(const boost::archive::archive_exception & e){
+        thrown = (e.code == boost::archive::archive_exception::input_stream_error);
+    }
+    BOOST_CHECK(thrown);
+
+    return EXIT_SUCCESS;
+}
+
+// EOF
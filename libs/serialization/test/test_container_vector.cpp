@@ -0,0 +1,74 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// test_container_vector.cpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// should pass compilation and execution
+
+#include <cstddef> // NULL
+#include <fstream>
+#include <vector>
+
+#include <cstdio> // remove
+#include <boost/config.hpp>
+#if defined(BOOST_NO_STDC_NAMESPACE)
+namespace std{ 
+    using ::remove;
+}
+#endif
+
+#include "test_tools.hpp"
+
+#include <boost/serialization/container_vector.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "A.hpp"
+#include "A.ipp"
+
+template <class T>
+int test_container_vector(T)
+{
+    const char * testfile = boost::archive::tmpnam(NULL);
+    BOOST_REQUIRE(NULL != testfile);
+
+    boost::container::vector< T > avector;
+    avector.push_back(T());
+    avector.push_back(T());
+    {   
+        test_ostream os(testfile, TEST_STREAM_FLAGS);
+        test_oarchive oa(os, TEST_ARCHIVE_FLAGS);
+        oa << boost::serialization::make_nvp("avector", avector);
+    }
+    boost::container::vector< T > avector1;
+    {
+        test_istream is(testfile, TEST_STREAM_FLAGS);
+        test_iarchive ia(is, TEST_ARCHIVE_FLAGS);
+        ia >> boost::serialization::make_nvp("avector", avector1);
+    }
+    BOOST_CHECK(avector == avector1);
+
+    // the format is that of std::vector
+    std::vector< T > svector;
+    {
+        test_istream is(testfile, TEST_STREAM_FLAGS);
+        test_iarchive ia(is, TEST_ARCHIVE_FLAGS);
+        ia >> boost::serialization::make_nvp("avector", svector);
+    }
+    BOOST_CHECK(svector.size() == avector.size());
+    BOOST_CHECK(std::equal(svector.begin(), svector.end(), avector.begin()));
+    std::remove(testfile);
+    return EXIT_SUCCESS;
+}
+
+int test_main( int /* argc */, char* /* argv */[] )
+{
+    int res = test_container_vector(A());
+    // test an int vector for which optimized versions should be available
+    if (res == EXIT_SUCCESS)
+        res = test_container_vector(0);  
+    return res;
+}
+
+// EOF
@@ -0,0 +1,229 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// test_flat_archive.cpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// should pass compilation and execution
+
+#include <cstddef> // NULL
+#include <cstring> // memcpy
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#if defined(BOOST_NO_STDC_NAMESPACE)
+namespace std{ 
+    using ::memcpy;
+}
+#endif
+
+#include "test_tools.hpp"
+
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/list.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/is_bitwise_serializable.hpp>
+
+#include <boost/archive/flat_oarchive.hpp>
+#include <boost/archive/flat_view.hpp>
+#include <boost/archive/archive_exception.hpp>
+
+using boost::serialization::make_nvp;
+
+struct point
+{
+    float m_x;
+    float m_y;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int /* file_version */){
+        ar & m_x & m_y;
+    }
+};
+
+BOOST_IS_BITWISE_SERIALIZABLE(point)
+
+enum colour { red, green, blue };
+
+struct shape
+{
+    std::string m_name;
+    colour m_colour;
+    point m_origin;
+    std::vector<point> m_outline;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int /* file_version */){
+        ar & make_nvp("name", m_name);
+        ar & make_nvp("colour", m_colour);
+        ar & make_nvp("origin", m_origin);
+        ar & make_nvp("outline", m_outline);
+    }
+};
+
+struct drawing
+{
+    int m_id;
+    std::vector<std::string> m_tags;
+    std::list<int> m_layers;
+    boost::shared_ptr<shape> m_first;
+    boost::shared_ptr<shape> m_again;
+    boost::shared_ptr<shape> m_none;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int /* file_version */){
+        ar & make_nvp("id", m_id);
+        ar & make_nvp("tags", m_tags);
+        ar & make_nvp("layers", m_layers);
+        ar & make_nvp("first", m_first);
+        ar & make_nvp("again", m_again);
+        ar & make_nvp("none", m_none);
+    }
+};
+
+struct node
+{
+    node * m_next;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int /* file_version */){
+        ar & make_nvp("next", m_next);
+    }
+};
+
+// copy the archive to memory aligned as a mapped file would be
+std::vector<boost::uint64_t>
+aligned_copy(const std::string & s, std::size_t size){
+    std::vector<boost::uint64_t> buffer(size / 8 + 1);
+    std::memcpy(& buffer[0], s.data(), size);
+    return buffer;
+}
+
+template<class F>
+bool
+throws(F f, boost::archive::archive_exception::exception_code code){
+    try{
+        f();
+    }
+    catch(const boost::archive::archive_exception & e){
+        return e.code == code;
+    }
+    return false;
+}
+
+struct wrong_type {
+    boost::archive::flat_table m_table;
+    void operator()() const {
+        m_table.value<double>(m_table.find("id"));
+    }
+};
+
+struct truncated {
+    const void * m_address;
+    std::size_t m_size;
+    void operator()() const {
+        boost::archive::flat_view v(m_address, m_size);
+    }
+};
+
+struct cycle {
+    void operator()() const {
+        node n;
+        n.m_next = & n;
+        std::ostringstream os;
+        boost::archive::flat_oarchive oa(os);
+        oa << make_nvp("n", n);
+    }
+};
+
+int
+test_main( int /* argc */, char* /* argv */[] )
+{
+    drawing d;
+    d.m_id = 42;
+    d.m_tags.push_back("first");
+    d.m_tags.push_back("second");
+    d.m_layers.push_back(3);
+    d.m_first.reset(new shape);
+    d.m_first->m_name = "triangle";
+    d.m_first->m_colour = green;
+    d.m_first->m_origin.m_x = 1;
+    d.m_first->m_origin.m_y = 2;
+    for(int i = 0; i < 3; ++i){
+        point p;
+        p.m_x = static_cast<float>(i);
+        p.m_y = static_cast<float>(i * i);
+        d.m_first->m_outline.push_back(p);
+    }
+    d.m_again = d.m_first;
+    const std::vector<double> samples(1000, 0.5);
+    const int unnamed = 7;
+
+    std::ostringstream os;
+    {
+        boost::archive::flat_oarchive oa(os);
+        oa << make_nvp("drawing", d);
+        oa << make_nvp("samples", samples);
+        oa << unnamed;
+    }
+    const std::string s = os.str();
+    std::vector<boost::uint64_t> buffer = aligned_copy(s, s.size());
+
+    boost::archive::flat_view v(& buffer[0], s.size());
+    const boost::archive::flat_table root = v.root();
+    BOOST_REQUIRE(3 == root.size());
+    BOOST_CHECK(NULL == root.name(2));
+    BOOST_CHECK(7 == root.value<int>(2));
+    BOOST_CHECK(root.size() == root.find("nothing"));
+
+    const boost::iterator_range<const double *> r
+        = root.array<double>(root.find("samples"));
+    BOOST_CHECK(samples.size() == static_cast<std::size_t>(r.size()));
+    BOOST_CHECK(std::equal(r.begin(), r.end(), samples.begin()));
+
+    const boost::archive::flat_table dt = root.object(root.find("drawing"));
+    BOOST_CHECK(42 == dt.value<int>(dt.find("id")));
+
+    // vectors of types which aren't bitwise serializable are objects
+    const boost::archive::flat_table tags = dt.object(dt.find("tags"));
+    BOOST_REQUIRE(2 == tags.size());
+    BOOST_CHECK(0 == std::strcmp("item", tags.name(1)));
+    BOOST_CHECK(std::string("second") == tags.string(1).begin());
+
+    // as are other collections, which have a count first
+    const boost::archive::flat_table layers = dt.object(dt.find("layers"));
+    BOOST_CHECK(3 == layers.value<int>(layers.find("item")));
+
+    const boost::archive::flat_table sp = dt.object(dt.find("first"));
+    const boost::archive::flat_table st = sp.object(sp.find("px"));
+    const boost::iterator_range<const char *> name
+        = st.string(st.find("name"));
+    BOOST_CHECK(std::string("triangle") == std::string(name.begin(), name.end()));
+    BOOST_CHECK(green == st.value<colour>(st.find("colour")));
+    BOOST_CHECK(2 == st.value<point>(st.find("origin")).m_y);
+    const boost::iterator_range<const point *> outline
+        = st.array<point>(st.find("outline"));
+    BOOST_REQUIRE(3 == outline.size());
+    BOOST_CHECK(4 == outline[2].m_y);
+
+    // the object was written once and both pointers refer to it
+    const boost::archive::flat_table again = dt.object(dt.find("again"));
+    BOOST_CHECK(
+        st.string(0).begin() == again.object(0).string(0).begin()
+    );
+    const boost::archive::flat_table none = dt.object(dt.find("none"));
+    BOOST_CHECK(none.is_null(none.find("px")));
+
+    wrong_type w = { dt };
+    BOOST_CHECK(throws(w, boost::archive::archive_exception::other_exception));
+    truncated t = { & buffer[0], s.size() / 2 };
+    BOOST_CHECK(throws(t, boost::archive::archive_exception::invalid_signature));
+    BOOST_CHECK(throws(cycle(), boost::archive::archive_exception::pointer_conflict));
+    return EXIT_SUCCESS;
+}
+
+// EOF
@@ -0,0 +1,93 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// test_multi_array.cpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// should pass compilation and execution
+
+#include <cstddef> // NULL
+#include <fstream>
+
+#include <cstdio> // remove
+#include <boost/config.hpp>
+#if defined(BOOST_NO_STDC_NAMESPACE)
+namespace std{ 
+    using ::remove;
+}
+#endif
+
+#include "test_tools.hpp"
+
+#include <boost/serialization/multi_array.hpp>
+
+#include "A.hpp"
+#include "A.ipp"
+
+template <class T, class U>
+void save_and_load(const T & t, U & u)
+{
+    const char * testfile = boost::archive::tmpnam(NULL);
+    BOOST_REQUIRE(NULL != testfile);
+    {   
+        test_ostream os(testfile, TEST_STREAM_FLAGS);
+        test_oarchive oa(os, TEST_ARCHIVE_FLAGS);
+        oa << boost::serialization::make_nvp("marray", t);
+    }
+    {
+        test_istream is(testfile, TEST_STREAM_FLAGS);
+        test_iarchive ia(is, TEST_ARCHIVE_FLAGS);
+        ia >> boost::serialization::make_nvp("marray", u);
+    }
+    std::remove(testfile);
+}
+
+int test_main( int /* argc */, char* /* argv */[] )
+{
+    typedef boost::multi_array<int, 3> int_array;
+    int_array a(boost::extents[2][3][4]);
+    for(std::size_t i = 0; i < a.num_elements(); ++i)
+        a.data()[i] = static_cast<int>(i);
+    {
+        int_array a1;
+        save_and_load(a, a1);
+        BOOST_CHECK(a == a1);
+    }
+
+    // non-zero index bases and a target with some other shape already
+    {
+        a.reindex(-1);
+        int_array a1(boost::extents[5][1][2]);
+        save_and_load(a, a1);
+        BOOST_CHECK(a1.index_bases()[0] == -1);
+        BOOST_CHECK(a1.index_bases()[2] == -1);
+        BOOST_CHECK(a == a1);
+        a.reindex(0);
+    }
+
+    // saved in fortran order, loaded into c order - and the other way
+    {
+        int_array f(boost::extents[2][3][4], boost::fortran_storage_order());
+        f = a;
+        int_array a1;
+        save_and_load(f, a1);
+        BOOST_CHECK(a == a1);
+        BOOST_CHECK(a1.storage_order() == a.storage_order());
+        int_array f1(boost::extents[2][3][4], boost::fortran_storage_order());
+        save_and_load(a, f1);
+        BOOST_CHECK(a == f1);
+        BOOST_CHECK(f1.storage_order() == f.storage_order());
+    }
+
+    // elements which aren't bitwise serializable
+    {
+        boost::multi_array<A, 2> b(boost::extents[3][2]);
+        boost::multi_array<A, 2> b1;
+        save_and_load(b, b1);
+        BOOST_CHECK(b == b1);
+    }
+    return EXIT_SUCCESS;
+}
+
+// EOF
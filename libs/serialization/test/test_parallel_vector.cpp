@@ -0,0 +1,209 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// test_parallel_vector.cpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// should pass compilation and execution
+
+#include <cstddef> // NULL
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/limits.hpp>
+
+#include <boost/config.hpp>
+#include <cstdio> // remove
+#if defined(BOOST_NO_STDC_NAMESPACE)
+namespace std{
+    using ::remove;
+}
+#endif
+
+#include "test_tools.hpp"
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/tracking.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/parallel_vector.hpp>
+#include <boost/archive/archive_exception.hpp>
+#include <boost/archive/binary_buffer_oarchive.hpp>
+#include <boost/archive/binary_buffer_iarchive.hpp>
+
+class record
+{
+    friend class boost::serialization::access;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int /* file_version */){
+        ar & BOOST_SERIALIZATION_NVP(m_id);
+        ar & BOOST_SERIALIZATION_NVP(m_name);
+    }
+public:
+    int m_id;
+    std::string m_name;
+    bool operator==(const record & rhs) const {
+        return m_id == rhs.m_id && m_name == rhs.m_name;
+    }
+};
+
+BOOST_CLASS_TRACKING(record, boost::serialization::track_never)
+
+// an element which can't be loaded if it was saved with a negative value
+class fragile
+{
+    friend class boost::serialization::access;
+    template<class Archive>
+    void save(Archive & ar, const unsigned int /* file_version */) const {
+        ar << BOOST_SERIALIZATION_NVP(m_value);
+    }
+    template<class Archive>
+    void load(Archive & ar, const unsigned int /* file_version */){
+        ar >> BOOST_SERIALIZATION_NVP(m_value);
+        if(m_value < 0)
+            boost::serialization::throw_exception(
+                boost::archive::archive_exception(
+                    boost::archive::archive_exception::other_exception
+                )
+            );
+    }
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+public:
+    int m_value;
+};
+
+BOOST_CLASS_TRACKING(fragile, boost::serialization::track_never)
+
+// an exception thrown by a worker thread reaches the caller
+void
+test_worker_exception(const char * testfile){
+    std::vector<fragile> v(100);
+    for(std::size_t i = 0; i < v.size(); ++i)
+        v[i].m_value = static_cast<int>(i);
+    // in the last chunk, which is loaded on a thread of its own
+    v[99].m_value = -1;
+    {
+        test_ostream os(testfile, TEST_STREAM_FLAGS);
+        test_oarchive oa(os, TEST_ARCHIVE_FLAGS);
+        oa << boost::serialization::make_nvp(
+            "v",
+            boost::serialization::make_parallel_vector(v, 4)
+        );
+    }
+    std::vector<fragile> v1;
+    boost::archive::archive_exception exception(
+        boost::archive::archive_exception::no_exception
+    );
+    BOOST_TRY {
+        test_istream is(testfile, TEST_STREAM_FLAGS);
+        test_iarchive ia(is, TEST_ARCHIVE_FLAGS);
+        ia >> boost::serialization::make_nvp(
+            "v",
+            boost::serialization::make_parallel_vector(v1, 4)
+        );
+    }
+    BOOST_CATCH(const boost::archive::archive_exception & ae){
+        exception = ae;
+    }
+    BOOST_CATCH_END
+    BOOST_CHECK(
+        exception.code == boost::archive::archive_exception::other_exception
+    );
+}
+
+// an index claiming more data than the archive holds is rejected before
+// the memory it claims is allocated
+void
+test_corrupt_index(){
+    std::vector<char> buffer;
+    {
+        boost::archive::binary_buffer_oarchive oa(buffer);
+        const boost::serialization::collection_size_type count(1);
+        const boost::serialization::collection_size_type chunks(1);
+        const boost::serialization::collection_size_type elements(1);
+        const boost::serialization::collection_size_type size(
+            (std::numeric_limits<std::size_t>::max)() / 2
+        );
+        oa << count << chunks << elements << size;
+    }
+    std::vector<int> v;
+    boost::archive::archive_exception exception(
+        boost::archive::archive_exception::no_exception
+    );
+    BOOST_TRY {
+        boost::archive::binary_buffer_iarchive ia(buffer);
+        ia >> boost::serialization::make_parallel_vector(v);
+    }
+    BOOST_CATCH(const boost::archive::archive_exception & ae){
+        exception = ae;
+    }
+    BOOST_CATCH_END
+    BOOST_CHECK(
+        exception.code == boost::archive::archive_exception::input_stream_error
+    );
+}
+
+int
+test_main( int /* argc */, char* /* argv */[] )
+{
+    const char * testfile = boost::archive::tmpnam(NULL);
+    BOOST_REQUIRE(NULL != testfile);
+
+    std::vector<record> records(1001);
+    for(std::size_t i = 0; i < records.size(); ++i){
+        records[i].m_id = static_cast<int>(i);
+        records[i].m_name = std::string(i % 17, 'a' + i % 26);
+    }
+    std::vector<int> ints(2);
+    ints[0] = 1;
+    ints[1] = 2;
+    std::vector<int> empty;
+    {
+        test_ostream os(testfile, TEST_STREAM_FLAGS);
+        test_oarchive oa(os, TEST_ARCHIVE_FLAGS);
+        oa << boost::serialization::make_nvp(
+            "records",
+            boost::serialization::make_parallel_vector(records, 3)
+        );
+        // fewer elements than threads
+        oa << boost::serialization::make_nvp(
+            "ints",
+            boost::serialization::make_parallel_vector(ints, 4)
+        );
+        oa << boost::serialization::make_nvp(
+            "empty",
+            boost::serialization::make_parallel_vector(empty)
+        );
+    }
+    std::vector<record> records1;
+    std::vector<int> ints1(5);
+    std::vector<int> empty1(5);
+    {
+        test_istream is(testfile, TEST_STREAM_FLAGS);
+        test_iarchive ia(is, TEST_ARCHIVE_FLAGS);
+        // the chunks needn't be loaded on as many threads as saved them
+        ia >> boost::serialization::make_nvp(
+            "records",
+            boost::serialization::make_parallel_vector(records1, 2)
+        );
+        ia >> boost::serialization::make_nvp(
+            "ints",
+            boost::serialization::make_parallel_vector(ints1)
+        );
+        ia >> boost::serialization::make_nvp(
+            "empty",
+            boost::serialization::make_parallel_vector(empty1)
+        );
+    }
+    BOOST_CHECK(records == records1);
+    BOOST_CHECK(ints == ints1);
+    BOOST_CHECK(empty1.empty());
+
+    test_worker_exception(testfile);
+    test_corrupt_index();
+    std::remove(testfile);
+    return EXIT_SUCCESS;
+}
+
+// EOF
@@ -0,0 +1,122 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// test_track_pointers_only.cpp
+
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// should pass compilation and execution
+
+#include <cstddef> // NULL
+#include <fstream>
+
+#include <boost/config.hpp>
+#include <cstdio> // remove
+#if defined(BOOST_NO_STDC_NAMESPACE)
+namespace std{
+    using ::remove;
+}
+#endif
+
+#include "test_tools.hpp"
+#include <boost/serialization/tracking.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/archive/archive_exception.hpp>
+
+class AA
+{
+    friend class boost::serialization::access;
+    template<class Archive>
+    void serialize(Archive & /* ar */, const unsigned int /* file_version */){
+        ++count;
+    }
+public:
+    static unsigned int count;
+};
+unsigned int AA::count = 0;
+BOOST_CLASS_TRACKING(AA, ::boost::serialization::track_always)
+
+class node
+{
+    friend class boost::serialization::access;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int /* file_version */){
+        ar & BOOST_SERIALIZATION_NVP(m_value);
+        ar & BOOST_SERIALIZATION_NVP(m_next);
+    }
+public:
+    int m_value;
+    boost::shared_ptr<node> m_next;
+    node(int value = 0) :
+        m_value(value)
+    {}
+};
+
+void out(const char *testfile)
+{
+    test_ostream os(testfile, TEST_STREAM_FLAGS);
+    test_oarchive oa(os, TEST_ARCHIVE_FLAGS | boost::archive::track_pointers_only);
+    oa.reserve_tracked_objects(100);
+
+    // objects saved directly aren't tracked, so are written each time
+    AA aa;
+    oa << BOOST_SERIALIZATION_NVP(aa) << BOOST_SERIALIZATION_NVP(aa);
+    BOOST_CHECK(aa.count == 2);
+
+    // but objects saved through pointers still are
+    boost::shared_ptr<node> first(new node(1));
+    first->m_next.reset(new node(2));
+    first->m_next->m_next.reset(new node(3));
+    boost::shared_ptr<node> last = first->m_next->m_next;
+    oa << BOOST_SERIALIZATION_NVP(first) << BOOST_SERIALIZATION_NVP(last);
+    // and a node saved directly after being saved through a pointer is
+    // still an error
+    const node & n = * last;
+    boost::archive::archive_exception exception(
+        boost::archive::archive_exception::no_exception
+    );
+    BOOST_TRY {
+        oa << BOOST_SERIALIZATION_NVP(n);
+    }
+    BOOST_CATCH (const boost::archive::archive_exception & ae){
+        exception = ae;
+    }
+    BOOST_CATCH_END
+    BOOST_CHECK(
+        exception.code == boost::archive::archive_exception::pointer_conflict
+    );
+}
+
+void in(const char *testfile)
+{
+    test_istream is(testfile, TEST_STREAM_FLAGS);
+    test_iarchive ia(is, TEST_ARCHIVE_FLAGS);
+
+    AA aa;
+    AA::count = 0;
+    ia >> BOOST_SERIALIZATION_NVP(aa) >> BOOST_SERIALIZATION_NVP(aa);
+    BOOST_CHECK(aa.count == 2);
+
+    boost::shared_ptr<node> first;
+    boost::shared_ptr<node> last;
+    ia >> BOOST_SERIALIZATION_NVP(first) >> BOOST_SERIALIZATION_NVP(last);
+    BOOST_REQUIRE(NULL != first.get());
+    BOOST_REQUIRE(NULL != first->m_next.get());
+    BOOST_CHECK(1 == first->m_value);
+    BOOST_CHECK(2 == first->m_next->m_value);
+    BOOST_CHECK(3 == last->m_value);
+    BOOST_CHECK(first->m_next->m_next == last);
+}
+
+int
+test_main( int /* argc */, char* /* argv */[] )
+{
+    const char * testfile = boost::archive::tmpnam(NULL);
+    BOOST_REQUIRE(NULL != testfile);
+
+    out(testfile);
+    in(testfile);
+    std::remove(testfile);
+    return EXIT_SUCCESS;
+}
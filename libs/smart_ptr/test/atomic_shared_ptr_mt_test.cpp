@@ -0,0 +1,150 @@
+#include <boost/config.hpp>
+
+//  atomic_shared_ptr_mt_test.cpp - compares atomic_load and atomic_store on
+//  a shared_ptr with atomic_shared_ptr, with a growing number of readers
+//  and one writer
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/shared_ptr.hpp>
+#include <boost/atomic_shared_ptr.hpp>
+#include <boost/bind.hpp>
+
+#include <boost/detail/lightweight_test.hpp>
+#include <boost/detail/lightweight_thread.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+//
+
+int const n = 1024 * 1024; // reads per reader
+int const nw = 64 * 1024; // writes
+
+struct X
+{
+    int v_; // version
+
+    explicit X( int v ): v_( v )
+    {
+    }
+};
+
+// the two ways of sharing a pointer, with a common interface
+
+struct spinlock_pool_access
+{
+    boost::shared_ptr<X> p_;
+
+    explicit spinlock_pool_access( boost::shared_ptr<X> const & p ): p_( p )
+    {
+    }
+
+    boost::shared_ptr<X> load() const
+    {
+        return boost::atomic_load( &p_ );
+    }
+
+    void store( boost::shared_ptr<X> const & p )
+    {
+        boost::atomic_store( &p_, p );
+    }
+};
+
+struct atomic_shared_ptr_access
+{
+    boost::atomic_shared_ptr<X> p_;
+
+    explicit atomic_shared_ptr_access( boost::shared_ptr<X> const & p ): p_( p )
+    {
+    }
+
+    boost::shared_ptr<X> load() const
+    {
+        return p_.load();
+    }
+
+    void store( boost::shared_ptr<X> const & p )
+    {
+        p_.store( p );
+    }
+};
+
+template<class A> void reader( A * a )
+{
+    int v = 0;
+
+    for( int i = 0; i < n; ++i )
+    {
+        boost::shared_ptr<X> p = a->load();
+
+        BOOST_TEST( p->v_ >= v );
+        v = p->v_;
+    }
+}
+
+template<class A> void writer( A * a )
+{
+    for( int i = 1; i <= nw; ++i )
+    {
+        a->store( boost::shared_ptr<X>( new X( i ) ) );
+    }
+}
+
+template<class A> double run( int m )
+{
+    using namespace std; // clock_t, clock
+
+    A a( boost::shared_ptr<X>( new X( 0 ) ) );
+    pthread_t t[ 65 ];
+
+    clock_t c = clock();
+
+    for( int i = 0; i < m; ++i )
+    {
+        boost::detail::lw_thread_create( t[ i ], boost::bind( reader<A>, &a ) );
+    }
+
+    boost::detail::lw_thread_create( t[ m ], boost::bind( writer<A>, &a ) );
+
+    for( int j = 0; j <= m; ++j )
+    {
+        pthread_join( t[ j ], 0 );
+    }
+
+    c = clock() - c;
+
+    BOOST_TEST( a.load()->v_ == nw );
+
+    return static_cast<double>( c ) / CLOCKS_PER_SEC;
+}
+
+#if defined( BOOST_HAS_PTHREADS )
+
+char const * thmodel = "POSIX";
+
+#else
+
+char const * thmodel = "Windows";
+
+#endif
+
+int main( int argc, char * argv[] )
+{
+    using namespace std; // printf, atoi
+
+    int const mr = argc > 1? atoi( argv[ 1 ] ): 16; // maximum number of readers
+
+    printf( "Using %s threads, up to %dR + 1W threads, %d reads per reader, %d writes (CPU seconds)\n\n", thmodel, mr, n, nw );
+    printf( "%8s %16s %20s\n", "readers", "atomic_load", "atomic_shared_ptr" );
+
+    for( int m = 1; m <= mr && m <= 64; m *= 2 )
+    {
+        printf( "%8d %16.3f %20.3f\n", m, run<spinlock_pool_access>( m ), run<atomic_shared_ptr_access>( m ) );
+    }
+
+    return boost::report_errors();
+}
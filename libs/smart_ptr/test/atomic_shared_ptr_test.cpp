@@ -0,0 +1,159 @@
+#include <boost/config.hpp>
+
+//  atomic_shared_ptr_test.cpp
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+
+#include <boost/detail/lightweight_test.hpp>
+#include <boost/detail/lightweight_thread.hpp>
+#include <boost/atomic_shared_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+
+//
+
+struct X
+{
+    static long instances;
+
+    int v_;
+
+    explicit X( int v = 0 ): v_( v )
+    {
+        ++instances;
+    }
+
+    ~X()
+    {
+        --instances;
+    }
+
+private:
+
+    X( X const & );
+    X & operator= ( X const & );
+};
+
+long X::instances = 0;
+
+#define BOOST_TEST_SP_EQ( p, q ) BOOST_TEST( p == q && !( p < q ) && !( q < p ) )
+
+static boost::atomic_shared_ptr<int> api( boost::shared_ptr<int>( new int( 0 ) ) );
+
+int const n = 100000;
+
+void reader()
+{
+    int last = 0;
+
+    for( int i = 0; i < n; ++i )
+    {
+        boost::shared_ptr<int> p = api.load();
+
+        BOOST_TEST( *p >= last );
+        last = *p;
+    }
+}
+
+void writer()
+{
+    for( int i = 1; i <= n; ++i )
+    {
+        boost::shared_ptr<int> p( new int( i ) );
+
+        if( i % 2 == 0 )
+        {
+            api.store( p );
+        }
+        else
+        {
+            boost::shared_ptr<int> cmp = api.load();
+            BOOST_TEST( api.compare_exchange_strong( cmp, p ) );
+        }
+    }
+}
+
+int main()
+{
+    {
+        boost::atomic_shared_ptr<X> apx;
+        BOOST_TEST( !apx.load() );
+
+        boost::shared_ptr<X> px( new X( 1 ) );
+        apx.store( px );
+
+        boost::shared_ptr<X> p2 = apx.load();
+        BOOST_TEST_SP_EQ( p2, px );
+        BOOST_TEST( p2->v_ == 1 );
+
+        boost::shared_ptr<X> px3( new X( 3 ) );
+        boost::shared_ptr<X> p3 = apx.exchange( px3 );
+        BOOST_TEST_SP_EQ( p3, px );
+        BOOST_TEST_SP_EQ( static_cast< boost::shared_ptr<X> >( apx ), px3 );
+
+        boost::shared_ptr<X> px4( new X( 4 ) );
+        boost::shared_ptr<X> cmp;
+
+        bool r = apx.compare_exchange_strong( cmp, px4 );
+        BOOST_TEST( !r );
+        BOOST_TEST_SP_EQ( apx.load(), px3 );
+        BOOST_TEST_SP_EQ( cmp, px3 );
+
+        r = apx.compare_exchange_weak( cmp, px4 );
+        BOOST_TEST( r );
+        BOOST_TEST_SP_EQ( apx.load(), px4 );
+
+        // an aliasing pointer is not equivalent to the owning one
+
+        boost::shared_ptr<X> alias( px4, px3.get() );
+        cmp = alias;
+        r = apx.compare_exchange_strong( cmp, boost::shared_ptr<X>() );
+        BOOST_TEST( !r );
+        BOOST_TEST_SP_EQ( cmp, px4 );
+
+        r = apx.compare_exchange_strong( cmp, boost::shared_ptr<X>() );
+        BOOST_TEST( r );
+        BOOST_TEST( !apx.load() );
+
+        cmp.reset();
+        r = apx.compare_exchange_strong( cmp, px );
+        BOOST_TEST( r );
+
+        apx = boost::shared_ptr<X>();
+        BOOST_TEST( !apx.load() );
+
+        apx = px3;
+        BOOST_TEST( px3.use_count() == 2 );
+
+        px.reset();
+        p2.reset();
+        p3.reset();
+        BOOST_TEST( X::instances == 2 );
+    }
+
+    BOOST_TEST( X::instances == 0 );
+
+    {
+        pthread_t a[ 4 ];
+
+        boost::detail::lw_thread_create( a[ 0 ], writer );
+
+        for( int i = 1; i < 4; ++i )
+        {
+            boost::detail::lw_thread_create( a[ i ], reader );
+        }
+
+        for( int i = 0; i < 4; ++i )
+        {
+            pthread_join( a[ i ], 0 );
+        }
+
+        boost::shared_ptr<int> p = api.load();
+        BOOST_TEST( *p == n );
+        BOOST_TEST( p.use_count() == 2 );
+    }
+
+    return boost::report_errors();
+}
@@ -0,0 +1,104 @@
+#include <boost/config.hpp>
+
+//  striped_shared_ptr_mt_test.cpp - compares copying a widely shared
+//  shared_ptr and striped_shared_ptr from a growing number of threads
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/shared_ptr.hpp>
+#include <boost/striped_shared_ptr.hpp>
+#include <boost/bind.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+#include <boost/detail/lightweight_thread.hpp>
+
+//
+
+int const n = 1024 * 1024;
+
+struct config
+{
+    int v_;
+
+    config(): v_( 1 )
+    {
+    }
+};
+
+// copies p into a small ring of local pointers, so that every iteration
+// copies one pointer and destroys another
+
+template<class P> void test( P const & p, int * result )
+{
+    P v[ 16 ];
+    int s = 0;
+
+    for( int i = 0; i < n; ++i )
+    {
+        v[ i % 16 ] = p;
+        s += v[ i % 16 ]->v_;
+    }
+
+    *result = s;
+}
+
+template<class P> double run( P const & p, int m )
+{
+    using namespace std; // clock_t, clock
+
+    pthread_t a[ 64 ];
+    int results[ 64 ];
+
+    clock_t t = clock();
+
+    for( int i = 0; i < m; ++i )
+    {
+        boost::detail::lw_thread_create( a[ i ], boost::bind( test<P>, boost::cref( p ), results + i ) );
+    }
+
+    for( int j = 0; j < m; ++j )
+    {
+        pthread_join( a[ j ], 0 );
+    }
+
+    t = clock() - t;
+
+    return static_cast<double>( t ) / CLOCKS_PER_SEC;
+}
+
+#if defined( BOOST_HAS_PTHREADS )
+
+char const * thmodel = "POSIX";
+
+#else
+
+char const * thmodel = "Windows";
+
+#endif
+
+int main( int argc, char * argv[] )
+{
+    using namespace std; // printf, atoi
+
+    int const mt = argc > 1? atoi( argv[ 1 ] ): 16; // maximum number of threads
+
+    printf( "Using %s threads, up to %d threads, %d copies per thread (CPU seconds)\n\n", thmodel, mt, n );
+    printf( "%8s %16s %20s\n", "threads", "shared_ptr", "striped_shared_ptr" );
+
+    boost::shared_ptr<config> ps( new config );
+
+    boost::striped_owner_ptr<config> owner( new config );
+    boost::striped_shared_ptr<config> pss( owner );
+
+    for( int m = 1; m <= mt && m <= 64; m *= 2 )
+    {
+        printf( "%8d %16.3f %20.3f\n", m, run( ps, m ), run( pss, m ) );
+    }
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include <boost/config.hpp>
+
+//  striped_shared_ptr_test.cpp
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+
+#include <boost/detail/lightweight_test.hpp>
+#include <boost/detail/lightweight_thread.hpp>
+#include <boost/striped_shared_ptr.hpp>
+#include <boost/bind.hpp>
+
+#include <vector>
+
+//
+
+struct X
+{
+    static long instances;
+
+    int v_;
+
+    explicit X( int v = 0 ): v_( v )
+    {
+        ++instances;
+    }
+
+    virtual ~X()
+    {
+        --instances;
+    }
+
+private:
+
+    X( X const & );
+    X & operator= ( X const & );
+};
+
+long X::instances = 0;
+
+struct Y: public X
+{
+    static long instances;
+
+    Y()
+    {
+        ++instances;
+    }
+
+    ~Y()
+    {
+        --instances;
+    }
+};
+
+long Y::instances = 0;
+
+int const n = 100000;
+
+void copy( boost::striped_shared_ptr<X> const & p, int & sum )
+{
+    std::vector< boost::striped_shared_ptr<X> > v;
+
+    for( int i = 0; i < n; ++i )
+    {
+        v.push_back( p );
+
+        if( v.size() == 64 )
+        {
+            v.clear();
+        }
+
+        sum += p->v_;
+    }
+}
+
+int main()
+{
+    {
+        boost::striped_owner_ptr<X> owner;
+        BOOST_TEST( !owner );
+        BOOST_TEST( owner.use_count() == 0 );
+
+        boost::striped_shared_ptr<X> p( owner );
+        BOOST_TEST( !p );
+        BOOST_TEST( p.use_count() == 0 );
+    }
+
+    {
+        boost::striped_owner_ptr<X> owner( new X( 5 ) );
+        BOOST_TEST( owner.get() != 0 );
+        BOOST_TEST( owner->v_ == 5 );
+        BOOST_TEST( owner.use_count() == 1 );
+
+        boost::striped_shared_ptr<X> p1( owner );
+        boost::striped_shared_ptr<X> p2( p1 );
+        boost::striped_shared_ptr<X> p3;
+        p3 = p2;
+
+        BOOST_TEST( p1 == p2 );
+        BOOST_TEST( p3.get() == owner.get() );
+        BOOST_TEST( ( *p3 ).v_ == 5 );
+        BOOST_TEST( owner.use_count() == 4 );
+
+        p2.reset();
+        BOOST_TEST( !p2 );
+        BOOST_TEST( p1 != p2 );
+        BOOST_TEST( owner.use_count() == 3 );
+
+        // the copies keep the object alive after the owner is gone
+
+        owner.reset();
+        BOOST_TEST( !owner );
+        BOOST_TEST( X::instances == 1 );
+        BOOST_TEST( p1.use_count() == 2 );
+
+        p2 = p1;
+        p1.reset();
+        p3.reset();
+        BOOST_TEST( X::instances == 1 );
+        BOOST_TEST( p2.use_count() == 1 );
+
+        p2.reset();
+        BOOST_TEST( X::instances == 0 );
+    }
+
+    {
+        boost::striped_owner_ptr<X> owner( new X );
+        owner.reset( new X );
+        BOOST_TEST( X::instances == 1 );
+
+        boost::striped_owner_ptr<X> other( new Y );
+        boost::striped_shared_ptr<X> p( other );
+
+        swap( owner, other );
+        BOOST_TEST( p.get() == owner.get() );
+
+        owner.reset();
+        other.reset();
+        BOOST_TEST( X::instances == 1 );
+        BOOST_TEST( Y::instances == 1 );
+
+        p.reset();
+        BOOST_TEST( X::instances == 0 );
+        BOOST_TEST( Y::instances == 0 );
+    }
+
+    // the owner goes away while other threads copy
+
+    {
+        int const m = 4;
+
+        boost::striped_owner_ptr<X> owner( new X( 1 ) );
+        boost::striped_shared_ptr<X> p( owner );
+
+        int sum[ m ] = { 0 };
+        pthread_t a[ m ];
+
+        for( int i = 0; i < m; ++i )
+        {
+            boost::detail::lw_thread_create( a[ i ], boost::bind( copy, p, boost::ref( sum[ i ] ) ) );
+        }
+
+        owner.reset();
+        p.reset();
+
+        for( int i = 0; i < m; ++i )
+        {
+            pthread_join( a[ i ], 0 );
+            BOOST_TEST( sum[ i ] == n );
+        }
+
+        BOOST_TEST( X::instances == 0 );
+    }
+
+    return boost::report_errors();
+}
@@ -0,0 +1,245 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Compares boost::mutex, condition_variable and shared_mutex with their
+// futex based counterparts:
+//
+// - uncontended: one thread locks and unlocks in a loop,
+// - contended: several threads increment a shared counter,
+// - ping-pong: two threads take turns through a condition variable,
+// - reader-heavy: several readers and one writer, one lock in a hundred
+//   exclusive.
+//
+// Usage: lock_microbenchmarks [<threads> [<milliseconds>]]
+
+#include <boost/thread/detail/config.hpp>
+
+#if defined BOOST_THREAD_LINUX
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/futex_mutex.hpp>
+#include <boost/thread/futex_condition_variable.hpp>
+#include <boost/thread/futex_shared_mutex.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+  typedef boost::chrono::steady_clock clock_type;
+
+  double seconds_since(clock_type::time_point start)
+  {
+    return boost::chrono::duration<double>(clock_type::now() - start).count();
+  }
+
+  void noop()
+  {
+  }
+
+  // Returns millions of lock/unlock pairs per second.
+  template <typename Mutex>
+  double uncontended(int milliseconds)
+  {
+    Mutex m;
+    unsigned long n = 0;
+    clock_type::time_point const start = clock_type::now();
+    clock_type::time_point const end = start + boost::chrono::milliseconds(milliseconds);
+    while (clock_type::now() < end)
+    {
+      for (int i = 0; i < 1000; ++i)
+      {
+        m.lock();
+        ++n;
+        m.unlock();
+      }
+    }
+    return n / seconds_since(start) / 1e6;
+  }
+
+  template <typename Mutex>
+  void increment(Mutex& m, unsigned long& counter, boost::atomic<bool> const& done)
+  {
+    while (!done.load(boost::memory_order_relaxed))
+    {
+      boost::unique_lock<Mutex> lk(m);
+      ++counter;
+    }
+  }
+
+  // Returns millions of increments per second of all threads together.
+  template <typename Mutex>
+  double contended(int threads, int milliseconds)
+  {
+    Mutex m;
+    unsigned long counter = 0;
+    boost::atomic<bool> done(false);
+
+    boost::thread_group group;
+    clock_type::time_point const start = clock_type::now();
+    for (int i = 0; i < threads; ++i)
+    {
+      group.create_thread(boost::bind(&increment<Mutex>, boost::ref(m),
+          boost::ref(counter), boost::cref(done)));
+    }
+    boost::this_thread::sleep_for(boost::chrono::milliseconds(milliseconds));
+    done = true;
+    group.join_all();
+    return counter / seconds_since(start) / 1e6;
+  }
+
+  template <typename Mutex, typename Condition>
+  struct ping_pong
+  {
+    Mutex m;
+    Condition cond;
+    unsigned long turn;
+    bool done;
+
+    ping_pong() : turn(0), done(false)
+    {
+    }
+
+    // Takes the odd turns until done.
+    void play_odd()
+    {
+      boost::unique_lock<Mutex> lk(m);
+      for (;;)
+      {
+        while (turn % 2 == 0 && !done)
+          cond.wait(lk);
+        if (done)
+          return;
+        ++turn;
+        cond.notify_one();
+      }
+    }
+  };
+
+  // Returns thousands of turns per second.
+  template <typename Mutex, typename Condition>
+  double condition_ping_pong(int milliseconds)
+  {
+    ping_pong<Mutex, Condition> p;
+    boost::thread other(boost::bind(&ping_pong<Mutex, Condition>::play_odd, &p));
+
+    clock_type::time_point const start = clock_type::now();
+    clock_type::time_point const end = start + boost::chrono::milliseconds(milliseconds);
+    {
+      boost::unique_lock<Mutex> lk(p.m);
+      while (clock_type::now() < end)
+      {
+        while (p.turn % 2 != 0)
+          p.cond.wait(lk);
+        ++p.turn;
+        p.cond.notify_one();
+      }
+      p.done = true;
+    }
+    p.cond.notify_all();
+    other.join();
+    return p.turn / seconds_since(start) / 1e3;
+  }
+
+  template <typename SharedMutex>
+  void read_mostly(SharedMutex& m, std::vector<int>& data,
+      boost::atomic<bool> const& done, unsigned long& ops)
+  {
+    unsigned long n = 0;
+    int sum = 0;
+    while (!done.load(boost::memory_order_relaxed))
+    {
+      if (n % 100 == 0)
+      {
+        boost::unique_lock<SharedMutex> lk(m);
+        ++data[n % data.size()];
+      }
+      else
+      {
+        boost::shared_lock<SharedMutex> lk(m);
+        sum += data[n % data.size()];
+      }
+      ++n;
+    }
+    ops = n + (sum < 0 ? 1 : 0);
+  }
+
+  // Returns millions of locks per second of all threads together.
+  template <typename SharedMutex>
+  double reader_heavy(int threads, int milliseconds)
+  {
+    SharedMutex m;
+    std::vector<int> data(64);
+    boost::atomic<bool> done(false);
+    std::vector<unsigned long> ops(threads);
+
+    boost::thread_group group;
+    clock_type::time_point const start = clock_type::now();
+    for (int i = 0; i < threads; ++i)
+    {
+      group.create_thread(boost::bind(&read_mostly<SharedMutex>, boost::ref(m),
+          boost::ref(data), boost::cref(done), boost::ref(ops[i])));
+    }
+    boost::this_thread::sleep_for(boost::chrono::milliseconds(milliseconds));
+    done = true;
+    group.join_all();
+
+    double total = 0;
+    for (int i = 0; i < threads; ++i)
+      total += ops[i];
+    return total / seconds_since(start) / 1e6;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  int max_threads = argc > 1 ? std::atoi(argv[1]) : 8;
+  int milliseconds = argc > 2 ? std::atoi(argv[2]) : 300;
+
+  // glibc omits the lock prefix of its atomic operations as long as the
+  // process has a single thread, which is not the case we measure
+  boost::thread(&noop).join();
+
+  std::printf("%-28s %8s %14s %14s\n", "benchmark", "threads", "boost", "futex");
+  std::printf("%-28s %8d %14.2f %14.2f\n", "uncontended mutex (M/s)", 1,
+      uncontended<boost::mutex>(milliseconds),
+      uncontended<boost::futex_mutex>(milliseconds));
+  std::printf("%-28s %8d %14.2f %14.2f\n", "uncontended shared (M/s)", 1,
+      uncontended<boost::shared_mutex>(milliseconds),
+      uncontended<boost::futex_shared_mutex>(milliseconds));
+  for (int threads = 2; threads <= max_threads; threads *= 2)
+  {
+    std::printf("%-28s %8d %14.2f %14.2f\n", "contended mutex (M/s)", threads,
+        contended<boost::mutex>(threads, milliseconds),
+        contended<boost::futex_mutex>(threads, milliseconds));
+  }
+  std::printf("%-28s %8d %14.2f %14.2f\n", "condition ping-pong (K/s)", 2,
+      condition_ping_pong<boost::mutex, boost::condition_variable>(milliseconds),
+      condition_ping_pong<boost::futex_mutex, boost::futex_condition_variable>(milliseconds));
+  for (int threads = 1; threads <= max_threads; threads *= 2)
+  {
+    std::printf("%-28s %8d %14.2f %14.2f\n", "reader-heavy shared (M/s)", threads,
+        reader_heavy<boost::shared_mutex>(threads, milliseconds),
+        reader_heavy<boost::futex_shared_mutex>(threads, milliseconds));
+  }
+  return 0;
+}
+
+#else
+
+int main()
+{
+  return 0;
+}
+
+#endif
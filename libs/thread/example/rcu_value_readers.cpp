@@ -0,0 +1,143 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Compares the read throughput of a routing table that is protected by a
+// shared_mutex with one that is published through an rcu_value, with a
+// growing number of reader threads and one writer that publishes a new
+// table every millisecond.
+//
+// Usage: rcu_value_readers [<max-readers> [<milliseconds>]]
+
+#include <boost/thread/rcu_value.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+
+namespace
+{
+  typedef std::map<int, int> table;
+
+  table make_table(int version)
+  {
+    table t;
+    for (int i = 0; i < 64; ++i)
+      t[i] = version;
+    return t;
+  }
+
+  // the two ways of sharing the table, with a common interface
+
+  class shared_mutex_table
+  {
+  public:
+    shared_mutex_table() : table_(make_table(0)) {}
+
+    int lookup(int key) const
+    {
+      boost::shared_lock<boost::shared_mutex> lk(mtx_);
+      return table_.find(key)->second;
+    }
+
+    void publish(int version)
+    {
+      table t = make_table(version);
+      boost::unique_lock<boost::shared_mutex> lk(mtx_);
+      table_.swap(t);
+    }
+
+  private:
+    mutable boost::shared_mutex mtx_;
+    table table_;
+  };
+
+  class rcu_table
+  {
+  public:
+    rcu_table() : table_(make_table(0)) {}
+
+    int lookup(int key) const
+    {
+      return table_.read()->find(key)->second;
+    }
+
+    void publish(int version)
+    {
+      table_.publish(make_table(version));
+    }
+
+  private:
+    boost::rcu_value<table> table_;
+  };
+
+  template <typename Table>
+  void reader(Table const& t, boost::atomic<bool> const& done, unsigned long& reads)
+  {
+    unsigned long n = 0;
+    int sum = 0;
+    while (!done.load(boost::memory_order_relaxed))
+    {
+      sum += t.lookup(static_cast<int>(n % 64));
+      ++n;
+    }
+    reads = n + (sum < 0 ? 1 : 0);
+  }
+
+  template <typename Table>
+  void writer(Table& t, boost::atomic<bool> const& done)
+  {
+    for (int version = 1; !done.load(); ++version)
+    {
+      t.publish(version);
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+    }
+  }
+
+  // Returns the number of reads per second of all readers together.
+  template <typename Table>
+  double run(int readers, int milliseconds)
+  {
+    Table t;
+    boost::atomic<bool> done(false);
+    std::vector<unsigned long> reads(readers);
+
+    boost::thread_group threads;
+    for (int i = 0; i < readers; ++i)
+    {
+      threads.create_thread(boost::bind(&reader<Table>, boost::cref(t),
+          boost::cref(done), boost::ref(reads[i])));
+    }
+    threads.create_thread(boost::bind(&writer<Table>, boost::ref(t), boost::cref(done)));
+
+    boost::this_thread::sleep_for(boost::chrono::milliseconds(milliseconds));
+    done = true;
+    threads.join_all();
+
+    double total = 0;
+    for (int i = 0; i < readers; ++i)
+      total += reads[i];
+    return total * 1000.0 / milliseconds;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  int max_readers = argc > 1 ? std::atoi(argv[1]) : 16;
+  int milliseconds = argc > 2 ? std::atoi(argv[2]) : 500;
+
+  std::printf("%8s %20s %20s\n", "readers", "shared_mutex (M/s)", "rcu_value (M/s)");
+  for (int readers = 1; readers <= max_readers; readers *= 2)
+  {
+    std::printf("%8d %20.2f %20.2f\n", readers,
+        run<shared_mutex_table>(readers, milliseconds) / 1e6,
+        run<rcu_table>(readers, milliseconds) / 1e6);
+  }
+  return 0;
+}
@@ -0,0 +1,166 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Compares fork/join parallelism on a thread_pool, where a task waits for its
+// sub-tasks by running queued tasks, against boost::async, which starts a new
+// thread for each sub-task.
+//
+// Usage: thread_pool_fork_join [<fib-n> [<sort-size> [<threads>]]]
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/thread_pool.hpp>
+#include <boost/thread/future.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+  // Below these sizes the work is done serially.
+  const int fib_cutoff = 18;
+  const std::size_t sort_cutoff = 16384;
+
+  long serial_fib(int n)
+  {
+    return n < 2 ? n : serial_fib(n - 1) + serial_fib(n - 2);
+  }
+
+  long pool_fib(boost::thread_pool& pool, int n)
+  {
+    if (n <= fib_cutoff)
+      return serial_fib(n);
+    boost::future<long> a = pool.submit(
+        boost::bind(&pool_fib, boost::ref(pool), n - 1));
+    long b = pool_fib(pool, n - 2);
+    pool.reschedule_until(boost::bind(&boost::future<long>::is_ready, &a));
+    return a.get() + b;
+  }
+
+  long async_fib(int n)
+  {
+    if (n <= fib_cutoff)
+      return serial_fib(n);
+    boost::future<long> a = boost::async(boost::launch::async,
+        boost::bind(&async_fib, n - 1));
+    long b = async_fib(n - 2);
+    return a.get() + b;
+  }
+
+  typedef std::vector<int>::iterator iterator;
+
+  void pool_sort(boost::thread_pool& pool, iterator first, iterator last)
+  {
+    std::size_t size = last - first;
+    if (size <= sort_cutoff)
+    {
+      std::sort(first, last);
+      return;
+    }
+    iterator middle = first + size / 2;
+    boost::future<void> a = pool.submit(
+        boost::bind(&pool_sort, boost::ref(pool), first, middle));
+    pool_sort(pool, middle, last);
+    pool.reschedule_until(boost::bind(&boost::future<void>::is_ready, &a));
+    a.get();
+    std::inplace_merge(first, middle, last);
+  }
+
+  void async_sort(iterator first, iterator last)
+  {
+    std::size_t size = last - first;
+    if (size <= sort_cutoff)
+    {
+      std::sort(first, last);
+      return;
+    }
+    iterator middle = first + size / 2;
+    boost::future<void> a = boost::async(boost::launch::async,
+        boost::bind(&async_sort, first, middle));
+    async_sort(middle, last);
+    a.get();
+    std::inplace_merge(first, middle, last);
+  }
+
+  double seconds_since(boost::chrono::steady_clock::time_point start)
+  {
+    return boost::chrono::duration<double>(
+        boost::chrono::steady_clock::now() - start).count();
+  }
+
+  void fill(std::vector<int>& v)
+  {
+    std::srand(1);
+    for (std::size_t i = 0; i < v.size(); ++i)
+      v[i] = std::rand();
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  int n = argc > 1 ? std::atoi(argv[1]) : 32;
+  std::size_t sort_size = argc > 2 ? std::atoi(argv[2]) : 4000000;
+  unsigned threads = argc > 3 ? std::atoi(argv[3]) : 0;
+
+  boost::thread_pool pool(threads);
+  std::printf("%u pool threads\n", static_cast<unsigned>(pool.size()));
+
+  boost::chrono::steady_clock::time_point start =
+      boost::chrono::steady_clock::now();
+  long serial_result = serial_fib(n);
+  std::printf("fib(%d)   serial      %8.3f s\n", n, seconds_since(start));
+
+  start = boost::chrono::steady_clock::now();
+  long pool_result = pool.submit(
+      boost::bind(&pool_fib, boost::ref(pool), n)).get();
+  std::printf("fib(%d)   thread_pool %8.3f s\n", n, seconds_since(start));
+
+  start = boost::chrono::steady_clock::now();
+  long async_result = async_fib(n);
+  std::printf("fib(%d)   async       %8.3f s\n", n, seconds_since(start));
+
+  if (pool_result != serial_result || async_result != serial_result)
+  {
+    std::printf("fib results differ\n");
+    return 1;
+  }
+
+  std::vector<int> expected(sort_size);
+  fill(expected);
+  start = boost::chrono::steady_clock::now();
+  std::sort(expected.begin(), expected.end());
+  std::printf("sort(%u) serial      %8.3f s\n",
+      static_cast<unsigned>(sort_size), seconds_since(start));
+
+  std::vector<int> v(sort_size);
+  fill(v);
+  start = boost::chrono::steady_clock::now();
+  pool.submit(boost::bind(&pool_sort, boost::ref(pool),
+      v.begin(), v.end())).get();
+  std::printf("sort(%u) thread_pool %8.3f s\n",
+      static_cast<unsigned>(sort_size), seconds_since(start));
+  if (v != expected)
+  {
+    std::printf("thread_pool sort failed\n");
+    return 1;
+  }
+
+  fill(v);
+  start = boost::chrono::steady_clock::now();
+  async_sort(v.begin(), v.end());
+  std::printf("sort(%u) async       %8.3f s\n",
+      static_cast<unsigned>(sort_size), seconds_since(start));
+  if (v != expected)
+  {
+    std::printf("async sort failed\n");
+    return 1;
+  }
+
+  return 0;
+}
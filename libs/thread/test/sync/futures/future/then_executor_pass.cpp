@@ -0,0 +1,131 @@
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/future.hpp>
+
+// class future<R>
+
+// template<typename Ex, typename F>
+// auto then(Ex& ex, F func) -> future<decltype(func(*this))>;
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/future.hpp>
+#include <boost/thread/thread_pool.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include <stdexcept>
+
+#if defined BOOST_THREAD_PROVIDES_FUTURE_CONTINUATION
+
+boost::thread::id continuation_thread;
+
+int p1()
+{
+  return 1;
+}
+
+int p2(boost::future<int>& f)
+{
+  continuation_thread = boost::this_thread::get_id();
+  return 2 * f.get();
+}
+
+void p3(boost::future<int>& f)
+{
+  f.get();
+}
+
+int p4(boost::future<int>& f)
+{
+  f.get();
+  throw std::runtime_error("continuation failed");
+}
+
+// An executor that runs the closures it is given immediately.
+struct inline_executor
+{
+  int count;
+
+  inline_executor() : count(0) {}
+
+  template <typename F>
+  void execute(F f)
+  {
+    ++count;
+    f();
+  }
+};
+
+int main()
+{
+  {
+    boost::thread_pool pool(2);
+    boost::future<int> f1 = pool.submit(&p1);
+    boost::future<int> f2 = f1.then(pool, &p2);
+    BOOST_TEST(!f1.valid());
+    BOOST_TEST(f2.get()==2);
+    BOOST_TEST(continuation_thread!=boost::this_thread::get_id());
+  }
+  {
+    // The continuation of a ready future is still run by the executor.
+    boost::promise<int> p;
+    p.set_value(1);
+    inline_executor ex;
+    boost::future<int> f2 = p.get_future().then(ex, &p2);
+    BOOST_TEST(ex.count==1);
+    BOOST_TEST(f2.get()==2);
+  }
+  {
+    boost::promise<int> p;
+    inline_executor ex;
+    boost::future<int> f2 = p.get_future().then(ex, &p2).then(ex, &p2);
+    BOOST_TEST(ex.count==0);
+    p.set_value(1);
+    BOOST_TEST(ex.count==2);
+    BOOST_TEST(f2.get()==4);
+  }
+  {
+    boost::thread_pool pool(2);
+    boost::future<void> f2 = pool.submit(&p1).then(pool, &p3);
+    f2.get();
+  }
+  {
+    boost::thread_pool pool(2);
+    boost::future<int> f2 = pool.submit(&p1).then(pool, &p4);
+    try
+    {
+      f2.get();
+      BOOST_TEST(false);
+    }
+    catch (std::runtime_error&)
+    {
+    }
+  }
+  {
+    // A continuation that cannot be scheduled makes the next future ready
+    // with the executor's exception.
+    boost::thread_pool pool(1);
+    pool.close();
+    boost::promise<int> p;
+    boost::future<int> f2 = p.get_future().then(pool, &p2);
+    p.set_value(1);
+    try
+    {
+      f2.get();
+      BOOST_TEST(false);
+    }
+    catch (boost::thread_resource_error&)
+    {
+    }
+  }
+
+  return boost::report_errors();
+}
+
+#else
+
+int main()
+{
+  return 0;
+}
+#endif
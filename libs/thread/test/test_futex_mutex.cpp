@@ -0,0 +1,238 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#if defined BOOST_THREAD_LINUX
+
+#include <boost/thread/futex_mutex.hpp>
+#include <boost/thread/futex_condition_variable.hpp>
+#include <boost/thread/futex_shared_mutex.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+
+namespace
+{
+    void increment(boost::futex_mutex& m, long& counter, int n)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            boost::unique_lock<boost::futex_mutex> lk(m);
+            ++counter;
+        }
+    }
+
+    struct gate
+    {
+        boost::futex_mutex m;
+        boost::futex_condition_variable cond;
+        bool open;
+        int waiting;
+        int passed;
+
+        gate() : open(false), waiting(0), passed(0)
+        {
+        }
+
+        bool is_open() const
+        {
+            return open;
+        }
+    };
+
+    void pass(gate& g)
+    {
+        boost::unique_lock<boost::futex_mutex> lk(g.m);
+        ++g.waiting;
+        g.cond.notify_all();
+        g.cond.wait(lk, boost::bind(&gate::is_open, boost::cref(g)));
+        ++g.passed;
+    }
+
+    // Writers keep both halves equal; readers check that they are.
+    struct pair_of_counters
+    {
+        boost::futex_shared_mutex m;
+        long first;
+        long second;
+
+        pair_of_counters() : first(0), second(0)
+        {
+        }
+    };
+
+    void writer(pair_of_counters& p, int n)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            boost::unique_lock<boost::futex_shared_mutex> lk(p.m);
+            ++p.first;
+            boost::this_thread::yield();
+            ++p.second;
+        }
+    }
+
+    void upgrader(pair_of_counters& p, int n)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            p.m.lock_upgrade();
+            long const first = p.first;
+            p.m.unlock_upgrade_and_lock();
+            p.first = first + 1;
+            p.second = first + 1;
+            p.m.unlock_and_lock_shared();
+            BOOST_CHECK_EQUAL(p.first, p.second);
+            p.m.unlock_shared();
+        }
+    }
+
+    void reader(pair_of_counters& p, boost::atomic<bool>& done, boost::atomic<int>& errors)
+    {
+        while (!done.load())
+        {
+            boost::shared_lock<boost::futex_shared_mutex> lk(p.m);
+            if (p.first != p.second)
+                ++errors;
+        }
+    }
+}
+
+void test_mutex_excludes()
+{
+    boost::futex_mutex m;
+    m.lock();
+    BOOST_CHECK(!m.try_lock());
+    m.unlock();
+    BOOST_CHECK(m.try_lock());
+    m.unlock();
+
+    long counter = 0;
+    boost::thread_group threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.create_thread(boost::bind(&increment, boost::ref(m),
+            boost::ref(counter), 100000));
+    }
+    threads.join_all();
+    BOOST_CHECK_EQUAL(counter, 400000);
+}
+
+void test_condition_variable_notify_all()
+{
+    gate g;
+    boost::thread_group threads;
+    for (int i = 0; i < 8; ++i)
+        threads.create_thread(boost::bind(&pass, boost::ref(g)));
+
+    {
+        boost::unique_lock<boost::futex_mutex> lk(g.m);
+        while (g.waiting < 8)
+            g.cond.wait(lk);
+        g.open = true;
+    }
+    g.cond.notify_all();
+    threads.join_all();
+    BOOST_CHECK_EQUAL(g.passed, 8);
+}
+
+void test_condition_variable_timeout()
+{
+    gate g;
+    boost::unique_lock<boost::futex_mutex> lk(g.m);
+
+    boost::chrono::steady_clock::time_point const start = boost::chrono::steady_clock::now();
+    BOOST_CHECK(!g.cond.wait_for(lk, boost::chrono::milliseconds(50),
+        boost::bind(&gate::is_open, boost::cref(g))));
+    BOOST_CHECK(boost::chrono::steady_clock::now() - start >= boost::chrono::milliseconds(50));
+    BOOST_CHECK(lk.owns_lock());
+
+    BOOST_CHECK(g.cond.wait_until(lk, boost::chrono::steady_clock::now()) == boost::cv_status::timeout);
+    BOOST_CHECK(!g.cond.timed_wait(lk, boost::posix_time::milliseconds(1)));
+}
+
+void test_shared_mutex_ownership()
+{
+    boost::futex_shared_mutex m;
+
+    m.lock_shared();
+    BOOST_CHECK(m.try_lock_shared());
+    BOOST_CHECK(m.try_lock_upgrade());
+    BOOST_CHECK(!m.try_lock());
+    BOOST_CHECK(!m.try_lock_for(boost::chrono::milliseconds(10)));
+    BOOST_CHECK(!m.try_lock_upgrade());
+    m.unlock_shared();
+    m.unlock_shared();
+
+    // the upgrade owner is now alone
+    BOOST_CHECK(m.try_unlock_upgrade_and_lock());
+    BOOST_CHECK(!m.try_lock_shared());
+    BOOST_CHECK(!m.try_lock_shared_for(boost::chrono::milliseconds(10)));
+    BOOST_CHECK(!m.try_lock_upgrade());
+    m.unlock_and_lock_upgrade();
+    m.unlock_upgrade_and_lock_shared();
+    BOOST_CHECK(m.try_unlock_shared_and_lock_upgrade());
+    m.unlock_upgrade();
+
+    m.lock_shared();
+    BOOST_CHECK(m.try_unlock_shared_and_lock());
+    m.unlock();
+    BOOST_CHECK(m.try_lock());
+    m.unlock();
+}
+
+void test_shared_mutex_readers_and_writers()
+{
+    pair_of_counters p;
+    boost::atomic<bool> done(false);
+    boost::atomic<int> errors(0);
+
+    boost::thread_group readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.create_thread(boost::bind(&reader, boost::ref(p),
+            boost::ref(done), boost::ref(errors)));
+    }
+
+    boost::thread_group writers;
+    writers.create_thread(boost::bind(&writer, boost::ref(p), 2000));
+    writers.create_thread(boost::bind(&writer, boost::ref(p), 2000));
+    writers.create_thread(boost::bind(&upgrader, boost::ref(p), 2000));
+    writers.join_all();
+
+    done = true;
+    readers.join_all();
+
+    BOOST_CHECK_EQUAL(errors.load(), 0);
+    BOOST_CHECK_EQUAL(p.first, 6000);
+    BOOST_CHECK_EQUAL(p.second, 6000);
+}
+
+boost::unit_test::test_suite* init_unit_test_suite(int, char*[])
+{
+    boost::unit_test::test_suite* test =
+        BOOST_TEST_SUITE("Boost.Threads: futex mutex test suite");
+
+    test->add(BOOST_TEST_CASE(test_mutex_excludes));
+    test->add(BOOST_TEST_CASE(test_condition_variable_notify_all));
+    test->add(BOOST_TEST_CASE(test_condition_variable_timeout));
+    test->add(BOOST_TEST_CASE(test_shared_mutex_ownership));
+    test->add(BOOST_TEST_CASE(test_shared_mutex_readers_and_writers));
+
+    return test;
+}
+
+#else
+
+boost::unit_test::test_suite* init_unit_test_suite(int, char*[])
+{
+    return BOOST_TEST_SUITE("Boost.Threads: futex mutex test suite");
+}
+
+#endif
@@ -0,0 +1,171 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/rcu_value.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    boost::atomic<int> instances(0);
+
+    // A version of a routing table: all entries equal the version number.
+    struct table
+    {
+        int version;
+        std::vector<int> entries;
+
+        explicit table(int v = 0) : version(v), entries(16, v)
+        {
+            ++instances;
+        }
+
+        table(table const& other) : version(other.version), entries(other.entries)
+        {
+            ++instances;
+        }
+
+        ~table()
+        {
+            --instances;
+        }
+
+        bool consistent() const
+        {
+            for (std::size_t i = 0; i < entries.size(); ++i)
+            {
+                if (entries[i] != version)
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    void next_version(table& t)
+    {
+        ++t.version;
+        for (std::size_t i = 0; i < t.entries.size(); ++i)
+            t.entries[i] = t.version;
+    }
+
+    void throw_runtime_error(table&)
+    {
+        throw std::runtime_error("update failed");
+    }
+
+    void reader(boost::rcu_value<table>& value, boost::atomic<bool>& done,
+        boost::atomic<int>& errors)
+    {
+        int last = 0;
+        while (!done.load())
+        {
+            boost::rcu_read_ptr<table> p = value.read();
+            if (!p->consistent() || p->version < last)
+                ++errors;
+            last = p->version;
+        }
+    }
+}
+
+void test_read_and_publish()
+{
+    {
+        boost::rcu_value<table> value(table(1));
+        BOOST_CHECK_EQUAL(value.read()->version, 1);
+        BOOST_CHECK_EQUAL(value->entries.size(), 16u);
+
+        value.publish(table(2));
+        BOOST_CHECK_EQUAL(value.get().version, 2);
+
+        value = table(3);
+        BOOST_CHECK_EQUAL((*value.read()).version, 3);
+        value.synchronize();
+        BOOST_CHECK_EQUAL(instances.load(), 1);
+    }
+    BOOST_CHECK_EQUAL(instances.load(), 0);
+}
+
+void test_snapshot_outlives_publish()
+{
+    {
+        boost::rcu_value<table> value(table(1));
+        {
+            boost::rcu_read_ptr<table> old = value.read();
+            value.update(&next_version);
+            value.update(&next_version);
+
+            // the reader still holds the first version
+            BOOST_CHECK_EQUAL(old->version, 1);
+            BOOST_CHECK(old->consistent());
+            BOOST_CHECK_EQUAL(value.read()->version, 3);
+            BOOST_CHECK(instances.load() >= 2);
+        }
+        value.synchronize();
+        BOOST_CHECK_EQUAL(instances.load(), 1);
+    }
+    BOOST_CHECK_EQUAL(instances.load(), 0);
+}
+
+void test_update_throws()
+{
+    boost::rcu_value<table> value(table(1));
+    BOOST_CHECK_THROW(value.update(&throw_runtime_error), std::runtime_error);
+    BOOST_CHECK_EQUAL(value.read()->version, 1);
+    value.synchronize();
+    BOOST_CHECK_EQUAL(instances.load(), 1);
+}
+
+void test_concurrent_readers()
+{
+    {
+        boost::rcu_value<table> value;
+        boost::atomic<bool> done(false);
+        boost::atomic<int> errors(0);
+
+        boost::thread_group readers;
+        for (int i = 0; i < 4; ++i)
+        {
+            readers.create_thread(boost::bind(&reader, boost::ref(value),
+                boost::ref(done), boost::ref(errors)));
+        }
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            value.update(&next_version);
+            if (i % 100 == 0)
+                boost::this_thread::yield();
+        }
+
+        done = true;
+        readers.join_all();
+
+        BOOST_CHECK_EQUAL(errors.load(), 0);
+        BOOST_CHECK_EQUAL(value.read()->version, 2000);
+
+        value.synchronize();
+        BOOST_CHECK_EQUAL(instances.load(), 1);
+    }
+    BOOST_CHECK_EQUAL(instances.load(), 0);
+}
+
+boost::unit_test::test_suite* init_unit_test_suite(int, char*[])
+{
+    boost::unit_test::test_suite* test =
+        BOOST_TEST_SUITE("Boost.Threads: rcu_value test suite");
+
+    test->add(BOOST_TEST_CASE(test_read_and_publish));
+    test->add(BOOST_TEST_CASE(test_snapshot_outlives_publish));
+    test->add(BOOST_TEST_CASE(test_update_throws));
+    test->add(BOOST_TEST_CASE(test_concurrent_readers));
+
+    return test;
+}
@@ -0,0 +1,217 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/thread_pool.hpp>
+#include <boost/thread/detail/work_stealing_deque.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    boost::atomic<int> counter(0);
+
+    void increment()
+    {
+        counter.fetch_add(1);
+    }
+
+    int return_value(int i)
+    {
+        return i;
+    }
+
+    int throw_runtime_error()
+    {
+        throw std::runtime_error("task failed");
+    }
+
+    // Computes fib(n) by submitting both halves of each step to the pool.
+    int fib(boost::thread_pool& pool, int n)
+    {
+        if (n < 2)
+            return n;
+        boost::future<int> a = pool.submit(
+            boost::bind(&fib, boost::ref(pool), n - 1));
+        boost::future<int> b = pool.submit(
+            boost::bind(&fib, boost::ref(pool), n - 2));
+        pool.reschedule_until(boost::bind(&boost::future<int>::is_ready, &a));
+        pool.reschedule_until(boost::bind(&boost::future<int>::is_ready, &b));
+        return a.get() + b.get();
+    }
+
+    void submit_increment(boost::thread_pool& pool)
+    {
+        pool.execute(&increment);
+    }
+
+    void steal_thread(boost::thread_detail::work_stealing_deque<int>& deque,
+        boost::atomic<bool>& done, std::vector<int>& stolen)
+    {
+        for (;;)
+        {
+            bool finished = done.load();
+            while (int* p = deque.steal())
+                stolen.push_back(*p);
+            if (finished)
+                break;
+        }
+    }
+}
+
+void test_work_stealing_deque_single_thread()
+{
+    boost::thread_detail::work_stealing_deque<int> deque(2);
+    std::vector<int> values(100);
+    for (int i = 0; i < 100; ++i)
+    {
+        values[i] = i;
+        deque.push(&values[i]);
+    }
+    BOOST_CHECK(!deque.empty());
+
+    // The owner takes the most recent element, thieves take the oldest.
+    BOOST_CHECK_EQUAL(*deque.take(), 99);
+    BOOST_CHECK_EQUAL(*deque.steal(), 0);
+    for (int i = 98; i > 0; --i)
+        BOOST_CHECK_EQUAL(*deque.take(), i);
+    BOOST_CHECK(deque.take() == 0);
+    BOOST_CHECK(deque.steal() == 0);
+    BOOST_CHECK(deque.empty());
+}
+
+void test_work_stealing_deque_concurrent_steal()
+{
+    const int count = 100000;
+    boost::thread_detail::work_stealing_deque<int> deque(4);
+    std::vector<int> values(count);
+    std::vector<int> taken;
+    std::vector<int> stolen[2];
+    boost::atomic<bool> done(false);
+
+    boost::thread t1(&steal_thread, boost::ref(deque), boost::ref(done),
+        boost::ref(stolen[0]));
+    boost::thread t2(&steal_thread, boost::ref(deque), boost::ref(done),
+        boost::ref(stolen[1]));
+
+    for (int i = 0; i < count; ++i)
+    {
+        values[i] = i;
+        deque.push(&values[i]);
+        if (i % 3 == 0)
+            if (int* p = deque.take())
+                taken.push_back(*p);
+    }
+    while (int* p = deque.take())
+        taken.push_back(*p);
+    done.store(true);
+    t1.join();
+    t2.join();
+
+    // Every element is removed exactly once.
+    std::vector<int> seen(count, 0);
+    for (std::size_t i = 0; i < taken.size(); ++i)
+        ++seen[taken[i]];
+    for (int j = 0; j < 2; ++j)
+        for (std::size_t i = 0; i < stolen[j].size(); ++i)
+            ++seen[stolen[j][i]];
+    for (int i = 0; i < count; ++i)
+        BOOST_CHECK_EQUAL(seen[i], 1);
+}
+
+void test_submit_returns_future()
+{
+    boost::thread_pool pool(2);
+    BOOST_CHECK_EQUAL(pool.size(), 2u);
+
+    std::vector<boost::shared_future<int> > results;
+    for (int i = 0; i < 100; ++i)
+        results.push_back(pool.submit(boost::bind(&return_value, i)).share());
+    for (int i = 0; i < 100; ++i)
+        BOOST_CHECK_EQUAL(results[i].get(), i);
+}
+
+void test_submit_propagates_exception()
+{
+    boost::thread_pool pool(2);
+    boost::future<int> f = pool.submit(&throw_runtime_error);
+    BOOST_CHECK_THROW(f.get(), std::runtime_error);
+}
+
+void test_execute_and_destructor_drain()
+{
+    counter = 0;
+    {
+        boost::thread_pool pool(4);
+        for (int i = 0; i < 1000; ++i)
+            pool.execute(boost::bind(&submit_increment, boost::ref(pool)));
+    }
+    BOOST_CHECK_EQUAL(counter.load(), 1000);
+}
+
+void test_fork_join()
+{
+    boost::thread_pool pool(4);
+    boost::future<int> f = pool.submit(
+        boost::bind(&fib, boost::ref(pool), 20));
+    BOOST_CHECK_EQUAL(f.get(), 6765);
+}
+
+void test_single_thread_fork_join()
+{
+    // With one thread, a task that waits for its sub-tasks must run them.
+    boost::thread_pool pool(1);
+    boost::future<int> f = pool.submit(
+        boost::bind(&fib, boost::ref(pool), 15));
+    BOOST_CHECK_EQUAL(f.get(), 610);
+}
+
+void test_try_executing_one_from_outside()
+{
+    counter = 0;
+    {
+        boost::thread_pool pool(1);
+        for (int i = 0; i < 100; ++i)
+            pool.execute(&increment);
+        while (pool.try_executing_one())
+        {
+        }
+    }
+    BOOST_CHECK_EQUAL(counter.load(), 100);
+}
+
+void test_submit_after_close_throws()
+{
+    boost::thread_pool pool(2);
+    pool.close();
+    BOOST_CHECK(pool.closed());
+    BOOST_CHECK_THROW(pool.execute(&increment), boost::thread_resource_error);
+    BOOST_CHECK_THROW(pool.submit(boost::bind(&return_value, 1)),
+        boost::thread_resource_error);
+}
+
+boost::unit_test::test_suite* init_unit_test_suite(int, char*[])
+{
+    boost::unit_test::test_suite* test =
+        BOOST_TEST_SUITE("Boost.Threads: thread_pool test suite");
+
+    test->add(BOOST_TEST_CASE(test_work_stealing_deque_single_thread));
+    test->add(BOOST_TEST_CASE(test_work_stealing_deque_concurrent_steal));
+    test->add(BOOST_TEST_CASE(test_submit_returns_future));
+    test->add(BOOST_TEST_CASE(test_submit_propagates_exception));
+    test->add(BOOST_TEST_CASE(test_execute_and_destructor_drain));
+    test->add(BOOST_TEST_CASE(test_fork_join));
+    test->add(BOOST_TEST_CASE(test_single_thread_fork_join));
+    test->add(BOOST_TEST_CASE(test_try_executing_one_from_outside));
+    test->add(BOOST_TEST_CASE(test_submit_after_close_throws));
+
+    return test;
+}